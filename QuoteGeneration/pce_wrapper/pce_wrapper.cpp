@@ -60,14 +60,23 @@ struct PCE_status {
     sgx_enclave_id_t m_pce_eid;
     sgx_misc_attribute_t m_pce_attributes;
     char pce_path[MAX_PATH];
+    // Target info and ISVSVN of the PCE at pce_path, see sgx_pce_get_target()
+    bool m_pce_target_cached;
+    sgx_target_info_t m_pce_target_info;
+    sgx_isv_svn_t m_pce_isvsvn;
+    uint32_t m_pce_path_generation;     // incremented when pce_path changes
 
     PCE_status() :
         m_pce_enclave_load_policy(SGX_QL_DEFAULT),
-        m_pce_eid(0)
+        m_pce_eid(0),
+        m_pce_target_cached(false),
+        m_pce_isvsvn(0),
+        m_pce_path_generation(0)
     {
         se_mutex_init(&m_pce_mutex);
         memset(&m_pce_attributes, 0, sizeof(m_pce_attributes));
         memset(pce_path, 0, sizeof(pce_path));
+        memset(&m_pce_target_info, 0, sizeof(m_pce_target_info));
     }
     ~PCE_status() {
         if (m_pce_eid != 0) sgx_destroy_enclave(m_pce_eid);
@@ -260,6 +269,32 @@ sgx_pce_error_t sgx_pce_get_target(sgx_target_info_t *p_target,
         return(SGX_PCE_INVALID_PARAMETER);
     }
 
+    // The target info and ISVSVN only depend on the PCE enclave file, so they are computed once
+    // instead of parsing the file and loading the PCE for each quote.
+    int rc = se_mutex_lock(&g_pce_status.m_pce_mutex);
+    if (rc != 1)
+    {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex");
+        return SGX_PCE_INTERFACE_UNAVAILABLE;
+    }
+    bool cached = g_pce_status.m_pce_target_cached;
+    uint32_t pce_path_generation = g_pce_status.m_pce_path_generation;
+    if (cached)
+    {
+        memcpy_s(p_target, sizeof(*p_target), &g_pce_status.m_pce_target_info, sizeof(g_pce_status.m_pce_target_info));
+        *p_isvsvn = g_pce_status.m_pce_isvsvn;
+    }
+    rc = se_mutex_unlock(&g_pce_status.m_pce_mutex);
+    if (rc != 1)
+    {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex");
+        return SGX_PCE_INTERFACE_UNAVAILABLE;
+    }
+    if (cached)
+    {
+        return SGX_PCE_SUCCESS;
+    }
+
     if (!get_pce_path(pce_enclave_path, MAX_PATH))
         return SGX_PCE_INTERFACE_UNAVAILABLE;
 
@@ -288,6 +323,25 @@ sgx_pce_error_t sgx_pce_get_target(sgx_target_info_t *p_target,
 
     *p_isvsvn = metadata.enclave_css.body.isv_svn;
 
+    rc = se_mutex_lock(&g_pce_status.m_pce_mutex);
+    if (rc != 1)
+    {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex");
+        return SGX_PCE_SUCCESS;
+    }
+    // Don't cache the target info if the PCE path has changed meanwhile
+    if (pce_path_generation == g_pce_status.m_pce_path_generation)
+    {
+        memcpy_s(&g_pce_status.m_pce_target_info, sizeof(g_pce_status.m_pce_target_info), p_target, sizeof(*p_target));
+        g_pce_status.m_pce_isvsvn = *p_isvsvn;
+        g_pce_status.m_pce_target_cached = true;
+    }
+    rc = se_mutex_unlock(&g_pce_status.m_pce_mutex);
+    if (rc != 1)
+    {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex");
+    }
+
     return SGX_PCE_SUCCESS;
 }
 
@@ -586,12 +640,27 @@ sgx_pce_error_t sgx_set_pce_path(const char* p_path)
     // after this line len <= sizeof(g_pce_status.pce_path) - 1
     if(len > sizeof(g_pce_status.pce_path) - 1)
         return SGX_PCE_INVALID_PARAMETER;
+    int rc = se_mutex_lock(&g_pce_status.m_pce_mutex);
+    if (rc != 1)
+    {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex");
+        return SGX_PCE_INTERFACE_UNAVAILABLE;
+    }
 #ifndef _MSC_VER
     strncpy(g_pce_status.pce_path, p_path, sizeof(g_pce_status.pce_path) - 1);
 #else
     strncpy_s(g_pce_status.pce_path, sizeof(g_pce_status.pce_path), p_path, sizeof(g_pce_status.pce_path));
 #endif
     g_pce_status.pce_path[len] = '\0';
+    // The cached target info belongs to the previous PCE
+    g_pce_status.m_pce_target_cached = false;
+    g_pce_status.m_pce_path_generation++;
+    rc = se_mutex_unlock(&g_pce_status.m_pce_mutex);
+    if (rc != 1)
+    {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex");
+        return SGX_PCE_INTERFACE_UNAVAILABLE;
+    }
     return SGX_PCE_SUCCESS;
 }
 
@@ -38,6 +38,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <fstream>
 #include <curl/curl.h>
 #include <algorithm>
@@ -45,11 +46,18 @@
 using namespace std;
 
 #define MAX_URL_LENGTH  2083
+#define MAX_PATH_LENGTH 4096
 
 // Default URL for PCCS server if configuration file doesn't exist
 char server_url[MAX_URL_LENGTH]  = "https://localhost:8081/sgx/certification/v3/";
 // Use secure HTTPS certificate or not
 bool g_use_secure_cert = true;
+// Expiration time of cached verification collateral in hours, 0 disables the cache
+uint32_t g_cache_expire_hours = 24;
+// Directory of the on-disk collateral cache, empty string disables the on-disk cache
+char g_cache_dir[MAX_PATH_LENGTH] = "";
+// Maximum number of idle CURL handles (and their keep-alive connections) kept for reuse
+uint32_t g_connection_pool_size = 4;
 
 /**
 * Global initializtion of the QCNL library. Will be called when .so is loaded
@@ -84,6 +92,18 @@ __attribute__((constructor)) void _qcnl_global_init()
                      (value.compare("FALSE") == 0 || value.compare("false") == 0)){
                 g_use_secure_cert = false;
             }
+            else if (name.compare("COLLATERAL_CACHE_EXPIRE_HOURS") == 0) {
+                g_cache_expire_hours = (uint32_t)strtoul(value.c_str(), NULL, 10);
+            }
+            else if (name.compare("CONNECTION_POOL_SIZE") == 0) {
+                g_connection_pool_size = (uint32_t)strtoul(value.c_str(), NULL, 10);
+            }
+            else if (name.compare("COLLATERAL_CACHE_DIR") == 0) {
+                if (value.size() < sizeof(g_cache_dir)) {
+                    value.copy(g_cache_dir, value.size()+1);
+                    g_cache_dir[value.size()] = '\0';
+                }
+            }
             else {
                 continue;
             }
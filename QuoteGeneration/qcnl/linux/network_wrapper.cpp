@@ -41,10 +41,13 @@
 #include <curl/curl.h>
 #include <map>
 #include <fstream>
+#include <mutex>
+#include <vector>
 #include "sgx_default_qcnl_wrapper.h"
 #include "se_memcpy.h"
 
 extern bool g_use_secure_cert;
+extern uint32_t g_connection_pool_size;
 
 typedef struct _network_malloc_info_t{
     char *base;
@@ -75,6 +78,118 @@ static size_t write_callback(void *ptr, size_t size, size_t nmemb, void *stream)
     return size*nmemb;
 }
 
+/**
+* Thread-safe pool of CURL easy handles. Idle handles are kept alive between requests, and all handles are attached
+* to one CURLSH share handle that holds the DNS cache, the SSL session cache and the connection cache. A request
+* to PCCS therefore reuses an open keep-alive connection, or at least resumes the TLS session, instead of doing a
+* new TCP connection and a full TLS handshake.
+*/
+class CurlHandlePool {
+public:
+    CurlHandlePool() : m_share(NULL) {}
+
+    ~CurlHandlePool()
+    {
+        for (size_t i = 0; i < m_idle.size(); i++) {
+            curl_easy_cleanup(m_idle[i]);
+        }
+        m_idle.clear();
+        if (m_share) {
+            curl_share_cleanup(m_share);
+            m_share = NULL;
+        }
+    }
+
+    CURL *acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_pool_mutex);
+            if (!m_idle.empty()) {
+                CURL *curl = m_idle.back();
+                m_idle.pop_back();
+                return curl;
+            }
+            if (!m_share) {
+                m_share = create_share();
+            }
+        }
+
+        CURL *curl = curl_easy_init();
+        if (curl && m_share) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+        }
+        return curl;
+    }
+
+    void release(CURL *curl)
+    {
+        if (!curl)
+            return;
+
+        // Drop all options (they may point to buffers of the finished request), but keep the live connection
+        curl_easy_reset(curl);
+
+        std::lock_guard<std::mutex> lock(m_pool_mutex);
+        if (m_idle.size() < g_connection_pool_size) {
+            m_idle.push_back(curl);
+        }
+        else {
+            curl_easy_cleanup(curl);
+        }
+    }
+
+private:
+    CurlHandlePool(const CurlHandlePool&);
+    CurlHandlePool& operator=(const CurlHandlePool&);
+
+    CURLSH *create_share()
+    {
+        CURLSH *share = curl_share_init();
+        if (!share)
+            return NULL;
+
+        if (curl_share_setopt(share, CURLSHOPT_LOCKFUNC, share_lock) != CURLSHE_OK ||
+            curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, share_unlock) != CURLSHE_OK ||
+            curl_share_setopt(share, CURLSHOPT_USERDATA, this) != CURLSHE_OK ||
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) != CURLSHE_OK ||
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK) {
+            curl_share_cleanup(share);
+            return NULL;
+        }
+#if LIBCURL_VERSION_NUM >= 0x073900
+        // Sharing the connection cache is supported since libcurl 7.57.0
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+        return share;
+    }
+
+    static void share_lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+    {
+        (void)handle;
+        (void)access;
+        CurlHandlePool *pool = reinterpret_cast<CurlHandlePool *>(userptr);
+        if (data < CURL_LOCK_DATA_LAST) {
+            pool->m_share_mutex[data].lock();
+        }
+    }
+
+    static void share_unlock(CURL *handle, curl_lock_data data, void *userptr)
+    {
+        (void)handle;
+        CurlHandlePool *pool = reinterpret_cast<CurlHandlePool *>(userptr);
+        if (data < CURL_LOCK_DATA_LAST) {
+            pool->m_share_mutex[data].unlock();
+        }
+    }
+
+    std::mutex m_pool_mutex;
+    std::vector<CURL *> m_idle;
+    CURLSH *m_share;
+    std::mutex m_share_mutex[CURL_LOCK_DATA_LAST];
+};
+
+static CurlHandlePool g_curl_pool;
+
 /**
 * This method converts CURL error codes to QCNL error codes
 *
@@ -158,7 +273,7 @@ sgx_qcnl_error_t qcnl_https_get(const char* url,
     network_malloc_info_t res_body = {0,0};
 
     do {
-        curl = curl_easy_init();
+        curl = g_curl_pool.acquire();
         if (!curl)
             break;
 
@@ -176,6 +291,10 @@ sgx_qcnl_error_t qcnl_https_get(const char* url,
                 break;
         }
 
+        // Keep the connection to PCCS alive between requests
+        if (curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L) != CURLE_OK)
+            break;
+
         // Set write callback functions
         if(curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback)!=CURLE_OK)
             break;
@@ -209,9 +328,7 @@ sgx_qcnl_error_t qcnl_https_get(const char* url,
 
     } while(0);
 
-    if (curl) {
-        curl_easy_cleanup(curl);
-    }
+    g_curl_pool.release(curl);
     if (ret != SGX_QCNL_SUCCESS) {
         if(res_body.base){
             free(res_body.base);
@@ -257,7 +374,7 @@ sgx_qcnl_error_t qcnl_https_post(const char* url,
     struct curl_slist *headers = NULL;
 
     do {
-        curl = curl_easy_init();
+        curl = g_curl_pool.acquire();
         if (!curl)
             break;
 
@@ -295,6 +412,10 @@ sgx_qcnl_error_t qcnl_https_post(const char* url,
                 break;
         }
 
+        // Keep the connection to PCCS alive between requests
+        if (curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L) != CURLE_OK)
+            break;
+
         // Set write callback functions
         if(curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback)!=CURLE_OK)
             break;
@@ -332,10 +453,8 @@ sgx_qcnl_error_t qcnl_https_post(const char* url,
 
     } while(0);
 
-    if (curl) {
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-    }
+    g_curl_pool.release(curl);
+    curl_slist_free_all(headers);
     if (ret != SGX_QCNL_SUCCESS) {
         if(res_body.base){
             free(res_body.base);
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * File: qcnl_cache.cpp
+ *  
+ * Description: In-process and optional on-disk cache of the verification
+ *              collateral returned by PCCS, keyed by request URL
+ *
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <map>
+#include <string>
+#include <mutex>
+#include <fstream>
+#include <algorithm>
+#include "qcnl_cache.h"
+#include "se_memcpy.h"
+
+using namespace std;
+
+#define QCNL_CACHE_FILE_MAGIC    0x4C4E4351    // "QCNL"
+#define QCNL_CACHE_FILE_VERSION  1
+#define QCNL_CACHE_MAX_ITEM_SIZE (16*1024*1024)
+
+#ifdef _MSC_VER
+#define sscanf  sscanf_s
+#define timegm  _mkgmtime
+#endif
+
+// Default expiration time of cached collateral in hours, 0 disables the cache
+extern uint32_t g_cache_expire_hours;
+// Directory of the on-disk cache, empty string disables the on-disk cache
+extern char g_cache_dir[];
+
+typedef struct _qcnl_cache_entry_t {
+    time_t expiry;
+    string header;
+    string body;
+} qcnl_cache_entry_t;
+
+typedef struct _qcnl_cache_file_header_t {
+    uint32_t magic;
+    uint32_t version;
+    int64_t expiry;
+    uint32_t url_size;
+    uint32_t header_size;
+    uint32_t body_size;
+} qcnl_cache_file_header_t;
+
+static mutex g_cache_mutex;
+static map<string, qcnl_cache_entry_t> g_cache_map;
+
+/**
+* This method calculates the FNV-1a hash of the request URL. It is used to name the cache file, so it must
+* be stable across processes and builds.
+*
+* @param url Request URL
+*
+* @return Name of the cache file for the URL
+*/
+static string url_to_file_name(const string& url)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < url.size(); i++) {
+        hash ^= static_cast<uint8_t>(url[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    char name[32] = { 0 };
+    snprintf(name, sizeof(name), "%016llx.qcnl", static_cast<unsigned long long>(hash));
+    return string(g_cache_dir) + "/" + name;
+}
+
+/**
+* This method extracts the value of the "nextUpdate" field from a TCB info or enclave identity JSON body
+*
+* @param body Response body
+* @param next_update Output time of the next update
+*
+* @return true if the field was found and parsed
+*/
+static bool get_next_update(const string& body, time_t& next_update)
+{
+    const string field("\"nextUpdate\":\"");
+    size_t pos = body.find(field);
+    if (pos == string::npos) {
+        return false;
+    }
+
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    if (sscanf(body.c_str() + pos + field.size(), "%4d-%2d-%2dT%2d:%2d:%2d",
+               &t.tm_year, &t.tm_mon, &t.tm_mday, &t.tm_hour, &t.tm_min, &t.tm_sec) != 6) {
+        return false;
+    }
+    t.tm_year -= 1900;
+    t.tm_mon -= 1;
+
+    next_update = timegm(&t);
+    return next_update != (time_t)-1;
+}
+
+/**
+* This method calculates when a PCCS response expires. The response is cached for at most the configured
+* expiration time. A "Cache-Control: max-age" header or a "nextUpdate" field in the body may shorten it,
+* and "Cache-Control: no-store/no-cache" disables caching of the response.
+*
+* @param header Response header
+* @param body Response body
+* @param now Current time
+*
+* @return Expiration time of the response, or 0 if the response must not be cached
+*/
+static time_t get_expiry_time(const string& header, const string& body, time_t now)
+{
+    time_t expiry = now + static_cast<time_t>(g_cache_expire_hours) * 3600;
+
+    // HTTP headers are case-insensitive. Convert to lower case for convenience.
+    string header_lc(header);
+    transform(header_lc.begin(), header_lc.end(), header_lc.begin(),
+              [](unsigned char c){return (unsigned char)::tolower(c);});
+
+    size_t pos = header_lc.find("\ncache-control:");
+    if (pos != string::npos) {
+        size_t end = header_lc.find_first_of("\r\n", pos + 1);
+        string cache_control = header_lc.substr(pos, end == string::npos ? string::npos : end - pos);
+        if (cache_control.find("no-store") != string::npos || cache_control.find("no-cache") != string::npos) {
+            return 0;
+        }
+        size_t max_age = cache_control.find("max-age=");
+        if (max_age != string::npos) {
+            long seconds = strtol(cache_control.c_str() + max_age + strlen("max-age="), NULL, 10);
+            if (seconds <= 0) {
+                return 0;
+            }
+            expiry = min(expiry, now + static_cast<time_t>(seconds));
+        }
+    }
+
+    time_t next_update = 0;
+    if (get_next_update(body, next_update)) {
+        if (next_update <= now) {
+            return 0;
+        }
+        expiry = min(expiry, next_update);
+    }
+
+    return expiry;
+}
+
+static bool read_cache_file(const string& url, qcnl_cache_entry_t& entry)
+{
+    ifstream ifs(url_to_file_name(url), ios::in | ios::binary);
+    if (!ifs.is_open()) {
+        return false;
+    }
+
+    qcnl_cache_file_header_t file_header;
+    if (!ifs.read(reinterpret_cast<char*>(&file_header), sizeof(file_header))) {
+        return false;
+    }
+    if (file_header.magic != QCNL_CACHE_FILE_MAGIC || file_header.version != QCNL_CACHE_FILE_VERSION ||
+        file_header.url_size != url.size() || file_header.header_size > QCNL_CACHE_MAX_ITEM_SIZE ||
+        file_header.body_size > QCNL_CACHE_MAX_ITEM_SIZE) {
+        return false;
+    }
+
+    // The URL is stored in the file to detect hash collisions
+    string file_url(file_header.url_size, '\0');
+    entry.header.assign(file_header.header_size, '\0');
+    entry.body.assign(file_header.body_size, '\0');
+    if (!ifs.read(&file_url[0], file_url.size()) ||
+        !ifs.read(&entry.header[0], entry.header.size()) ||
+        !ifs.read(&entry.body[0], entry.body.size())) {
+        return false;
+    }
+    if (file_url != url) {
+        return false;
+    }
+    entry.expiry = static_cast<time_t>(file_header.expiry);
+
+    return true;
+}
+
+static void write_cache_file(const string& url, const qcnl_cache_entry_t& entry)
+{
+    string file_name = url_to_file_name(url);
+    string tmp_file_name = file_name + ".tmp";
+
+    qcnl_cache_file_header_t file_header;
+    file_header.magic = QCNL_CACHE_FILE_MAGIC;
+    file_header.version = QCNL_CACHE_FILE_VERSION;
+    file_header.expiry = static_cast<int64_t>(entry.expiry);
+    file_header.url_size = static_cast<uint32_t>(url.size());
+    file_header.header_size = static_cast<uint32_t>(entry.header.size());
+    file_header.body_size = static_cast<uint32_t>(entry.body.size());
+
+    {
+        ofstream ofs(tmp_file_name, ios::out | ios::binary | ios::trunc);
+        if (!ofs.is_open()) {
+            return;
+        }
+        ofs.write(reinterpret_cast<const char*>(&file_header), sizeof(file_header));
+        ofs.write(url.data(), url.size());
+        ofs.write(entry.header.data(), entry.header.size());
+        ofs.write(entry.body.data(), entry.body.size());
+        if (!ofs) {
+            ofs.close();
+            remove(tmp_file_name.c_str());
+            return;
+        }
+    }
+
+    // Replace the old file in one step so that concurrent readers never see a partial file
+    remove(file_name.c_str());
+    if (rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+        remove(tmp_file_name.c_str());
+    }
+}
+
+static bool copy_to_buffer(const string& src, char **dst, uint32_t& dst_size)
+{
+    *dst = NULL;
+    dst_size = 0;
+    if (src.empty()) {
+        return true;
+    }
+    *dst = (char*)malloc(src.size());
+    if (*dst == NULL) {
+        return false;
+    }
+    if (memcpy_s(*dst, src.size(), src.data(), src.size()) != 0) {
+        free(*dst);
+        *dst = NULL;
+        return false;
+    }
+    dst_size = static_cast<uint32_t>(src.size());
+    return true;
+}
+
+/**
+* This method looks up a PCCS response in the cache. The in-process cache is checked first, then the on-disk cache
+* if it is configured. The output buffers are allocated with malloc and must be freed by the caller, the same way as
+* the buffers returned by qcnl_https_get.
+*
+* @param url Request URL
+* @param resp_msg Output buffer of response body
+* @param resp_size Size of response body
+* @param resp_header Output buffer of response header
+* @param header_size Size of response header
+*
+* @return true if an unexpired response was found in the cache
+*/
+bool qcnl_cache_get(const string& url,
+                    char **resp_msg,
+                    uint32_t& resp_size,
+                    char **resp_header,
+                    uint32_t& header_size)
+{
+    if (g_cache_expire_hours == 0) {
+        return false;
+    }
+
+    time_t now = time(NULL);
+    lock_guard<mutex> lock(g_cache_mutex);
+
+    map<string, qcnl_cache_entry_t>::iterator it = g_cache_map.find(url);
+    if (it != g_cache_map.end() && it->second.expiry <= now) {
+        g_cache_map.erase(it);
+        it = g_cache_map.end();
+    }
+    if (it == g_cache_map.end()) {
+        if (g_cache_dir[0] == '\0') {
+            return false;
+        }
+        qcnl_cache_entry_t entry;
+        if (!read_cache_file(url, entry) || entry.expiry <= now) {
+            return false;
+        }
+        it = g_cache_map.insert(make_pair(url, entry)).first;
+    }
+
+    if (!copy_to_buffer(it->second.body, resp_msg, resp_size)) {
+        return false;
+    }
+    if (!copy_to_buffer(it->second.header, resp_header, header_size)) {
+        free(*resp_msg);
+        *resp_msg = NULL;
+        resp_size = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+* This method stores a successfully processed PCCS response in the cache
+*
+* @param url Request URL
+* @param resp_msg Response body
+* @param resp_size Size of response body
+* @param resp_header Response header
+* @param header_size Size of response header
+*/
+void qcnl_cache_put(const string& url,
+                    const char *resp_msg,
+                    uint32_t resp_size,
+                    const char *resp_header,
+                    uint32_t header_size)
+{
+    if (g_cache_expire_hours == 0) {
+        return;
+    }
+    if (resp_size > QCNL_CACHE_MAX_ITEM_SIZE || header_size > QCNL_CACHE_MAX_ITEM_SIZE) {
+        return;
+    }
+
+    qcnl_cache_entry_t entry;
+    if (resp_msg) {
+        entry.body.assign(resp_msg, resp_size);
+    }
+    if (resp_header) {
+        entry.header.assign(resp_header, header_size);
+    }
+
+    time_t now = time(NULL);
+    entry.expiry = get_expiry_time(entry.header, entry.body, now);
+    if (entry.expiry <= now) {
+        return;
+    }
+
+    lock_guard<mutex> lock(g_cache_mutex);
+
+    // Drop expired entries so that the cache doesn't grow with stale collateral
+    for (map<string, qcnl_cache_entry_t>::iterator it = g_cache_map.begin(); it != g_cache_map.end(); ) {
+        if (it->second.expiry <= now) {
+            it = g_cache_map.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (g_cache_dir[0] != '\0') {
+        write_cache_file(url, entry);
+    }
+    g_cache_map[url] = entry;
+}
+
@@ -46,6 +46,7 @@
 #include "sgx_default_qcnl_wrapper.h"
 #include "sgx_pce.h"
 #include "network_wrapper.h"
+#include "qcnl_cache.h"
 #include "se_memcpy.h"
 
 using namespace std;
@@ -475,9 +476,13 @@ sgx_qcnl_error_t sgx_qcnl_get_pck_crl_chain(const char* ca,
     char* resp_header = NULL;
     uint32_t header_size = 0;
 
-    sgx_qcnl_error_t ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
-    if (ret != SGX_QCNL_SUCCESS) {
-        return ret;
+    sgx_qcnl_error_t ret = SGX_QCNL_SUCCESS;
+    bool from_cache = qcnl_cache_get(url, &resp_msg, resp_size, &resp_header, header_size);
+    if (!from_cache) {
+        ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
+        if (ret != SGX_QCNL_SUCCESS) {
+            return ret;
+        }
     }
 
     do {
@@ -519,6 +524,9 @@ sgx_qcnl_error_t sgx_qcnl_get_pck_crl_chain(const char* ca,
         ret = SGX_QCNL_SUCCESS;
     } while(0);
 
+    if (ret == SGX_QCNL_SUCCESS && !from_cache) {
+        qcnl_cache_put(url, resp_msg, resp_size, resp_header, header_size);
+    }
     if (ret != SGX_QCNL_SUCCESS) {
         sgx_qcnl_free_pck_crl_chain(*p_crl_chain);
     }
@@ -584,9 +592,12 @@ sgx_qcnl_error_t sgx_qcnl_get_tcbinfo(const char* fmspc,
     char* resp_header = NULL;
     uint32_t header_size = 0;
 
-    ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
-    if (ret != SGX_QCNL_SUCCESS) {
-        return ret;
+    bool from_cache = qcnl_cache_get(url, &resp_msg, resp_size, &resp_header, header_size);
+    if (!from_cache) {
+        ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
+        if (ret != SGX_QCNL_SUCCESS) {
+            return ret;
+        }
     }
 
     do {
@@ -628,6 +639,9 @@ sgx_qcnl_error_t sgx_qcnl_get_tcbinfo(const char* fmspc,
         ret = SGX_QCNL_SUCCESS;
     } while(0);
 
+    if (ret == SGX_QCNL_SUCCESS && !from_cache) {
+        qcnl_cache_put(url, resp_msg, resp_size, resp_header, header_size);
+    }
     if (ret != SGX_QCNL_SUCCESS) {
         sgx_qcnl_free_tcbinfo(*p_tcbinfo);
     }
@@ -683,9 +697,13 @@ sgx_qcnl_error_t sgx_qcnl_get_qe_identity(uint8_t qe_type,
     char* resp_header = NULL;
     uint32_t header_size = 0;
 
-    sgx_qcnl_error_t ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
-    if (ret != SGX_QCNL_SUCCESS) {
-        return ret;
+    sgx_qcnl_error_t ret = SGX_QCNL_SUCCESS;
+    bool from_cache = qcnl_cache_get(url, &resp_msg, resp_size, &resp_header, header_size);
+    if (!from_cache) {
+        ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
+        if (ret != SGX_QCNL_SUCCESS) {
+            return ret;
+        }
     }
 
     do {
@@ -727,6 +745,9 @@ sgx_qcnl_error_t sgx_qcnl_get_qe_identity(uint8_t qe_type,
         ret = SGX_QCNL_SUCCESS;
     } while(0);
 
+    if (ret == SGX_QCNL_SUCCESS && !from_cache) {
+        qcnl_cache_put(url, resp_msg, resp_size, resp_header, header_size);
+    }
     if (ret != SGX_QCNL_SUCCESS) {
         sgx_qcnl_free_qe_identity(*p_qe_identity);
     }
@@ -788,9 +809,13 @@ sgx_qcnl_error_t sgx_qcnl_get_qve_identity(char **pp_qve_identity,
     char* resp_header = NULL;
     uint32_t header_size = 0;
 
-    sgx_qcnl_error_t ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
-    if (ret != SGX_QCNL_SUCCESS) {
-        return ret;
+    sgx_qcnl_error_t ret = SGX_QCNL_SUCCESS;
+    bool from_cache = qcnl_cache_get(url, &resp_msg, resp_size, &resp_header, header_size);
+    if (!from_cache) {
+        ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
+        if (ret != SGX_QCNL_SUCCESS) {
+            return ret;
+        }
     }
 
     do {
@@ -846,6 +871,9 @@ sgx_qcnl_error_t sgx_qcnl_get_qve_identity(char **pp_qve_identity,
         ret = SGX_QCNL_SUCCESS;
     } while(0);
 
+    if (ret == SGX_QCNL_SUCCESS && !from_cache) {
+        qcnl_cache_put(url, resp_msg, resp_size, resp_header, header_size);
+    }
     if (ret != SGX_QCNL_SUCCESS) {
         sgx_qcnl_free_qve_identity(*pp_qve_identity, *pp_qve_identity_issuer_chain);
     }
@@ -903,9 +931,13 @@ sgx_qcnl_error_t sgx_qcnl_get_root_ca_crl (uint8_t **p_root_ca_crl, uint16_t *p_
     char* resp_header = NULL;
     uint32_t header_size = 0;
 
-    sgx_qcnl_error_t ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
-    if (ret != SGX_QCNL_SUCCESS) {
-        return ret;
+    sgx_qcnl_error_t ret = SGX_QCNL_SUCCESS;
+    bool from_cache = qcnl_cache_get(url, &resp_msg, resp_size, &resp_header, header_size);
+    if (!from_cache) {
+        ret = qcnl_https_get(url.c_str(), &resp_msg, resp_size, &resp_header, header_size);
+        if (ret != SGX_QCNL_SUCCESS) {
+            return ret;
+        }
     }
 
     do {
@@ -930,6 +962,9 @@ sgx_qcnl_error_t sgx_qcnl_get_root_ca_crl (uint8_t **p_root_ca_crl, uint16_t *p_
         ret = SGX_QCNL_SUCCESS;
     } while(0);
 
+    if (ret == SGX_QCNL_SUCCESS && !from_cache) {
+        qcnl_cache_put(url, resp_msg, resp_size, resp_header, header_size);
+    }
     if (ret != SGX_QCNL_SUCCESS) {
         sgx_qcnl_free_root_ca_crl(*p_root_ca_crl);
     }
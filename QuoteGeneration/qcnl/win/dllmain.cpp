@@ -2,16 +2,24 @@
 #include <Windows.h>
 #include <tchar.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #define MAX_URL_LENGTH  2083
+#define MAX_PATH_LENGTH 260
 #define REG_KEY_SGX_QCNL                _T("SOFTWARE\\Intel\\SGX\\QCNL")
 #define REG_VALUE_QCNL_PCCS_URL         _T("PCCS_URL")
 #define REG_VALUE_QCNL_USE_SECURE_CERT  _T("USE_SECURE_CERT")
+#define REG_VALUE_QCNL_CACHE_EXPIRE_HOURS _T("COLLATERAL_CACHE_EXPIRE_HOURS")
+#define REG_VALUE_QCNL_CACHE_DIR        _T("COLLATERAL_CACHE_DIR")
 
 // Default URL for PCCS server if registry key doesn't exist
 char server_url[MAX_URL_LENGTH] = "https://localhost:8081/sgx/certification/v3/";
 // Use secure HTTPS certificate or not
 bool g_use_secure_cert = true;
+// Expiration time of cached verification collateral in hours, 0 disables the cache
+uint32_t g_cache_expire_hours = 24;
+// Directory of the on-disk collateral cache, empty string disables the on-disk cache
+char g_cache_dir[MAX_PATH_LENGTH] = "";
 bool g_isWin81OrLater = true;
 
 bool isWin81OrLater();
@@ -67,6 +75,25 @@ BOOL APIENTRY DllMain( HMODULE hModule,
         g_use_secure_cert = (dwSecureCert != 0);
     }
 
+    count = sizeof(DWORD);
+    DWORD dwCacheExpireHours = 0;
+    status = RegQueryValueEx(key, REG_VALUE_QCNL_CACHE_EXPIRE_HOURS, NULL, &type, (LPBYTE)&dwCacheExpireHours, &count);
+    if (ERROR_SUCCESS == status && type == REG_DWORD) {
+        g_cache_expire_hours = (uint32_t)dwCacheExpireHours;
+    }
+
+    TCHAR cache_dir[MAX_PATH_LENGTH] = { 0 };
+    count = MAX_PATH_LENGTH * sizeof(TCHAR);
+    status = RegQueryValueEx(key, REG_VALUE_QCNL_CACHE_DIR, NULL, &type, (LPBYTE)cache_dir, &count);
+    if (ERROR_SUCCESS == status && type == REG_SZ) {
+        size_t input_len = _tcsnlen(cache_dir, MAX_PATH_LENGTH);
+        size_t output_len = 0;
+
+        if (wcstombs_s(&output_len, g_cache_dir, MAX_PATH_LENGTH, cache_dir, input_len) != 0) {
+            g_cache_dir[0] = '\0';
+        }
+    }
+
     RegCloseKey(key);
 
     return TRUE;
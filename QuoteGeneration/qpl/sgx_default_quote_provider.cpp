@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <future>
 #include "se_memcpy.h"
 #include "sgx_default_quote_provider.h"
 #include "sgx_default_qcnl_wrapper.h"
@@ -183,8 +184,22 @@ quote3_error_t sgx_ql_get_quote_verification_collateral(const uint8_t *fmspc, ui
             (*pp_quote_collateral)->version = api_version;
         }
 
+        // Issue the four PCCS requests concurrently and join on all of them, so a cold fetch costs about one
+        // round trip instead of four. If a thread can't be created, the request runs on this thread when joined.
+        uint16_t pck_ca_size = (uint16_t)strnlen(pck_ca, USHRT_MAX);
+        future<sgx_qcnl_error_t> pck_crl_chain_ret = async(launch::async | launch::deferred, sgx_qcnl_get_pck_crl_chain,
+            pck_ca, pck_ca_size, &p_pck_crl_chain, &pck_crl_chain_size);
+        future<sgx_qcnl_error_t> qe_identity_ret = async(launch::async | launch::deferred, sgx_qcnl_get_qe_identity,
+            (uint8_t)0, &p_qe_identity, &qe_identity_size);
+        future<sgx_qcnl_error_t> root_ca_crl_ret = async(launch::async | launch::deferred, sgx_qcnl_get_root_ca_crl,
+            &p_root_ca_crl, &root_ca_crl_size);
+        sgx_qcnl_error_t tcbinfo_ret = sgx_qcnl_get_tcbinfo(reinterpret_cast<const char*>(fmspc), fmspc_size, &p_tcbinfo, &tcbinfo_size);
+        sgx_qcnl_error_t pck_crl_ret = pck_crl_chain_ret.get();
+        sgx_qcnl_error_t qe_id_ret = qe_identity_ret.get();
+        sgx_qcnl_error_t root_crl_ret = root_ca_crl_ret.get();
+
         // Set PCK CRL and certchain
-        qcnl_ret = sgx_qcnl_get_pck_crl_chain(pck_ca, (uint16_t)strnlen(pck_ca, USHRT_MAX), &p_pck_crl_chain, &pck_crl_chain_size);
+        qcnl_ret = pck_crl_ret;
         if (qcnl_ret != SGX_QCNL_SUCCESS) {
             ret = qcnl_error_to_ql_error(qcnl_ret);
             break;
@@ -197,7 +212,7 @@ quote3_error_t sgx_ql_get_quote_verification_collateral(const uint8_t *fmspc, ui
         }
 
         // Set TCBInfo and certchain
-        qcnl_ret = sgx_qcnl_get_tcbinfo(reinterpret_cast<const char*>(fmspc), fmspc_size, &p_tcbinfo, &tcbinfo_size);
+        qcnl_ret = tcbinfo_ret;
         if (qcnl_ret != SGX_QCNL_SUCCESS) {
             ret = qcnl_error_to_ql_error(qcnl_ret);
             break;
@@ -210,7 +225,7 @@ quote3_error_t sgx_ql_get_quote_verification_collateral(const uint8_t *fmspc, ui
         }
 
         // Set QEIdentity and certchain
-        qcnl_ret = sgx_qcnl_get_qe_identity(0, &p_qe_identity, &qe_identity_size);
+        qcnl_ret = qe_id_ret;
         if (qcnl_ret != SGX_QCNL_SUCCESS) {
             ret = qcnl_error_to_ql_error(qcnl_ret);
             break;
@@ -223,7 +238,7 @@ quote3_error_t sgx_ql_get_quote_verification_collateral(const uint8_t *fmspc, ui
         }
 
         // Set Root CA CRL
-        qcnl_ret = sgx_qcnl_get_root_ca_crl(&p_root_ca_crl, &root_ca_crl_size);
+        qcnl_ret = root_crl_ret;
         if (qcnl_ret != SGX_QCNL_SUCCESS) {
             ret = qcnl_error_to_ql_error(qcnl_ret);
             break;
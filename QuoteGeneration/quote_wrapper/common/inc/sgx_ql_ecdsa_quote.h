@@ -65,6 +65,12 @@ public:
                                      sgx_quote3_t *p_quote,
                                      uint32_t quote_size);
 
+    virtual quote3_error_t get_quotes(const sgx_report_t *p_app_reports,
+                                      uint32_t report_count,
+                                      sgx_ql_att_key_id_t* p_att_key_id,
+                                      uint8_t *p_quotes,
+                                      uint32_t quote_size);
+
 private:
     quote3_error_t ecdsa_set_enclave_load_policy(sgx_ql_request_policy_t policy);
 
@@ -80,6 +86,12 @@ private:
                                    sgx_ql_qe_report_info_t *p_qe_report_info,
                                    sgx_quote3_t *p_quote,
                                    uint32_t quote_size);
+
+    quote3_error_t ecdsa_get_quotes(const sgx_report_t *p_app_reports,
+                                    uint32_t report_count,
+                                    sgx_ql_qe_report_info_t *p_qe_report_info,
+                                    uint8_t *p_quotes,
+                                    uint32_t quote_size);
 };
 #endif  //_SGX_QL_ECDSA_QUOTE_H_
 
@@ -104,6 +104,12 @@ public:
                                      sgx_ql_qe_report_info_t *p_qe_report_info,
                                      sgx_quote3_t *p_quote,
                                      uint32_t quote_size) = 0;
+
+    virtual quote3_error_t get_quotes(const sgx_report_t *p_app_reports,
+                                      uint32_t report_count,
+                                      sgx_ql_att_key_id_t* p_att_key_id,
+                                      uint8_t *p_quotes,
+                                      uint32_t quote_size) = 0;
 };
 #endif //#ifdef __cplusplus
 #endif //_SGX_QL_QUOTE_H_
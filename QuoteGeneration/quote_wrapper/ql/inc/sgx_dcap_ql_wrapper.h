@@ -56,8 +56,17 @@ quote3_error_t sgx_qe_get_quote(const sgx_report_t *p_app_report,
                                 uint32_t quote_size,
                                 uint8_t *p_quote);
 
+quote3_error_t sgx_qe_get_quotes(const sgx_report_t *p_app_reports,
+                                 uint32_t report_count,
+                                 uint32_t quote_size,
+                                 uint8_t *p_quotes);
+
 quote3_error_t sgx_qe_cleanup_by_policy();
 
+quote3_error_t sgx_ql_reload_qpl();
+
+quote3_error_t sgx_ql_get_qpl_load_count(uint32_t *p_load_count);
+
 #ifndef _MSC_VER
 typedef enum
 {
@@ -66,6 +75,23 @@ typedef enum
     SGX_QL_QPL_PATH
 } sgx_ql_path_type_t;
 quote3_error_t sgx_ql_set_path(sgx_ql_path_type_t path_type, const char *p_path);
+
+typedef uint64_t sgx_ql_quote_ticket_t;
+
+typedef struct _sgx_ql_quote_completion_t
+{
+    sgx_ql_quote_ticket_t ticket;           ///< Ticket returned by sgx_qe_submit_quote().
+    quote3_error_t status;                  ///< Result of generating the quote.  Same errors as sgx_qe_get_quote().
+} sgx_ql_quote_completion_t;
+
+quote3_error_t sgx_qe_submit_quote(const sgx_report_t *p_app_report,
+                                   uint32_t quote_size,
+                                   uint8_t *p_quote,
+                                   sgx_ql_quote_ticket_t *p_ticket);
+quote3_error_t sgx_qe_get_completion_fd(int *p_fd);
+quote3_error_t sgx_qe_poll_completions(sgx_ql_quote_completion_t *p_completions,
+                                       uint32_t max_count,
+                                       uint32_t *p_count);
 #endif
 
 #if defined(__cplusplus)
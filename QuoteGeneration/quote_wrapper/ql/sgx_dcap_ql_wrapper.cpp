@@ -571,6 +571,61 @@ extern "C" quote3_error_t sgx_qe_get_quote(const sgx_report_t *p_app_report,
     return(quote_ret);
 }
 
+/**
+ * This API is a thin wrapper around the core sgx_ql_get_quotes() API and is used to return the quotes for a batch of
+ * application enclave REPORTs.
+ *
+ * The result is the same as calling sgx_qe_get_quote() for each REPORT, but the attestation key is verified, the
+ * certification data is retrieved and the QE is entered once for the whole batch.  The batch is all-or-nothing: if any
+ * REPORT fails, the error is returned and the contents of p_quotes are undefined.
+ *
+ * @param p_app_reports Array of report_count application enclave REPORTs that need quotes.  The reports need to be
+ *                      generated using the QE's target info returned by the sgx_qe_get_target_info() API.  Must not
+ *                      be NULL.
+ * @param report_count Number of REPORTs in p_app_reports.  Must not be 0.
+ * @param quote_size Size of each quote slot in p_quotes (in bytes).  It must be at least the size returned by
+ *                   sgx_qe_get_quote_size().
+ * @param p_quotes Pointer to a buffer of report_count * quote_size bytes.  The quote for p_app_reports[i] is returned
+ *                 at p_quotes + i * quote_size.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS Successfully generated all of the quotes.
+ * @return SGX_QL_ERROR_INVALID_PARAMETER If either p_app_reports or p_quotes is null, report_count is 0 or quote_size
+ *         isn't large enough.
+ * @return SGX_QL_INVALID_REPORT One of the REPORTs failed verification.
+ * @return SGX_QL_UNSUPPORTED_MODE This function is called in out-of-process mode.
+ * @return Same errors as sgx_qe_get_quote().
+ *
+ */
+extern "C" quote3_error_t sgx_qe_get_quotes(const sgx_report_t *p_app_reports,
+                                            uint32_t report_count,
+                                            uint32_t quote_size,
+                                            uint8_t *p_quotes)
+{
+    quote3_error_t quote_ret = SGX_QL_UNSUPPORTED_MODE;
+
+    // Verify Inputs
+    if((NULL == p_app_reports) ||
+       (NULL == p_quotes) ||
+       (0 == report_count))
+    {
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
+
+    if(false == g_out_of_proc)
+    {
+        quote_ret = sgx_ql_get_quotes(p_app_reports,
+                                      report_count,
+                                      NULL,
+                                      p_quotes,
+                                      quote_size);
+        if (SGX_QL_SUCCESS != quote_ret) {
+            SE_TRACE(SE_TRACE_ERROR, "Error in sgx_ql_get_quotes. 0x%04x\n", quote_ret);
+        }
+    }
+
+    return(quote_ret);
+}
+
 /**
  * This API is primarily a hint for SGX lib that it can release a QE it had cached for efficiency: In the mainline case,
  * sgx_get_qe_targetinfo, sgx_get_quote_size and sgx_get_quote would be called in succession. If SGX lib keeps QE
@@ -591,6 +646,47 @@ quote3_error_t sgx_qe_cleanup_by_policy()
     return(SGX_QL_SUCCESS);
 }
 
+/**
+ * The Quote Provider Library is loaded on first use and stays loaded until the Quoting Library is unloaded.  This API
+ * reloads it, e.g. after the provider library has been updated on disk.  If a quote request is using the provider
+ * library, the reload happens once that request is done with it.
+ *
+ * @return SGX_QL_SUCCESS Successfully reloaded the provider library or scheduled the reload.
+ * @return SGX_QL_PLATFORM_LIB_UNAVAILABLE The provider library couldn't be loaded.
+ * @return SGX_QL_UNSUPPORTED_MODE This function is called in out-of-process mode.
+ * @return SGX_QL_ERROR_UNEXPECTED Unexpected internal error.
+ */
+extern "C" quote3_error_t sgx_ql_reload_qpl()
+{
+    quote3_error_t quote_ret = SGX_QL_UNSUPPORTED_MODE;
+
+    if(false == g_out_of_proc)
+        quote_ret = sgx_reload_qpl();
+
+    return(quote_ret);
+}
+
+/**
+ * Returns the number of times the Quote Provider Library has been loaded by this process.  Each explicit or path
+ * triggered reload increments it, so it can be used to check that the provider library isn't reloaded per quote.
+ *
+ * @param p_load_count Returned load count.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS Successfully returned the load count.
+ * @return SGX_QL_ERROR_INVALID_PARAMETER p_load_count is NULL.
+ * @return SGX_QL_UNSUPPORTED_MODE This function is called in out-of-process mode.
+ * @return SGX_QL_ERROR_UNEXPECTED Unexpected internal error.
+ */
+extern "C" quote3_error_t sgx_ql_get_qpl_load_count(uint32_t *p_load_count)
+{
+    quote3_error_t quote_ret = SGX_QL_UNSUPPORTED_MODE;
+
+    if(false == g_out_of_proc)
+        quote_ret = sgx_get_qpl_load_count(p_load_count);
+
+    return(quote_ret);
+}
+
 #ifndef _MSC_VER
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -648,5 +744,319 @@ quote3_error_t sgx_ql_set_path(sgx_ql_path_type_t path_type, const char *p_path)
     }
     return(ret);
 }
-#endif
 
+#include <sys/eventfd.h>
+
+// Quote generation in the QE3 is serialized on its single TCS and the ECDSA blob lock, so additional workers would
+// only wait on that lock.  The pool exists so a slow certification data fetch doesn't block the caller.
+#define QL_ASYNC_WORKER_COUNT 1
+
+typedef struct _ql_async_request_t {
+    sgx_ql_quote_ticket_t ticket;
+    sgx_report_t app_report;
+    uint32_t quote_size;
+    uint8_t *p_quote;
+    quote3_error_t status;
+    struct _ql_async_request_t *p_next;
+} ql_async_request_t;
+
+/** Queue of submitted requests serviced by the worker pool and queue of completed requests returned to the caller by
+ *  sgx_qe_poll_completions().  Completions are signalled on an eventfd so event-loop callers can poll on it. */
+typedef struct _ql_async_data_t {
+    se_mutex_t mutex;
+    se_cond_t cond;
+    bool started;
+    bool stopping;
+    int event_fd;
+    pthread_t workers[QL_ASYNC_WORKER_COUNT];
+    uint32_t worker_count;
+    sgx_ql_quote_ticket_t next_ticket;
+    ql_async_request_t *p_pending_head;
+    ql_async_request_t *p_pending_tail;
+    ql_async_request_t *p_completed_head;
+    ql_async_request_t *p_completed_tail;
+} ql_async_data_t;
+
+static ql_async_data_t g_async_data;
+
+static void __attribute__((constructor)) _sgx_dcap_ql_async_init()
+{
+    memset(&g_async_data, 0, sizeof(g_async_data));
+    se_mutex_init(&g_async_data.mutex);
+    se_thread_cond_init(&g_async_data.cond);
+    g_async_data.event_fd = -1;
+    g_async_data.next_ticket = 1;
+}
+
+static void free_async_requests(ql_async_request_t *p_request)
+{
+    while(NULL != p_request) {
+        ql_async_request_t *p_next = p_request->p_next;
+        free(p_request);
+        p_request = p_next;
+    }
+}
+
+static void __attribute__((destructor)) _sgx_dcap_ql_async_fini(void)
+{
+    se_mutex_lock(&g_async_data.mutex);
+    g_async_data.stopping = true;
+    se_thread_cond_broadcast(&g_async_data.cond);
+    se_mutex_unlock(&g_async_data.mutex);
+
+    // A worker finishes the quote it is generating before it exits.  Requests that were never started are dropped.
+    for(uint32_t i = 0; i < g_async_data.worker_count; i++) {
+        pthread_join(g_async_data.workers[i], NULL);
+    }
+    free_async_requests(g_async_data.p_pending_head);
+    free_async_requests(g_async_data.p_completed_head);
+    if(-1 != g_async_data.event_fd) {
+        close(g_async_data.event_fd);
+    }
+    se_thread_cond_destroy(&g_async_data.cond);
+    se_mutex_destroy(&g_async_data.mutex);
+}
+
+static void *async_quote_worker(void *p_arg)
+{
+    (void)p_arg;
+    uint64_t signal = 1;
+
+    se_mutex_lock(&g_async_data.mutex);
+    while(true) {
+        while(!g_async_data.stopping && NULL == g_async_data.p_pending_head) {
+            se_thread_cond_wait(&g_async_data.cond, &g_async_data.mutex);
+        }
+        if(g_async_data.stopping) {
+            break;
+        }
+        ql_async_request_t *p_request = g_async_data.p_pending_head;
+        g_async_data.p_pending_head = p_request->p_next;
+        if(NULL == g_async_data.p_pending_head) {
+            g_async_data.p_pending_tail = NULL;
+        }
+        p_request->p_next = NULL;
+        se_mutex_unlock(&g_async_data.mutex);
+
+        p_request->status = sgx_qe_get_quote(&p_request->app_report,
+                                             p_request->quote_size,
+                                             p_request->p_quote);
+
+        se_mutex_lock(&g_async_data.mutex);
+        if(NULL == g_async_data.p_completed_tail) {
+            g_async_data.p_completed_head = p_request;
+        }
+        else {
+            g_async_data.p_completed_tail->p_next = p_request;
+        }
+        g_async_data.p_completed_tail = p_request;
+        if(sizeof(signal) != write(g_async_data.event_fd, &signal, sizeof(signal))) {
+            SE_TRACE(SE_TRACE_ERROR, "Failed to signal the quote completion eventfd.\n");
+        }
+    }
+    se_mutex_unlock(&g_async_data.mutex);
+
+    return NULL;
+}
+
+/**
+ * Creates the completion eventfd and starts the worker pool on first use.  Must be called with the async mutex held.
+ *
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_ERROR_UNEXPECTED The eventfd or no worker thread could be created.
+ */
+static quote3_error_t start_async_workers()
+{
+    if(g_async_data.started) {
+        return(SGX_QL_SUCCESS);
+    }
+    if(g_async_data.stopping) {
+        return(SGX_QL_ERROR_UNEXPECTED);
+    }
+    if(-1 == g_async_data.event_fd) {
+        g_async_data.event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(-1 == g_async_data.event_fd) {
+            SE_TRACE(SE_TRACE_ERROR, "Failed to create the quote completion eventfd.\n");
+            return(SGX_QL_ERROR_UNEXPECTED);
+        }
+    }
+    while(g_async_data.worker_count < QL_ASYNC_WORKER_COUNT) {
+        if(0 != pthread_create(&g_async_data.workers[g_async_data.worker_count], NULL, async_quote_worker, NULL)) {
+            SE_TRACE(SE_TRACE_ERROR, "Failed to create quote worker thread.\n");
+            break;
+        }
+        g_async_data.worker_count++;
+    }
+    if(0 == g_async_data.worker_count) {
+        return(SGX_QL_ERROR_UNEXPECTED);
+    }
+    g_async_data.started = true;
+
+    return(SGX_QL_SUCCESS);
+}
+
+/**
+ * Asynchronous version of sgx_qe_get_quote().  The application enclave's REPORT is copied and queued for the Quoting
+ * Library's worker pool, and the call returns a ticket without waiting for the quote.  When the quote has been
+ * generated, its ticket and status are returned by sgx_qe_poll_completions() and the completion fd returned by
+ * sgx_qe_get_completion_fd() becomes readable.
+ *
+ * @param p_app_report Pointer to the application enclave's REPORT that needs the quote.  Must not be NULL.
+ * @param quote_size Size of the buffer pointed to by p_quote (in bytes).
+ * @param p_quote Pointer to the buffer that will contain the generated quote.  It must stay valid until the ticket's
+ *                completion is returned.  Must not be NULL.
+ * @param p_ticket Returned ticket that identifies the request's completion.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS The request was queued.
+ * @return SGX_QL_ERROR_INVALID_PARAMETER One of the pointers is NULL or quote_size is 0.
+ * @return SGX_QL_ERROR_OUT_OF_MEMORY Unable to allocate the request.
+ * @return SGX_QL_ERROR_UNEXPECTED The worker pool couldn't be started.
+ */
+quote3_error_t sgx_qe_submit_quote(const sgx_report_t *p_app_report,
+                                   uint32_t quote_size,
+                                   uint8_t *p_quote,
+                                   sgx_ql_quote_ticket_t *p_ticket)
+{
+    quote3_error_t ret = SGX_QL_SUCCESS;
+    ql_async_request_t *p_request = NULL;
+
+    if((NULL == p_app_report) ||
+       (NULL == p_quote) ||
+       (NULL == p_ticket) ||
+       (0 == quote_size))
+    {
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
+
+    p_request = (ql_async_request_t *)malloc(sizeof(*p_request));
+    if(NULL == p_request) {
+        return(SGX_QL_ERROR_OUT_OF_MEMORY);
+    }
+    memset(p_request, 0, sizeof(*p_request));
+    memcpy(&p_request->app_report, p_app_report, sizeof(p_request->app_report));
+    p_request->quote_size = quote_size;
+    p_request->p_quote = p_quote;
+    p_request->status = SGX_QL_ERROR_UNEXPECTED;
+
+    if(0 == se_mutex_lock(&g_async_data.mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        free(p_request);
+        return(SGX_QL_ERROR_UNEXPECTED);
+    }
+    ret = start_async_workers();
+    if(SGX_QL_SUCCESS == ret) {
+        p_request->ticket = g_async_data.next_ticket++;
+        if(NULL == g_async_data.p_pending_tail) {
+            g_async_data.p_pending_head = p_request;
+        }
+        else {
+            g_async_data.p_pending_tail->p_next = p_request;
+        }
+        g_async_data.p_pending_tail = p_request;
+        *p_ticket = p_request->ticket;
+        se_thread_cond_signal(&g_async_data.cond);
+    }
+    se_mutex_unlock(&g_async_data.mutex);
+
+    if(SGX_QL_SUCCESS != ret) {
+        free(p_request);
+    }
+
+    return(ret);
+}
+
+/**
+ * Returns the file descriptor that becomes readable when completed requests are waiting to be returned by
+ * sgx_qe_poll_completions().  It is an eventfd owned by the Quoting Library and the caller must not read, write or
+ * close it.  It is intended to be added to the caller's poll/epoll set.
+ *
+ * @param p_fd Returned file descriptor.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_ERROR_INVALID_PARAMETER p_fd is NULL.
+ * @return SGX_QL_ERROR_UNEXPECTED The worker pool couldn't be started.
+ */
+quote3_error_t sgx_qe_get_completion_fd(int *p_fd)
+{
+    quote3_error_t ret = SGX_QL_SUCCESS;
+
+    if(NULL == p_fd) {
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
+
+    if(0 == se_mutex_lock(&g_async_data.mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return(SGX_QL_ERROR_UNEXPECTED);
+    }
+    ret = start_async_workers();
+    if(SGX_QL_SUCCESS == ret) {
+        *p_fd = g_async_data.event_fd;
+    }
+    se_mutex_unlock(&g_async_data.mutex);
+
+    return(ret);
+}
+
+/**
+ * Returns completed requests in the order they completed without blocking.  Once a ticket's completion is returned,
+ * its quote buffer is no longer used by the library.
+ *
+ * @param p_completions Array that will contain the completions.  Must not be NULL.
+ * @param max_count Number of entries in p_completions.  Must not be 0.
+ * @param p_count Returned number of completions written to p_completions.  0 if none are waiting.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_ERROR_INVALID_PARAMETER One of the pointers is NULL or max_count is 0.
+ * @return SGX_QL_ERROR_UNEXPECTED Unexpected internal error.
+ */
+quote3_error_t sgx_qe_poll_completions(sgx_ql_quote_completion_t *p_completions,
+                                       uint32_t max_count,
+                                       uint32_t *p_count)
+{
+    uint64_t signal = 0;
+    uint32_t count = 0;
+    ql_async_request_t *p_done = NULL;
+
+    if((NULL == p_completions) ||
+       (NULL == p_count) ||
+       (0 == max_count))
+    {
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
+    *p_count = 0;
+
+    if(0 == se_mutex_lock(&g_async_data.mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return(SGX_QL_ERROR_UNEXPECTED);
+    }
+    // Reset the eventfd before draining the queue.  It is set again below if completions are left in the queue.
+    if(-1 != g_async_data.event_fd) {
+        if(sizeof(signal) != read(g_async_data.event_fd, &signal, sizeof(signal))) {
+            // EAGAIN, nothing was signalled.
+            signal = 0;
+        }
+    }
+    while((count < max_count) && (NULL != g_async_data.p_completed_head)) {
+        p_done = g_async_data.p_completed_head;
+        g_async_data.p_completed_head = p_done->p_next;
+        p_completions[count].ticket = p_done->ticket;
+        p_completions[count].status = p_done->status;
+        count++;
+        free(p_done);
+    }
+    if(NULL == g_async_data.p_completed_head) {
+        g_async_data.p_completed_tail = NULL;
+    }
+    else {
+        signal = 1;
+        if(sizeof(signal) != write(g_async_data.event_fd, &signal, sizeof(signal))) {
+            SE_TRACE(SE_TRACE_ERROR, "Failed to signal the quote completion eventfd.\n");
+        }
+    }
+    se_mutex_unlock(&g_async_data.mutex);
+
+    *p_count = count;
+
+    return(SGX_QL_SUCCESS);
+}
+#endif
@@ -164,6 +164,27 @@ static const char QE_ATT_STRING[] = "QE_ATT_DER";
 
 #define MAX_CERT_DATA_SIZE (4098*3)
 #define MIN_CERT_DATA_SIZE (500)
+// Largest quote the QE3 generates: PCE certification data is the largest certification data it accepts.
+#define MAX_QUOTE_SIZE (sizeof(sgx_quote3_t) + sizeof(sgx_ql_ecdsa_sig_data_t) + sizeof(sgx_ql_auth_data_t) + \
+                        REF_ECDSDA_AUTHENTICATION_DATA_SIZE + sizeof(sgx_ql_certification_data_t) + MAX_CERT_DATA_SIZE)
+
+// The QE_ID only depends on the platform's MRSIGNER based seal key at TCB 0, so it is derived once per enclave load.
+static bool g_qe_id_cached = false;
+static sgx_key_128bit_t g_qe_id = { 0 };
+
+// The last ECDSA blob that passed verify_blob_internal() and its unsealed contents.  The entry is bound to the exact
+// sealed blob and to the TCB (CPUSVN and QE3 ISVSVN) it was verified at, so a new or resealed blob, or a TCB change,
+// goes through the full unseal again.  The QE3 has a single TCS, so the ECALLs don't race on it.
+typedef struct _ecdsa_blob_cache_t {
+    bool valid;
+    uint8_t sealed_blob[SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK];
+    sgx_cpu_svn_t cpu_svn;
+    sgx_isv_svn_t isv_svn;
+    ref_plaintext_ecdsa_data_sdk_t plaintext;
+} ecdsa_blob_cache_t;
+static ecdsa_blob_cache_t g_ecdsa_blob_cache;
+// securely align the cached attestation key
+static sgx::custom_alignment_aligned<ref_ciphertext_ecdsa_data_sdk_t, 32, __builtin_offsetof(ref_ciphertext_ecdsa_data_sdk_t, ecdsa_private_key), sizeof(((ref_ciphertext_ecdsa_data_sdk_t*)0)->ecdsa_private_key)> g_ecdsa_blob_cache_secret;
 
 #ifdef ENABLE_QE3_LOGGING
 /*
@@ -438,6 +459,11 @@ static qe3_error_t get_qe_id_internal(sgx_key_128bit_t *p_qe_id)
         return REFQE3_ERROR_INVALID_PARAMETER;
     }
 
+    if (g_qe_id_cached) {
+        memcpy(p_qe_id, &g_qe_id, sizeof(*p_qe_id));
+        return REFQE3_SUCCESS;
+    }
+
     memset(&key_tmp, 0, sizeof(key_tmp));
 
     // Set up the key request structure for Seal Key with both CPUSVN and ISVSVN set to 0 and KeyID set to 0
@@ -476,6 +502,8 @@ static qe3_error_t get_qe_id_internal(sgx_key_128bit_t *p_qe_id)
         }
     }
     else {
+        memcpy(&g_qe_id, p_qe_id, sizeof(g_qe_id));
+        g_qe_id_cached = true;
         ret = REFQE3_SUCCESS;
     }
 
@@ -484,11 +512,21 @@ ret_point:
     return ret;
 }
 
+/**
+ * Drop the cached ECDSA blob and clear the attestation key it holds.
+ */
+static void clear_ecdsa_blob_cache()
+{
+    memset_s(&g_ecdsa_blob_cache_secret.v, sizeof(g_ecdsa_blob_cache_secret.v), 0, sizeof(g_ecdsa_blob_cache_secret.v));
+    memset(&g_ecdsa_blob_cache, 0, sizeof(g_ecdsa_blob_cache));
+}
+
 /**
  * An internal function used to verify the ECDSA Blob.  It will verify the format of the blob and check the
  * authenticity using the seal key.  If the TCB of the platform has increased since the last time the blob was sealed,
  * it will be resealed to the new TCB and the p_is_resealed will be set to TRUE.  It will also optionally return the pub
- * key id and the encrypted data from the seal data if requested by the caller.
+ * key id and the encrypted data from the seal data if requested by the caller.  The contents of the last verified blob
+ * are cached, so verifying the same blob again at the same TCB doesn't unseal it.
  *
  * @param p_blob    Pointer to the inputted ECDSA sealed blob to
  *                  be checked and unsealed.
@@ -564,6 +602,33 @@ static qe3_error_t verify_blob_internal(uint8_t *p_blob,
     memset(plocal_secret_ecdsa_data, 0, sizeof(*plocal_secret_ecdsa_data));
     memset(p_plaintext_ecdsa_data, 0, sizeof(*p_plaintext_ecdsa_data));
 
+    /* Create report to get current cpu_svn and isv_svn. */
+    memset(&report, 0, sizeof(report));
+    sgx_status = sgx_create_report(NULL, NULL, &report);
+    if (SGX_SUCCESS != sgx_status) {
+        if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
+            ret = REFQE3_ERROR_OUT_OF_MEMORY;
+        }
+        else {
+            ret = REFQE3_ERROR_UNEXPECTED;
+        }
+        goto ret_point;
+    }
+
+    if (NULL != p_report_body) {
+        memcpy(p_report_body, &report.body, sizeof(*p_report_body));
+    }
+
+    if (g_ecdsa_blob_cache.valid &&
+        (0 == memcmp(g_ecdsa_blob_cache.sealed_blob, p_blob, blob_size)) &&
+        (0 == memcmp(&g_ecdsa_blob_cache.cpu_svn, &report.body.cpu_svn, sizeof(report.body.cpu_svn))) &&
+        (g_ecdsa_blob_cache.isv_svn == report.body.isv_svn)) {
+        // Same blob at the same TCB.  It was sealed to this TCB, so there is nothing to reseal either.
+        memcpy(p_plaintext_ecdsa_data, &g_ecdsa_blob_cache.plaintext, sizeof(*p_plaintext_ecdsa_data));
+        memcpy(plocal_secret_ecdsa_data, &g_ecdsa_blob_cache_secret.v, sizeof(*plocal_secret_ecdsa_data));
+        goto copy_out;
+    }
+
     sgx_status = sgx_unseal_data(p_ecdsa_blob,
         (uint8_t *)p_plaintext_ecdsa_data,
         &plaintext_length,
@@ -586,23 +651,6 @@ static qe3_error_t verify_blob_internal(uint8_t *p_blob,
         goto ret_point;
     }
 
-    /* Create report to get current cpu_svn and isv_svn. */
-    memset(&report, 0, sizeof(report));
-    sgx_status = sgx_create_report(NULL, NULL, &report);
-    if (SGX_SUCCESS != sgx_status) {
-        if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
-            ret = REFQE3_ERROR_OUT_OF_MEMORY;
-        }
-        else {
-            ret = REFQE3_ERROR_UNEXPECTED;
-        }
-        goto ret_point;
-    }
-
-    if (NULL != p_report_body) {
-        memcpy(p_report_body, &report.body, sizeof(*p_report_body));
-    }
-
     // Update the Key Blob using the SEAL Key for the current TCB if the TCB is
     // upgraded after the Key Blob is generated. Here memcmp cpu_svn might be
     // different even though they're actually the same, but for defense in depth we
@@ -629,6 +677,16 @@ static qe3_error_t verify_blob_internal(uint8_t *p_blob,
         resealed = TRUE;
     }
 
+    // Cache the blob as it is now sealed to the current TCB.
+    clear_ecdsa_blob_cache();
+    memcpy(g_ecdsa_blob_cache.sealed_blob, p_blob, blob_size);
+    memcpy(&g_ecdsa_blob_cache.cpu_svn, &report.body.cpu_svn, sizeof(g_ecdsa_blob_cache.cpu_svn));
+    g_ecdsa_blob_cache.isv_svn = report.body.isv_svn;
+    memcpy(&g_ecdsa_blob_cache.plaintext, p_plaintext_ecdsa_data, sizeof(g_ecdsa_blob_cache.plaintext));
+    memcpy(&g_ecdsa_blob_cache_secret.v, plocal_secret_ecdsa_data, sizeof(g_ecdsa_blob_cache_secret.v));
+    g_ecdsa_blob_cache.valid = true;
+
+copy_out:
     if (NULL != p_pub_key_id) {
         memcpy(p_pub_key_id, &p_plaintext_ecdsa_data->ecdsa_id, sizeof(p_plaintext_ecdsa_data->ecdsa_id));
     }
@@ -1064,6 +1122,9 @@ uint32_t gen_att_key(uint8_t *p_blob,
         }
     }
 
+    // A new attestation key replaces the current one, don't keep the old one around.
+    clear_ecdsa_blob_cache();
+
     memset(&plaintext_data, 0, sizeof(plaintext_data));
 
     if (UINT16_MAX < authentication_data_size) {
@@ -1449,192 +1510,51 @@ ret_point:
 }
 
 /**
- * External function exposed through the EDL used to generate a quote.  It will take the REPORT (targeting this enclave)
- * of the application enclave requesting a quote.  It also takes the ECDSA blob that contains the private attestation
- * key and the PCE certification data.  The other inputs are the data required to fill out the quote structure. The
- * application enclave's report will verified and signed with the ECDSA attestation private key and will return the
- * resulting quote in the provided buffer. The caller can also optionally request that this enclave generate a report
- * targeting the requesting enclave along with a nonce.  If requested, the resulting QE report will be returned with
- * the QE_Report.ReportData equal to the nonce. This allows the requesting enclave to verify the Quote was generated by
- * a valid QE.
+ * Fills out and signs the quote for an application enclave REPORT that the caller has already verified.  Shared by
+ * gen_quote() and gen_quotes() so that a batch can reuse the unsealed attestation key and the ECC context.
+ *
+ * @param p_enclave_report [In] The verified application enclave's report.  Must reside in the enclave's memory space.
+ * @param p_plaintext [In] Plaintext portion of the verified ECDSA blob.
+ * @param pciphertext [In] Decrypted secret portion of the verified ECDSA blob, it contains the attestation private key.
+ * @param qe_isv_svn [In] This enclave's ISVSVN to put in the quote header.
+ * @param pce_isvsvn [In] The ISVSVN of the PCE currently installed on the platform.
+ * @param p_certification_data [In] The optional cert_data, it can be NULL.  Must have been checked by the caller.
+ * @param ecc_handle [In] Open ECC256 context used to sign the quote.
+ * @param p_quote_buf [Out] Pointer to the output buffer for quote.  Must reside in the enclave's memory space.
+ * @param quote_size [In] The size of buffer pointed to by p_quote_buf, in bytes.
+ * @param p_quote_out_size [Out] The number of bytes of p_quote_buf used by the quote.
  *
- * @param p_blob     [In, Out] Pointer to the ECDSA Blob. Must not be NULL and the full buffer must be inside the
- *                   enclave's memory space.  If the blob was resealed, upon return, the p_blob will point to the
- *                   resealed blob and the caller should save it.[in, out] Pointer to the ECDSA Blob.
- * @param blob_size  [In] Size in bytes of the ECDSA blob buffer pointed to by p_blob.
- * @param p_enclave_report
- *                   [In] The application enclave's report.  It must be generated targeting this enclave.
- * @param p_nonce    [In] Optional pointer to a nonce.  This nonce will be used when the caller requests this enclave to
- *                   generate a report.  The resulting report's report_data field will contain the SHA256(nonce||quote).
- *                   If the p_nonce is NULL, then the p_qe_report must be NULL.  IF the p_nonce is not NULL, then the
- *                   p_qe_report must not be NULL.  If provided, the buffer must reside in the enclave's memory space.
- * @param p_qe_report
- *                   [In, Out] Optional pointer to this enclave's report targeting the requesting enclave. The resulting
- *                   report's report_data field will contain the SHA256(nonce||quote).  If the p_nonce is NULL, then the
- *                   p_qe_report must be NULL.  IF the p_nonce is not NULL, then the p_qe_report must not be NULL. If
- *                   provided, the buffer must reside in the enclave's memory space.
- * @param p_quote  [out] Pointer to the output buffer for quote.
- * @param quote_size [in] The size of buffer pointed to by p_quote, in bytes.  It must be at least the value returned by
-                     the ref_get_quote_size() API.
- * @param pce_isvsvn [In] The ISVSVN of the PCE currently installed on the platform.  This value will be placed in the
- *                   quote header to allow the quote verifier to know whether the PCE has been properly upgraded in case
- *                   of a TCB recover.  The verifier can then request that the attestation key to be re-certified.
- * @param p_certification_data [In] The optional cert_data, it can be NULL.
- * @param cert_data_size [in] The size of buffer pointed to by p_certification_data, in bytes.  If p_certification_data is NULL, it should
-                     be 0.
-
  * @return REFQE3_SUCCESS
  * @return REFQE3_ERROR_INVALID_PARAMETER
- * @return REFQE3_ECDSABLOB_ERROR
  * @return REFQE3_ERROR_UNEXPECTED
- * @return REFQE3_ERROR_INVALID_REPORT
  * @return REFQE3_ERROR_OUT_OF_MEMORY
+ * @return Errors from get_qe_id_internal()
  */
-uint32_t gen_quote(uint8_t *p_blob,
-    uint32_t blob_size,
-    const sgx_report_t *p_enclave_report,
-    const sgx_quote_nonce_t *p_nonce,
-    const sgx_target_info_t *p_app_enclave_target_info,
-    sgx_report_t *p_qe_report_out,
+static qe3_error_t build_quote(const sgx_report_t *p_enclave_report,
+    const ref_plaintext_ecdsa_data_sdk_t *p_plaintext,
+    const ref_ciphertext_ecdsa_data_sdk_t *pciphertext,
+    sgx_isv_svn_t qe_isv_svn,
+    sgx_isv_svn_t pce_isvsvn,
+    const uint8_t *p_certification_data,
+    sgx_ecc_state_handle_t ecc_handle,
     uint8_t *p_quote_buf,
     uint32_t quote_size,
-    sgx_isv_svn_t pce_isvsvn,
-    const uint8_t * p_certification_data,
-    uint32_t cert_data_size)
+    uint32_t *p_quote_out_size)
 {
     qe3_error_t ret = REFQE3_SUCCESS;
     sgx_quote3_t* p_quote;
     sgx_ql_ecdsa_sig_data_t *p_quote_sig;
-    uint8_t is_resealed = 0;
     uint32_t sign_size = 0;
     sgx_status_t sgx_status = SGX_SUCCESS;
-    sgx_report_t qe_report;
     size_t required_buffer_size = 0;
-    ref_plaintext_ecdsa_data_sdk_t plaintext;
-    //
-    // provide extra protection for attestation key by
-    // randomizing its address and securely aligning it
-    //
-    using cciphertext = randomly_placed_object<
-        sgx::custom_alignment_aligned<
-        ref_ciphertext_ecdsa_data_sdk_t,
-        alignof(ref_ciphertext_ecdsa_data_sdk_t),
-        __builtin_offsetof(ref_ciphertext_ecdsa_data_sdk_t, ecdsa_private_key),
-        sizeof(((ref_ciphertext_ecdsa_data_sdk_t*)0)->ecdsa_private_key)>>;
-    //
-    // instance of randomly_placed_object
-    //
-    cciphertext ociphertext_buf;
-    //
-    // pointer to instance of custom_alignment_aligned
-    //
-    auto* ociphertext = ociphertext_buf.instantiate_object();
-    ref_ciphertext_ecdsa_data_sdk_t* pciphertext = &ociphertext->v;
-
-    sgx_ecc_state_handle_t handle = NULL;
     sgx_ql_auth_data_t *p_auth_data;
     sgx_ql_certification_data_t *p_certification_data_output;
 #ifdef ALLOW_CLEARTEXT_PPID
     sgx_ql_ppid_cleartext_cert_info_t *p_cert_cleartext_ppid_info_data;
 #endif
     sgx_ql_ppid_rsa3072_encrypted_cert_info_t *p_cert_encrypted_ppid_info_data;
-    sgx_sha_state_handle_t sha_quote_context = NULL;
-    sgx_report_data_t qe_report_data;
     sgx_key_128bit_t qe_id = { 0 };
 
-    memset(&plaintext, 0, sizeof(plaintext));
-
-    // Actually, some cases here will be checked with code generated by
-    // edger8r. Here we just want to defend in depth.
-    if ((NULL == p_blob) ||
-        (NULL == p_enclave_report) ||
-        (NULL == p_quote_buf) ||
-        (!quote_size)) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-    if (SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK != blob_size) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-    if (!(NULL == p_nonce) && (NULL == p_app_enclave_target_info) && (NULL == p_qe_report_out)) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-    if (!(NULL != p_nonce) && (NULL != p_app_enclave_target_info) && (NULL != p_qe_report_out)) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-    if (NULL != p_certification_data)
-    {
-        sgx_ql_certification_data_t * p_input_certification_data_header = (sgx_ql_certification_data_t *)p_certification_data;
-        if (PPID_CLEARTEXT > p_input_certification_data_header->cert_key_type
-            || QL_CERT_KEY_TYPE_MAX < p_input_certification_data_header->cert_key_type) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-        if (MAX_CERT_DATA_SIZE < p_input_certification_data_header->size) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-        if (sizeof(sgx_ql_certification_data_t) + p_input_certification_data_header->size != cert_data_size) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-    }
-    if (NULL == p_certification_data && cert_data_size !=0) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-
-
-    // The ECDSA Quote is not so large that it needs to be outside the enclave.  Verify the full buffer is within
-    // the EPC.  To reduce the ECDSA QE, it can be moved outside the epc.
-    if (!sgx_is_within_enclave(p_quote_buf, quote_size)) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-
-    /* Check whether p_blob is copied into EPC. If we want to reduce the
-       memory usage, maybe we can leave the p_blob outside EPC. */
-    if (!sgx_is_within_enclave(p_blob, blob_size)) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-    if (!sgx_is_within_enclave(p_enclave_report, sizeof(*p_enclave_report))) {
-        return(REFQE3_ERROR_INVALID_PARAMETER);
-    }
-
-    if (NULL != p_certification_data) {
-        if (!sgx_is_within_enclave(p_certification_data, cert_data_size)) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-    }
-
-    // If the code reaches here, if p_nonce is NULL, then p_qe_report will be
-    // NULL also. So we only check p_nonce here.
-    if (p_nonce) {
-        // Actually Edger8r will alloc the buffer within EPC, this is just kind
-        // of defense in depth.
-        if (!sgx_is_within_enclave(p_nonce, sizeof(*p_nonce))) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-        if (!sgx_is_within_enclave(p_qe_report_out, sizeof(*p_qe_report_out))) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-        if (!sgx_is_within_enclave(p_app_enclave_target_info, sizeof(*p_app_enclave_target_info))) {
-            return(REFQE3_ERROR_INVALID_PARAMETER);
-        }
-    }
-
-    // Verify the input report.
-    if (SGX_SUCCESS != sgx_verify_report(p_enclave_report)) {
-        return(REFQE3_ERROR_INVALID_REPORT);
-    }
-
-    // Verify EPID p_blob and create the context
-    ret = random_stack_advance(verify_blob_internal,p_blob,
-        blob_size,
-        &is_resealed,
-        &plaintext,
-        (sgx_report_body_t*) NULL,
-        (uint8_t*) NULL,
-        0,
-        pciphertext);
-    if (REFQE3_SUCCESS != ret) {
-        goto ret_point;
-    }
-
     sign_size = sizeof(sgx_ql_ecdsa_sig_data_t) +           // ECDSA sig data structure
         sizeof(sgx_ql_auth_data_t) +
         sizeof(sgx_ql_certification_data_t);
@@ -1650,18 +1570,16 @@ uint32_t gen_quote(uint8_t *p_blob,
         }
     }
     /* Check for overflow before adding in the variable size of authentication data. */
-    if ((UINT32_MAX - sign_size - sizeof(sgx_quote3_t)) < plaintext.authentication_data_size) {
-        ret = REFQE3_ERROR_INVALID_PARAMETER;
-        goto ret_point;
+    if ((UINT32_MAX - sign_size - sizeof(sgx_quote3_t)) < p_plaintext->authentication_data_size) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
     }
-    sign_size += plaintext.authentication_data_size;     // Authentication data
+    sign_size += p_plaintext->authentication_data_size;     // Authentication data
 
     required_buffer_size = sizeof(sgx_quote3_t) + sign_size;
 
     // Make sure the buffer size is big enough.
     if (quote_size < required_buffer_size) {
-        ret = REFQE3_ERROR_INVALID_PARAMETER;
-        goto ret_point;
+        return(REFQE3_ERROR_INVALID_PARAMETER);
     }
 
     // Verify sizeof header.userdata is large enough
@@ -1675,7 +1593,7 @@ uint32_t gen_quote(uint8_t *p_blob,
     p_quote->signature_data_len = sign_size;
     p_quote_sig = (sgx_ql_ecdsa_sig_data_t*)(p_quote->signature_data);
     p_auth_data = (sgx_ql_auth_data_t*)(p_quote_sig->auth_certification_data);
-    p_auth_data->size = (uint16_t)plaintext.authentication_data_size;
+    p_auth_data->size = (uint16_t)p_plaintext->authentication_data_size;
     //Note:  This is potentially dangerous pointer math using an untrusted input size.  The 'required_buffer_size' check
     //above verifies that the size will not put the calculated address and certification data outside of the inputted
     //p_quote + quote_size memory.
@@ -1690,7 +1608,7 @@ uint32_t gen_quote(uint8_t *p_blob,
     ///todo:  Verify that the QE_ID  matches the value in the blob.
     ret = get_qe_id_internal(&qe_id);
     if (REFQE3_SUCCESS != ret) {
-        goto ret_point;
+        return(ret);
     }
     memcpy(&p_quote->header.user_data, &qe_id, sizeof(qe_id));
     // Copy in Intel's Vender ID
@@ -1698,44 +1616,22 @@ uint32_t gen_quote(uint8_t *p_blob,
     //  Copy the incoming report into Quote body.
     memcpy(&p_quote->report_body, &(p_enclave_report->body), sizeof(p_quote->report_body));
 
-    memset(&qe_report_data, 0, sizeof(qe_report_data));
-    sgx_status = sgx_create_report(NULL, &qe_report_data, &qe_report);
-    if (SGX_SUCCESS != sgx_status) {
-        if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
-            ret = REFQE3_ERROR_OUT_OF_MEMORY;
-        }
-        else {
-            ret = REFQE3_ERROR_UNEXPECTED;
-        }
-        goto ret_point;
-    }
     // Copy QE's security version in to Quote header.
-    p_quote->header.qe_svn = qe_report.body.isv_svn;
+    p_quote->header.qe_svn = qe_isv_svn;
 
     // Generate the quote signature.
-    sgx_status = sgx_ecc256_open_context(&handle);
-    if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
-        ret = REFQE3_ERROR_OUT_OF_MEMORY;
-        goto ret_point;
-    }
-    else if (SGX_SUCCESS != sgx_status) {
-        ret = (qe3_error_t)sgx_status;
-        goto ret_point;
-    }
     // Sign everything in the quote except the signature_data_len.  This allows the quote certification information to change
     // to contain the actual PCK cert after initially only carring the PPID+PCEID+TCB without making the quote invalid.
     sgx_status = sgx_ecdsa_sign(reinterpret_cast<const uint8_t *>(p_quote),
         sizeof(*p_quote) - sizeof(p_quote->signature_data_len),
         &pciphertext->ecdsa_private_key,
         reinterpret_cast<sgx_ec256_signature_t *>(p_quote_sig->sig),
-        handle);
+        ecc_handle);
     if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
-        ret = REFQE3_ERROR_OUT_OF_MEMORY;
-        goto ret_point;
+        return(REFQE3_ERROR_OUT_OF_MEMORY);
     }
     else if (SGX_SUCCESS != sgx_status) {
-        ret = REFQE3_ERROR_UNEXPECTED;
-        goto ret_point;
+        return(REFQE3_ERROR_UNEXPECTED);
     }
     // Swap signature x and y from little endian used in sgx_crypto to big endian used in quote byte order
     {
@@ -1753,17 +1649,17 @@ uint32_t gen_quote(uint8_t *p_blob,
         }
     }
     // Add the public part of the ECDSA key to the quote sig data.  Store it in Big Endian
-    memcpy(p_quote_sig->attest_pub_key, &plaintext.ecdsa_att_public_key, sizeof(p_quote_sig->attest_pub_key));
+    memcpy(p_quote_sig->attest_pub_key, &p_plaintext->ecdsa_att_public_key, sizeof(p_quote_sig->attest_pub_key));
 
     // Add the QE Report to the Quote sig data (the qe report when it was signed by the PCE!).
-    memcpy(&p_quote_sig->qe3_report, &plaintext.qe3_report.body, sizeof(p_quote_sig->qe3_report));
+    memcpy(&p_quote_sig->qe3_report, &p_plaintext->qe3_report.body, sizeof(p_quote_sig->qe3_report));
 
     // Add the PCE signature
-    memcpy(p_quote_sig->qe3_report_sig, &plaintext.qe3_report_cert_key_sig, sizeof(p_quote_sig->qe3_report_sig));
+    memcpy(p_quote_sig->qe3_report_sig, &p_plaintext->qe3_report_cert_key_sig, sizeof(p_quote_sig->qe3_report_sig));
 
     // Copy in the Authentication Data
     if (0 != p_auth_data->size) {
-        memcpy(p_auth_data->auth_data, plaintext.authentication_data, p_auth_data->size);
+        memcpy(p_auth_data->auth_data, p_plaintext->authentication_data, p_auth_data->size);
     }
 
     if (1 == pciphertext->is_clear_ppid) {
@@ -1775,14 +1671,13 @@ uint32_t gen_quote(uint8_t *p_blob,
         // Get the cert_info_data from the ECDSA blob.
         memcpy(p_cert_cleartext_ppid_info_data->ppid, pciphertext->ppid, sizeof(p_cert_cleartext_ppid_info_data->ppid));
 #ifdef USE_PCEID
-        p_cert_cleartext_ppid_info_data->pce_info = plaintext.cert_pce_info;
+        p_cert_cleartext_ppid_info_data->pce_info = p_plaintext->cert_pce_info;
 #else
-        p_cert_cleartext_ppid_info_data->pce_info.pce_isv_svn = plaintext.cert_pce_info.pce_isv_svn;
+        p_cert_cleartext_ppid_info_data->pce_info.pce_isv_svn = p_plaintext->cert_pce_info.pce_isv_svn;
 #endif
-        memcpy(&p_cert_cleartext_ppid_info_data->cpu_svn, &plaintext.cert_cpu_svn, sizeof(p_cert_cleartext_ppid_info_data->cpu_svn));
+        memcpy(&p_cert_cleartext_ppid_info_data->cpu_svn, &p_plaintext->cert_cpu_svn, sizeof(p_cert_cleartext_ppid_info_data->cpu_svn));
 #else
-        ret = REFQE3_ERROR_UNEXPECTED;
-        goto ret_point;
+        return(REFQE3_ERROR_UNEXPECTED);
 #endif
     }
     else {
@@ -1794,11 +1689,11 @@ uint32_t gen_quote(uint8_t *p_blob,
             // Get the cert_info_data from the ECDSA blob.
             memcpy(p_cert_encrypted_ppid_info_data->enc_ppid, pciphertext->encrypted_ppid_data.encrypted_ppid, sizeof(p_cert_encrypted_ppid_info_data->enc_ppid));
 #ifdef USE_PCEID
-            p_cert_encrypted_ppid_info_data->pce_info = plaintext.cert_pce_info;
+            p_cert_encrypted_ppid_info_data->pce_info = p_plaintext->cert_pce_info;
 #else
-            p_cert_encrypted_ppid_info_data->pce_info.pce_isv_svn = plaintext.cert_pce_info.pce_isv_svn;
+            p_cert_encrypted_ppid_info_data->pce_info.pce_isv_svn = p_plaintext->cert_pce_info.pce_isv_svn;
 #endif
-            memcpy(&p_cert_encrypted_ppid_info_data->cpu_svn, &plaintext.cert_cpu_svn, sizeof(p_cert_encrypted_ppid_info_data->cpu_svn));
+            memcpy(&p_cert_encrypted_ppid_info_data->cpu_svn, &p_plaintext->cert_cpu_svn, sizeof(p_cert_encrypted_ppid_info_data->cpu_svn));
         }
         else {
             sgx_ql_certification_data_t * p_input_certification_data_header = (sgx_ql_certification_data_t *)p_certification_data;
@@ -1809,19 +1704,243 @@ uint32_t gen_quote(uint8_t *p_blob,
         }
     }
 
-    // Get the QE's report if requested.
-    ///todo:  It is possible that the untrusted code can change the certification data of the quote (including the
-    //the signature_length.  We may need to modify the quote hash generation to skip the modifiable values!!
-    if (NULL != p_nonce) {
-        ref_static_assert(sizeof(qe_report_data) >= sizeof(sgx_sha256_hash_t));
-
-        sgx_status = sgx_sha256_init(&sha_quote_context);
-        if (SGX_SUCCESS != sgx_status) {
-            ret = REFQE3_ERROR_UNEXPECTED;
-            goto ret_point;
-        }
+    *p_quote_out_size = (uint32_t)required_buffer_size;
+    return(REFQE3_SUCCESS);
+}
 
-        memset(&qe_report_data, 0, sizeof(qe_report_data));
+/**
+ * Checks the optional certification data the untrusted code wants to put in the quote.
+ *
+ * @param p_certification_data [In] The optional cert_data, it can be NULL.
+ * @param cert_data_size [In] The size of buffer pointed to by p_certification_data, in bytes.
+ *
+ * @return REFQE3_SUCCESS
+ * @return REFQE3_ERROR_INVALID_PARAMETER
+ */
+static qe3_error_t check_certification_data(const uint8_t *p_certification_data,
+    uint32_t cert_data_size)
+{
+    if (NULL != p_certification_data)
+    {
+        sgx_ql_certification_data_t * p_input_certification_data_header = (sgx_ql_certification_data_t *)p_certification_data;
+        if (PPID_CLEARTEXT > p_input_certification_data_header->cert_key_type
+            || QL_CERT_KEY_TYPE_MAX < p_input_certification_data_header->cert_key_type) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+        if (MAX_CERT_DATA_SIZE < p_input_certification_data_header->size) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+        if (sizeof(sgx_ql_certification_data_t) + p_input_certification_data_header->size != cert_data_size) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+    }
+    if (NULL == p_certification_data && cert_data_size !=0) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    return(REFQE3_SUCCESS);
+}
+
+/**
+ * External function exposed through the EDL used to generate a quote.  It will take the REPORT (targeting this enclave)
+ * of the application enclave requesting a quote.  It also takes the ECDSA blob that contains the private attestation
+ * key and the PCE certification data.  The other inputs are the data required to fill out the quote structure. The
+ * application enclave's report will verified and signed with the ECDSA attestation private key and will return the
+ * resulting quote in the provided buffer. The caller can also optionally request that this enclave generate a report
+ * targeting the requesting enclave along with a nonce.  If requested, the resulting QE report will be returned with
+ * the QE_Report.ReportData equal to the nonce. This allows the requesting enclave to verify the Quote was generated by
+ * a valid QE.
+ *
+ * @param p_blob     [In, Out] Pointer to the ECDSA Blob. Must not be NULL and the full buffer must be inside the
+ *                   enclave's memory space.  If the blob was resealed, upon return, the p_blob will point to the
+ *                   resealed blob and the caller should save it.[in, out] Pointer to the ECDSA Blob.
+ * @param blob_size  [In] Size in bytes of the ECDSA blob buffer pointed to by p_blob.
+ * @param p_enclave_report
+ *                   [In] The application enclave's report.  It must be generated targeting this enclave.
+ * @param p_nonce    [In] Optional pointer to a nonce.  This nonce will be used when the caller requests this enclave to
+ *                   generate a report.  The resulting report's report_data field will contain the SHA256(nonce||quote).
+ *                   If the p_nonce is NULL, then the p_qe_report must be NULL.  IF the p_nonce is not NULL, then the
+ *                   p_qe_report must not be NULL.  If provided, the buffer must reside in the enclave's memory space.
+ * @param p_qe_report
+ *                   [In, Out] Optional pointer to this enclave's report targeting the requesting enclave. The resulting
+ *                   report's report_data field will contain the SHA256(nonce||quote).  If the p_nonce is NULL, then the
+ *                   p_qe_report must be NULL.  IF the p_nonce is not NULL, then the p_qe_report must not be NULL. If
+ *                   provided, the buffer must reside in the enclave's memory space.
+ * @param p_quote  [out] Pointer to the output buffer for quote.
+ * @param quote_size [in] The size of buffer pointed to by p_quote, in bytes.  It must be at least the value returned by
+                     the ref_get_quote_size() API.
+ * @param pce_isvsvn [In] The ISVSVN of the PCE currently installed on the platform.  This value will be placed in the
+ *                   quote header to allow the quote verifier to know whether the PCE has been properly upgraded in case
+ *                   of a TCB recover.  The verifier can then request that the attestation key to be re-certified.
+ * @param p_certification_data [In] The optional cert_data, it can be NULL.
+ * @param cert_data_size [in] The size of buffer pointed to by p_certification_data, in bytes.  If p_certification_data is NULL, it should
+                     be 0.
+
+ * @return REFQE3_SUCCESS
+ * @return REFQE3_ERROR_INVALID_PARAMETER
+ * @return REFQE3_ECDSABLOB_ERROR
+ * @return REFQE3_ERROR_UNEXPECTED
+ * @return REFQE3_ERROR_INVALID_REPORT
+ * @return REFQE3_ERROR_OUT_OF_MEMORY
+ */
+uint32_t gen_quote(uint8_t *p_blob,
+    uint32_t blob_size,
+    const sgx_report_t *p_enclave_report,
+    const sgx_quote_nonce_t *p_nonce,
+    const sgx_target_info_t *p_app_enclave_target_info,
+    sgx_report_t *p_qe_report_out,
+    uint8_t *p_quote_buf,
+    uint32_t quote_size,
+    sgx_isv_svn_t pce_isvsvn,
+    const uint8_t * p_certification_data,
+    uint32_t cert_data_size)
+{
+    qe3_error_t ret = REFQE3_SUCCESS;
+    uint8_t is_resealed = 0;
+    sgx_status_t sgx_status = SGX_SUCCESS;
+    sgx_report_t qe_report;
+    uint32_t quote_out_size = 0;
+    ref_plaintext_ecdsa_data_sdk_t plaintext;
+    //
+    // provide extra protection for attestation key by
+    // randomizing its address and securely aligning it
+    //
+    using cciphertext = randomly_placed_object<
+        sgx::custom_alignment_aligned<
+        ref_ciphertext_ecdsa_data_sdk_t,
+        alignof(ref_ciphertext_ecdsa_data_sdk_t),
+        __builtin_offsetof(ref_ciphertext_ecdsa_data_sdk_t, ecdsa_private_key),
+        sizeof(((ref_ciphertext_ecdsa_data_sdk_t*)0)->ecdsa_private_key)>>;
+    //
+    // instance of randomly_placed_object
+    //
+    cciphertext ociphertext_buf;
+    //
+    // pointer to instance of custom_alignment_aligned
+    //
+    auto* ociphertext = ociphertext_buf.instantiate_object();
+    ref_ciphertext_ecdsa_data_sdk_t* pciphertext = &ociphertext->v;
+
+    sgx_ecc_state_handle_t handle = NULL;
+    sgx_sha_state_handle_t sha_quote_context = NULL;
+    sgx_report_data_t qe_report_data;
+
+    memset(&plaintext, 0, sizeof(plaintext));
+
+    // Actually, some cases here will be checked with code generated by
+    // edger8r. Here we just want to defend in depth.
+    if ((NULL == p_blob) ||
+        (NULL == p_enclave_report) ||
+        (NULL == p_quote_buf) ||
+        (!quote_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK != blob_size) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (!(NULL == p_nonce) && (NULL == p_app_enclave_target_info) && (NULL == p_qe_report_out)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (!(NULL != p_nonce) && (NULL != p_app_enclave_target_info) && (NULL != p_qe_report_out)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (REFQE3_SUCCESS != check_certification_data(p_certification_data, cert_data_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+
+
+    // The ECDSA Quote is not so large that it needs to be outside the enclave.  Verify the full buffer is within
+    // the EPC.  To reduce the ECDSA QE, it can be moved outside the epc.
+    if (!sgx_is_within_enclave(p_quote_buf, quote_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+
+    /* Check whether p_blob is copied into EPC. If we want to reduce the
+       memory usage, maybe we can leave the p_blob outside EPC. */
+    if (!sgx_is_within_enclave(p_blob, blob_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (!sgx_is_within_enclave(p_enclave_report, sizeof(*p_enclave_report))) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+
+    if (NULL != p_certification_data) {
+        if (!sgx_is_within_enclave(p_certification_data, cert_data_size)) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+    }
+
+    // If the code reaches here, if p_nonce is NULL, then p_qe_report will be
+    // NULL also. So we only check p_nonce here.
+    if (p_nonce) {
+        // Actually Edger8r will alloc the buffer within EPC, this is just kind
+        // of defense in depth.
+        if (!sgx_is_within_enclave(p_nonce, sizeof(*p_nonce))) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+        if (!sgx_is_within_enclave(p_qe_report_out, sizeof(*p_qe_report_out))) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+        if (!sgx_is_within_enclave(p_app_enclave_target_info, sizeof(*p_app_enclave_target_info))) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+    }
+
+    // Verify the input report.
+    if (SGX_SUCCESS != sgx_verify_report(p_enclave_report)) {
+        return(REFQE3_ERROR_INVALID_REPORT);
+    }
+
+    // Verify EPID p_blob and create the context.  This also returns the QE's own REPORT body.
+    memset(&qe_report, 0, sizeof(qe_report));
+    ret = random_stack_advance(verify_blob_internal,p_blob,
+        blob_size,
+        &is_resealed,
+        &plaintext,
+        &qe_report.body,
+        (uint8_t*) NULL,
+        0,
+        pciphertext);
+    if (REFQE3_SUCCESS != ret) {
+        goto ret_point;
+    }
+
+    // Generate the quote signature.
+    sgx_status = sgx_ecc256_open_context(&handle);
+    if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
+        ret = REFQE3_ERROR_OUT_OF_MEMORY;
+        goto ret_point;
+    }
+    else if (SGX_SUCCESS != sgx_status) {
+        ret = (qe3_error_t)sgx_status;
+        goto ret_point;
+    }
+    ret = build_quote(p_enclave_report,
+        &plaintext,
+        pciphertext,
+        qe_report.body.isv_svn,
+        pce_isvsvn,
+        p_certification_data,
+        handle,
+        p_quote_buf,
+        quote_size,
+        &quote_out_size);
+    if (REFQE3_SUCCESS != ret) {
+        goto ret_point;
+    }
+
+    // Get the QE's report if requested.
+    ///todo:  It is possible that the untrusted code can change the certification data of the quote (including the
+    //the signature_length.  We may need to modify the quote hash generation to skip the modifiable values!!
+    if (NULL != p_nonce) {
+        ref_static_assert(sizeof(qe_report_data) >= sizeof(sgx_sha256_hash_t));
+
+        sgx_status = sgx_sha256_init(&sha_quote_context);
+        if (SGX_SUCCESS != sgx_status) {
+            ret = REFQE3_ERROR_UNEXPECTED;
+            goto ret_point;
+        }
+
+        memset(&qe_report_data, 0, sizeof(qe_report_data));
         // Update hash for nonce.
         sgx_status = sgx_sha256_update((uint8_t *)const_cast<sgx_quote_nonce_t *>(p_nonce),
             (uint32_t)sizeof(*p_nonce),
@@ -1832,7 +1951,7 @@ uint32_t gen_quote(uint8_t *p_blob,
         }
         // Update hash with the quote.
         sgx_status = sgx_sha256_update(p_quote_buf,
-            (uint32_t)required_buffer_size,
+            quote_out_size,
             sha_quote_context);
         if (SGX_SUCCESS != sgx_status) {
             ret = REFQE3_ERROR_UNEXPECTED;
@@ -1873,3 +1992,175 @@ ret_point:
     return(ret);
 }
 
+/**
+ * External function exposed through the EDL used to generate quotes for a batch of application enclave REPORTs.  The
+ * ECDSA blob is verified once and the same attestation key, certification data and ECC context are used to sign every
+ * quote.  Otherwise each quote is the same as the one gen_quote() generates for the REPORT without a QE report.
+ *
+ * The REPORTs and quotes stay in untrusted memory so that the batch size isn't limited by the enclave's heap.  Each
+ * REPORT is copied into the enclave before it is verified, and each quote is generated and signed in enclave memory
+ * before it is copied out.
+ *
+ * @param p_blob     [In, Out] Pointer to the ECDSA Blob. Must not be NULL and the full buffer must be inside the
+ *                   enclave's memory space.  If the blob was resealed, upon return, the p_blob will point to the
+ *                   resealed blob and the caller should save it.
+ * @param blob_size  [In] Size in bytes of the ECDSA blob buffer pointed to by p_blob.
+ * @param p_app_reports
+ *                   [In] Array of report_count application enclave reports.  They must be generated targeting this
+ *                   enclave.  The full array must be outside the enclave's memory space.
+ * @param report_count [In] Number of reports in p_app_reports.  Must not be 0.
+ * @param p_quotes   [Out] Buffer of report_count * quote_size bytes.  The quote for p_app_reports[i] is returned at
+ *                   p_quotes + i * quote_size.  The full buffer must be outside the enclave's memory space.
+ * @param quote_size [In] The size of each quote slot in p_quotes, in bytes.  It must be at least the value returned by
+ *                   the ref_get_quote_size() API.
+ * @param pce_isvsvn [In] The ISVSVN of the PCE currently installed on the platform.
+ * @param p_certification_data [In] The optional cert_data, it can be NULL.
+ * @param cert_data_size [In] The size of buffer pointed to by p_certification_data, in bytes.  If p_certification_data
+ *                   is NULL, it should be 0.
+ *
+ * @return REFQE3_SUCCESS All of the quotes were generated.
+ * @return REFQE3_ERROR_INVALID_PARAMETER
+ * @return REFQE3_ECDSABLOB_ERROR
+ * @return REFQE3_ERROR_UNEXPECTED
+ * @return REFQE3_ERROR_INVALID_REPORT One of the reports failed verification.  No quotes after it were generated.
+ * @return REFQE3_ERROR_OUT_OF_MEMORY
+ */
+uint32_t gen_quotes(uint8_t *p_blob,
+    uint32_t blob_size,
+    const sgx_report_t *p_app_reports,
+    uint32_t report_count,
+    uint8_t *p_quotes,
+    uint32_t quote_size,
+    sgx_isv_svn_t pce_isvsvn,
+    const uint8_t * p_certification_data,
+    uint32_t cert_data_size)
+{
+    qe3_error_t ret = REFQE3_SUCCESS;
+    uint8_t is_resealed = 0;
+    sgx_status_t sgx_status = SGX_SUCCESS;
+    sgx_report_body_t qe_report_body;
+    sgx_report_t app_report;
+    uint32_t local_quote_size = 0;
+    uint32_t quote_out_size = 0;
+    uint8_t *p_local_quote = NULL;
+    ref_plaintext_ecdsa_data_sdk_t plaintext;
+    //
+    // provide extra protection for attestation key by
+    // randomizing its address and securely aligning it
+    //
+    using cciphertext = randomly_placed_object<
+        sgx::custom_alignment_aligned<
+        ref_ciphertext_ecdsa_data_sdk_t,
+        alignof(ref_ciphertext_ecdsa_data_sdk_t),
+        __builtin_offsetof(ref_ciphertext_ecdsa_data_sdk_t, ecdsa_private_key),
+        sizeof(((ref_ciphertext_ecdsa_data_sdk_t*)0)->ecdsa_private_key)>>;
+    cciphertext ociphertext_buf;
+    auto* ociphertext = ociphertext_buf.instantiate_object();
+    ref_ciphertext_ecdsa_data_sdk_t* pciphertext = &ociphertext->v;
+
+    sgx_ecc_state_handle_t handle = NULL;
+
+    memset(&plaintext, 0, sizeof(plaintext));
+
+    if ((NULL == p_blob) ||
+        (NULL == p_app_reports) ||
+        (NULL == p_quotes) ||
+        (!report_count) ||
+        (!quote_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK != blob_size) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (REFQE3_SUCCESS != check_certification_data(p_certification_data, cert_data_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (!sgx_is_within_enclave(p_blob, blob_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (NULL != p_certification_data) {
+        if (!sgx_is_within_enclave(p_certification_data, cert_data_size)) {
+            return(REFQE3_ERROR_INVALID_PARAMETER);
+        }
+    }
+    // The batch buffers are [user_check].  Both sizes are products of two uint32_t values, so they fit in 64 bits.
+    if ((SIZE_MAX / sizeof(sgx_report_t) < report_count) ||
+        (SIZE_MAX / quote_size < report_count)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (!sgx_is_outside_enclave(p_app_reports, (size_t)report_count * sizeof(sgx_report_t))) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    if (!sgx_is_outside_enclave(p_quotes, (size_t)report_count * quote_size)) {
+        return(REFQE3_ERROR_INVALID_PARAMETER);
+    }
+    sgx_lfence();
+
+    // Verify EPID p_blob and create the context.  This also returns the QE's own REPORT body.
+    memset(&qe_report_body, 0, sizeof(qe_report_body));
+    ret = random_stack_advance(verify_blob_internal,p_blob,
+        blob_size,
+        &is_resealed,
+        &plaintext,
+        &qe_report_body,
+        (uint8_t*) NULL,
+        0,
+        pciphertext);
+    if (REFQE3_SUCCESS != ret) {
+        goto ret_point;
+    }
+
+    // Each quote is built in enclave memory so the untrusted code can't change it while it is being signed.
+    local_quote_size = quote_size < MAX_QUOTE_SIZE ? quote_size : (uint32_t)MAX_QUOTE_SIZE;
+    p_local_quote = (uint8_t *)malloc(local_quote_size);
+    if (NULL == p_local_quote) {
+        ret = REFQE3_ERROR_OUT_OF_MEMORY;
+        goto ret_point;
+    }
+
+    sgx_status = sgx_ecc256_open_context(&handle);
+    if (SGX_ERROR_OUT_OF_MEMORY == sgx_status) {
+        ret = REFQE3_ERROR_OUT_OF_MEMORY;
+        goto ret_point;
+    }
+    else if (SGX_SUCCESS != sgx_status) {
+        ret = (qe3_error_t)sgx_status;
+        goto ret_point;
+    }
+
+    for (uint32_t i = 0; i < report_count; i++) {
+        memcpy(&app_report, &p_app_reports[i], sizeof(app_report));
+        sgx_lfence();
+        // Verify the input report.
+        if (SGX_SUCCESS != sgx_verify_report(&app_report)) {
+            ret = REFQE3_ERROR_INVALID_REPORT;
+            goto ret_point;
+        }
+        ret = build_quote(&app_report,
+            &plaintext,
+            pciphertext,
+            qe_report_body.isv_svn,
+            pce_isvsvn,
+            p_certification_data,
+            handle,
+            p_local_quote,
+            local_quote_size,
+            &quote_out_size);
+        if (REFQE3_SUCCESS != ret) {
+            goto ret_point;
+        }
+        memcpy(p_quotes + (size_t)i * quote_size, p_local_quote, quote_out_size);
+    }
+
+ret_point:
+    // Clear out any senstive data.
+    memset_s(pciphertext, sizeof(*pciphertext), 0, sizeof(*pciphertext));
+    if (handle != NULL) {
+        sgx_ecc256_close_context(handle);
+    }
+    if (NULL != p_local_quote) {
+        free(p_local_quote);
+    }
+
+    return(ret);
+}
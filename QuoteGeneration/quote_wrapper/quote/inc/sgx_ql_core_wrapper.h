@@ -66,8 +66,16 @@ quote3_error_t sgx_ql_get_quote(const sgx_report_t *p_app_report,
                                 uint8_t *p_quote,
                                 uint32_t quote_size);
 
+quote3_error_t sgx_ql_get_quotes(const sgx_report_t *p_app_reports,
+                                 uint32_t report_count,
+                                 sgx_ql_att_key_id_t *p_att_key_id,
+                                 uint8_t *p_quotes,
+                                 uint32_t quote_size);
+
 quote3_error_t sgx_set_qe3_path(const char *p_path);
 quote3_error_t sgx_set_qpl_path(const char *p_path);
+quote3_error_t sgx_reload_qpl();
+quote3_error_t sgx_get_qpl_load_count(uint32_t *p_load_count);
 quote3_error_t sgx_ql_get_keyid(sgx_att_key_id_ext_t *p_att_key_id_ext);
 #if defined(__cplusplus)
 }
@@ -40,6 +40,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <time.h>
 #ifndef _MSC_VER
     #include <pthread.h>
     #include <dlfcn.h>
@@ -72,7 +73,14 @@
     #define QE3_ENCLAVE_NAME _T("qe3.signed.dll")
     #define SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME "dcap_quoteprov.dll"
 #endif
+#ifndef _MSC_VER
+    typedef void* qpl_handle_t;
+#else
+    typedef HINSTANCE qpl_handle_t;
+#endif
 #define ECDSA_BLOB_LABEL "ecdsa_data.blob"
+// The cached ECDSA blob is read again from persistent storage when it was last read or stored this many seconds ago
+#define ECDSA_BLOB_REVALIDATE_SECONDS 60
 
 
 #define MAX_PATH 260
@@ -157,11 +165,22 @@ static quote3_error_t translate_pce_errors(sgx_pce_error_t pce_error)
  * thread safe updating of the load policy and the storage of
  * target information of the QE  when the policy is
  * persistent mode.  Also contains the global ecdsa_blob and
- * provides thread safe access to he blob.
+ * provides thread safe access to he blob.  Also caches the
+ * PCK Cert data returned by the platform library for the last
+ * platform identity.  Also keeps the Quote Provider Library
+ * loaded with its entry points resolved, so that it is opened
+ * once for the lifetime of the QL instead of on every call.
+ * The ECDSA blob is read from persistent storage once per load
+ * of the platform library and written back in the background.
  */
+static void stop_ecdsa_blob_writer();
+
 struct ql_global_data{
     se_mutex_t m_enclave_load_mutex;
     se_mutex_t m_ecdsa_blob_mutex;
+    se_mutex_t m_pck_cert_mutex;
+    se_mutex_t m_qpl_mutex;
+    se_mutex_t m_blob_writer_mutex;
 
     sgx_ql_request_policy_t m_load_policy;
     sgx_enclave_id_t m_eid;
@@ -173,31 +192,118 @@ struct ql_global_data{
     char qe3_path[MAX_PATH];
     char qpl_path[MAX_PATH];
 
+    // Platform identity of the cached PCK Cert data
+    bool m_pck_cert_cached;
+    sgx_key_128bit_t m_pck_cert_qe3_id;
+    sgx_cpu_svn_t m_pck_cert_platform_cpu_svn;
+    sgx_isv_svn_t m_pck_cert_platform_pce_isv_svn;
+    uint16_t m_pck_cert_pce_id;
+    // Cached PCK Cert data
+    sgx_cpu_svn_t m_pck_cert_cpu_svn;
+    sgx_isv_svn_t m_pck_cert_pce_isv_svn;
+    uint32_t m_pck_cert_data_size;
+    uint8_t *m_pck_cert_data;
+
+    // Resident Quote Provider Library
+    qpl_handle_t m_qpl_handle;
+    qpl_functions_t m_qpl_functions;
+    bool m_qpl_reload_pending;
+    uint32_t m_qpl_users;
+    uint32_t m_qpl_load_count;
+
+    // m_ecdsa_blob is the current blob, read or stored at m_ecdsa_blob_time while the platform library's
+    // m_ecdsa_blob_qpl_load_count load was current
+    bool m_ecdsa_blob_cached;
+    uint32_t m_ecdsa_blob_qpl_load_count;
+    time_t m_ecdsa_blob_time;
+    // Last stored blob and its generation, written to persistent storage by the blob writer
+    uint8_t m_ecdsa_blob_pending[SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK];
+    uint32_t m_ecdsa_blob_generation;
+    uint32_t m_ecdsa_blob_written_generation;
+#ifndef _MSC_VER
+    se_cond_t m_blob_writer_cond;
+    pthread_t m_blob_writer;
+    bool m_blob_writer_started;
+    bool m_blob_writer_stopping;
+#endif
+
     ql_global_data():
         m_load_policy(SGX_QL_DEFAULT),
         m_eid(0),
-        m_pencryptedppid(NULL)
+        m_pencryptedppid(NULL),
+        m_pck_cert_cached(false),
+        m_pck_cert_platform_pce_isv_svn(0),
+        m_pck_cert_pce_id(0),
+        m_pck_cert_pce_isv_svn(0),
+        m_pck_cert_data_size(0),
+        m_pck_cert_data(NULL),
+        m_qpl_handle(NULL),
+        m_qpl_reload_pending(false),
+        m_qpl_users(0),
+        m_qpl_load_count(0),
+        m_ecdsa_blob_cached(false),
+        m_ecdsa_blob_qpl_load_count(0),
+        m_ecdsa_blob_time(0),
+        m_ecdsa_blob_generation(0),
+        m_ecdsa_blob_written_generation(0)
+#ifndef _MSC_VER
+        ,m_blob_writer_started(false),
+        m_blob_writer_stopping(false)
+#endif
     {
         se_mutex_init(&m_enclave_load_mutex);
         se_mutex_init(&m_ecdsa_blob_mutex);
+        se_mutex_init(&m_pck_cert_mutex);
+        se_mutex_init(&m_qpl_mutex);
+        se_mutex_init(&m_blob_writer_mutex);
+#ifndef _MSC_VER
+        se_thread_cond_init(&m_blob_writer_cond);
+#endif
+        memset(m_ecdsa_blob_pending, 0, sizeof(m_ecdsa_blob_pending));
         memset(&m_attributes, 0, sizeof(m_attributes));
         memset(&m_launch_token, 0, sizeof(m_launch_token));
         memset(m_ecdsa_blob, 0, sizeof(m_ecdsa_blob));
         memset(&m_pce_info, 0, sizeof(m_pce_info));
         memset(qe3_path, 0, sizeof(qe3_path));
         memset(qpl_path, 0, sizeof(qpl_path));
+        memset(&m_pck_cert_qe3_id, 0, sizeof(m_pck_cert_qe3_id));
+        memset(&m_pck_cert_platform_cpu_svn, 0, sizeof(m_pck_cert_platform_cpu_svn));
+        memset(&m_pck_cert_cpu_svn, 0, sizeof(m_pck_cert_cpu_svn));
+        memset(&m_qpl_functions, 0, sizeof(m_qpl_functions));
     }
     ql_global_data(const ql_global_data&);
     ql_global_data& operator=(const ql_global_data&);
     ~ql_global_data(){
+        // Flush the last stored blob before the platform library is closed.
+        stop_ecdsa_blob_writer();
         if (m_eid!=0) sgx_destroy_enclave(m_eid);
         se_mutex_destroy(&m_enclave_load_mutex);
         se_mutex_destroy(&m_ecdsa_blob_mutex);
+        se_mutex_destroy(&m_pck_cert_mutex);
+        se_mutex_destroy(&m_qpl_mutex);
+        se_mutex_destroy(&m_blob_writer_mutex);
+#ifndef _MSC_VER
+        se_thread_cond_destroy(&m_blob_writer_cond);
+#endif
+        if (m_qpl_handle)
+        {
+#ifndef _MSC_VER
+            dlclose(m_qpl_handle);
+#else
+            FreeLibrary(m_qpl_handle);
+#endif
+            m_qpl_handle = NULL;
+        }
         if (m_pencryptedppid)
         {
             free(m_pencryptedppid);
             m_pencryptedppid = NULL;
         }
+        if (m_pck_cert_data)
+        {
+            free(m_pck_cert_data);
+            m_pck_cert_data = NULL;
+        }
     }
 };
 
@@ -230,25 +336,75 @@ quote3_error_t sgx_set_qpl_path(const char* p_path)
     // after this line len <= sizeof(g_ql_global_data.qpl_path) - 1
     if(len > sizeof(g_ql_global_data.qpl_path) - 1)
         return SGX_QL_ERROR_INVALID_PARAMETER;
+    // The path is read when the resident library is (re)loaded.
+    if (0 == se_mutex_lock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    if (0 != strncmp(g_ql_global_data.qpl_path, p_path, sizeof(g_ql_global_data.qpl_path))) {
 #ifndef _MSC_VER
-    strncpy(g_ql_global_data.qpl_path, p_path, sizeof(g_ql_global_data.qpl_path) - 1);
+        strncpy(g_ql_global_data.qpl_path, p_path, sizeof(g_ql_global_data.qpl_path) - 1);
 #else
-    strncpy_s(g_ql_global_data.qpl_path, sizeof(g_ql_global_data.qpl_path), p_path, sizeof(g_ql_global_data.qpl_path));
+        strncpy_s(g_ql_global_data.qpl_path, sizeof(g_ql_global_data.qpl_path), p_path, sizeof(g_ql_global_data.qpl_path));
 #endif
-    g_ql_global_data.qpl_path[len] = '\0';
+        g_ql_global_data.qpl_path[len] = '\0';
+        // Swap out a library loaded from the previous path.
+        if (NULL != g_ql_global_data.m_qpl_handle) {
+            g_ql_global_data.m_qpl_reload_pending = true;
+        }
+    }
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
     return SGX_QL_SUCCESS;
 }
 
-#ifndef _MSC_VER
-void * get_qpl_handle()
+/**
+ * Look up an entry point in the Quote Provider Library.
+ *
+ * @param handle Handle of the loaded library.  Must not be NULL.
+ * @param p_name Name of the exported API.  Must not be NULL.
+ *
+ * @return Address of the API or NULL if the library doesn't export it.
+ */
+static void *get_qpl_symbol(qpl_handle_t handle, const char *p_name)
+{
+    void *p_symbol = NULL;
+
+    #ifndef _MSC_VER
+    dlerror();
+    p_symbol = dlsym(handle, p_name);
+    if (NULL != dlerror()) {
+        p_symbol = NULL;
+    }
+    if (NULL == p_symbol) {
+        SE_TRACE(SE_TRACE_WARNING, "Couldn't find '%s()' in the platform library.\n", p_name);
+    }
+    #else
+    p_symbol = (void *)GetProcAddress(handle, p_name);
+    if (NULL == p_symbol) {
+        SE_TRACE(SE_TRACE_WARNING, "Couldn't find '%s()' in the platform library. %d\n", p_name, GetLastError());
+    }
+    #endif
+    return p_symbol;
+}
+
+/**
+ * Load the Quote Provider Library and resolve its entry points.  The caller must hold m_qpl_mutex and no library
+ * may be loaded.
+ *
+ * @return true if the library was loaded.  Entry points it doesn't export are left NULL.
+ */
+static bool load_qpl()
 {
-    void * handle = NULL;
+    qpl_handle_t handle = NULL;
+
+    #ifndef _MSC_VER
     if (g_ql_global_data.qpl_path[0]) {
         handle = dlopen(g_ql_global_data.qpl_path, RTLD_LAZY);
         if (NULL == handle) {
             SE_PROD_LOG("Cannot open Quote Provider Library %s\n", g_ql_global_data.qpl_path);
         }
-        return handle;
     }
     else {
         handle = dlopen(SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME, RTLD_LAZY);
@@ -264,9 +420,101 @@ void * get_qpl_handle()
             }
         }
     }
-    return handle;
+    if (NULL == handle) {
+        SE_PROD_LOG("Couldn't find the platform library. %s\n", dlerror());
+        return false;
+    }
+    #else
+    handle = LoadLibrary(TEXT(SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME));
+    if (NULL == handle) {
+        SE_PROD_LOG("Couldn't find the platform library. %d\n", GetLastError());
+        return false;
+    }
+    SE_TRACE(SE_TRACE_DEBUG, "Found the Quote's dependent library. %s.\n", SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME);
+    #endif
+
+    g_ql_global_data.m_qpl_functions.p_get_quote_config =
+        (sgx_get_quote_config_func_t)get_qpl_symbol(handle, "sgx_ql_get_quote_config");
+    g_ql_global_data.m_qpl_functions.p_free_quote_config =
+        (sgx_free_quote_config_func_t)get_qpl_symbol(handle, "sgx_ql_free_quote_config");
+    g_ql_global_data.m_qpl_functions.p_write_persistent_data =
+        (sgx_write_persistent_data_func_t)get_qpl_symbol(handle, "sgx_ql_write_persistent_data");
+    g_ql_global_data.m_qpl_functions.p_read_persistent_data =
+        (sgx_read_persistent_data_func_t)get_qpl_symbol(handle, "sgx_ql_read_persistent_data");
+    g_ql_global_data.m_qpl_handle = handle;
+    g_ql_global_data.m_qpl_load_count++;
+    SE_TRACE(SE_TRACE_DEBUG, "Loaded the platform library (load count %u).\n", g_ql_global_data.m_qpl_load_count);
+
+    return true;
+}
+
+/**
+ * Unload the Quote Provider Library and forget its entry points.  The caller must hold m_qpl_mutex and no caller may
+ * be using the entry points.
+ */
+static void unload_qpl()
+{
+    if (NULL != g_ql_global_data.m_qpl_handle) {
+        #ifndef _MSC_VER
+        dlclose(g_ql_global_data.m_qpl_handle);
+        #else
+        FreeLibrary(g_ql_global_data.m_qpl_handle);
+        #endif
+        g_ql_global_data.m_qpl_handle = NULL;
+    }
+    memset(&g_ql_global_data.m_qpl_functions, 0, sizeof(g_ql_global_data.m_qpl_functions));
+    g_ql_global_data.m_qpl_reload_pending = false;
+}
+
+/**
+ * Get the entry points of the resident Quote Provider Library, loading it on first use.  The library then stays
+ * loaded until the QL is unloaded.  A pending reload is applied here once no other caller is using the library.
+ * A successful call must be paired with release_qpl_functions() once the caller is done with the entry points.
+ *
+ * @param p_functions Returned entry points.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_PLATFORM_LIB_UNAVAILABLE
+ * @return SGX_QL_ERROR_UNEXPECTED
+ */
+static quote3_error_t acquire_qpl_functions(qpl_functions_t *p_functions)
+{
+    quote3_error_t ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
+
+    if (0 == se_mutex_lock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    if (g_ql_global_data.m_qpl_reload_pending && 0 == g_ql_global_data.m_qpl_users) {
+        unload_qpl();
+    }
+    if (NULL != g_ql_global_data.m_qpl_handle || load_qpl()) {
+        *p_functions = g_ql_global_data.m_qpl_functions;
+        g_ql_global_data.m_qpl_users++;
+        ret_val = SGX_QL_SUCCESS;
+    }
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
+    return ret_val;
+}
+
+/**
+ * Release the entry points returned by acquire_qpl_functions().
+ */
+static void release_qpl_functions()
+{
+    if (0 == se_mutex_lock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return;
+    }
+    if (g_ql_global_data.m_qpl_users > 0) {
+        g_ql_global_data.m_qpl_users--;
+    }
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
 }
-#endif
 
 
 #ifdef ENABLE_QE3_LOGGING
@@ -298,25 +546,16 @@ void qe_ocall_print_string(const char *str)
  * @return SGX_QL_PLATFORM_LIB_UNAVAILABLE
  * @return SGX_QL_NO_PLATFORM_CERT_DATA
  */
-static quote3_error_t get_platform_quote_cert_data(sgx_ql_pck_cert_id_t *p_pck_cert_id,
-                                                   sgx_cpu_svn_t *p_cert_cpu_svn,
-                                                   sgx_isv_svn_t *p_cert_pce_isv_svn,
-                                                   uint32_t *p_cert_data_size,
-                                                   uint8_t *p_cert_data)
+static quote3_error_t get_platform_quote_cert_data_from_qpl(sgx_ql_pck_cert_id_t *p_pck_cert_id,
+                                                            sgx_cpu_svn_t *p_cert_cpu_svn,
+                                                            sgx_isv_svn_t *p_cert_pce_isv_svn,
+                                                            uint32_t *p_cert_data_size,
+                                                            uint8_t *p_cert_data)
 {
     quote3_error_t ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
-    sgx_get_quote_config_func_t p_sgx_get_quote_config = NULL;
-    sgx_free_quote_config_func_t p_sgx_free_quote_config = NULL;
+    qpl_functions_t qpl_functions;
     sgx_ql_config_t *p_pck_cert_config = NULL;
 
-    #ifndef _MSC_VER
-    void *handle = NULL;
-    char *error1 = NULL;
-    char *error2 = NULL;
-    #else
-    HINSTANCE handle;
-    #endif
-
     if((NULL == p_pck_cert_id) ||
        (NULL == p_cert_cpu_svn) ||
        (NULL == p_cert_pce_isv_svn) ||
@@ -327,161 +566,284 @@ static quote3_error_t get_platform_quote_cert_data(sgx_ql_pck_cert_id_t *p_pck_c
         return SGX_QL_ERROR_INVALID_PARAMETER;
     }
 
-    #ifndef _MSC_VER
-    handle = get_qpl_handle();
-    if (handle) {
-        p_sgx_get_quote_config = (sgx_get_quote_config_func_t)dlsym(handle, "sgx_ql_get_quote_config");
-        error1 = dlerror();
-        p_sgx_free_quote_config = (sgx_free_quote_config_func_t)dlsym(handle, "sgx_ql_free_quote_config");
-        error2 = dlerror();
-
-        if ((NULL == error1) &&
-             (NULL != p_sgx_get_quote_config) &&
-            (NULL == error2) &&
-             (NULL != p_sgx_free_quote_config)){
-            SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_get_quote_config and sgx_ql_free_quote_config API.\n");
-            SE_TRACE(SE_TRACE_DEBUG, "Request the Quote Config data.\n");
-            ret_val = p_sgx_get_quote_config(p_pck_cert_id, &p_pck_cert_config);
-            if (SGX_QL_SUCCESS != ret_val) {
-                SE_PROD_LOG("Error returned from the p_sgx_get_quote_config API. 0x%04x\n", ret_val);
-                goto CLEANUP;
-            }
-            if(NULL == p_pck_cert_config) {
-                ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
-                SE_PROD_LOG("p_sgx_get_quote_config returned NULL for p_pck_cert_config.\n");
-                goto CLEANUP;
-            }
-            if(p_pck_cert_config->version != SGX_QL_CONFIG_VERSION_1) {
-                SE_PROD_LOG("p_sgx_get_quote_config returned incompatible pck_cert_config version.\n");
-                ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
-                goto CLEANUP;
-            }
-            if(0 != memcpy_s(p_cert_cpu_svn, sizeof(*p_cert_cpu_svn), &p_pck_cert_config->cert_cpu_svn, sizeof(p_pck_cert_config->cert_cpu_svn))) {
-                ret_val = SGX_QL_ERROR_UNEXPECTED;
-                goto CLEANUP;
-            }
-            *p_cert_pce_isv_svn = p_pck_cert_config->cert_pce_isv_svn;
-            if(NULL == p_cert_data) {
-                // The caller only needs the TCBm and/or the required buffer size.
-                // Return the required buffer size.
-                *p_cert_data_size = p_pck_cert_config->cert_data_size;
-            }
-            else {
-                // The caller wants the TCBm and the required buffer size.
-                if(*p_cert_data_size < p_pck_cert_config->cert_data_size) {
-                    // The buffer passed in to this API is not large enouge to contain the provider library's returned cert data.
-                    // This shouldn't happen since the passed in value should be the result of calling this function
-                    // with the inputted p_cert_data equal to NULL just befor this caller.
-                    SE_PROD_LOG("sgx_ql_get_quote_config returned a cert_data_size too large to fit in inputted buffer.\n");
-                    ret_val = SGX_QL_ERROR_INVALID_PARAMETER;
-                    goto CLEANUP;
-                }
-                if(NULL == p_pck_cert_config->p_cert_data) {
-                    SE_PROD_LOG("sgx_ql_get_quote_config returned NULL for p_cert_data.\n");
-                    ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
-                    goto CLEANUP;
-                }
-                // Copy the returned cert data
-                if(0 != memcpy_s(p_cert_data, *p_cert_data_size, p_pck_cert_config->p_cert_data, p_pck_cert_config->cert_data_size)) {
-                    ret_val = SGX_QL_ERROR_UNEXPECTED;
-                    goto CLEANUP;
-                }
-                // Return the number of bytes copied.
-                *p_cert_data_size = p_pck_cert_config->cert_data_size;
-            }
-        } else {
-            SE_PROD_LOG("Couldn't find 'sgx_ql_get_quote_config()' and 'sgx_ql_free_quote_config()' in the platform library. %s\n", dlerror());
+    ret_val = acquire_qpl_functions(&qpl_functions);
+    if (SGX_QL_SUCCESS != ret_val) {
+        return ret_val;
+    }
+    if ((NULL == qpl_functions.p_get_quote_config) ||
+        (NULL == qpl_functions.p_free_quote_config)) {
+        SE_PROD_LOG("Couldn't find 'sgx_ql_get_quote_config()' and 'sgx_ql_free_quote_config()' in the platform library.\n");
+        ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
+        goto CLEANUP;
+    }
+    SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_get_quote_config and sgx_ql_free_quote_config API.\n");
+    SE_TRACE(SE_TRACE_DEBUG, "Request the Quote Config data.\n");
+    ret_val = qpl_functions.p_get_quote_config(p_pck_cert_id, &p_pck_cert_config);
+    if (SGX_QL_SUCCESS != ret_val) {
+        SE_PROD_LOG("Error returned from the p_sgx_get_quote_config API. 0x%04x\n", ret_val);
+        goto CLEANUP;
+    }
+    if(NULL == p_pck_cert_config) {
+        ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
+        SE_PROD_LOG("p_sgx_get_quote_config returned NULL for p_pck_cert_config.\n");
+        goto CLEANUP;
+    }
+    if(p_pck_cert_config->version != SGX_QL_CONFIG_VERSION_1) {
+        SE_PROD_LOG("p_sgx_get_quote_config returned incompatible pck_cert_config version.\n");
+        ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
+        goto CLEANUP;
+    }
+    if(0 != memcpy_s(p_cert_cpu_svn, sizeof(*p_cert_cpu_svn), &p_pck_cert_config->cert_cpu_svn, sizeof(p_pck_cert_config->cert_cpu_svn))) {
+        ret_val = SGX_QL_ERROR_UNEXPECTED;
+        goto CLEANUP;
+    }
+    *p_cert_pce_isv_svn = p_pck_cert_config->cert_pce_isv_svn;
+    if(NULL == p_cert_data) {
+        // The caller only needs the TCBm and/or the required buffer size.
+        // Return the required buffer size.
+        *p_cert_data_size = p_pck_cert_config->cert_data_size;
+    }
+    else {
+        // The caller wants the TCBm and the required buffer size.
+        if(*p_cert_data_size < p_pck_cert_config->cert_data_size) {
+            // The buffer passed in to this API is not large enouge to contain the provider library's returned cert data.
+            // This shouldn't happen since the passed in value should be the result of calling this function
+            // with the inputted p_cert_data equal to NULL just befor this caller.
+            SE_PROD_LOG("sgx_ql_get_quote_config returned a cert_data_size too large to fit in inputted buffer.\n");
+            ret_val = SGX_QL_ERROR_INVALID_PARAMETER;
+            goto CLEANUP;
         }
-    } else {
-        SE_PROD_LOG("Couldn't find the platform library. %s\n", dlerror());
+        if(NULL == p_pck_cert_config->p_cert_data) {
+            SE_PROD_LOG("sgx_ql_get_quote_config returned NULL for p_cert_data.\n");
+            ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
+            goto CLEANUP;
+        }
+        // Copy the returned cert data
+        if(0 != memcpy_s(p_cert_data, *p_cert_data_size, p_pck_cert_config->p_cert_data, p_pck_cert_config->cert_data_size)) {
+            ret_val = SGX_QL_ERROR_UNEXPECTED;
+            goto CLEANUP;
+        }
+        // Return the number of bytes copied.
+        *p_cert_data_size = p_pck_cert_config->cert_data_size;
     }
 
     CLEANUP:
-    if(NULL != p_sgx_free_quote_config){
-        if(NULL != p_pck_cert_config) {
-            p_sgx_free_quote_config(p_pck_cert_config);
+    if(NULL != p_pck_cert_config) {
+        qpl_functions.p_free_quote_config(p_pck_cert_config);
+    }
+    release_qpl_functions();
+
+    return(ret_val);
+}
+
+/**
+ * Drop the cached PCK Cert data, so that the next request goes to the platform library.  The caller must hold
+ * m_pck_cert_mutex.
+ */
+static void clear_pck_cert_data_cache()
+{
+    if (NULL != g_ql_global_data.m_pck_cert_data) {
+        free(g_ql_global_data.m_pck_cert_data);
+        g_ql_global_data.m_pck_cert_data = NULL;
+    }
+    g_ql_global_data.m_pck_cert_data_size = 0;
+    g_ql_global_data.m_pck_cert_cached = false;
+}
+
+/**
+ * Drop the cached PCK Cert data.  Used when the caller explicitly requests a refresh of the attestation key.
+ */
+static void refresh_pck_cert_data_cache()
+{
+    if (0 == se_mutex_lock(&g_ql_global_data.m_pck_cert_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return;
+    }
+    clear_pck_cert_data_cache();
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_pck_cert_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
+}
+
+/**
+ * Reload the Quote Provider Library, e.g. after the provider has been updated on disk.  If another thread is in the
+ * middle of a provider call, the reload is deferred until the library is no longer in use.  The PCK Cert data cached
+ * from the previous library is dropped.
+ *
+ * @return SGX_QL_SUCCESS The library was reloaded or the reload is pending.
+ * @return SGX_QL_PLATFORM_LIB_UNAVAILABLE The library couldn't be loaded.
+ * @return SGX_QL_ERROR_UNEXPECTED
+ */
+quote3_error_t sgx_reload_qpl()
+{
+    quote3_error_t ret_val = SGX_QL_SUCCESS;
+
+    if (0 == se_mutex_lock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    if (0 == g_ql_global_data.m_qpl_users) {
+        unload_qpl();
+        if (!load_qpl()) {
+            ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
         }
     }
-    if(NULL != handle) {
-        dlclose(handle);
+    else {
+        SE_TRACE(SE_TRACE_DEBUG, "The platform library is in use, deferring the reload.\n");
+        g_ql_global_data.m_qpl_reload_pending = true;
     }
-    #else
-    handle = LoadLibrary(TEXT(SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME));
-    if (handle != NULL) {
-        SE_TRACE(SE_TRACE_DEBUG, "Found the Quote's dependent library. %s.\n", SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME);
-        p_sgx_get_quote_config = (sgx_get_quote_config_func_t)GetProcAddress(handle, "sgx_ql_get_quote_config");
-        p_sgx_free_quote_config = (sgx_free_quote_config_func_t)GetProcAddress(handle, "sgx_ql_free_quote_config");
-        if ((NULL != p_sgx_get_quote_config) &&
-            (NULL != p_sgx_free_quote_config)){
-            SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_get_quote_config and sgx_ql_free_quote_config API.\n");
-            SE_TRACE(SE_TRACE_DEBUG, "Request the Quote Config data.\n");
-            ret_val = p_sgx_get_quote_config(p_pck_cert_id, &p_pck_cert_config);
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
+    // m_pck_cert_mutex is taken before m_qpl_mutex elsewhere, so don't nest it here.
+    refresh_pck_cert_data_cache();
+
+    return ret_val;
+}
+
+/**
+ * Get the number of times the Quote Provider Library has been loaded by this process.
+ *
+ * @param p_load_count Returned load count.  Must not be NULL.
+ *
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_ERROR_INVALID_PARAMETER
+ * @return SGX_QL_ERROR_UNEXPECTED
+ */
+quote3_error_t sgx_get_qpl_load_count(uint32_t *p_load_count)
+{
+    if (NULL == p_load_count) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+    if (0 == se_mutex_lock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    *p_load_count = g_ql_global_data.m_qpl_load_count;
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_qpl_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Wrapper function for retrieving the PCK Certificate data, see get_platform_quote_cert_data_from_qpl().  The data
+ * returned by the platform library is cached for the last platform identity (QE_ID, raw CPUSVN, raw PCE ISVSVN and
+ * PCE_ID), so that generating a quote doesn't load the platform library and query the PCCS each time.  A TCB change
+ * changes the platform identity and so refreshes the cache.  Errors are not cached.
+ *
+ * @param p_pck_cert_id Pointer to the platorm identification data.  Must not be NULL.
+ * @param p_cert_cpu_svn Returned CPUSVN of the PCK cert. Must not be NULL.
+ * @param p_cert_isv_svn Returned CPUSVN of the PCK cert.  Must not be NULL.
+ * @param p_cert_data_size Pointer to the size in bytes of the cert data.  Must not be NULL. If p_cert_data is NULL,
+ *                         then this function will return the size of the bufffer to allocate. If p_cert_data is not
+ *                         NULL, then the p_cert_data_size points the number of bytes in the p_cert_data buffer and it
+ *                         must not be 0.
+ * @param p_cert_data Pointer ot the buffer to containt the cert data.  Can be NULL.  If NULL, the required buffer size
+ *                         will be returned in p_cert_data_size.
+ *
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_ERROR_INVALID_PARAMETER
+ * @return SGX_QL_ERROR_OUT_OF_MEMORY
+ * @return SGX_QL_PLATFORM_LIB_UNAVAILABLE
+ * @return SGX_QL_NO_PLATFORM_CERT_DATA
+ */
+static quote3_error_t get_platform_quote_cert_data(sgx_ql_pck_cert_id_t *p_pck_cert_id,
+                                                   sgx_cpu_svn_t *p_cert_cpu_svn,
+                                                   sgx_isv_svn_t *p_cert_pce_isv_svn,
+                                                   uint32_t *p_cert_data_size,
+                                                   uint8_t *p_cert_data)
+{
+    quote3_error_t ret_val = SGX_QL_ERROR_UNEXPECTED;
+    sgx_cpu_svn_t cert_cpu_svn;
+    sgx_isv_svn_t cert_pce_isv_svn = 0;
+    uint32_t cert_data_size = 0;
+    uint8_t *p_qpl_cert_data = NULL;
+
+    if((NULL == p_pck_cert_id) ||
+       (NULL == p_pck_cert_id->p_qe3_id) ||
+       (NULL == p_pck_cert_id->p_platform_cpu_svn) ||
+       (NULL == p_pck_cert_id->p_platform_pce_isv_svn) ||
+       (NULL == p_cert_cpu_svn) ||
+       (NULL == p_cert_pce_isv_svn) ||
+       (NULL == p_cert_data_size)) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+    if((NULL != p_cert_data) && (0 == *p_cert_data_size))  {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+    if(sizeof(g_ql_global_data.m_pck_cert_qe3_id) != p_pck_cert_id->qe3_id_size) {
+        // Not a platform identity the cache can hold.
+        return get_platform_quote_cert_data_from_qpl(p_pck_cert_id, p_cert_cpu_svn, p_cert_pce_isv_svn,
+                                                     p_cert_data_size, p_cert_data);
+    }
+
+    if (0 == se_mutex_lock(&g_ql_global_data.m_pck_cert_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+
+    do {
+        if((false == g_ql_global_data.m_pck_cert_cached) ||
+           (0 != memcmp(&g_ql_global_data.m_pck_cert_qe3_id, p_pck_cert_id->p_qe3_id, sizeof(g_ql_global_data.m_pck_cert_qe3_id))) ||
+           (0 != memcmp(&g_ql_global_data.m_pck_cert_platform_cpu_svn, p_pck_cert_id->p_platform_cpu_svn, sizeof(g_ql_global_data.m_pck_cert_platform_cpu_svn))) ||
+           (g_ql_global_data.m_pck_cert_platform_pce_isv_svn != *p_pck_cert_id->p_platform_pce_isv_svn) ||
+           (g_ql_global_data.m_pck_cert_pce_id != p_pck_cert_id->pce_id)) {
+            SE_TRACE(SE_TRACE_DEBUG, "PCK Cert data isn't cached for the platform identity, request it from the platform library.\n");
+            clear_pck_cert_data_cache();
+
+            ret_val = get_platform_quote_cert_data_from_qpl(p_pck_cert_id, &cert_cpu_svn, &cert_pce_isv_svn,
+                                                            &cert_data_size, NULL);
             if (SGX_QL_SUCCESS != ret_val) {
-                SE_PROD_LOG("Error returned from the p_sgx_get_quote_config API. 0x%04x\n", ret_val);
-                goto CLEANUP;
+                break;
             }
-            if (NULL == p_pck_cert_config) {
+            if (0 == cert_data_size) {
                 ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
-                SE_PROD_LOG("p_sgx_get_quote_config returned NULL for p_pck_cert_config.\n");
-                goto CLEANUP;
+                break;
             }
-            if (p_pck_cert_config->version != SGX_QL_CONFIG_VERSION_1) {
-                SE_PROD_LOG("p_sgx_get_quote_config returned incompatible pck_cert_config version.\n");
-                ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
-                goto CLEANUP;
+            p_qpl_cert_data = (uint8_t *)malloc(cert_data_size);
+            if (NULL == p_qpl_cert_data) {
+                ret_val = SGX_QL_ERROR_OUT_OF_MEMORY;
+                break;
             }
-            if (0 != memcpy_s(p_cert_cpu_svn, sizeof(*p_cert_cpu_svn), &p_pck_cert_config->cert_cpu_svn, sizeof(p_pck_cert_config->cert_cpu_svn))) {
-                ret_val = SGX_QL_ERROR_UNEXPECTED;
-                goto CLEANUP;
+            ret_val = get_platform_quote_cert_data_from_qpl(p_pck_cert_id, &cert_cpu_svn, &cert_pce_isv_svn,
+                                                            &cert_data_size, p_qpl_cert_data);
+            if (SGX_QL_SUCCESS != ret_val) {
+                free(p_qpl_cert_data);
+                break;
             }
-            *p_cert_pce_isv_svn = p_pck_cert_config->cert_pce_isv_svn;
-            if (NULL == p_cert_data) {
-                // The caller only needs the TCBm and/or the required buffer size.
-                // Return the required buffer size.
-                *p_cert_data_size = p_pck_cert_config->cert_data_size;
+
+            memcpy(&g_ql_global_data.m_pck_cert_qe3_id, p_pck_cert_id->p_qe3_id, sizeof(g_ql_global_data.m_pck_cert_qe3_id));
+            g_ql_global_data.m_pck_cert_platform_cpu_svn = *p_pck_cert_id->p_platform_cpu_svn;
+            g_ql_global_data.m_pck_cert_platform_pce_isv_svn = *p_pck_cert_id->p_platform_pce_isv_svn;
+            g_ql_global_data.m_pck_cert_pce_id = p_pck_cert_id->pce_id;
+            g_ql_global_data.m_pck_cert_cpu_svn = cert_cpu_svn;
+            g_ql_global_data.m_pck_cert_pce_isv_svn = cert_pce_isv_svn;
+            g_ql_global_data.m_pck_cert_data_size = cert_data_size;
+            g_ql_global_data.m_pck_cert_data = p_qpl_cert_data;
+            g_ql_global_data.m_pck_cert_cached = true;
+        }
+
+        *p_cert_cpu_svn = g_ql_global_data.m_pck_cert_cpu_svn;
+        *p_cert_pce_isv_svn = g_ql_global_data.m_pck_cert_pce_isv_svn;
+        if(NULL != p_cert_data) {
+            if(*p_cert_data_size < g_ql_global_data.m_pck_cert_data_size) {
+                SE_PROD_LOG("The cached cert_data_size is too large to fit in inputted buffer.\n");
+                ret_val = SGX_QL_ERROR_INVALID_PARAMETER;
+                break;
             }
-            else {
-                // The caller wants the TCBm and the required buffer size.
-                if (*p_cert_data_size < p_pck_cert_config->cert_data_size) {
-                    // The buffer passed in to this API is not large enouge to contain the provider library's returned cert data.
-                    // This shouldn't happen since the passed in value should be the result of calling this function
-                    // with the inputted p_cert_data equal to NULL just befor this caller.
-                    SE_PROD_LOG("sgx_ql_get_quote_config returned a cert_data_size too large to fit in inputted buffer.\n");
-                    ret_val = SGX_QL_ERROR_INVALID_PARAMETER;
-                    goto CLEANUP;
-                }
-                if (NULL == p_pck_cert_config->p_cert_data) {
-                    SE_PROD_LOG("sgx_ql_get_quote_config returned NULL for p_cert_data.\n");
-                    ret_val = SGX_QL_NO_PLATFORM_CERT_DATA;
-                    goto CLEANUP;
-                }
-                // Copy the returned cert data
-                if (0 != memcpy_s(p_cert_data, *p_cert_data_size, p_pck_cert_config->p_cert_data, p_pck_cert_config->cert_data_size)) {
-                    ret_val = SGX_QL_ERROR_UNEXPECTED;
-                    goto CLEANUP;
-                }
-                // Return the number of bytes copied.
-                *p_cert_data_size = p_pck_cert_config->cert_data_size;
+            if(0 != memcpy_s(p_cert_data, *p_cert_data_size, g_ql_global_data.m_pck_cert_data, g_ql_global_data.m_pck_cert_data_size)) {
+                ret_val = SGX_QL_ERROR_UNEXPECTED;
+                break;
             }
         }
-        else {
-            SE_PROD_LOG("Couldn't find 'sgx_ql_get_quote_config()' and 'sgx_ql_free_quote_config()' in the platform library. %d\n", GetLastError());
-        }
-    }
-    else {
-        SE_PROD_LOG("Couldn't find the platform library. %d\n", GetLastError());
-    }
-    CLEANUP:
-    if (NULL != p_sgx_free_quote_config) {
-        if (NULL != p_pck_cert_config) {
-            p_sgx_free_quote_config(p_pck_cert_config);
-        }
-    }
-    if (NULL != handle) {
-        FreeLibrary(handle);
-    }
-    #endif
+        *p_cert_data_size = g_ql_global_data.m_pck_cert_data_size;
+        ret_val = SGX_QL_SUCCESS;
+    } while (0);
 
+    if (0 == se_mutex_unlock(&g_ql_global_data.m_pck_cert_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    }
     return(ret_val);
 }
 
@@ -805,13 +1167,7 @@ static quote3_error_t write_persistent_data(const uint8_t *p_buf,
                                             const char *p_label)
 {
     quote3_error_t ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
-    sgx_write_persistent_data_func_t p_sgx_qe_write_persistent_data;
-    #ifndef _MSC_VER
-    void *handle;
-    char *error;
-    #else
-    HINSTANCE handle;
-    #endif
+    qpl_functions_t qpl_functions;
 
     if((NULL == p_buf) ||
        (0 == buf_size)||
@@ -819,51 +1175,24 @@ static quote3_error_t write_persistent_data(const uint8_t *p_buf,
         return(SGX_QL_ERROR_INVALID_PARAMETER);
     }
 
-    #ifndef _MSC_VER
-    handle = get_qpl_handle();
-    if (handle) {
-        p_sgx_qe_write_persistent_data = (sgx_write_persistent_data_func_t)dlsym(handle, "sgx_ql_write_persistent_data");
-        if ((error = dlerror()) == NULL &&
-            NULL != p_sgx_qe_write_persistent_data) {
-            SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_write_persistent_data API.\n");
-            ret_val = p_sgx_qe_write_persistent_data(p_buf,
+    ret_val = acquire_qpl_functions(&qpl_functions);
+    if (SGX_QL_SUCCESS != ret_val) {
+        return(ret_val);
+    }
+    if (NULL != qpl_functions.p_write_persistent_data) {
+        SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_write_persistent_data API.\n");
+        ret_val = qpl_functions.p_write_persistent_data(p_buf,
                                                         buf_size,
                                                         p_label);
-            if (SGX_QL_SUCCESS != ret_val) {
-                SE_PROD_LOG("Error returned from the sgx_ql_write_persistent_data API. 0x%04x\n", ret_val);
-            }
-        } else {
-            SE_TRACE(SE_TRACE_WARNING, "Couldn't find 'sgx_ql_write_persistent_data()' in the platform library. %s\n", dlerror());
+        if (SGX_QL_SUCCESS != ret_val) {
+            SE_PROD_LOG("Error returned from the sgx_ql_write_persistent_data API. 0x%04x\n", ret_val);
         }
-        dlclose(handle);
     } else {
-        SE_PROD_LOG("Couldn't find the platform library. %s\n", dlerror());
-    }
-    #else
-    handle = LoadLibrary(TEXT(SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME));
-    if (handle != NULL) {
-        SE_TRACE(SE_TRACE_DEBUG, "Found the Quote's dependent library. %s.\n", SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME);
-        p_sgx_qe_write_persistent_data = (sgx_write_persistent_data_func_t)GetProcAddress(handle, "sgx_ql_write_persistent_data");
-        if (NULL != p_sgx_qe_write_persistent_data) {
-            SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_write_persistent_data API.\n");
-            ret_val = p_sgx_qe_write_persistent_data(p_buf,
-                buf_size,
-                p_label);
-            if (SGX_QL_SUCCESS != ret_val) {
-                SE_PROD_LOG("Error returned from the sgx_ql_write_persistent_data API. 0x%04x\n", ret_val);
-            }
-        }
-        else {
-            SE_TRACE(SE_TRACE_WARNING, "Couldn't find 'sgx_ql_write_persistent_data()' in the platform library. %d\n", GetLastError());
-        }
-        FreeLibrary(handle);
+        SE_TRACE(SE_TRACE_WARNING, "Couldn't find 'sgx_ql_write_persistent_data()' in the platform library.\n");
+        ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
     }
-    else {
-        SE_PROD_LOG("Couldn't find the platform library. %d\n", GetLastError());
-    }
-    #endif
+    release_qpl_functions();
 
-    //CLEANUP:
     return(ret_val);
 }
 
@@ -885,14 +1214,7 @@ static quote3_error_t read_persistent_data(uint8_t *p_buf,
                                            const char *p_label)
 {
     quote3_error_t ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
-    sgx_read_persistent_data_func_t p_sgx_qe_read_persistent_data;
-
-    #ifndef _MSC_VER
-    void *handle;
-    char *error;
-    #else
-    HINSTANCE handle;
-    #endif
+    qpl_functions_t qpl_functions;
 
     if((NULL == p_buf) ||
        (NULL == p_buf_size)||
@@ -900,53 +1222,197 @@ static quote3_error_t read_persistent_data(uint8_t *p_buf,
         return(SGX_QL_ERROR_INVALID_PARAMETER);
     }
 
-    #ifndef _MSC_VER
-    handle = get_qpl_handle();
-    if (handle) {
-        p_sgx_qe_read_persistent_data = (sgx_read_persistent_data_func_t)dlsym(handle, "sgx_ql_read_persistent_data");
-        if ((error = dlerror()) == NULL &&
-            NULL != p_sgx_qe_read_persistent_data) {
-            SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_qe_read_persistent_data API.\n");
-            ret_val = p_sgx_qe_read_persistent_data(p_buf,
-                                                    p_buf_size,
-                                                    p_label);
-            if (SGX_QL_SUCCESS != ret_val) {
-                SE_PROD_LOG("Error returned from the sgx_ql_read_persistent_data API. 0x%04x\n", ret_val);
-            }
-        } else {
-            SE_TRACE(SE_TRACE_WARNING, "Couldn't find 'sgx_ql_read_persistent_data()' in the platform library. %s\n", dlerror());
+    ret_val = acquire_qpl_functions(&qpl_functions);
+    if (SGX_QL_SUCCESS != ret_val) {
+        return(ret_val);
+    }
+    if (NULL != qpl_functions.p_read_persistent_data) {
+        SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_read_persistent_data API.\n");
+        ret_val = qpl_functions.p_read_persistent_data(p_buf,
+                                                       p_buf_size,
+                                                       p_label);
+        if (SGX_QL_SUCCESS != ret_val) {
+            SE_PROD_LOG("Error returned from the sgx_ql_read_persistent_data API. 0x%04x\n", ret_val);
         }
-        dlclose(handle);
     } else {
-        SE_PROD_LOG("Couldn't find the platform library. %s\n", dlerror());
+        SE_TRACE(SE_TRACE_WARNING, "Couldn't find 'sgx_ql_read_persistent_data()' in the platform library.\n");
+        ret_val = SGX_QL_PLATFORM_LIB_UNAVAILABLE;
     }
-    #else
-    handle = LoadLibrary(TEXT(SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME));
-    if (handle != NULL) {
-        SE_TRACE(SE_TRACE_DEBUG, "Found the Quote's dependent library. %s.\n", SGX_QL_QUOTE_CONFIG_LIB_FILE_NAME);
-        p_sgx_qe_read_persistent_data = (sgx_read_persistent_data_func_t)GetProcAddress(handle, "sgx_ql_read_persistent_data");
-        if (NULL != p_sgx_qe_read_persistent_data) {
-            SE_TRACE(SE_TRACE_DEBUG, "Found the sgx_ql_read_persistent_data API.\n");
-            ret_val = p_sgx_qe_read_persistent_data(p_buf,
-                                                    p_buf_size,
-                                                    p_label);
-            if (SGX_QL_SUCCESS != ret_val) {
-                SE_PROD_LOG("Error returned from the sgx_ql_read_persistent_data API. 0x%04x\n", ret_val);
-            }
+    release_qpl_functions();
+
+    return(ret_val);
+}
+
+#ifndef _MSC_VER
+/**
+ * Background thread that writes the last stored ECDSA blob to persistent storage.  Blobs stored while a write is in
+ * progress are coalesced into a single write of the newest one.  Pending blobs are written before the thread exits.
+ */
+static void *ecdsa_blob_writer(void *p_arg)
+{
+    (void)p_arg;
+    quote3_error_t ret_val = SGX_QL_SUCCESS;
+    uint8_t blob[SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK];
+    uint32_t generation = 0;
+
+    se_mutex_lock(&g_ql_global_data.m_blob_writer_mutex);
+    while (true) {
+        while (!g_ql_global_data.m_blob_writer_stopping &&
+               g_ql_global_data.m_ecdsa_blob_generation == g_ql_global_data.m_ecdsa_blob_written_generation) {
+            se_thread_cond_wait(&g_ql_global_data.m_blob_writer_cond, &g_ql_global_data.m_blob_writer_mutex);
         }
-        else {
-            SE_TRACE(SE_TRACE_WARNING, "Couldn't find 'sgx_ql_read_persistent_data()' in the platform library. %d\n", GetLastError());
+        if (g_ql_global_data.m_ecdsa_blob_generation == g_ql_global_data.m_ecdsa_blob_written_generation) {
+            break;
+        }
+        memcpy(blob, g_ql_global_data.m_ecdsa_blob_pending, sizeof(blob));
+        generation = g_ql_global_data.m_ecdsa_blob_generation;
+        se_mutex_unlock(&g_ql_global_data.m_blob_writer_mutex);
+
+        ret_val = write_persistent_data(blob,
+                                        sizeof(blob),
+                                        ECDSA_BLOB_LABEL);
+        if (SGX_QL_SUCCESS != ret_val) {
+            // Don't need to error since the blob is still good in memory.
+            SE_TRACE(SE_TRACE_WARNING, "Warning, unable to store ECDSA blob to persistent storage.\n");
+            SE_TRACE(SE_TRACE_DEBUG, "File storage is not required for the QE_Library.  Library will use ECDSA Blob cached in memory.\n");
         }
-        FreeLibrary(handle);
+
+        se_mutex_lock(&g_ql_global_data.m_blob_writer_mutex);
+        g_ql_global_data.m_ecdsa_blob_written_generation = generation;
+    }
+    se_mutex_unlock(&g_ql_global_data.m_blob_writer_mutex);
+    memset(blob, 0, sizeof(blob));
+
+    return NULL;
+}
+#endif
+
+/**
+ * Stops the blob writer after it has written any pending blob.
+ */
+static void stop_ecdsa_blob_writer()
+{
+#ifndef _MSC_VER
+    bool started = false;
+
+    se_mutex_lock(&g_ql_global_data.m_blob_writer_mutex);
+    started = g_ql_global_data.m_blob_writer_started;
+    g_ql_global_data.m_blob_writer_stopping = true;
+    se_thread_cond_signal(&g_ql_global_data.m_blob_writer_cond);
+    se_mutex_unlock(&g_ql_global_data.m_blob_writer_mutex);
+    if (started) {
+        pthread_join(g_ql_global_data.m_blob_writer, NULL);
+    }
+#endif
+}
+
+/**
+ * Stores the ECDSA blob in g_ql_global_data.m_ecdsa_blob after it has been generated, certified or resealed.  The blob
+ * becomes the cached blob and is written to persistent storage in the background.  If the writer thread can't be
+ * started, or on Windows, it is written before returning.  Errors are not returned since persistent storage is not
+ * required.  Must be called with m_ecdsa_blob_mutex held.
+ */
+static void store_ecdsa_blob()
+{
+    g_ql_global_data.m_ecdsa_blob_cached = true;
+    g_ql_global_data.m_ecdsa_blob_time = time(NULL);
+    if (SGX_QL_SUCCESS != sgx_get_qpl_load_count(&g_ql_global_data.m_ecdsa_blob_qpl_load_count)) {
+        g_ql_global_data.m_ecdsa_blob_cached = false;
+    }
+
+#ifndef _MSC_VER
+    if (0 == se_mutex_lock(&g_ql_global_data.m_blob_writer_mutex)) {
+        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
     }
     else {
-        SE_PROD_LOG("Couldn't find the platform library. %d\n", GetLastError());
+        bool queued = false;
+        if (!g_ql_global_data.m_blob_writer_started && !g_ql_global_data.m_blob_writer_stopping) {
+            if (0 == pthread_create(&g_ql_global_data.m_blob_writer, NULL, ecdsa_blob_writer, NULL)) {
+                g_ql_global_data.m_blob_writer_started = true;
+            }
+            else {
+                SE_TRACE(SE_TRACE_WARNING, "Unable to start the ECDSA blob writer thread.\n");
+            }
+        }
+        if (g_ql_global_data.m_blob_writer_started && !g_ql_global_data.m_blob_writer_stopping) {
+            memcpy(g_ql_global_data.m_ecdsa_blob_pending, g_ql_global_data.m_ecdsa_blob, sizeof(g_ql_global_data.m_ecdsa_blob_pending));
+            g_ql_global_data.m_ecdsa_blob_generation++;
+            se_thread_cond_signal(&g_ql_global_data.m_blob_writer_cond);
+            queued = true;
+        }
+        se_mutex_unlock(&g_ql_global_data.m_blob_writer_mutex);
+        if (queued) {
+            return;
+        }
+    }
+#endif
+    if (SGX_QL_SUCCESS != write_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
+                                                sizeof(g_ql_global_data.m_ecdsa_blob),
+                                                ECDSA_BLOB_LABEL)) {
+        // Don't need to error since the blob is still good in memory.
+        SE_TRACE(SE_TRACE_WARNING, "Warning, unable to store ECDSA blob to persistent storage.\n");
+        SE_TRACE(SE_TRACE_DEBUG, "File storage is not required for the QE_Library.  Library will use ECDSA Blob cached in memory.\n");
     }
+}
 
-    #endif
+/**
+ * Makes g_ql_global_data.m_ecdsa_blob hold the current ECDSA blob.  The blob is only read from persistent storage the
+ * first time, after the platform library has been reloaded, after the cached blob failed verification or when it was
+ * read or stored more than ECDSA_BLOB_REVALIDATE_SECONDS ago.  The cached blob is private to the process: the platform
+ * library doesn't report changes to persistent storage, so a blob written by another process or tool is only picked
+ * up by the next read.  If a stored blob hasn't been written yet, it is newer than the one in persistent storage and
+ * is used instead.  Must be called with m_ecdsa_blob_mutex held.
+ *
+ * @return SGX_QL_SUCCESS m_ecdsa_blob holds the blob to verify.  If persistent storage doesn't have the blob, it holds
+ *         the blob already in memory.
+ * @return SGX_QL_ATT_KEY_NOT_INITIALIZED The blob in persistent storage has an invalid size.
+ */
+static quote3_error_t load_ecdsa_blob()
+{
+    quote3_error_t refqt_ret = SGX_QL_SUCCESS;
+    uint32_t blob_size_read = sizeof(g_ql_global_data.m_ecdsa_blob);
+    uint32_t qpl_load_count = 0;
+    bool write_pending = false;
+    time_t now = time(NULL);
+
+    if (g_ql_global_data.m_ecdsa_blob_cached &&
+        now >= g_ql_global_data.m_ecdsa_blob_time &&
+        now - g_ql_global_data.m_ecdsa_blob_time < ECDSA_BLOB_REVALIDATE_SECONDS &&
+        SGX_QL_SUCCESS == sgx_get_qpl_load_count(&qpl_load_count) &&
+        qpl_load_count == g_ql_global_data.m_ecdsa_blob_qpl_load_count) {
+        return(SGX_QL_SUCCESS);
+    }
 
-    //CLEANUP:
-    return(ret_val);
+    if (0 != se_mutex_lock(&g_ql_global_data.m_blob_writer_mutex)) {
+        if (g_ql_global_data.m_ecdsa_blob_generation != g_ql_global_data.m_ecdsa_blob_written_generation) {
+            memcpy(g_ql_global_data.m_ecdsa_blob, g_ql_global_data.m_ecdsa_blob_pending, sizeof(g_ql_global_data.m_ecdsa_blob));
+            write_pending = true;
+        }
+        se_mutex_unlock(&g_ql_global_data.m_blob_writer_mutex);
+    }
+    if (!write_pending) {
+        // Get ECDSA Blob if exists
+        SE_TRACE(SE_TRACE_DEBUG, "Read ECDSA blob from persistent storage.\n");
+        refqt_ret = read_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
+                                         &blob_size_read,
+                                         ECDSA_BLOB_LABEL);
+        if (SGX_QL_SUCCESS != refqt_ret) {
+            // Ignore errors since persistent storage is not required.  Blob in memory may still be OK so continue to try to verify the cached blob.
+            SE_TRACE(SE_TRACE_WARNING, "ECDSA Blob doesn't exist is persistent storage.  Try to use the cached version.\n");
+            refqt_ret = SGX_QL_SUCCESS;
+        }
+        else if (blob_size_read != sizeof(g_ql_global_data.m_ecdsa_blob)) {
+            // If the blob was successfully read from persistent storage, verify its size.
+            SE_TRACE(SE_TRACE_ERROR, "Invalid ECDSA Blob file size. blob_size_read = %uld, sizeof(g_ecdsa_blob) = %uld.\n", blob_size_read, (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob));
+            g_ql_global_data.m_ecdsa_blob_cached = false;
+            return(SGX_QL_ATT_KEY_NOT_INITIALIZED);
+        }
+    }
+    // The load count is read after the read since it loads the platform library on first use.
+    g_ql_global_data.m_ecdsa_blob_time = now;
+    g_ql_global_data.m_ecdsa_blob_cached = (SGX_QL_SUCCESS == sgx_get_qpl_load_count(&g_ql_global_data.m_ecdsa_blob_qpl_load_count));
+
+    return(refqt_ret);
 }
 
 /**
@@ -1048,16 +1514,8 @@ static quote3_error_t certify_key(uint8_t *p_ecdsa_blob,
         refqt_ret = (quote3_error_t)qe3_error;
         goto CLEANUP;
     } else {
-        SE_TRACE(SE_TRACE_DEBUG, "Certification done.  Store updated ECDSA blob to disk.\n");
-        refqt_ret = write_persistent_data(p_ecdsa_blob,
-                                          SGX_QL_TRUSTED_ECDSA_BLOB_SIZE_SDK,
-                                          ECDSA_BLOB_LABEL);
-        if (refqt_ret != SGX_QL_SUCCESS) {
-            // This should not be a critical failure but a warning.  The ECDSA key is still in memory.
-            SE_TRACE(SE_TRACE_WARNING, "Warning, unable to store resealed ECDSA blob to persistent storage.\n");
-            SE_TRACE(SE_TRACE_DEBUG, "File storage is not required for the QE_Library.  Library will use ECDSA Blob cached in memory.\n");
-            refqt_ret = SGX_QL_SUCCESS;
-        }
+        SE_TRACE(SE_TRACE_DEBUG, "Certification done.  Store updated ECDSA blob.\n");
+        store_ecdsa_blob();
     }
 
     CLEANUP:
@@ -1234,22 +1692,16 @@ quote3_error_t ECDSA256Quote::ecdsa_init_quote(sgx_ql_cert_key_type_t certificat
         if (true == refresh_att_key) {
             SE_TRACE(SE_TRACE_DEBUG, "Caller requests a new ECDSA Key.\n");
             gen_new_key = true;
+            // Certify the new key with fresh PCK Cert data.
+            refresh_pck_cert_data_cache();
             break;
         }
-        uint32_t blob_size_read = sizeof(g_ql_global_data.m_ecdsa_blob);
         // Get ECDSA Blob if exists
-        SE_TRACE(SE_TRACE_DEBUG, "Read ECDSA blob.\n");
-        refqt_ret = read_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                                         &blob_size_read,
-                                         ECDSA_BLOB_LABEL);
+        SE_TRACE(SE_TRACE_DEBUG, "Load ECDSA blob.\n");
+        refqt_ret = load_ecdsa_blob();
         if (SGX_QL_SUCCESS != refqt_ret) {
-            // Ignore errors since persistent storage is not required.  Blob in memory may still be OK so continue to try to verify the cached blob.
-            SE_TRACE(SE_TRACE_WARNING, "ECDSA Blob doesn't exist is persistent storage.  Try to use the cached version.\n");
+            // Since caller requested use any key, generate a new key.
             refqt_ret = SGX_QL_SUCCESS;
-        }
-        else if (blob_size_read != sizeof(g_ql_global_data.m_ecdsa_blob)) {
-            // If the blob was successfully read from persistent storage, verify its size.
-            SE_TRACE(SE_TRACE_ERROR, "Invalid ECDSA Blob file size. blob_size_read = %uld, sizeof(g_ecdsa_blob) = %uld.  Since caller requested use any key, generate a new key.\n", blob_size_read, (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob));
             gen_new_key = true;
             break;
         }
@@ -1277,17 +1729,8 @@ quote3_error_t ECDSA256Quote::ecdsa_init_quote(sgx_ql_cert_key_type_t certificat
         SE_TRACE(SE_TRACE_DEBUG, "Successfully verified ECDSA Blob.\n");
         p_qe_target_info->mr_enclave = qe3_report_body.mr_enclave;
         if (resealed) {
-            SE_TRACE(SE_TRACE_DEBUG, "ECDSA Blob was resealed. Store it disk.\n");
-            refqt_ret = write_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                                              sizeof(g_ql_global_data.m_ecdsa_blob),
-                                              ECDSA_BLOB_LABEL);
-            if (refqt_ret != SGX_QL_SUCCESS) {
-                // Don't need to error since the blob is still good in memory.
-                ///todo:  What is the best way to notify the requester that the blob was not stored to disk?
-                SE_TRACE(SE_TRACE_WARNING, "Warning, unable to store resealed ECDSA blob to persistent storage.\n");
-                SE_TRACE(SE_TRACE_DEBUG, "File storage is not required for the QE_Library.  Library will use ECDSA Blob cached in memory.\n");
-                refqt_ret = SGX_QL_SUCCESS;
-            }
+            SE_TRACE(SE_TRACE_DEBUG, "ECDSA Blob was resealed. Store it.\n");
+            store_ecdsa_blob();
         }
 
         p_sealed_ecdsa = reinterpret_cast<sgx_sealed_data_t *>(g_ql_global_data.m_ecdsa_blob);
@@ -1589,6 +2032,10 @@ quote3_error_t ECDSA256Quote::ecdsa_init_quote(sgx_ql_cert_key_type_t certificat
 
     CLEANUP:
     if(0 != blob_mutex_rc ) {
+        if (SGX_QL_SUCCESS != refqt_ret) {
+            // The blob in memory may be a key that failed certification.  Reload the last stored blob next time.
+            g_ql_global_data.m_ecdsa_blob_cached = false;
+        }
         blob_mutex_rc = se_mutex_unlock(&g_ql_global_data.m_ecdsa_blob_mutex);
         if (0 == blob_mutex_rc)
         {
@@ -1641,7 +2088,6 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote_size(sgx_ql_cert_key_type_t certif
     sgx_misc_attribute_t qe3_attributes;
     uint8_t resealed = 0;
     sgx_ql_pck_cert_id_t pck_cert_id;
-    uint32_t blob_size_read;
     int blob_mutex_rc = 0;
 
     // Verify inputs
@@ -1698,21 +2144,10 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote_size(sgx_ql_cert_key_type_t certif
         goto CLEANUP;
     }
 
-    blob_size_read = sizeof(g_ql_global_data.m_ecdsa_blob);
     // Get ECDSA Blob if exists
-    SE_TRACE(SE_TRACE_DEBUG, "Read ECDSA blob from persistent storage.\n");
-    refqt_ret = read_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                                     &blob_size_read,
-                                     ECDSA_BLOB_LABEL);
+    SE_TRACE(SE_TRACE_DEBUG, "Load ECDSA blob.\n");
+    refqt_ret = load_ecdsa_blob();
     if (SGX_QL_SUCCESS != refqt_ret) {
-        // Ignore errors since persistent storage is not required.  Blob in memory may still be OK and continue to try to verify the cached blob.
-        SE_TRACE(SE_TRACE_WARNING, "ECDSA Blob doesn't exist is persistent storage.  Try to use the cached version.\n");
-        refqt_ret = SGX_QL_SUCCESS;
-    }
-    else if (blob_size_read != sizeof(g_ql_global_data.m_ecdsa_blob)) {
-        // If the blob was successfully read from persistent storage, verify its size.
-        SE_TRACE(SE_TRACE_ERROR, "Invalid ECDSA Blob file size. blob_size_read = %uld, sizeof(g_ecdsa_blob) = %uld.  Since caller requested use any key, generate a new key.\n", blob_size_read, (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob));
-        refqt_ret = SGX_QL_ATT_KEY_NOT_INITIALIZED;
         goto CLEANUP;
     }
     memset(&qe3_report_body, 0, sizeof(qe3_report_body));
@@ -1735,22 +2170,14 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote_size(sgx_ql_cert_key_type_t certif
         SE_TRACE(SE_TRACE_ERROR, "Invalid ECDSA Blob verificaton. 0x%04x, generate a new key.\n", qe3_error);
         ///todo:  Do we want to force the caller to generate the attestation key again when the ECDSA blob fails?
         // May want to add logic to the DCAP wrappers to automatically call init_quote on this failure.
+        // Read the blob from persistent storage again next time.
+        g_ql_global_data.m_ecdsa_blob_cached = false;
         refqt_ret = SGX_QL_ATT_KEY_NOT_INITIALIZED;
         goto CLEANUP;
     }
     if (resealed) {
-        SE_TRACE(SE_TRACE_DEBUG, "ECDSA Blob was resealed. Store it disk.\n");
-        refqt_ret = write_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                                          sizeof(g_ql_global_data.m_ecdsa_blob),
-                                          ECDSA_BLOB_LABEL);
-
-        if (refqt_ret != SGX_QL_SUCCESS) {
-            // Don't need to error since the blob is still good in memory.
-            // /todo:  What is the best way to notify the requester that the blob was not stored?
-            SE_TRACE(SE_TRACE_WARNING, "Warning, unable to store resealed ECDSA blob to persistent storage.\n");
-            SE_TRACE(SE_TRACE_DEBUG, "File storage is not required for the QE_Library.  Library will use ECDSA Blob cached in memory.\n");
-            refqt_ret = SGX_QL_SUCCESS;
-        }
+        SE_TRACE(SE_TRACE_DEBUG, "ECDSA Blob was resealed. Store it.\n");
+        store_ecdsa_blob();
     }
     SE_TRACE(SE_TRACE_DEBUG, "Successfully verified ECDSA Blob.\n");
 
@@ -1848,6 +2275,33 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote_size(sgx_ql_cert_key_type_t certif
 * @param p_quote
 * @param quote_size
 *
+* @return Errors from ecdsa_get_quotes()
+*/
+quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
+                                              sgx_ql_qe_report_info_t *p_qe_report_info,
+                                              sgx_quote3_t *p_quote,
+                                              uint32_t quote_size)
+{
+    return(ecdsa_get_quotes(p_app_report,
+                            1,
+                            p_qe_report_info,
+                            (uint8_t*)p_quote,
+                            quote_size));
+}
+
+/**
+* Generates a quote for each of the report_count application enclave reports.  The ECDSA blob, the PCE's ISVSVN and
+* the certification data are read once for the whole batch.  A single report uses the QE3's gen_quote ECALL and may
+* request a QE report.  A batch uses the gen_quotes ECALL, which signs all of the quotes in one enclave transition and
+* doesn't support a QE report.
+*
+* @param p_app_reports Array of report_count application enclave reports.
+* @param report_count Number of reports.  Must not be 0.
+* @param p_qe_report_info Optional QE report request.  Must be NULL when report_count is greater than 1.
+* @param p_quotes Buffer of report_count * quote_size bytes.  The quote for p_app_reports[i] is returned at
+*                 p_quotes + i * quote_size.
+* @param quote_size Size in bytes of each quote slot in p_quotes.
+*
 * @return SGX_QL_SUCCESS
 * @return Return codes from load_qe.
 * @return SGX_QL_ATT_KEY_NOT_INITIALIZED  The Attestaion key has not been generated, certified or requires
@@ -1866,10 +2320,11 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote_size(sgx_ql_cert_key_type_t certif
 * @return REFQE3_ERROR_OUT_OF_MEMORY
 * @return SGX_ERROR_INVALID_PARAMETER
 */
-quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
-                                              sgx_ql_qe_report_info_t *p_qe_report_info,
-                                              sgx_quote3_t *p_quote,
-                                              uint32_t quote_size)
+quote3_error_t ECDSA256Quote::ecdsa_get_quotes(const sgx_report_t *p_app_reports,
+                                               uint32_t report_count,
+                                               sgx_ql_qe_report_info_t *p_qe_report_info,
+                                               uint8_t *p_quotes,
+                                               uint32_t quote_size)
 {
     quote3_error_t refqt_ret = SGX_QL_SUCCESS;
     sgx_status_t sgx_status = SGX_SUCCESS;
@@ -1878,7 +2333,6 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
     sgx_enclave_id_t qe3_eid = 0;
     qe3_error_t qe3_error = REFQE3_ERROR_UNEXPECTED;
     uint8_t resealed = 0;
-    uint32_t blob_size_read = sizeof(g_ql_global_data.m_ecdsa_blob);
     sgx_sha256_hash_t blob_ecdsa_id;
     sgx_isv_svn_t cur_pce_isv_svn = {0};
     sgx_quote_nonce_t *p_nonce = NULL;
@@ -1896,11 +2350,16 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
     int blob_mutex_rc = 0;
 
     //Verify inputs
-    if (NULL == p_app_report ||
-        NULL == p_quote) {
+    if (NULL == p_app_reports ||
+        NULL == p_quotes) {
         SE_TRACE(SE_TRACE_ERROR, "Invalid input pointer.\n");
         return(SGX_QL_ERROR_INVALID_PARAMETER);
     }
+    if (0 == report_count ||
+        (1 < report_count && NULL != p_qe_report_info)) {
+        SE_TRACE(SE_TRACE_ERROR, "Invalid report count.\n");
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
 
     // Load the QE3
     memset(&launch_token, 0, sizeof(sgx_launch_token_t));
@@ -1921,23 +2380,10 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
     }
 
     SE_TRACE(SE_TRACE_DEBUG, "Read and verify ecdsa blob\n");
-    blob_size_read = sizeof(g_ql_global_data.m_ecdsa_blob);
     // Get ECDSA Blob if exists
-    SE_TRACE(SE_TRACE_DEBUG, "Read ECDSA blob.\n");
-    refqt_ret = read_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                                     &blob_size_read,
-                                     ECDSA_BLOB_LABEL);
+    SE_TRACE(SE_TRACE_DEBUG, "Load ECDSA blob.\n");
+    refqt_ret = load_ecdsa_blob();
     if (SGX_QL_SUCCESS != refqt_ret) {
-        // Ignore errors since persistent storage is not required.  Blob in memory may still be OK and continue to try to verify the cached blob.
-        ///todo:  May want to have a library configuration option that requires persistent storage.  Then treat the
-        //failures accordingly
-        SE_TRACE(SE_TRACE_WARNING, "ECDSA Blob doesn't exist is persistent storage.  Try to use the cached version.\n");
-        refqt_ret = SGX_QL_SUCCESS;
-    }
-    else if (blob_size_read != sizeof(g_ql_global_data.m_ecdsa_blob)) {
-        // If the blob was successfully read from persistent storage, verify its size.
-        SE_TRACE(SE_TRACE_ERROR, "Invalid ECDSA Blob file size. blob_size_read = %uld, sizeof(g_ecdsa_blob) = %uld.  Since caller requested use any key, generate a new key.\n", blob_size_read, (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob));
-        refqt_ret = SGX_QL_ATT_KEY_NOT_INITIALIZED;
         goto CLEANUP;
     }
     memset(&qe3_report_body, 0, sizeof(qe3_report_body));
@@ -1959,22 +2405,14 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
     }
     if (REFQE3_SUCCESS != qe3_error) {
         SE_TRACE(SE_TRACE_ERROR, "Invalid ECDSA Blob verification. 0x%04x\n", qe3_error);
+        // Read the blob from persistent storage again next time.
+        g_ql_global_data.m_ecdsa_blob_cached = false;
         refqt_ret = SGX_QL_ATT_KEY_NOT_INITIALIZED;
         goto CLEANUP;
     }
     if (resealed) {
         SE_TRACE(SE_TRACE_DEBUG, "ECDSA Blob was resealed. Store it.\n");
-        refqt_ret = write_persistent_data((uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                                          sizeof(g_ql_global_data.m_ecdsa_blob),
-                                          ECDSA_BLOB_LABEL);
-
-        if (refqt_ret != SGX_QL_SUCCESS) {
-            // Don't need to error since the blob is still good in memory.
-            ///todo:  What is the best way to notify the requester that the blob was not stored?
-            SE_TRACE(SE_TRACE_WARNING, "Warning, unable to store resealed ECDSA blob to persistent storage.\n");
-            SE_TRACE(SE_TRACE_DEBUG, "File storage is not required for the QE_Library.  Library will use ECDSA Blob cached in memory.\n");
-            refqt_ret = SGX_QL_SUCCESS;
-        }
+        store_ecdsa_blob();
     }
     SE_TRACE(SE_TRACE_DEBUG, "Using ECDSA_ID:\n");
     PRINT_BYTE_ARRAY(SE_TRACE_DEBUG, (uint8_t *)&blob_ecdsa_id, sizeof(blob_ecdsa_id));
@@ -2070,20 +2508,36 @@ quote3_error_t ECDSA256Quote::ecdsa_get_quote(const sgx_report_t *p_app_report,
         // This is the normal flow when there is no provider library.
         refqt_ret = SGX_QL_SUCCESS;
     }
-    SE_TRACE(SE_TRACE_DEBUG, "Call QE3 gen_quote\n");
-    sgx_status = gen_quote(qe3_eid,
-                           (uint32_t*)&qe3_error,
-                           (uint8_t*)g_ql_global_data.m_ecdsa_blob,
-                           (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob),
-                           p_app_report,
-                           p_nonce,
-                           p_app_enclave_target_info,
-                           p_qe_report_out,
-                           (uint8_t*)p_quote,
-                           quote_size,
-                           cur_pce_isv_svn,
-                           (uint8_t*)p_certification_data,
-                           p_certification_data ? (uint32_t)(sizeof(*p_certification_data) + cert_data_size) : 0);
+    if (1 == report_count) {
+        SE_TRACE(SE_TRACE_DEBUG, "Call QE3 gen_quote\n");
+        sgx_status = gen_quote(qe3_eid,
+                               (uint32_t*)&qe3_error,
+                               (uint8_t*)g_ql_global_data.m_ecdsa_blob,
+                               (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob),
+                               p_app_reports,
+                               p_nonce,
+                               p_app_enclave_target_info,
+                               p_qe_report_out,
+                               p_quotes,
+                               quote_size,
+                               cur_pce_isv_svn,
+                               (uint8_t*)p_certification_data,
+                               p_certification_data ? (uint32_t)(sizeof(*p_certification_data) + cert_data_size) : 0);
+    }
+    else {
+        SE_TRACE(SE_TRACE_DEBUG, "Call QE3 gen_quotes for %u reports\n", report_count);
+        sgx_status = gen_quotes(qe3_eid,
+                                (uint32_t*)&qe3_error,
+                                (uint8_t*)g_ql_global_data.m_ecdsa_blob,
+                                (uint32_t)sizeof(g_ql_global_data.m_ecdsa_blob),
+                                p_app_reports,
+                                report_count,
+                                p_quotes,
+                                quote_size,
+                                cur_pce_isv_svn,
+                                (uint8_t*)p_certification_data,
+                                p_certification_data ? (uint32_t)(sizeof(*p_certification_data) + cert_data_size) : 0);
+    }
     if (SGX_SUCCESS != sgx_status) {
         SE_TRACE(SE_TRACE_ERROR, "Failed call into the QE3. 0x%04x\n", sgx_status);
         ///todo:  May want to retry on SGX_ERROR_ENCLAVE_LOST caused by power transition
@@ -2334,3 +2788,52 @@ quote3_error_t ECDSA256Quote::get_quote(const sgx_report_t *p_app_report,
     return(ret_val);
 }
 
+/**
+* This function is used to generate quotes for a batch of application enclave reports with an already generated ECDSA
+* attestation key.  It is equivalent to calling get_quote() for each report without a QE report, but the attestation
+* key is verified and the certification data is retrieved once and all of the quotes are signed in a single call into
+* the QE.  The batch is all-or-nothing: if any report fails, the error is returned and the contents of p_quotes are
+* undefined.
+*
+* @param p_app_reports
+*                   Array of report_count application enclave reports generated to target the QE.  Must not be NULL.
+* @param report_count Number of reports in p_app_reports.  Must not be 0.
+* @param p_att_key_id Identifies the quoting enclave and the attestation algorithm requested by the caller.
+* @param p_quotes   Pointer to a buffer of report_count * quote_size bytes.  The quote for p_app_reports[i] is
+*                   returned at p_quotes + i * quote_size.  It must not be NULL.
+* @param quote_size The size in bytes of each quote slot in p_quotes.  It should be at least the value returned by the
+*                   get_quote_size() function.
+*
+* @return SGX_QL_SUCCESS
+* @return SGX_QL_ERROR_UNEXPECTED
+* @return SGX_QL_ERROR_INVALID_PARAMETER
+* @return Errors from ecdsa_get_quotes()
+*/
+quote3_error_t ECDSA256Quote::get_quotes(const sgx_report_t *p_app_reports,
+                                         uint32_t report_count,
+                                         sgx_ql_att_key_id_t* p_att_key_id,
+                                         uint8_t *p_quotes,
+                                         uint32_t quote_size)
+{
+    quote3_error_t ret_val = SGX_QL_ERROR_UNEXPECTED;
+
+    if (NULL == p_att_key_id) {
+        SE_TRACE(SE_TRACE_ERROR, "Invalid p_att_key_id.\n");
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
+
+    // Attestation key must be ECDSAP256.
+    if (SGX_QL_ALG_ECDSA_P256 != p_att_key_id->algorithm_id) {
+        SE_TRACE(SE_TRACE_ERROR, "Invalid attestation algorithm_id.\n");
+        return(SGX_QL_ERROR_INVALID_PARAMETER);
+    }
+
+    ret_val = ecdsa_get_quotes(p_app_reports,
+                               report_count,
+                               NULL,
+                               p_quotes,
+                               quote_size);
+
+    return(ret_val);
+}
+
@@ -58,5 +58,16 @@ typedef quote3_error_t (*sgx_read_persistent_data_func_t)(const uint8_t *p_buf,
                                                           uint32_t *p_buf_size,  
                                                           const char *p_label);
 
+/**
+ * Entry points resolved from the Quote Provider Library.  An entry point is NULL when the loaded library doesn't
+ * export the corresponding API.
+ */
+typedef struct _qpl_functions_t {
+    sgx_get_quote_config_func_t p_get_quote_config;
+    sgx_free_quote_config_func_t p_free_quote_config;
+    sgx_write_persistent_data_func_t p_write_persistent_data;
+    sgx_read_persistent_data_func_t p_read_persistent_data;
+} qpl_functions_t;
+
 #endif
 
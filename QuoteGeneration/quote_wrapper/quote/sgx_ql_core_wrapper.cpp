@@ -515,68 +515,18 @@ extern "C" quote3_error_t sgx_ql_get_quote_size(sgx_ql_att_key_id_t *p_att_key_i
 }
 
 /**
- * This function is c-code wrapper for getting the quote. The function will take the application enclave's REPORT that
- * will be converted into a quote after the QE verifies the REPORT.  Once verified it will sign it with platform's
- * attestation key matching the selected attestation key ID.  If the key is not available, this API may return an error
- * (SGX_QL_ATT_KEY_NOT_INITIALIZED) depending on the algorithm.  In this case, the caller must call sgx_ql_init_quote()
- * to re-generate and certify the attestation key. an attestation key.
+ * Verifies that the attestation key ID selected by the caller is the one supported by the reference QE3 and returns
+ * the key ID to use.
  *
- * The caller can request a REPORT from the QE using a supplied nonce.  This will allow the enclave requesting the quote
- * to verify the QE used to generate the quote. This makes it more difficult for something to spoof a QE and allows the
- * app enclave to catch it earlier.  But since the authenticity of the QE lies in knowledge of the Quote signing key,
- * such spoofing will ultimately be detected by the quote verifier.  QE REPORT.ReportData =
- * SHA256(*p_nonce||*p_quote)||32-0x00's.
+ * @param p_att_key_id The caller's attestation key ID.  If it is NULL, the default ECDSA-P256 key ID is used.
+ * @param pp_local_att_key_id Returns the attestation key ID to pass to the quoting interface.
  *
- * @param p_app_report Pointer to the enclave report that needs the quote. The report needs to be generated using the
- *                     QE's target info returned by the sgx_ql_init_quote() API.  Must not be NULL.
- * @param p_att_key_id The selected attestation key ID from the quote verifier's list.  It includes the QE identity as
- *                     well as the attestation key's algorithm type. It cannot be NULL.
- * @param p_qe_report_info Pointer to a data structure that will contain the information required for the QE to generate
- *                         a REPORT that can be verified by the application enclave.  The inputted data structure
- *                         contains the application's TARGET_INFO, a nonce and a buffer to hold the generated report.
- *                         The QE Report will be generated using the target information and the QE's REPORT.ReportData =
- *                         SHA256(*p_nonce||*p_quote)||32-0x00's.  This parameter is used when the application wants to
- *                         verify the QE's REPORT to provide earlier detection that the QE is not being spoofed by
- *                         untrusted code.  A spoofed QE will ultimately be rejected by the remote verifier.   This
- *                         parameter is optional and will be ignored when NULL.
- * @param p_quote Pointer to the buffer that will contain the quote.
- * @param quote_size Size of the buffer pointed to by p_quote.
- *
- * @return SGX_QL_SUCCESS Successfully generated the quote.
- * @return SGX_QL_ERROR_UNEXPECTED An unexpected internal error occurred.
- * @return SGX_QL_ERROR_INVALID_PARAMETER If either p_app_report or p_quote is null. Or, if quote_size isn't large
- *         enough, p_att_key_id is NULL.
- * @return SGX_QL_ATT_KEY_NOT_INITIALIZED The platform quoting infrastructure does not have the attestation key
- *         available to generate quotes.  sgx_ql_init_quote() must be called again.
- * @return SGX_QL_UNSUPPORTED_ATT_KEY_ID The platform quoting infrastructure does not support the key described in
- *         p_att_key_id.
- * @return SGX_QL_ATT_KEY_CERT_DATA_INVALID The data returned by the platform library's sgx_ql_get_quote_config() is
- *         invalid.
- * @return SGX_QL_OUT_OF_EPC There is not enough EPC memory to load one of the Architecture Enclaves needed to complete
- *         this operation.
- * @return SGX_QL_ERROR_OUT_OF_MEMORY Heap memory allocation error in library or enclave.
- * @return SGX_QL_ENCLAVE_LOAD_ERROR Unable to load the enclaves required to initialize the attestation key.  Could be
- *         due to file I/O error, loading infrastructure error or insufficient enclave memory.
- * @return SGX_QL_ENCLAVE_LOST Enclave lost after power transition or used in child process created by linux:fork().
- * @return SGX_QL_INVALID_REPORT Report MAC check failed on application report.
- * @return SGX_QL_UNABLE_TO_GENERATE_QE_REPORT The QE was unable to generate its own report targeting the application
- *         enclave either because the QE doesn't support this feature or there is an enclave compatibility issue.
- *         Please call again with the p_qe_report_info set to NULL.
+ * @return SGX_QL_SUCCESS
+ * @return SGX_QL_ERROR_INVALID_PARAMETER The QE identity or attestation algorithm is not supported.
  */
-extern "C" quote3_error_t sgx_ql_get_quote(const sgx_report_t *p_app_report,
-                                           sgx_ql_att_key_id_t *p_att_key_id,
-                                           sgx_ql_qe_report_info_t *p_qe_report_info,
-                                           uint8_t *p_quote,
-                                           uint32_t quote_size)
+static quote3_error_t check_get_quote_att_key_id(sgx_ql_att_key_id_t *p_att_key_id,
+                                                 sgx_ql_att_key_id_t **pp_local_att_key_id)
 {
-    quote3_error_t ret_val = SGX_QL_ERROR_UNEXPECTED;
-    sgx_status_t sgx_status;
-    qe3_error_t qe3_error;
-    ECDSA256Quote ecdsa_quote;
-    sgx_ql_att_key_id_t *p_local_att_key_id = NULL;
-
-    // Verify Inputs
-
     // Dispatch the call based on the key_id.  Ref only supports ecdsa with ref QE.
     // Verify the Attestation key identity is supported.
     if(NULL != p_att_key_id)
@@ -608,18 +558,28 @@ extern "C" quote3_error_t sgx_ql_get_quote(const sgx_report_t *p_app_report,
                 return(SGX_QL_ERROR_INVALID_PARAMETER);
             }
         }
-        p_local_att_key_id = p_att_key_id;
+        *pp_local_att_key_id = p_att_key_id;
     }
     else
     {
-        p_local_att_key_id = (sgx_ql_att_key_id_t*)&g_default_ecdsa_p256_att_key_id;
+        *pp_local_att_key_id = (sgx_ql_att_key_id_t*)&g_default_ecdsa_p256_att_key_id;
     }
 
-    ret_val = ecdsa_quote.get_quote(p_app_report,
-                                    p_local_att_key_id,
-                                    p_qe_report_info,
-                                    (sgx_quote3_t*)p_quote,
-                                    quote_size);
+    return(SGX_QL_SUCCESS);
+}
+
+/**
+ * Translates the QE3 and SDK errors returned by the quoting interface's get_quote methods into the quoting library's
+ * errors.  Quoting library errors are returned unchanged.
+ *
+ * @param ret_val The error returned by get_quote() or get_quotes().
+ *
+ * @return The translated error.
+ */
+static quote3_error_t translate_get_quote_errors(quote3_error_t ret_val)
+{
+    sgx_status_t sgx_status;
+    qe3_error_t qe3_error;
 
     if(SGX_QL_SUCCESS != ret_val) {
         if((ret_val < SGX_QL_ERROR_MIN) ||
@@ -712,6 +672,124 @@ extern "C" quote3_error_t sgx_ql_get_quote(const sgx_report_t *p_app_report,
     return(ret_val);
 }
 
+/**
+ * This function is c-code wrapper for getting the quote. The function will take the application enclave's REPORT that
+ * will be converted into a quote after the QE verifies the REPORT.  Once verified it will sign it with platform's
+ * attestation key matching the selected attestation key ID.  If the key is not available, this API may return an error
+ * (SGX_QL_ATT_KEY_NOT_INITIALIZED) depending on the algorithm.  In this case, the caller must call sgx_ql_init_quote()
+ * to re-generate and certify the attestation key. an attestation key.
+ *
+ * The caller can request a REPORT from the QE using a supplied nonce.  This will allow the enclave requesting the quote
+ * to verify the QE used to generate the quote. This makes it more difficult for something to spoof a QE and allows the
+ * app enclave to catch it earlier.  But since the authenticity of the QE lies in knowledge of the Quote signing key,
+ * such spoofing will ultimately be detected by the quote verifier.  QE REPORT.ReportData =
+ * SHA256(*p_nonce||*p_quote)||32-0x00's.
+ *
+ * @param p_app_report Pointer to the enclave report that needs the quote. The report needs to be generated using the
+ *                     QE's target info returned by the sgx_ql_init_quote() API.  Must not be NULL.
+ * @param p_att_key_id The selected attestation key ID from the quote verifier's list.  It includes the QE identity as
+ *                     well as the attestation key's algorithm type. It cannot be NULL.
+ * @param p_qe_report_info Pointer to a data structure that will contain the information required for the QE to generate
+ *                         a REPORT that can be verified by the application enclave.  The inputted data structure
+ *                         contains the application's TARGET_INFO, a nonce and a buffer to hold the generated report.
+ *                         The QE Report will be generated using the target information and the QE's REPORT.ReportData =
+ *                         SHA256(*p_nonce||*p_quote)||32-0x00's.  This parameter is used when the application wants to
+ *                         verify the QE's REPORT to provide earlier detection that the QE is not being spoofed by
+ *                         untrusted code.  A spoofed QE will ultimately be rejected by the remote verifier.   This
+ *                         parameter is optional and will be ignored when NULL.
+ * @param p_quote Pointer to the buffer that will contain the quote.
+ * @param quote_size Size of the buffer pointed to by p_quote.
+ *
+ * @return SGX_QL_SUCCESS Successfully generated the quote.
+ * @return SGX_QL_ERROR_UNEXPECTED An unexpected internal error occurred.
+ * @return SGX_QL_ERROR_INVALID_PARAMETER If either p_app_report or p_quote is null. Or, if quote_size isn't large
+ *         enough, p_att_key_id is NULL.
+ * @return SGX_QL_ATT_KEY_NOT_INITIALIZED The platform quoting infrastructure does not have the attestation key
+ *         available to generate quotes.  sgx_ql_init_quote() must be called again.
+ * @return SGX_QL_UNSUPPORTED_ATT_KEY_ID The platform quoting infrastructure does not support the key described in
+ *         p_att_key_id.
+ * @return SGX_QL_ATT_KEY_CERT_DATA_INVALID The data returned by the platform library's sgx_ql_get_quote_config() is
+ *         invalid.
+ * @return SGX_QL_OUT_OF_EPC There is not enough EPC memory to load one of the Architecture Enclaves needed to complete
+ *         this operation.
+ * @return SGX_QL_ERROR_OUT_OF_MEMORY Heap memory allocation error in library or enclave.
+ * @return SGX_QL_ENCLAVE_LOAD_ERROR Unable to load the enclaves required to initialize the attestation key.  Could be
+ *         due to file I/O error, loading infrastructure error or insufficient enclave memory.
+ * @return SGX_QL_ENCLAVE_LOST Enclave lost after power transition or used in child process created by linux:fork().
+ * @return SGX_QL_INVALID_REPORT Report MAC check failed on application report.
+ * @return SGX_QL_UNABLE_TO_GENERATE_QE_REPORT The QE was unable to generate its own report targeting the application
+ *         enclave either because the QE doesn't support this feature or there is an enclave compatibility issue.
+ *         Please call again with the p_qe_report_info set to NULL.
+ */
+extern "C" quote3_error_t sgx_ql_get_quote(const sgx_report_t *p_app_report,
+                                           sgx_ql_att_key_id_t *p_att_key_id,
+                                           sgx_ql_qe_report_info_t *p_qe_report_info,
+                                           uint8_t *p_quote,
+                                           uint32_t quote_size)
+{
+    quote3_error_t ret_val = SGX_QL_ERROR_UNEXPECTED;
+    ECDSA256Quote ecdsa_quote;
+    sgx_ql_att_key_id_t *p_local_att_key_id = NULL;
+
+    // Verify Inputs
+
+    ret_val = check_get_quote_att_key_id(p_att_key_id, &p_local_att_key_id);
+    if(SGX_QL_SUCCESS != ret_val) {
+        return(ret_val);
+    }
+
+    ret_val = ecdsa_quote.get_quote(p_app_report,
+                                    p_local_att_key_id,
+                                    p_qe_report_info,
+                                    (sgx_quote3_t*)p_quote,
+                                    quote_size);
+
+    return(translate_get_quote_errors(ret_val));
+}
+
+/**
+ * This function is c-code wrapper for generating quotes for a batch of application enclave REPORTs.  It is equivalent
+ * to calling sgx_ql_get_quote() with a NULL p_qe_report_info for each REPORT, but the attestation key is verified and
+ * the certification data is retrieved once, and the QE signs all of the quotes in a single call.  The batch is
+ * all-or-nothing: if any REPORT fails, the error is returned and the contents of p_quotes are undefined.
+ *
+ * @param p_app_reports Array of report_count enclave reports that need quotes.  The reports need to be generated using
+ *                      the QE's target info returned by the sgx_ql_init_quote() API.  Must not be NULL.
+ * @param report_count Number of reports in p_app_reports.  Must not be 0.
+ * @param p_att_key_id The selected attestation key ID from the quote verifier's list.  If it is NULL, the default
+ *                     ECDSA-P256 attestation key is used.
+ * @param p_quotes Pointer to a buffer of report_count * quote_size bytes.  The quote for p_app_reports[i] is returned
+ *                 at p_quotes + i * quote_size.
+ * @param quote_size Size of each quote slot in p_quotes.  It must be at least the value returned by
+ *                   sgx_ql_get_quote_size().
+ *
+ * @return SGX_QL_SUCCESS Successfully generated all of the quotes.
+ * @return Same errors as sgx_ql_get_quote() except SGX_QL_UNABLE_TO_GENERATE_QE_REPORT.
+ */
+extern "C" quote3_error_t sgx_ql_get_quotes(const sgx_report_t *p_app_reports,
+                                            uint32_t report_count,
+                                            sgx_ql_att_key_id_t *p_att_key_id,
+                                            uint8_t *p_quotes,
+                                            uint32_t quote_size)
+{
+    quote3_error_t ret_val = SGX_QL_ERROR_UNEXPECTED;
+    ECDSA256Quote ecdsa_quote;
+    sgx_ql_att_key_id_t *p_local_att_key_id = NULL;
+
+    ret_val = check_get_quote_att_key_id(p_att_key_id, &p_local_att_key_id);
+    if(SGX_QL_SUCCESS != ret_val) {
+        return(ret_val);
+    }
+
+    ret_val = ecdsa_quote.get_quotes(p_app_reports,
+                                     report_count,
+                                     p_local_att_key_id,
+                                     p_quotes,
+                                     quote_size);
+
+    return(translate_get_quote_errors(ret_val));
+}
+
 extern "C" quote3_error_t sgx_ql_get_keyid(sgx_att_key_id_ext_t *p_att_key_id_ext)
 {
     if(NULL == p_att_key_id_ext)
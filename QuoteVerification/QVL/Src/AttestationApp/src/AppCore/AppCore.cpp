@@ -31,28 +31,14 @@
 
 #include "AppCore.h"
 #include "AppOptions.h"
+#include "BulkVerifier.h"
+#include "CrlReader.h"
 #include "IAttestationLibraryAdapter.h"
 #include "StatusPrinter.h"
 
 namespace intel { namespace sgx { namespace dcap {
 
 namespace {
-inline std::string bytesToHexString(const std::vector<uint8_t> &vector)
-{
-    std::string result;
-    result.reserve(vector.size() * 2);   // two digits per character
-
-    static constexpr char hex[] = "0123456789ABCDEF";
-
-    for (const uint8_t c : vector)
-    {
-        result.push_back(hex[c / 16]);
-        result.push_back(hex[c % 16]);
-    }
-
-    return result;
-}
-
 void outputResult(const std::string& step, Status status, std::ostream& logger)
 {
     if (status != STATUS_OK)
@@ -80,21 +66,12 @@ bool AppCore::runVerification(const AppOptions& options, std::ostream& logger) c
 {
     try
     {
-        static constexpr char PEM_HEADER_STRING_X509_CRL[] = "-----BEGIN X509 CRL-----";
         const auto expirationDate = options.expirationDate;
         const auto pckCert = fileReader->readContent(options.pckCertificateFile);
         const auto pckSigningChain = fileReader->readContent(options.pckSigningChainFile);
         const auto pckCertChain = pckSigningChain + pckCert;
-        auto rootCaCrl = fileReader->readContent(options.rootCaCrlFile);
-        if (rootCaCrl.rfind(PEM_HEADER_STRING_X509_CRL, 0) == std::string::npos)
-        {
-            rootCaCrl = bytesToHexString(fileReader->readBinaryContent(options.rootCaCrlFile));
-        }
-        auto intermediateCaCrl = fileReader->readContent(options.intermediateCaCrlFile);
-        if (intermediateCaCrl.rfind(PEM_HEADER_STRING_X509_CRL, 0) == std::string::npos)
-        {
-            intermediateCaCrl = bytesToHexString(fileReader->readBinaryContent(options.intermediateCaCrlFile));
-        }
+        const auto rootCaCrl = readCrl(*fileReader, options.rootCaCrlFile);
+        const auto intermediateCaCrl = readCrl(*fileReader, options.intermediateCaCrlFile);
         const auto trustedRootCACert = fileReader->readContent(options.trustedRootCACertificateFile);
         const auto pckVerifyStatus = attestationLib->verifyPCKCertificate(pckCertChain, rootCaCrl, intermediateCaCrl, trustedRootCACert, expirationDate);
         outputResult("PCK certificate chain", pckVerifyStatus, logger);
@@ -138,4 +115,28 @@ bool AppCore::runVerification(const AppOptions& options, std::ostream& logger) c
     }
 }
 
+bool AppCore::runBulkVerification(const AppOptions& options, std::ostream& logger) const
+{
+    try
+    {
+        BulkVerifier verifier(attestationLib, fileReader);
+        verifier.load(options);
+        logger << "Loaded " << verifier.size() << " quotes for bulk verification" << std::endl;
+
+        const auto report = verifier.run(options.threads, options.iterations);
+        logger << report;
+        return report.failedVerifications == 0;
+    }
+    catch (const IFileReader::ReadFileException& e)
+    {
+        logger << "ERROR while trying to read input files: " << e.what();
+        return false;
+    }
+    catch (const BulkVerifier::InvalidManifestException& e)
+    {
+        logger << "ERROR while trying to load quotes: " << e.what();
+        return false;
+    }
+}
+
 }}}
@@ -49,6 +49,7 @@ public:
     std::string version() const;
 
     bool runVerification(const AppOptions& options, std::ostream& log) const;
+    bool runBulkVerification(const AppOptions& options, std::ostream& log) const;
 
 private:
     std::shared_ptr<IAttestationLibraryAdapter> attestationLib;
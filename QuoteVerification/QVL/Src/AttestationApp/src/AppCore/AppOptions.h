@@ -49,6 +49,10 @@ struct AppOptions
     std::string qeIdentityFile;
     std::string qveIdentityFile;
     time_t expirationDate;
+    std::string bulkManifestFile;
+    std::string bulkDirectory;
+    unsigned int threads = 1;
+    unsigned int iterations = 1;
 };
 
 }}}
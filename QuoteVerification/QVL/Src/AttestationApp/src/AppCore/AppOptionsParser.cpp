@@ -30,6 +30,7 @@
  */
 
 #include "AppOptionsParser.h"
+#include <algorithm>
 #include <chrono>
 
 namespace intel { namespace sgx { namespace dcap {
@@ -45,6 +46,8 @@ namespace {
     static const std::string intermediateCaCrlDefaultPath = "intermediateCaCrl.der";
     static const std::string qeIdentityDefaultPath = "";
     static const std::string qveIdentityDefaultPath = "";
+    static const std::string bulkManifestDefaultPath = "";
+    static const std::string bulkDirectoryDefaultPath = "";
     static const std::string expirationDateDefault = std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
 }
 
@@ -61,12 +64,17 @@ std::unique_ptr<AppOptions> AppOptionsParser::parse(int argc, char **argv, std::
     auto intermediateCaCrlFile = arg_str0(NULL, "intermediateCaCrl", NULL, "Intermediate Ca CRL file path, PEM or DER format [=intermediateCaCrl.der]");
     auto quoteFile = arg_str0(NULL, "quote", NULL, "Quote file path, binary format [=quote.dat]");
     auto expirationDate = arg_str0(NULL, "expirationDate", NULL, "Expiration date in timestamp seconds [=seconds]");
+    auto bulkManifestFile = arg_str0(NULL, "bulkManifest", NULL, "Bulk verification manifest file path, one quote and its collateral files per line [=]");
+    auto bulkDirectory = arg_str0(NULL, "bulkDir", NULL, "Bulk verification directory path, every *.dat file is a quote [=]");
+    auto threads = arg_int0(NULL, "threads", NULL, "Number of bulk verification threads [=1]");
+    auto iterations = arg_int0(NULL, "iterations", NULL, "Number of times every quote is verified in bulk verification [=1]");
     struct arg_lit* help = arg_lit0("h", "help", "Print this message");
     auto end = arg_end(20);
 
     void *argtable[] = {trustedRootCACertificateFile, pckSigningChainFile, pckCertificateFile,
                         tcbSigningChainFile, tcbInfoFile, qeIdentityFile, qveIdentityFile,
-                        rootCaCrlFile, intermediateCaCrlFile, quoteFile, expirationDate, help, end};
+                        rootCaCrlFile, intermediateCaCrlFile, quoteFile, expirationDate,
+                        bulkManifestFile, bulkDirectory, threads, iterations, help, end};
 
     if (arg_nullcheck(argtable) != 0)
     {
@@ -85,6 +93,10 @@ std::unique_ptr<AppOptions> AppOptionsParser::parse(int argc, char **argv, std::
     intermediateCaCrlFile->sval[0] = intermediateCaCrlDefaultPath.c_str();
     quoteFile->sval[0] = quoteDefaultPath.c_str();
     expirationDate->sval[0] = expirationDateDefault.c_str();
+    bulkManifestFile->sval[0] = bulkManifestDefaultPath.c_str();
+    bulkDirectory->sval[0] = bulkDirectoryDefaultPath.c_str();
+    threads->ival[0] = 1;
+    iterations->ival[0] = 1;
 
 
     auto nerrors = arg_parse(argc, argv, argtable);
@@ -114,6 +126,10 @@ std::unique_ptr<AppOptions> AppOptionsParser::parse(int argc, char **argv, std::
     options->intermediateCaCrlFile = std::string(intermediateCaCrlFile->sval[0]);
     options->quoteFile = std::string(quoteFile->sval[0]);
     options->expirationDate = std::stol(expirationDate->sval[0]);
+    options->bulkManifestFile = std::string(bulkManifestFile->sval[0]);
+    options->bulkDirectory = std::string(bulkDirectory->sval[0]);
+    options->threads = static_cast<unsigned int>(std::max(threads->ival[0], 1));
+    options->iterations = static_cast<unsigned int>(std::max(iterations->ival[0], 1));
 
     arg_freetable(argtable, sizeof(argtable)/sizeof(argtable[0]));
 
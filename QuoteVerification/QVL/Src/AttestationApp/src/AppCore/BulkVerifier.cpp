@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "BulkVerifier.h"
+#include "AllocationCounter.h"
+#include "AppOptions.h"
+#include "CrlReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace intel { namespace sgx { namespace dcap {
+
+namespace {
+constexpr char QUOTE_FILE_EXTENSION[] = ".dat";
+
+std::string directoryOf(const std::string& filePath)
+{
+    const auto separator = filePath.find_last_of("/\\");
+    return separator == std::string::npos ? std::string{} : filePath.substr(0, separator + 1);
+}
+
+bool isAbsolute(const std::string& path)
+{
+    return (!path.empty() && (path[0] == '/' || path[0] == '\\')) || (path.size() > 1 && path[1] == ':');
+}
+
+bool endsWith(const std::string& value, const std::string& suffix)
+{
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// nearest rank percentile of sorted latencies, permille to avoid floating point ranks
+std::chrono::nanoseconds percentile(const std::vector<std::chrono::nanoseconds::rep>& sorted, size_t permille)
+{
+    if (sorted.empty())
+    {
+        return std::chrono::nanoseconds{0};
+    }
+    const auto rank = (sorted.size() * permille + 999) / 1000;
+    return std::chrono::nanoseconds{sorted[std::max<size_t>(rank, 1) - 1]};
+}
+
+double toMicroseconds(std::chrono::nanoseconds duration)
+{
+    return static_cast<double>(duration.count()) / 1000.0;
+}
+}
+
+struct BulkVerifier::WorkerResult
+{
+    std::array<std::vector<std::chrono::nanoseconds::rep>, STAGE_COUNT> latencies;
+    std::array<size_t, STAGE_COUNT> failures{};
+    std::array<uint64_t, STAGE_COUNT> allocations{};
+    size_t verifications = 0;
+    size_t failedVerifications = 0;
+};
+
+// Reads every file once, PEM and DER CRLs are provided the same way as in single quote verification
+class BulkVerifier::FileCache
+{
+public:
+    explicit FileCache(const IFileReader& reader): fileReader(reader) {}
+
+    std::shared_ptr<const std::string> text(const std::string& filePath)
+    {
+        auto& content = texts[filePath];
+        if (!content)
+        {
+            content = std::make_shared<const std::string>(fileReader.readContent(filePath));
+        }
+        return content;
+    }
+
+    std::shared_ptr<const std::string> crl(const std::string& filePath)
+    {
+        auto& content = crls[filePath];
+        if (!content)
+        {
+            content = std::make_shared<const std::string>(readCrl(fileReader, filePath));
+        }
+        return content;
+    }
+
+    std::shared_ptr<const std::string> certChain(const std::string& signingChainPath, const std::string& certPath)
+    {
+        auto& content = chains[std::make_pair(signingChainPath, certPath)];
+        if (!content)
+        {
+            content = std::make_shared<const std::string>(*text(signingChainPath) + *text(certPath));
+        }
+        return content;
+    }
+
+    std::shared_ptr<const std::vector<uint8_t>> binary(const std::string& filePath)
+    {
+        auto& content = binaries[filePath];
+        if (!content)
+        {
+            content = std::make_shared<const std::vector<uint8_t>>(fileReader.readBinaryContent(filePath));
+        }
+        return content;
+    }
+
+private:
+    const IFileReader& fileReader;
+    std::map<std::string, std::shared_ptr<const std::string>> texts;
+    std::map<std::string, std::shared_ptr<const std::string>> crls;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<const std::string>> chains;
+    std::map<std::string, std::shared_ptr<const std::vector<uint8_t>>> binaries;
+};
+
+BulkVerifier::BulkVerifier(std::shared_ptr<IAttestationLibraryAdapter> libAdapter, std::shared_ptr<IFileReader> reader)
+    : attestationLib(libAdapter), fileReader(reader)
+{
+}
+
+void BulkVerifier::load(const AppOptions& options)
+{
+    FileCache files(*fileReader);
+    std::vector<Job> loaded;
+    expirationDate = options.expirationDate;
+
+    const auto addJob = [&](const std::map<std::string, std::string>& paths) {
+        const auto path = [&](const std::string& name, const std::string& defaultPath) {
+            const auto it = paths.find(name);
+            return it == paths.end() ? defaultPath : it->second;
+        };
+        Job job;
+        job.pckCert = files.text(path("pckCert", options.pckCertificateFile));
+        job.pckCertChain = files.certChain(path("pckSignChain", options.pckSigningChainFile),
+                                           path("pckCert", options.pckCertificateFile));
+        job.rootCaCrl = files.crl(path("rootCaCrl", options.rootCaCrlFile));
+        job.intermediateCaCrl = files.crl(path("intermediateCaCrl", options.intermediateCaCrlFile));
+        job.trustedRootCaCert = files.text(path("trustedRootCaCert", options.trustedRootCACertificateFile));
+        job.tcbInfo = files.text(path("tcbInfo", options.tcbInfoFile));
+        job.tcbSigningChain = files.text(path("tcbSignChain", options.tcbSigningChainFile));
+        const auto qeIdentityPath = path("qeIdentity", options.qeIdentityFile);
+        if (!qeIdentityPath.empty())
+        {
+            job.qeIdentity = files.text(qeIdentityPath);
+        }
+        job.quote = files.binary(path("quote", options.quoteFile));
+        loaded.push_back(std::move(job));
+    };
+
+    if (!options.bulkManifestFile.empty())
+    {
+        static const std::vector<std::string> fieldNames = {
+            "quote", "pckCert", "pckSignChain", "tcbInfo", "tcbSignChain", "qeIdentity",
+            "rootCaCrl", "intermediateCaCrl", "trustedRootCaCert"};
+
+        const auto baseDirectory = directoryOf(options.bulkManifestFile);
+        std::istringstream manifest(fileReader->readContent(options.bulkManifestFile));
+        std::string line;
+        for (size_t lineNumber = 1; std::getline(manifest, line); ++lineNumber)
+        {
+            std::istringstream fields(line);
+            std::string field;
+            std::map<std::string, std::string> paths;
+            while (fields >> field)
+            {
+                if (paths.empty() && field[0] == '#')
+                {
+                    break;
+                }
+                const auto separator = field.find('=');
+                const auto name = field.substr(0, separator);
+                if (separator == std::string::npos || separator + 1 == field.size()
+                    || std::find(fieldNames.cbegin(), fieldNames.cend(), name) == fieldNames.cend())
+                {
+                    throw InvalidManifestException("BulkVerifier: invalid field \"" + field + "\" in line " +
+                                                   std::to_string(lineNumber) + " of \"" + options.bulkManifestFile + "\"");
+                }
+                const auto filePath = field.substr(separator + 1);
+                paths[name] = isAbsolute(filePath) ? filePath : baseDirectory + filePath;
+            }
+            if (!paths.empty())
+            {
+                addJob(paths);
+            }
+        }
+    }
+    else
+    {
+        for (const auto& fileName : fileReader->listDirectory(options.bulkDirectory))
+        {
+            if (endsWith(fileName, QUOTE_FILE_EXTENSION))
+            {
+                addJob({{"quote", options.bulkDirectory + "/" + fileName}});
+            }
+        }
+    }
+
+    if (loaded.empty())
+    {
+        throw InvalidManifestException("BulkVerifier: no quotes to verify");
+    }
+    jobs = std::move(loaded);
+}
+
+size_t BulkVerifier::size() const
+{
+    return jobs.size();
+}
+
+void BulkVerifier::verify(const Job& job, WorkerResult& result) const
+{
+    bool verified = true;
+    const auto measure = [&](Stage stage, const std::function<Status()>& verification) {
+        const auto allocationsBefore = threadAllocationCount();
+        const auto start = std::chrono::steady_clock::now();
+        const auto status = verification();
+        const auto latency = std::chrono::steady_clock::now() - start;
+        result.allocations[stage] += threadAllocationCount() - allocationsBefore;
+        result.latencies[stage].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+        if (status != STATUS_OK)
+        {
+            ++result.failures[stage];
+            verified = false;
+        }
+    };
+
+    measure(PCK_CERT_CHAIN, [&] {
+        return attestationLib->verifyPCKCertificate(*job.pckCertChain, *job.rootCaCrl, *job.intermediateCaCrl,
+                                                    *job.trustedRootCaCert, expirationDate);
+    });
+    measure(TCB_INFO, [&] {
+        return attestationLib->verifyTCBInfo(*job.tcbInfo, *job.tcbSigningChain, *job.rootCaCrl,
+                                             *job.trustedRootCaCert, expirationDate);
+    });
+    if (job.qeIdentity)
+    {
+        measure(QE_IDENTITY, [&] {
+            return attestationLib->verifyQeIdentity(*job.qeIdentity, *job.tcbSigningChain, *job.rootCaCrl,
+                                                    *job.trustedRootCaCert, expirationDate);
+        });
+    }
+    static const std::string noQeIdentity{};
+    measure(QUOTE, [&] {
+        return attestationLib->verifyQuote(*job.quote, *job.pckCert, *job.intermediateCaCrl, *job.tcbInfo,
+                                           job.qeIdentity ? *job.qeIdentity : noQeIdentity);
+    });
+
+    ++result.verifications;
+    if (!verified)
+    {
+        ++result.failedVerifications;
+    }
+}
+
+BulkVerifier::Report BulkVerifier::run(unsigned int threads, unsigned int iterations) const
+{
+    threads = std::max(threads, 1u);
+    const size_t total = jobs.size() * std::max(iterations, 1u);
+    std::atomic<size_t> next{0};
+    std::vector<WorkerResult> results(threads);
+    for (auto& result : results)
+    {
+        for (auto& latencies : result.latencies)
+        {
+            latencies.reserve(total / threads + 1);
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (auto& result : results)
+    {
+        workers.emplace_back([&] {
+            for (auto index = next++; index < total; index = next++)
+            {
+                verify(jobs[index % jobs.size()], result);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    Report report;
+    report.threads = threads;
+    report.wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    for (size_t stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        std::vector<std::chrono::nanoseconds::rep> latencies;
+        auto& stageReport = report.stages[stage];
+        for (const auto& result : results)
+        {
+            latencies.insert(latencies.end(), result.latencies[stage].cbegin(), result.latencies[stage].cend());
+            stageReport.failures += result.failures[stage];
+            stageReport.allocations += result.allocations[stage];
+        }
+        std::sort(latencies.begin(), latencies.end());
+        stageReport.calls = latencies.size();
+        stageReport.p50 = percentile(latencies, 500);
+        stageReport.p99 = percentile(latencies, 990);
+        stageReport.p999 = percentile(latencies, 999);
+    }
+    for (const auto& result : results)
+    {
+        report.verifications += result.verifications;
+        report.failedVerifications += result.failedVerifications;
+    }
+    return report;
+}
+
+const char* BulkVerifier::stageName(Stage stage)
+{
+    switch (stage)
+    {
+        case PCK_CERT_CHAIN:
+            return "PCK certificate chain";
+        case TCB_INFO:
+            return "TCB info";
+        case QE_IDENTITY:
+            return "QeIdentity";
+        case QUOTE:
+            return "Quote";
+        default:
+            return "Unknown";
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const BulkVerifier::Report& report)
+{
+    const auto seconds = static_cast<double>(report.wallTime.count()) / 1e9;
+    const auto throughput = seconds > 0 ? static_cast<double>(report.verifications) / seconds : 0.0;
+    const auto flags = os.flags();
+    os << std::fixed << std::setprecision(1)
+       << "Verified " << report.verifications << " quotes on " << report.threads << " threads in "
+       << seconds << " s, " << throughput << " verifications/s, " << report.failedVerifications << " failed\n"
+       << std::left << std::setw(24) << "Stage" << std::right
+       << std::setw(10) << "calls" << std::setw(10) << "failed"
+       << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]" << std::setw(12) << "p999 [us]"
+       << std::setw(14) << "allocs/call" << "\n";
+    for (size_t stage = 0; stage < BulkVerifier::STAGE_COUNT; ++stage)
+    {
+        const auto& stageReport = report.stages[stage];
+        const auto allocationsPerCall = stageReport.calls > 0
+                ? static_cast<double>(stageReport.allocations) / static_cast<double>(stageReport.calls) : 0.0;
+        os << std::left << std::setw(24) << BulkVerifier::stageName(static_cast<BulkVerifier::Stage>(stage)) << std::right
+           << std::setw(10) << stageReport.calls << std::setw(10) << stageReport.failures
+           << std::setw(12) << toMicroseconds(stageReport.p50)
+           << std::setw(12) << toMicroseconds(stageReport.p99)
+           << std::setw(12) << toMicroseconds(stageReport.p999)
+           << std::setw(14) << allocationsPerCall << "\n";
+    }
+    os.flags(flags);
+    return os;
+}
+
+}}}
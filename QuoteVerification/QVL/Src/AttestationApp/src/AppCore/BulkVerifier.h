@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_BULKVERIFIER_H
+#define SGXECDSAATTESTATION_BULKVERIFIER_H
+
+#include "IFileReader.h"
+#include "IAttestationLibraryAdapter.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap {
+
+struct AppOptions;
+
+/**
+ * Verifies many quotes on a pool of worker threads and measures every verification stage.
+ *
+ * Jobs come from a manifest or from a directory of quotes. Each line of a manifest describes one quote as
+ * whitespace separated name=path pairs, names are the same as the command line options: quote, pckCert,
+ * pckSignChain, tcbInfo, tcbSignChain, qeIdentity, rootCaCrl, intermediateCaCrl and trustedRootCaCert.
+ * Files not given on a line are taken from the command line options, relative paths are relative
+ * to the manifest. Empty lines and lines starting with '#' are skipped. In a directory every *.dat file
+ * is a quote verified against collateral from the command line options.
+ *
+ * Every file is read once before verification starts, jobs with the same collateral share it.
+ */
+class BulkVerifier
+{
+public:
+    struct InvalidManifestException : public std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
+
+    enum Stage
+    {
+        PCK_CERT_CHAIN,
+        TCB_INFO,
+        QE_IDENTITY,
+        QUOTE,
+        STAGE_COUNT
+    };
+
+    struct StageReport
+    {
+        size_t calls = 0;
+        size_t failures = 0;
+        std::chrono::nanoseconds p50{0};
+        std::chrono::nanoseconds p99{0};
+        std::chrono::nanoseconds p999{0};
+        uint64_t allocations = 0;
+    };
+
+    struct Report
+    {
+        size_t verifications = 0;
+        size_t failedVerifications = 0;
+        unsigned int threads = 0;
+        std::chrono::nanoseconds wallTime{0};
+        std::array<StageReport, STAGE_COUNT> stages;
+    };
+
+    BulkVerifier(std::shared_ptr<IAttestationLibraryAdapter> attestationLib, std::shared_ptr<IFileReader> fileReader);
+
+    /**
+     * Load jobs described by options, bulkManifestFile takes precedence over bulkDirectory.
+     * @throws IFileReader::ReadFileException, InvalidManifestException
+     */
+    void load(const AppOptions& options);
+
+    /**
+     * Get number of loaded jobs.
+     */
+    size_t size() const;
+
+    /**
+     * Verify all loaded jobs.
+     * @param threads - number of worker threads, at least one is used
+     * @param iterations - number of times every job is verified
+     */
+    Report run(unsigned int threads, unsigned int iterations) const;
+
+    static const char* stageName(Stage stage);
+
+private:
+    struct Job
+    {
+        std::shared_ptr<const std::string> pckCertChain;
+        std::shared_ptr<const std::string> pckCert;
+        std::shared_ptr<const std::string> rootCaCrl;
+        std::shared_ptr<const std::string> intermediateCaCrl;
+        std::shared_ptr<const std::string> trustedRootCaCert;
+        std::shared_ptr<const std::string> tcbInfo;
+        std::shared_ptr<const std::string> tcbSigningChain;
+        std::shared_ptr<const std::string> qeIdentity;
+        std::shared_ptr<const std::vector<uint8_t>> quote;
+    };
+
+    struct WorkerResult;
+    class FileCache;
+
+    void verify(const Job& job, WorkerResult& result) const;
+
+    std::shared_ptr<IAttestationLibraryAdapter> attestationLib;
+    std::shared_ptr<IFileReader> fileReader;
+    std::vector<Job> jobs;
+    time_t expirationDate = 0;
+};
+
+std::ostream& operator<<(std::ostream& os, const BulkVerifier::Report& report);
+
+}}}
+
+#endif //SGXECDSAATTESTATION_BULKVERIFIER_H
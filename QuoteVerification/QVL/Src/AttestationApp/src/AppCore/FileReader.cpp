@@ -31,8 +31,15 @@
 
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 #include "FileReader.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
 
 namespace intel { namespace sgx { namespace dcap {
 
@@ -66,4 +73,41 @@ std::vector<uint8_t> FileReader::readBinaryContent(const std::string& filePath)
     file.read(reinterpret_cast<char*>(retVal.data()), fileSize);
     return retVal;
 }
+
+std::vector<std::string> FileReader::listDirectory(const std::string& directoryPath) const
+{
+    std::vector<std::string> fileNames;
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    const auto handle = FindFirstFileA((directoryPath + "\\*").c_str(), &entry);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        throw ReadFileException(std::string("FileReader: failed to open \"") + directoryPath + "\" directory!");
+    }
+    do
+    {
+        if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+        {
+            fileNames.emplace_back(entry.cFileName);
+        }
+    } while (FindNextFileA(handle, &entry));
+    FindClose(handle);
+#else
+    const auto directory = opendir(directoryPath.c_str());
+    if (directory == nullptr)
+    {
+        throw ReadFileException(std::string("FileReader: failed to open \"") + directoryPath + "\" directory!");
+    }
+    while (const auto entry = readdir(directory))
+    {
+        if (entry->d_type == DT_REG || entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+        {
+            fileNames.emplace_back(entry->d_name);
+        }
+    }
+    closedir(directory);
+#endif
+    std::sort(fileNames.begin(), fileNames.end());
+    return fileNames;
+}
 }}}
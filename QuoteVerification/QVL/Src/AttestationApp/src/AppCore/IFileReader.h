@@ -50,6 +50,7 @@ struct IFileReader
 
     virtual std::string readContent(const std::string& filePath) const = 0;
     virtual std::vector<uint8_t> readBinaryContent(const std::string& filePath) const = 0;
+    virtual std::vector<std::string> listDirectory(const std::string& directoryPath) const = 0;
 };
 
 }}}
@@ -55,7 +55,8 @@ int main(int argc, char* argv[])
     }
 
     std::cout << "Running QVL version: " << app.version() << std::endl;
-    bool result = app.runVerification(*options, logger);
+    const bool bulk = !options->bulkManifestFile.empty() || !options->bulkDirectory.empty();
+    bool result = bulk ? app.runBulkVerification(*options, logger) : app.runVerification(*options, logger);
     std::cout << "Verification results: " << std::boolalpha << result << std::noboolalpha << "\n\n";
     std::cout << "AppLogs:\n" << logger.str() << std::endl;
 
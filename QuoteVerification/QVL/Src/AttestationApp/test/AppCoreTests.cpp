@@ -60,7 +60,11 @@ struct AppCoreTests: public Test
         "Quote/file/path",
         "QeIdentity/file/path/",
         "QveIdentity/file/path/",
-        0};
+        0,
+        "",
+        "",
+        1,
+        1};
 
     std::vector<uint8_t> quoteContent = {1, 2, 255, 0, 0, 43, 58};
     std::string pckCertContent = "pckCert content";
@@ -213,7 +217,11 @@ TEST_F(AppCoreTests, shouldVerifyWhenQeIdentityAndQveIdentityFileWasNotGiven)
             "",
             "",
             "",
-            0
+            0,
+            "",
+            "",
+            1,
+            1
     };
 
     EXPECT_CALL(*fileReaderMock, readContent(_)).WillRepeatedly(Return("content"));
@@ -242,7 +250,11 @@ TEST_F(AppCoreTests, shouldVerifyWhenQeIdentityFileWasNotGiven)
             "",
             "",
             "QveIdentity/file/path/",
-            0
+            0,
+            "",
+            "",
+            1,
+            1
     };
 
     EXPECT_CALL(*fileReaderMock, readContent(_)).WillRepeatedly(Return("content"));
@@ -270,7 +282,11 @@ TEST_F(AppCoreTests, shouldVerifyWhenQveIdentityFileWasNotGiven)
             "",
             "QeIdentity/file/path/",
             "",
-            0
+            0,
+            "",
+            "",
+            1,
+            1
     };
 
     EXPECT_CALL(*fileReaderMock, readContent(_)).WillRepeatedly(Return("content"));
@@ -53,7 +53,7 @@ struct AppOptionsParserTests: public Test
     const std::string intermediateCaCrlDefaultPath = "intermediateCaCrl.der";
     const std::string qeIdentityDefaultPath = "qeIdentity.json";
 
-    const std::string helpOutput = "Usage: [-h] [--trustedRootCaCert=<string>] [--pckSignChain=<string>] [--pckCert=<string>] [--tcbSignChain=<string>] [--tcbInfo=<string>] [--qeIdentity=<string>] [--qveIdentity=<string>] [--rootCaCrl=<string>] [--intermediateCaCrl=<string>] [--quote=<string>] [--expirationDate=<string>]\n\n"
+    const std::string helpOutput = "Usage: [-h] [--trustedRootCaCert=<string>] [--pckSignChain=<string>] [--pckCert=<string>] [--tcbSignChain=<string>] [--tcbInfo=<string>] [--qeIdentity=<string>] [--qveIdentity=<string>] [--rootCaCrl=<string>] [--intermediateCaCrl=<string>] [--quote=<string>] [--expirationDate=<string>] [--bulkManifest=<string>] [--bulkDir=<string>] [--threads=<int>] [--iterations=<int>]\n\n"
             "--trustedRootCaCert=<string>             Trusted root CA Certificate file path, PEM format [=trustedRootCaCert.pem]\n"
             "--pckSignChain=<string>                  PCK Signing Certificate chain file path, PEM format [=pckSignChain.pem]\n"
             "--pckCert=<string>                       PCK Certificate file path, PEM format [=pckCert.pem]\n"
@@ -65,6 +65,10 @@ struct AppOptionsParserTests: public Test
             "--intermediateCaCrl=<string>             Intermediate Ca CRL file path, PEM or DER format [=intermediateCaCrl.der]\n"
             "--quote=<string>                         Quote file path, binary format [=quote.dat]\n"
             "--expirationDate=<string>                Expiration date in timestamp seconds [=seconds]\n"
+            "--bulkManifest=<string>                  Bulk verification manifest file path, one quote and its collateral files per line [=]\n"
+            "--bulkDir=<string>                       Bulk verification directory path, every *.dat file is a quote [=]\n"
+            "--threads=<int>                          Number of bulk verification threads [=1]\n"
+            "--iterations=<int>                       Number of times every quote is verified in bulk verification [=1]\n"
             "-h, --help                               Print this message\n";
 
     // return true if difference between input time and current time is less than 3 seconds
@@ -95,6 +99,26 @@ TEST_F(AppOptionsParserTests, ReturnsDefaultValuesWhenNoArgumentsGivenPrintsNoth
     EXPECT_EQ(options->tcbSigningChainFile, tcbSignChainDefaultPath);
     EXPECT_EQ(options->quoteFile, quoteDefaultPath);
     EXPECT_TRUE(checkTimeWithHysteresis(options->expirationDate));
+    EXPECT_TRUE(options->bulkManifestFile.empty());
+    EXPECT_TRUE(options->bulkDirectory.empty());
+    EXPECT_EQ(options->threads, 1);
+    EXPECT_EQ(options->iterations, 1);
+}
+
+TEST_F(AppOptionsParserTests, ReturnsBulkValuesWhenBulkParametersPassedPrintsNothing)
+{
+    std::vector<const char*> vec {"./AppCommand", "--bulkManifest=quotes/manifest.txt", "--bulkDir=quotes",
+                                  "--threads=8", "--iterations=0"};
+    std::ostringstream logger;
+
+    auto options = parser.parse((int32_t) vec.size(), const_cast<char**>(vec.data()), logger);
+
+    EXPECT_TRUE(options != nullptr);
+    EXPECT_TRUE(logger.str().empty());
+    EXPECT_EQ(options->bulkManifestFile, "quotes/manifest.txt");
+    EXPECT_EQ(options->bulkDirectory, "quotes");
+    EXPECT_EQ(options->threads, 8);
+    EXPECT_EQ(options->iterations, 1);
 }
 
 TEST_F(AppOptionsParserTests, ReturnsGivenValuesWhenSomeParametersPassedOtherAsDefaultsPrintsNothing)
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "AppCore/AppCore.h"
+#include "AppCore/AppOptions.h"
+#include "AppCore/BulkVerifier.h"
+#include "Mocks/AttestationLibraryAdapterMock.h"
+#include "Mocks/FileReaderMock.h"
+
+using namespace ::testing;
+using namespace intel::sgx::dcap;
+
+struct BulkVerifierTests: public Test
+{
+    std::shared_ptr<StrictMock<test::AttestationLibraryAdapterMock>> attestationLibraryMock =
+        std::make_shared<StrictMock<test::AttestationLibraryAdapterMock>>();
+    std::shared_ptr<StrictMock<test::FileReaderMock>> fileReaderMock =
+        std::make_shared<StrictMock<test::FileReaderMock>>();
+    std::stringstream log;
+    BulkVerifier verifier{attestationLibraryMock, fileReaderMock};
+
+    AppOptions options{
+        "pckCert.pem",
+        "pckSignChain.pem",
+        "rootCaCrl.pem",
+        "intermediateCaCrl.pem",
+        "trustedRootCaCert.pem",
+        "tcbInfo.json",
+        "tcbSignChain.pem",
+        "quote.dat",
+        "",
+        "",
+        0,
+        "",
+        "",
+        1,
+        1};
+
+    std::vector<uint8_t> quoteContent = {1, 2, 255, 0, 0, 43, 58};
+
+    void expectCollateralReadOnce()
+    {
+        EXPECT_CALL(*fileReaderMock, readContent("pckCert.pem")).WillOnce(Return("pckCert"));
+        EXPECT_CALL(*fileReaderMock, readContent("pckSignChain.pem")).WillOnce(Return("pckSignChain"));
+        EXPECT_CALL(*fileReaderMock, readContent("rootCaCrl.pem")).WillOnce(Return("-----BEGIN X509 CRL-----root"));
+        EXPECT_CALL(*fileReaderMock, readContent("intermediateCaCrl.pem")).WillOnce(Return("-----BEGIN X509 CRL-----intermediate"));
+        EXPECT_CALL(*fileReaderMock, readContent("trustedRootCaCert.pem")).WillOnce(Return("trustedRoot"));
+        EXPECT_CALL(*fileReaderMock, readContent("tcbInfo.json")).WillOnce(Return("tcbInfo"));
+        EXPECT_CALL(*fileReaderMock, readContent("tcbSignChain.pem")).WillOnce(Return("tcbSignChain"));
+    }
+};
+
+TEST_F(BulkVerifierTests, shouldLoadManifestReadingSharedCollateralOnce)
+{
+    options.bulkManifestFile = "corpus/manifest.txt";
+    EXPECT_CALL(*fileReaderMock, readContent(options.bulkManifestFile)).WillOnce(Return(
+        "# quotes of one platform\n"
+        "quote=quote1.dat\n"
+        "\n"
+        "quote=quote2.dat qeIdentity=/collateral/qeIdentity.json\n"));
+    expectCollateralReadOnce();
+    EXPECT_CALL(*fileReaderMock, readContent("/collateral/qeIdentity.json")).WillOnce(Return("qeIdentity"));
+    EXPECT_CALL(*fileReaderMock, readBinaryContent("corpus/quote1.dat")).WillOnce(Return(quoteContent));
+    EXPECT_CALL(*fileReaderMock, readBinaryContent("corpus/quote2.dat")).WillOnce(Return(quoteContent));
+
+    verifier.load(options);
+
+    EXPECT_EQ(2, verifier.size());
+}
+
+TEST_F(BulkVerifierTests, shouldLoadEveryQuoteOfDirectory)
+{
+    options.bulkDirectory = "corpus";
+    EXPECT_CALL(*fileReaderMock, listDirectory("corpus")).WillOnce(Return(std::vector<std::string>{"a.dat", "b.dat", "readme.txt"}));
+    expectCollateralReadOnce();
+    EXPECT_CALL(*fileReaderMock, readBinaryContent("corpus/a.dat")).WillOnce(Return(quoteContent));
+    EXPECT_CALL(*fileReaderMock, readBinaryContent("corpus/b.dat")).WillOnce(Return(quoteContent));
+
+    verifier.load(options);
+
+    EXPECT_EQ(2, verifier.size());
+}
+
+TEST_F(BulkVerifierTests, shouldRejectUnknownManifestField)
+{
+    options.bulkManifestFile = "manifest.txt";
+    EXPECT_CALL(*fileReaderMock, readContent(_)).WillRepeatedly(Return("content"));
+    EXPECT_CALL(*fileReaderMock, readBinaryContent(_)).WillRepeatedly(Return(quoteContent));
+    EXPECT_CALL(*fileReaderMock, readContent(options.bulkManifestFile)).WillOnce(Return("quote=quote1.dat\nquotes=quote2.dat\n"));
+
+    try
+    {
+        verifier.load(options);
+        FAIL();
+    }
+    catch (const BulkVerifier::InvalidManifestException& e)
+    {
+        EXPECT_THAT(e.what(), HasSubstr("line 2"));
+    }
+}
+
+TEST_F(BulkVerifierTests, shouldRejectEmptyManifest)
+{
+    options.bulkManifestFile = "manifest.txt";
+    EXPECT_CALL(*fileReaderMock, readContent(options.bulkManifestFile)).WillOnce(Return("# nothing\n"));
+
+    EXPECT_THROW(verifier.load(options), BulkVerifier::InvalidManifestException);
+}
+
+TEST_F(BulkVerifierTests, shouldMeasureEveryStageOfEveryVerification)
+{
+    options.bulkDirectory = "corpus";
+    options.qeIdentityFile = "qeIdentity.json";
+    EXPECT_CALL(*fileReaderMock, listDirectory("corpus")).WillOnce(Return(std::vector<std::string>{"a.dat", "b.dat"}));
+    expectCollateralReadOnce();
+    EXPECT_CALL(*fileReaderMock, readContent("qeIdentity.json")).WillOnce(Return("qeIdentity"));
+    EXPECT_CALL(*fileReaderMock, readBinaryContent(_)).WillRepeatedly(Return(quoteContent));
+    verifier.load(options);
+
+    EXPECT_CALL(*attestationLibraryMock, verifyPCKCertificate("pckSignChainpckCert", "-----BEGIN X509 CRL-----root",
+        "-----BEGIN X509 CRL-----intermediate", "trustedRoot", _)).Times(6).WillRepeatedly(Return(STATUS_OK));
+    EXPECT_CALL(*attestationLibraryMock, verifyTCBInfo("tcbInfo", "tcbSignChain", "-----BEGIN X509 CRL-----root", "trustedRoot", _))
+        .Times(6).WillRepeatedly(Return(STATUS_OK));
+    EXPECT_CALL(*attestationLibraryMock, verifyQeIdentity("qeIdentity", "tcbSignChain", "-----BEGIN X509 CRL-----root", "trustedRoot", _))
+        .Times(6).WillRepeatedly(Return(STATUS_OK));
+    EXPECT_CALL(*attestationLibraryMock, verifyQuote(quoteContent, "pckCert", "-----BEGIN X509 CRL-----intermediate", "tcbInfo", "qeIdentity"))
+        .Times(6).WillOnce(Return(STATUS_TCB_OUT_OF_DATE)).WillRepeatedly(Return(STATUS_OK));
+
+    const auto report = verifier.run(4, 3);
+
+    EXPECT_EQ(6, report.verifications);
+    EXPECT_EQ(1, report.failedVerifications);
+    EXPECT_EQ(4, report.threads);
+    for (const auto& stage : report.stages)
+    {
+        EXPECT_EQ(6, stage.calls);
+        EXPECT_LE(stage.p50, stage.p99);
+        EXPECT_LE(stage.p99, stage.p999);
+    }
+    EXPECT_EQ(1, report.stages[BulkVerifier::QUOTE].failures);
+    EXPECT_EQ(0, report.stages[BulkVerifier::PCK_CERT_CHAIN].failures);
+
+    log << report;
+    EXPECT_THAT(log.str(), HasSubstr("Verified 6 quotes on 4 threads"));
+    EXPECT_THAT(log.str(), HasSubstr("PCK certificate chain"));
+    EXPECT_THAT(log.str(), HasSubstr("p999 [us]"));
+}
+
+TEST_F(BulkVerifierTests, shouldReportFailureThroughAppCore)
+{
+    AppCore app{attestationLibraryMock, fileReaderMock};
+    options.bulkManifestFile = "manifest.txt";
+    EXPECT_CALL(*fileReaderMock, readContent(options.bulkManifestFile))
+        .WillOnce(Throw(IFileReader::ReadFileException("manifest missing")));
+
+    EXPECT_FALSE(app.runBulkVerification(options, log));
+    EXPECT_THAT(log.str(), HasSubstr("manifest missing"));
+}
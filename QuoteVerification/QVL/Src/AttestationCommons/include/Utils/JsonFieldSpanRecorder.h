@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef QVL_JSONFIELDSPANRECORDER_H
+#define QVL_JSONFIELDSPANRECORDER_H
+
+#include <rapidjson/document.h>
+#include <rapidjson/stream.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap {
+
+/**
+ * Builds the document from SAX events and records where the object and array
+ * values of root object members begin and end in the parsed text.
+ */
+class JsonFieldSpanRecorder
+{
+public:
+    using FieldSpans = std::vector<std::pair<std::string, std::pair<size_t, size_t>>>;
+
+    JsonFieldSpanRecorder(rapidjson::Document& document, const rapidjson::StringStream& stream, FieldSpans& spans)
+        : targetDocument(document), inputStream(stream), recordedSpans(spans)
+    {}
+
+    bool Null() { return targetDocument.Null(); }
+    bool Bool(bool b) { return targetDocument.Bool(b); }
+    bool Int(int i) { return targetDocument.Int(i); }
+    bool Uint(unsigned i) { return targetDocument.Uint(i); }
+    bool Int64(int64_t i) { return targetDocument.Int64(i); }
+    bool Uint64(uint64_t i) { return targetDocument.Uint64(i); }
+    bool Double(double d) { return targetDocument.Double(d); }
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) { return targetDocument.RawNumber(str, length, copy); }
+    bool String(const char* str, rapidjson::SizeType length, bool copy) { return targetDocument.String(str, length, copy); }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if(depth == 1)
+        {
+            key.assign(str, length);
+        }
+        return targetDocument.Key(str, length, copy);
+    }
+
+    bool StartObject() { startContainer(); return targetDocument.StartObject(); }
+    bool EndObject(rapidjson::SizeType memberCount) { endContainer(); return targetDocument.EndObject(memberCount); }
+    bool StartArray() { startContainer(); return targetDocument.StartArray(); }
+    bool EndArray(rapidjson::SizeType elementCount) { endContainer(); return targetDocument.EndArray(elementCount); }
+
+private:
+    // The reader reports a container once its opening and closing brackets are consumed
+    void startContainer()
+    {
+        if(depth == 1)
+        {
+            begin = inputStream.Tell() - 1;
+        }
+        ++depth;
+    }
+
+    void endContainer()
+    {
+        --depth;
+        if(depth == 1)
+        {
+            recordedSpans.emplace_back(key, std::make_pair(begin, inputStream.Tell() - begin));
+        }
+    }
+
+    rapidjson::Document& targetDocument;
+    const rapidjson::StringStream& inputStream;
+    FieldSpans& recordedSpans;
+    std::string key;
+    size_t begin = 0;
+    unsigned int depth = 0;
+};
+
+}}} // namespace intel { namespace sgx { namespace dcap {
+
+#endif //QVL_JSONFIELDSPANRECORDER_H
@@ -34,26 +34,42 @@
 #include "X509Constants.h"
 
 #include <algorithm>
+#include <utility>
 
 namespace intel { namespace sgx { namespace dcap {
 
 
 Status CertificateChain::parse(const std::string& pemCertChain)
 {
-    const auto certStrs = splitChain(pemCertChain);
+    return parseCerts(splitChain(pemCertChain), [](const std::string &certPem) {
+        return dcap::parser::x509::Certificate::parse(certPem);
+    });
+}
+
+Status CertificateChain::parseDer(const std::vector<std::vector<uint8_t>>& derCertChain)
+{
+    return parseCerts(derCertChain, [](const std::vector<uint8_t> &certDer) {
+        return dcap::parser::x509::Certificate::parseDer(certDer);
+    });
+}
 
-    certs.reserve(certStrs.size());
-    for(const auto& certPem : certStrs)
+template<typename EncodedCert, typename DecodeFunction>
+Status CertificateChain::parseCerts(const std::vector<EncodedCert> &certStrs, DecodeFunction decode)
+{
+    // Every certificate is decoded exactly once, the PCK certificate is upcast in place below
+    std::vector<std::shared_ptr<dcap::parser::x509::Certificate>> parsedCerts;
+    parsedCerts.reserve(certStrs.size());
+    for(const auto& encodedCert : certStrs)
     {
         try {
-            auto cert = std::make_shared<dcap::parser::x509::Certificate>(dcap::parser::x509::Certificate::parse(certPem));
+            auto cert = std::make_shared<dcap::parser::x509::Certificate>(decode(encodedCert));
 
             if (cert->getSubject() == cert->getIssuer())
             {
                 rootCert = cert;
             }
 
-            certs.emplace_back(cert);
+            parsedCerts.emplace_back(cert);
         }
         // any cert in chain has wrong format
         // then whole chain should be considered invalid
@@ -67,11 +83,11 @@ Status CertificateChain::parse(const std::string& pemCertChain)
             // we do not know which cert we failed to parse (subject is also an extension)
             // Is that RootCA? IntermediateCA? PCKCert? TCBSigningCert?
             // We will do some guessing... I mean some heuristics
-            if (certs.empty()) // we failed parsing first cert, in most cases it will be a root CA
+            if (parsedCerts.empty()) // we failed parsing first cert, in most cases it will be a root CA
             {
                 return STATUS_SGX_ROOT_CA_INVALID_EXTENSIONS;
             }
-            if (certs.size() == 1) // second cert wll be probably an intermediate CA
+            if (parsedCerts.size() == 1) // second cert wll be probably an intermediate CA
             {
                 if (certStrs.size() == 2)
                 {
@@ -86,14 +102,14 @@ Status CertificateChain::parse(const std::string& pemCertChain)
         }
     }
 
-    for(auto const &cert: certs)
+    for(auto &cert: parsedCerts)
     {
-        auto signedCertIter = std::find_if(certs.cbegin(), certs.cend(), [cert](const std::shared_ptr<const dcap::parser::x509::Certificate> &found)
+        auto signedCertIter = std::find_if(parsedCerts.cbegin(), parsedCerts.cend(), [&cert](const std::shared_ptr<dcap::parser::x509::Certificate> &found)
         {
             return found->getSubject() != cert->getSubject()
                    && found->getIssuer() == cert->getSubject();
         });
-        if(signedCertIter == certs.cend())
+        if(signedCertIter == parsedCerts.cend())
         {
             topmostCert = cert;
         }
@@ -101,7 +117,18 @@ Status CertificateChain::parse(const std::string& pemCertChain)
         {
             try
             {
-                pckCert = std::make_shared<dcap::parser::x509::PckCertificate>(dcap::parser::x509::PckCertificate(*cert));
+                // take over already parsed members instead of copying them, only SGX extensions are decoded here
+                auto pck = std::make_shared<dcap::parser::x509::PckCertificate>(std::move(*cert));
+                if (topmostCert == cert)
+                {
+                    topmostCert = pck;
+                }
+                if (rootCert == cert)
+                {
+                    rootCert = pck;
+                }
+                cert = pck;
+                pckCert = pck;
             }
             catch (const dcap::parser::FormatException&)
             {
@@ -114,6 +141,8 @@ Status CertificateChain::parse(const std::string& pemCertChain)
         }
     }
 
+    certs.assign(parsedCerts.cbegin(), parsedCerts.cend());
+
     if (length() == 0)
     {
         return STATUS_UNSUPPORTED_CERT_FORMAT;
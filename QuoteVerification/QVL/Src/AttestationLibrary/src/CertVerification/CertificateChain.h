@@ -64,6 +64,14 @@ public:
     */
     virtual Status parse(const std::string& pemCertChain);
 
+    /**
+    * Parse certificate chain of DER encoded certificates, with the same checks as parse.
+    *
+    * @param derCertChain - DER encoded certificates
+    * @return true if chain has been successfully parsed
+    */
+    virtual Status parseDer(const std::vector<std::vector<uint8_t>>& derCertChain);
+
     /**
     * Get length of the parsed chain
     * @return chain length.
@@ -117,6 +125,8 @@ private:
     BaseVerifier _baseVerifier{};
 
     std::vector<std::string> splitChain(const std::string &pemChain) const;
+    template<typename EncodedCert, typename DecodeFunction>
+    Status parseCerts(const std::vector<EncodedCert> &encodedCerts, DecodeFunction decode);
     std::vector<std::shared_ptr<const dcap::parser::x509::Certificate>> certs{};
     std::shared_ptr<const dcap::parser::x509::Certificate> rootCert{};
     std::shared_ptr<const dcap::parser::x509::Certificate> topmostCert{};
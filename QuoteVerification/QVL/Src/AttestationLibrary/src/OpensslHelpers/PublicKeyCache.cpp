@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "PublicKeyCache.h"
+#include "KeyUtils.h"
+
+#include <algorithm>
+
+namespace intel { namespace sgx { namespace dcap { namespace crypto {
+
+PreparedPublicKey::PreparedPublicKey(EVP_PKEY_uptr key, EVP_MD_CTX_uptr verifyContext)
+        : _key(std::move(key)), _verifyContext(std::move(verifyContext))
+{
+}
+
+std::shared_ptr<const PreparedPublicKey> PreparedPublicKey::prepare(const std::array<uint8_t, 64> &rawKey)
+{
+    const auto ecKey = rawToP256PubKey(rawKey);
+    if (!ecKey)
+    {
+        return nullptr;
+    }
+
+    auto key = toEvp(*ecKey);
+    if (!key)
+    {
+        return nullptr;
+    }
+
+    auto verifyContext = crypto::make_unique(EVP_MD_CTX_new());
+    if (!verifyContext || EVP_DigestVerifyInit(verifyContext.get(), nullptr, EVP_sha256(), nullptr, key.get()) != 1)
+    {
+        return nullptr;
+    }
+
+    return std::shared_ptr<const PreparedPublicKey>(new PreparedPublicKey(std::move(key), std::move(verifyContext)));
+}
+
+const EVP_PKEY& PreparedPublicKey::getKey() const
+{
+    return *_key;
+}
+
+bool PreparedPublicKey::verifySha256Signature(const std::vector<uint8_t> &derSignature,
+                                              const uint8_t *message, size_t messageSize) const
+{
+    auto ctx = crypto::make_unique(EVP_MD_CTX_new());
+    if (!ctx)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (EVP_MD_CTX_copy_ex(ctx.get(), _verifyContext.get()) != 1)
+        {
+            return false;
+        }
+    }
+
+    return (EVP_DigestVerifyUpdate(ctx.get(), message, messageSize) == 1)
+        && (EVP_DigestVerifyFinal(ctx.get(), derSignature.data(), derSignature.size()) == 1);
+}
+
+PublicKeyCache::PublicKeyCache(size_t capacity)
+        : _capacity(capacity)
+{
+}
+
+PublicKeyCache& PublicKeyCache::instance()
+{
+    static PublicKeyCache cache;
+    return cache;
+}
+
+std::shared_ptr<const PreparedPublicKey> PublicKeyCache::get(const RawKey &rawKey)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _index.find(rawKey);
+        if (it != _index.end())
+        {
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return it->second->second;
+        }
+    }
+
+    // prepare outside of the lock, invalid keys are never cached
+    auto prepared = PreparedPublicKey::prepare(rawKey);
+    if (!prepared || _capacity == 0)
+    {
+        return prepared;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_index.find(rawKey) == _index.end())
+    {
+        _entries.emplace_front(rawKey, prepared);
+        _index[rawKey] = _entries.begin();
+        if (_entries.size() > _capacity)
+        {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+    }
+    return prepared;
+}
+
+std::shared_ptr<const PreparedPublicKey> PublicKeyCache::get(const std::vector<uint8_t> &publicKey)
+{
+    RawKey rawKey{};
+    if (publicKey.size() != rawKey.size() + 1 || publicKey.front() != POINT_CONVERSION_UNCOMPRESSED)
+    {
+        return nullptr;
+    }
+    std::copy_n(publicKey.begin() + 1, rawKey.size(), rawKey.begin()); // skip header byte
+    return get(rawKey);
+}
+
+void PublicKeyCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _index.clear();
+    _entries.clear();
+}
+
+size_t PublicKeyCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+}}}} // namespace intel { namespace sgx { namespace dcap { namespace crypto {
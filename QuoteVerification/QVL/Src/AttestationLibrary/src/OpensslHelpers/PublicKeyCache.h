@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_PUBLICKEYCACHE_H_
+#define SGXECDSAATTESTATION_PUBLICKEYCACHE_H_
+
+#include "OpensslHelpers/OpensslTypes.h"
+
+#include <array>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap { namespace crypto {
+
+/**
+ * P-256 public key ready to verify signatures. The key is decoded and validated once, and SHA-256 verification
+ * is initialized once, each verification works on a copy of the initialized context.
+ */
+class PreparedPublicKey
+{
+public:
+    /**
+     * Prepare a key.
+     * @param rawKey - X and Y coordinates, big endian
+     * @return nullptr if the coordinates are not a valid point on P-256
+     */
+    static std::shared_ptr<const PreparedPublicKey> prepare(const std::array<uint8_t, 64> &rawKey);
+
+    PreparedPublicKey(const PreparedPublicKey&) = delete;
+    PreparedPublicKey& operator=(const PreparedPublicKey&) = delete;
+
+    const EVP_PKEY& getKey() const;
+
+    /**
+     * Verify a SHA-256 ECDSA signature.
+     * @param derSignature - DER encoded ECDSA-Sig-Value
+     * @param message - signed message
+     * @param messageSize - size of signed message in bytes
+     */
+    bool verifySha256Signature(const std::vector<uint8_t> &derSignature, const uint8_t *message, size_t messageSize) const;
+
+private:
+    PreparedPublicKey(EVP_PKEY_uptr key, EVP_MD_CTX_uptr verifyContext);
+
+    const EVP_PKEY_uptr _key;
+    const EVP_MD_CTX_uptr _verifyContext;
+    mutable std::mutex _mutex; // copying a context updates its reference counts
+};
+
+/**
+ * Bounded LRU cache of prepared public keys, keyed by raw key. A quote is verified with a handful of keys
+ * which are the same for all quotes of a platform, most of them for all quotes at all.
+ */
+class PublicKeyCache
+{
+public:
+    using RawKey = std::array<uint8_t, 64>;
+
+    /**
+     * Default number of cached keys, a key with its contexts takes about 2KB.
+     */
+#ifdef SGX_TRUSTED
+    static constexpr size_t DEFAULT_CAPACITY = 8;
+#else
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+#endif
+
+    explicit PublicKeyCache(size_t capacity = DEFAULT_CAPACITY);
+    PublicKeyCache(const PublicKeyCache&) = delete;
+    PublicKeyCache& operator=(const PublicKeyCache&) = delete;
+
+    /**
+     * Get the cache shared by signature verification.
+     */
+    static PublicKeyCache& instance();
+
+    /**
+     * Get prepared key.
+     * @param rawKey - X and Y coordinates, big endian
+     * @return nullptr if the coordinates are not a valid point on P-256
+     */
+    std::shared_ptr<const PreparedPublicKey> get(const RawKey &rawKey);
+
+    /**
+     * Get prepared key.
+     * @param publicKey - uncompressed point as in certificates, with 0x04 header byte
+     * @return nullptr if the key is not a valid uncompressed point on P-256
+     */
+    std::shared_ptr<const PreparedPublicKey> get(const std::vector<uint8_t> &publicKey);
+
+    /**
+     * Drop all keys.
+     */
+    void clear();
+
+    /**
+     * Get number of cached keys.
+     */
+    size_t size() const;
+
+private:
+    using Entry = std::pair<RawKey, std::shared_ptr<const PreparedPublicKey>>;
+
+    const size_t _capacity;
+    std::list<Entry> _entries; // most recently used first
+    std::map<RawKey, std::list<Entry>::iterator> _index;
+    mutable std::mutex _mutex;
+};
+
+}}}} // namespace intel { namespace sgx { namespace dcap { namespace crypto {
+
+#endif // SGXECDSAATTESTATION_PUBLICKEYCACHE_H_
@@ -37,17 +37,12 @@ namespace intel { namespace sgx { namespace dcap { namespace crypto {
 
 bool verifySignature(const pckparser::CrlStore& crl, const std::vector<uint8_t>& pubKey)
 {
-    auto publicKey = crypto::rawToP256PubKey(pubKey);
+    const auto publicKey = PublicKeyCache::instance().get(pubKey);
     if (publicKey == nullptr)
     {
         return false;
     }
-    const auto evp = crypto::toEvp(*publicKey);
-    if(!evp)
-    {
-        return false;
-    }
-    return 1 == X509_CRL_verify(&const_cast<X509_CRL&>(crl.getCrl()), evp.get());
+    return 1 == X509_CRL_verify(&const_cast<X509_CRL&>(crl.getCrl()), &const_cast<EVP_PKEY&>(publicKey->getKey()));
 }
 
 bool verifySha256Signature(const Bytes& signature, const Bytes& msg, const EC_KEY& pubKey)
@@ -61,6 +56,11 @@ bool verifySha256Signature(const Bytes& signature, const Bytes& msg, const EC_KE
 }
 
 bool verifySha256Signature(const Bytes& signature, const Bytes& message, const EVP_PKEY& pubKey)
+{
+    return verifySha256Signature(signature, message.data(), message.size(), pubKey);
+}
+
+bool verifySha256Signature(const Bytes& signature, const uint8_t* message, size_t messageSize, const EVP_PKEY& pubKey)
 {
     auto ctx = crypto::make_unique(EVP_MD_CTX_new());
     if (!ctx)
@@ -69,7 +69,7 @@ bool verifySha256Signature(const Bytes& signature, const Bytes& message, const E
     }
 
     return (EVP_DigestVerifyInit(ctx.get(), nullptr, EVP_sha256(), nullptr, &const_cast<EVP_PKEY&>(pubKey)) == 1)
-        && (EVP_DigestVerifyUpdate(ctx.get(), message.data(), message.size()) == 1)
+        && (EVP_DigestVerifyUpdate(ctx.get(), message, messageSize) == 1)
         && (EVP_DigestVerifyFinal(ctx.get(), signature.data(), signature.size()) == 1);
 }
 
@@ -110,6 +110,17 @@ bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_
     return verifySha256Signature(sig, message, publicKey);
 }
 
+bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_SIGNATURE_BYTE_LEN> &signature,
+                                const uint8_t *message, size_t messageSize, const EC_KEY &publicKey)
+{
+    const auto evp = crypto::toEvp(publicKey);
+    if(!evp)
+    {
+        return false;
+    }
+    return verifySha256Signature(rawEcdsaSignatureToDER(signature), message, messageSize, *evp);
+}
+
 bool verifySha256EcdsaSignature(const Bytes &signature, const std::vector<uint8_t> &message, const EC_KEY &publicKey)
 {
     if(signature.size() != constants::ECDSA_P256_SIGNATURE_BYTE_LEN)
@@ -121,14 +132,36 @@ bool verifySha256EcdsaSignature(const Bytes &signature, const std::vector<uint8_
     return verifySha256EcdsaSignature(signatureArr, message, publicKey);
 }
 
+bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_SIGNATURE_BYTE_LEN> &signature,
+                                const uint8_t *message, size_t messageSize, const PreparedPublicKey &publicKey)
+{
+    return publicKey.verifySha256Signature(rawEcdsaSignatureToDER(signature), message, messageSize);
+}
+
+bool verifySha256EcdsaSignature(const Bytes &signature, const std::vector<uint8_t> &message, const std::vector<uint8_t> &publicKey)
+{
+    if(signature.size() != constants::ECDSA_P256_SIGNATURE_BYTE_LEN)
+    {
+        return false;
+    }
+    const auto pubKey = PublicKeyCache::instance().get(publicKey);
+    if (pubKey == nullptr)
+    {
+        return false;
+    }
+    std::array<uint8_t, constants::ECDSA_P256_SIGNATURE_BYTE_LEN> signatureArr{};
+    std::copy_n(signature.begin(), constants::ECDSA_P256_SIGNATURE_BYTE_LEN, signatureArr.begin());
+    return verifySha256EcdsaSignature(signatureArr, message.data(), message.size(), *pubKey);
+}
+
 bool verifySha256EcdsaSignature(const dcap::parser::x509::Signature &signature, const std::vector<uint8_t> &message, const std::vector<uint8_t> &publicKey)
 {
-    auto pubKey = rawToP256PubKey(publicKey);
+    const auto pubKey = PublicKeyCache::instance().get(publicKey);
     if (pubKey == nullptr)
     {
         return false;
     }
-    return verifySha256Signature(signature.getRawDer(), message, *pubKey);
+    return pubKey->verifySha256Signature(signature.getRawDer(), message.data(), message.size());
 }
 
 }}}} // namespace intel { namespace sgx { namespace dcap { namespace crypto {
@@ -36,6 +36,7 @@
 
 #include "OpensslHelpers/Bytes.h"
 #include "OpensslHelpers/OpensslTypes.h"
+#include "OpensslHelpers/PublicKeyCache.h"
 
 #include <PckParser/CrlStore.h>
 #include <QuoteVerification/QuoteConstants.h>
@@ -48,6 +49,7 @@ bool verifySignature(const pckparser::CrlStore& crl, const std::vector<uint8_t>&
 
 bool verifySha256Signature(const Bytes& signature, const Bytes& message, const EC_KEY& publicKey);
 bool verifySha256Signature(const Bytes& signature, const Bytes& message, const EVP_PKEY& publicKey);
+bool verifySha256Signature(const Bytes& signature, const uint8_t* message, size_t messageSize, const EVP_PKEY& publicKey);
 
 template<size_t N>
 bool verifySha256Signature(const Bytes& signature, const std::array<uint8_t,N>& message, const EC_KEY& publicKey)
@@ -66,8 +68,16 @@ bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_
 bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_SIGNATURE_BYTE_LEN> &signature,
                                 const std::vector<uint8_t> &message, const EC_KEY &publicKey);
 
+bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_SIGNATURE_BYTE_LEN> &signature,
+                                const uint8_t *message, size_t messageSize, const EC_KEY &publicKey);
+
 bool verifySha256EcdsaSignature(const Bytes &signature, const std::vector<uint8_t> &message, const EC_KEY &publicKey);
 
+bool verifySha256EcdsaSignature(const std::array<uint8_t, constants::ECDSA_P256_SIGNATURE_BYTE_LEN> &signature,
+                                const uint8_t *message, size_t messageSize, const PreparedPublicKey &publicKey);
+
+bool verifySha256EcdsaSignature(const Bytes &signature, const std::vector<uint8_t> &message, const std::vector<uint8_t> &publicKey);
+
 bool verifySha256EcdsaSignature(const dcap::parser::x509::Signature &signature, const std::vector<uint8_t> &message, const std::vector<uint8_t> &publicKey);
 
 }}}} // namespace intel { namespace sgx { namespace dcap { namespace crypto {
@@ -36,17 +36,34 @@
 #include <OpensslHelpers/Assert.h>
 
 #include <algorithm>
+#include <cstring>
 
 namespace intel { namespace sgx { namespace dcap { namespace pckparser {
 
+namespace {
+
+int compareSerialNumbers(const uint8_t *lhs, size_t lhsLength, const uint8_t *rhs, size_t rhsLength)
+{
+    if(lhsLength != rhsLength)
+    {
+        return lhsLength < rhsLength ? -1 : 1;
+    }
+    return lhsLength == 0 ? 0 : std::memcmp(lhs, rhs, lhsLength);
+}
+
+} // anonymous namespace
+
 CrlStore::CrlStore()
     : _crl{crypto::make_unique(X509_CRL_new())},
       _issuer{},
       _validity{},
-      _revoked{},
       _extensions{},
       _signature{},
-      _crlNum{}
+      _crlNum{},
+      _revokedSerialNumbers{},
+      _revokedIndex{},
+      _revokedOnce{std::make_unique<std::once_flag>()},
+      _revoked{}
 {
 }
 
@@ -66,15 +83,21 @@ bool CrlStore::parse(const std::string& crlString)
 {
     try
     {
-        _crl = pckparser::str2X509Crl(crlString);
-        QVL_ASSERT(_crl);
-
-        _issuer = pckparser::getIssuer(*_crl);
-        _validity = pckparser::getValidity(*_crl);
-        _extensions = pckparser::getExtensions(*_crl);
-        _revoked = pckparser::getRevoked(*_crl);
-        _signature = pckparser::getSignature(*_crl);
-        _crlNum = pckparser::getCrlNum(*_crl);
+        setCrl(pckparser::str2X509Crl(crlString));
+    }
+    catch(const FormatException&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool CrlStore::parseDer(const std::vector<uint8_t>& der)
+{
+    try
+    {
+        setCrl(pckparser::der2X509Crl(der));
     }
     catch(const FormatException&)
     {
@@ -101,6 +124,7 @@ const Validity& CrlStore::getValidity() const
 
 const std::vector<Revoked>& CrlStore::getRevoked() const
 {
+    std::call_once(*_revokedOnce, [this]{ _revoked = pckparser::getRevoked(*_crl); });
     return _revoked;
 }
 
@@ -127,11 +151,72 @@ const X509_CRL& CrlStore::getCrl() const
 
 bool CrlStore::isRevoked(const dcap::parser::x509::Certificate& cert) const
 {
-    return std::find_if(
-            getRevoked().cbegin(),
-            getRevoked().cend(), [&](const pckparser::Revoked& revoked){
-                return revoked.serialNumber == cert.getSerialNumber();
-            }) != getRevoked().cend();
+    const auto& serialNumber = cert.getSerialNumber();
+    const auto found = std::lower_bound(_revokedIndex.cbegin(), _revokedIndex.cend(), serialNumber,
+        [this](const RevokedSerialNumber& revoked, const std::vector<uint8_t>& serial) {
+            return compareSerialNumbers(_revokedSerialNumbers.data() + revoked.offset, revoked.length,
+                                        serial.data(), serial.size()) < 0;
+        });
+    return found != _revokedIndex.cend() &&
+           compareSerialNumbers(_revokedSerialNumbers.data() + found->offset, found->length,
+                                serialNumber.data(), serialNumber.size()) == 0;
+}
+
+void CrlStore::setCrl(crypto::X509_CRL_uptr crl)
+{
+    _crl = std::move(crl);
+    QVL_ASSERT(_crl);
+
+    _issuer = pckparser::getIssuer(*_crl);
+    _validity = pckparser::getValidity(*_crl);
+    _extensions = pckparser::getExtensions(*_crl);
+    buildRevocationIndex();
+    _revokedOnce = std::make_unique<std::once_flag>();
+    _revoked.clear();
+    _signature = pckparser::getSignature(*_crl);
+    _crlNum = pckparser::getCrlNum(*_crl);
+}
+
+void CrlStore::buildRevocationIndex()
+{
+    _revokedSerialNumbers.clear();
+    _revokedIndex.clear();
+
+    // this is internal pointer, must not be freed
+    const STACK_OF(X509_REVOKED) *revokedStack = X509_CRL_get_REVOKED(_crl.get());
+    const int revokedCount = pckparser::getRevokedCount(*_crl);
+    if(!revokedStack || revokedCount == 0)
+    {
+        return;
+    }
+
+    _revokedIndex.reserve(static_cast<size_t>(revokedCount));
+    for(int i = 0; i < revokedCount; i++)
+    {
+        // internal pointers
+        const X509_REVOKED *revoked = sk_X509_REVOKED_value(revokedStack, i);
+        if(!revoked)
+        {
+            continue;
+        }
+        const ASN1_INTEGER *serialNumber = X509_REVOKED_get0_serialNumber(revoked);
+        const ASN1_TIME *time = X509_REVOKED_get0_revocationDate(revoked);
+
+        // same entries as skipped by getRevoked
+        if(!serialNumber || !time || serialNumber->length <= 0)
+        {
+            continue;
+        }
+
+        _revokedIndex.push_back({_revokedSerialNumbers.size(), static_cast<size_t>(serialNumber->length)});
+        _revokedSerialNumbers.insert(_revokedSerialNumbers.end(), serialNumber->data, serialNumber->data + serialNumber->length);
+    }
+
+    std::sort(_revokedIndex.begin(), _revokedIndex.end(),
+        [this](const RevokedSerialNumber& lhs, const RevokedSerialNumber& rhs) {
+            return compareSerialNumbers(_revokedSerialNumbers.data() + lhs.offset, lhs.length,
+                                        _revokedSerialNumbers.data() + rhs.offset, rhs.length) < 0;
+        });
 }
 
 }}}} // namespace intel { namespace sgx { namespace dcap { namespace pckparser {
@@ -38,6 +38,9 @@
 
 #include <OpensslHelpers/OpensslTypes.h>
 
+#include <memory>
+#include <mutex>
+
 using namespace intel::sgx::dcap;
 
 namespace intel { namespace sgx { namespace dcap { namespace pckparser {
@@ -56,6 +59,7 @@ public:
     bool operator!=(const CrlStore& other) const;
 
     virtual bool parse(const std::string& crlString);
+    virtual bool parseDer(const std::vector<uint8_t>& der);
 
     virtual bool expired(const time_t& expirationDate) const;
     virtual const Issuer& getIssuer() const;
@@ -68,14 +72,32 @@ public:
     virtual bool isRevoked(const dcap::parser::x509::Certificate& cert) const;
 
 private:
+    // Serial number of a revoked certificate in _revokedSerialNumbers
+    struct RevokedSerialNumber
+    {
+        size_t offset;
+        size_t length;
+    };
+
+    void setCrl(crypto::X509_CRL_uptr crl);
+    void buildRevocationIndex();
+
     crypto::X509_CRL_uptr _crl;
 
     Issuer _issuer;
     Validity _validity;
-    std::vector<Revoked> _revoked;
     std::vector<Extension> _extensions;
     Signature _signature;
     long _crlNum;
+
+    // Revocation index built at parse time: serial numbers of all revoked certificates stored back to back,
+    // and their positions sorted by length then bytes, so that isRevoked is a binary search without allocations
+    std::vector<uint8_t> _revokedSerialNumbers;
+    std::vector<RevokedSerialNumber> _revokedIndex;
+
+    // Full revoked entries are only built when requested
+    std::unique_ptr<std::once_flag> _revokedOnce;
+    mutable std::vector<Revoked> _revoked;
 };
 
 }}}} // namespace intel { namespace sgx { namespace dcap { namespace pckparser {
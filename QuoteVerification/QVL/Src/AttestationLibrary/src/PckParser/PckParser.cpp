@@ -499,6 +499,22 @@ crypto::X509_CRL_uptr str2X509Crl(const std::string& string)
     return ret;
 }
 
+crypto::X509_CRL_uptr der2X509Crl(const std::vector<uint8_t>& der)
+{
+    const unsigned char *data = der.data();
+    crypto::X509_CRL_uptr ret = crypto::make_unique(d2i_X509_CRL(nullptr, &data, static_cast<long>(der.size())));
+    if(!ret)
+    {
+        throw FormatException(getLastError());
+    }
+    if(data != der.data() + der.size())
+    {
+        throw FormatException("Unexpected data after DER encoded CRL");
+    }
+
+    return ret;
+}
+
 long getVersion(const X509_CRL& crl)
 {
     // version is zero-indexed thus +1
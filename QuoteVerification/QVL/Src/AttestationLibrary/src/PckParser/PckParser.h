@@ -137,6 +137,7 @@ void cleanUpOpenSSL();
 ////////////////////////////////////////////////////////////////////////////
 
 crypto::X509_CRL_uptr str2X509Crl(const std::string& data);
+crypto::X509_CRL_uptr der2X509Crl(const std::vector<uint8_t>& der);
 long getVersion(const X509_CRL& crl);
 Issuer getIssuer(const X509_CRL& crl);
 int getExtensionCount(const X509_CRL& crl);
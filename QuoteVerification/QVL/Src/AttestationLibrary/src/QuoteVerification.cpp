@@ -37,6 +37,7 @@
 #include "PckParser/CrlStore.h"
 #include "CertVerification/CertificateChain.h"
 #include "QuoteVerification/Quote.h"
+#include "QuoteVerification/QuoteView.h"
 #include "QuoteVerification/QuoteConstants.h"
 
 #include "Verifiers/PckCertVerifier.h"
@@ -49,6 +50,7 @@
 #include "Verifiers/EnclaveIdentity.h"
 #include "Utils/TimeUtils.h"
 #include "Utils/SafeMemcpy.h"
+#include "Utils/CollateralCache.h"
 
 #include <SgxEcdsaAttestation/QuoteVerification.h>
 #include <Version/Version.h>
@@ -95,29 +97,32 @@ Status sgxAttestationVerifyPCKCertificate(const char *pemCertChain, const char *
         return STATUS_UNSUPPORTED_CERT_FORMAT;
     }
 
-    dcap::CertificateChain chain;
-    const auto status = chain.parse(pemCertChain);
+    auto& cache = dcap::CollateralCache::instance();
+
+    std::shared_ptr<const dcap::CertificateChain> chain;
+    const auto status = cache.getCertificateChain(pemCertChain, chain);
 
     if(status != STATUS_OK)
     {
         return status;
     }
 
-    if(chain.length() != EXPECTED_CERTIFICATE_COUNT_IN_PCK_CHAIN)
+    if(chain->length() != EXPECTED_CERTIFICATE_COUNT_IN_PCK_CHAIN)
     {
         return STATUS_UNSUPPORTED_CERT_FORMAT;
     }
 
-    dcap::pckparser::CrlStore rootCaCrl, intermediateCrl;
-    if(!rootCaCrl.parse(crls[0]) || !intermediateCrl.parse(crls[1]))
+    const auto rootCaCrl = cache.getCrl(crls[0]);
+    const auto intermediateCrl = rootCaCrl ? cache.getCrl(crls[1]) : nullptr;
+    if(!rootCaCrl || !intermediateCrl)
     {
         return STATUS_SGX_CRL_UNSUPPORTED_FORMAT;
     }
 
     try
     {
-        auto rootCa = dcap::parser::x509::Certificate::parse(pemRootCaCertificate);
-        return dcap::PckCertVerifier{}.verify(chain, rootCaCrl, intermediateCrl, rootCa, currentTime);
+        const auto rootCa = cache.getCertificate(pemRootCaCertificate);
+        return dcap::PckCertVerifier{}.verify(*chain, *rootCaCrl, *intermediateCrl, *rootCa, currentTime);
     }
     catch (const dcap::parser::FormatException&)
     {
@@ -182,10 +187,12 @@ Status sgxAttestationVerifyTCBInfo(const char *tcbInfo, const char *pemCertChain
         return STATUS_UNSUPPORTED_CERT_FORMAT;
     }
 
-    dcap::parser::json::TcbInfo tcbInfoJson;
+    auto& cache = dcap::CollateralCache::instance();
+
+    std::shared_ptr<const dcap::parser::json::TcbInfo> tcbInfoJson;
     try
     {
-        tcbInfoJson = dcap::parser::json::TcbInfo::parse(tcbInfo);
+        tcbInfoJson = cache.getTcbInfo(tcbInfo);
     }
     catch (const dcap::parser::FormatException&)
     {
@@ -196,28 +203,38 @@ Status sgxAttestationVerifyTCBInfo(const char *tcbInfo, const char *pemCertChain
         return STATUS_SGX_TCB_INFO_INVALID;
     }
 
-    dcap::CertificateChain chain;
-    const auto status = chain.parse(pemCertChain);
+    std::shared_ptr<const dcap::CertificateChain> chain;
+    const auto status = cache.getCertificateChain(pemCertChain, chain);
     if (status != STATUS_OK)
     {
         return status;
     }
 
-    if(chain.length() != EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN)
+    if(chain->length() != EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN)
     {
         return STATUS_UNSUPPORTED_CERT_FORMAT;
     }
 
-    dcap::pckparser::CrlStore rootCaCrl;
-    if(!rootCaCrl.parse(stringRootCaCrl))
+    const auto rootCaCrl = cache.getCrl(stringRootCaCrl);
+    if(!rootCaCrl)
     {
         return STATUS_SGX_CRL_UNSUPPORTED_FORMAT;
     }
 
     try
     {
-        auto trustedRootCa = dcap::parser::x509::Certificate::parse(pemRootCaCertificate);
-        return dcap::TCBInfoVerifier{}.verify(tcbInfoJson, chain, rootCaCrl, trustedRootCa, currentTime);
+        const auto trustedRootCa = cache.getCertificate(pemRootCaCertificate);
+        const dcap::TCBInfoVerifier verifier{};
+
+        // signature checks don't depend on time, they run once per collateral set
+        const auto signatureStatus = cache.getVerificationStatus("TCBInfoVerifier",
+                {tcbInfo, pemCertChain, stringRootCaCrl, pemRootCaCertificate},
+                [&] { return verifier.verifySignature(*tcbInfoJson, *chain, *rootCaCrl, *trustedRootCa); });
+        if (signatureStatus != STATUS_OK)
+        {
+            return signatureStatus;
+        }
+        return verifier.verifyExpiration(*tcbInfoJson, *chain, *rootCaCrl, currentTime);
     }
     catch (const dcap::parser::FormatException&)
     {
@@ -251,39 +268,50 @@ Status sgxAttestationVerifyEnclaveIdentity(const char *enclaveIdentityString, co
         return STATUS_UNSUPPORTED_CERT_FORMAT;
     }
 
-    dcap::EnclaveIdentityParser parser;
-    std::unique_ptr<dcap::EnclaveIdentity> enclaveIdentity;
+    auto& cache = dcap::CollateralCache::instance();
+
+    std::shared_ptr<const dcap::EnclaveIdentity> enclaveIdentity;
     try
     {
-        enclaveIdentity = parser.parse(enclaveIdentityString);
+        enclaveIdentity = cache.getEnclaveIdentity(enclaveIdentityString);
     }
     catch (const dcap::ParserException &e)
     {
         return e.getStatus();
     }
 
-    dcap::CertificateChain chain;
-    const auto status = chain.parse(pemCertChain);
+    std::shared_ptr<const dcap::CertificateChain> chain;
+    const auto status = cache.getCertificateChain(pemCertChain, chain);
     if(status != STATUS_OK)
     {
         return status;
     }
 
-    if(chain.length() != EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN)
+    if(chain->length() != EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN)
     {
         return STATUS_UNSUPPORTED_CERT_FORMAT;
     }
 
-    dcap::pckparser::CrlStore rootCaCrl;
-    if(!rootCaCrl.parse(stringRootCaCrl))
+    const auto rootCaCrl = cache.getCrl(stringRootCaCrl);
+    if(!rootCaCrl)
     {
         return STATUS_SGX_CRL_UNSUPPORTED_FORMAT;
     }
 
     try
     {
-        auto trustedRootCa = dcap::parser::x509::Certificate::parse(pemRootCaCertificate);
-        return dcap::EnclaveIdentityVerifier{}.verify(*enclaveIdentity, chain, rootCaCrl, trustedRootCa, currentTime);
+        const auto trustedRootCa = cache.getCertificate(pemRootCaCertificate);
+        const dcap::EnclaveIdentityVerifier verifier{};
+
+        // signature checks don't depend on time, they run once per collateral set
+        const auto signatureStatus = cache.getVerificationStatus("EnclaveIdentityVerifier",
+                {enclaveIdentityString, pemCertChain, stringRootCaCrl, pemRootCaCertificate},
+                [&] { return verifier.verifySignature(*enclaveIdentity, *chain, *rootCaCrl, *trustedRootCa); });
+        if (signatureStatus != STATUS_OK)
+        {
+            return signatureStatus;
+        }
+        return verifier.verifyExpiration(*enclaveIdentity, *chain, *rootCaCrl, currentTime);
     }
     catch (const dcap::parser::FormatException&)
     {
@@ -309,27 +337,29 @@ Status sgxAttestationVerifyQuote(const uint8_t* rawQuote, uint32_t quoteSize, co
    
     // We totally trust user on this, it should be explicitly and clearly
     // mentioned in doc, is there any max quote len other than numeric_limit<uint32_t>::max() ? 
-    const std::vector<uint8_t> vecQuote(rawQuote, std::next(rawQuote, quoteSize));
 
     /// 4.1.2.4.2
-    dcap::Quote quote;
-    if(!quote.parse(vecQuote) || !quote.validate())
+    dcap::QuoteView quote;
+    if(!quote.parse(rawQuote, quoteSize) || !quote.validate())
     {
         return Status::STATUS_UNSUPPORTED_QUOTE_FORMAT;
     }
 
+    auto& cache = dcap::CollateralCache::instance();
+
     /// 4.1.2.4.5
-    dcap::pckparser::CrlStore pckCrlStore;
-    if(!pckCrlStore.parse(pckCrl))
+    const auto pckCrlStore = cache.getCrl(pckCrl);
+    if(!pckCrlStore)
     {
         return STATUS_UNSUPPORTED_PCK_RL_FORMAT;
     }
 
     /// 4.1.2.4.8
-    dcap::parser::json::TcbInfo tcbInfo;
+    std::shared_ptr<const dcap::parser::json::TcbInfo> tcbInfo;
+    std::shared_ptr<const dcap::TcbLevelMatcher> tcbLevelMatcher;
     try
     {
-        tcbInfo = dcap::parser::json::TcbInfo::parse(tcbInfoJson);
+        tcbInfo = cache.getTcbInfo(tcbInfoJson, tcbLevelMatcher);
     }
     catch (const dcap::parser::FormatException&)
     {
@@ -340,12 +370,11 @@ Status sgxAttestationVerifyQuote(const uint8_t* rawQuote, uint32_t quoteSize, co
         return STATUS_UNSUPPORTED_TCB_INFO_FORMAT;
     }
 
-    dcap::EnclaveIdentityParser parser;
-    std::unique_ptr<dcap::EnclaveIdentity> enclaveIdentity;
+    std::shared_ptr<const dcap::EnclaveIdentity> enclaveIdentity;
     if (qeIdentityJson != nullptr)
     {
         try {
-            enclaveIdentity = parser.parse(qeIdentityJson);
+            enclaveIdentity = cache.getEnclaveIdentity(qeIdentityJson);
         }
         catch (const dcap::ParserException&)
         {
@@ -356,7 +385,7 @@ Status sgxAttestationVerifyQuote(const uint8_t* rawQuote, uint32_t quoteSize, co
     try
     {
         auto pckCert = dcap::parser::x509::PckCertificate::parse(pemPckCertificate); /// 4.1.2.4.3
-        return dcap::QuoteVerifier{}.verify(quote, pckCert, pckCrlStore, tcbInfo, enclaveIdentity.get(), dcap::EnclaveReportVerifier());
+        return dcap::QuoteVerifier{}.verify(quote, pckCert, *pckCrlStore, *tcbInfo, *tcbLevelMatcher, enclaveIdentity.get(), dcap::EnclaveReportVerifier());
     }
     catch (const dcap::parser::FormatException&)
     {
@@ -411,15 +440,13 @@ Status sgxAttestationGetQECertificationDataSize(
 
     // We totally trust user on this, it should be explicitly and clearly
     // mentioned in doc, is there any max quote len other than numeric_limit<uint32_t>::max() ?
-    const std::vector<uint8_t> vecQuote(rawQuote, std::next(rawQuote, quoteSize));
-
-    dcap::Quote quote;
-    if(!quote.parse(vecQuote) || !quote.validate())
+    dcap::QuoteView quote;
+    if(!quote.parse(rawQuote, quoteSize) || !quote.validate())
     {
         return Status::STATUS_UNSUPPORTED_QUOTE_FORMAT;
     }
 
-    *qeCertificationDataSize = static_cast<uint32_t>(quote.getQuoteAuthData().qeCertData.parsedDataSize);
+    *qeCertificationDataSize = quote.getQeCertDataSize();
 
     return STATUS_OK;
 }
@@ -440,25 +467,23 @@ Status sgxAttestationGetQECertificationData(
 
     // We totally trust user on this, it should be explicitly and clearly
     // mentioned in doc, is there any max quote len other than numeric_limit<uint32_t>::max() ?
-    const std::vector<uint8_t> vecQuote(rawQuote, std::next(rawQuote, quoteSize));
-
-    dcap::Quote quote;
-    if(!quote.parse(vecQuote) || !quote.validate())
+    dcap::QuoteView quote;
+    if(!quote.parse(rawQuote, quoteSize) || !quote.validate())
     {
         return STATUS_UNSUPPORTED_QUOTE_FORMAT;
     }
 
-    const auto& quoteQeCertData = quote.getQuoteAuthData().qeCertData;
+    const auto quoteQeCertData = quote.getQeCertData();
 
-    if(qeCertificationDataSize != quoteQeCertData.parsedDataSize)
+    if(qeCertificationDataSize != quote.getQeCertDataSize())
     {
         return STATUS_INVALID_QE_CERTIFICATION_DATA_SIZE;
     }
 
-    *qeCertificationDataType = quoteQeCertData.type;
+    *qeCertificationDataType = quote.getQeCertDataType();
 
     // buffer pointed to by 'qeCertificationData' must be at least 'qeCertificationDataSize' long
-    std::copy(std::begin(quoteQeCertData.data), std::end(quoteQeCertData.data), qeCertificationData);
+    std::copy(quoteQeCertData.begin(), quoteQeCertData.end(), qeCertificationData);
 
     return STATUS_OK;
 }
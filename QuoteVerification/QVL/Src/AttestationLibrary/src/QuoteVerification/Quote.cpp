@@ -67,7 +67,7 @@ namespace {
             AUTH_DATA_MIN_BYTE_LEN;
 
     template<typename T>
-    bool copyAndAdvance(T& val, std::vector<uint8_t>::const_iterator& from, size_t amount, const std::vector<uint8_t>::const_iterator& totalEnd)
+    bool copyAndAdvance(T& val, const uint8_t*& from, size_t amount, const uint8_t* totalEnd)
     {
         const auto available = std::distance(from, totalEnd);
         if (available < 0 || (unsigned) available < amount)
@@ -79,7 +79,7 @@ namespace {
     }
 
     template<size_t N>
-    bool copyAndAdvance(std::array<uint8_t, N>& arr, std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& totalEnd)
+    bool copyAndAdvance(std::array<uint8_t, N>& arr, const uint8_t*& from, const uint8_t* totalEnd)
     {
         const auto capacity = std::distance(arr.cbegin(), arr.cend());
         if (std::distance(from, totalEnd) < capacity)
@@ -92,7 +92,7 @@ namespace {
         return true;
     }
 
-    bool copyAndAdvance(uint16_t& val, std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& totalEnd)
+    bool copyAndAdvance(uint16_t& val, const uint8_t*& from, const uint8_t* totalEnd)
     {
         const auto available = std::distance(from, totalEnd);
         const auto capacity = sizeof(uint16_t);
@@ -107,7 +107,7 @@ namespace {
     }
 
 
-    bool copyAndAdvance(uint32_t& val, std::vector<uint8_t>::const_iterator& position, const std::vector<uint8_t>::const_iterator& totalEnd)
+    bool copyAndAdvance(uint32_t& val, const uint8_t*& position, const uint8_t* totalEnd)
     {
         const auto available = std::distance(position, totalEnd);
         const auto capacity = sizeof(uint32_t);
@@ -130,39 +130,40 @@ bool Quote::parse(const std::vector<uint8_t>& rawQuote)
         return false;
     }
 
-    auto from = rawQuote.cbegin();
+    const uint8_t *from = rawQuote.data();
+    const uint8_t *end = rawQuote.data() + rawQuote.size();
     Header localHeader;
-    if (!copyAndAdvance(localHeader, from, HEADER_BYTE_LEN, rawQuote.cend())) {
+    if (!copyAndAdvance(localHeader, from, HEADER_BYTE_LEN, end)) {
         return false;
     }
 
     EnclaveReport localEnclaveReport = {};
     if (localHeader.teeType == TEE_TYPE_SGX)
     {
-        if (!copyAndAdvance(localEnclaveReport, from, ENCLAVE_REPORT_BYTE_LEN, rawQuote.cend())) {
+        if (!copyAndAdvance(localEnclaveReport, from, ENCLAVE_REPORT_BYTE_LEN, end)) {
             return false;
         }
     }
 
     uint32_t localAuthDataSize;
-    if (!copyAndAdvance(localAuthDataSize, from, rawQuote.cend())) {
+    if (!copyAndAdvance(localAuthDataSize, from, end)) {
         return false;
     }
-    const auto remainingDistance = std::distance(from, rawQuote.cend());
+    const auto remainingDistance = std::distance(from, end);
     if(localAuthDataSize != remainingDistance)
     {
         return false;
     }
 
     Ecdsa256BitQuoteAuthData localQuoteAuth;
-    if (!copyAndAdvance(localQuoteAuth, from, static_cast<size_t>(localAuthDataSize), rawQuote.cend())) {
+    if (!copyAndAdvance(localQuoteAuth, from, static_cast<size_t>(localAuthDataSize), end)) {
         return false;
     }
 
     // parsing done, we should be precisely at the end of our buffer
     // if we're not it means inconsistency in internal structure
     // and it means invalid format
-    if(from != rawQuote.cend())
+    if(from != end)
     {
         return false;
     }
@@ -192,8 +193,8 @@ bool Quote::parseEnclaveReport(const std::vector<uint8_t> &enclaveReport)
     }
 
     EnclaveReport localBody;
-    auto from = enclaveReport.cbegin();
-    auto end = enclaveReport.cend();
+    const uint8_t *from = enclaveReport.data();
+    const uint8_t *end = enclaveReport.data() + enclaveReport.size();
     if (!copyAndAdvance(localBody, from, ENCLAVE_REPORT_BYTE_LEN, end)) {
         return false;
     }
@@ -209,6 +210,11 @@ bool Quote::parseEnclaveReport(const std::vector<uint8_t> &enclaveReport)
 }
 
 bool Quote::validate() const
+{
+    return validateHeader(header);
+}
+
+bool Quote::validateHeader(const Header& header)
 {
     if(std::find(ALLOWED_QUOTE_VERSIONS.begin(), ALLOWED_QUOTE_VERSIONS.end(), header.version) ==
        ALLOWED_QUOTE_VERSIONS.end())
@@ -264,7 +270,7 @@ const std::vector<uint8_t>& Quote::getSignedData() const
     return signedData;
 }
 
-bool Quote::Header::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::Header::insert(const uint8_t*& from, const uint8_t* end)
 {
     if (!copyAndAdvance(version, from, end)) { return false; }
     if (!copyAndAdvance(attestationKeyType, from, end)) { return false; }
@@ -277,7 +283,7 @@ bool Quote::Header::insert(std::vector<uint8_t>::const_iterator& from, const std
     return true;
 }
 
-bool Quote::EnclaveReport::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::EnclaveReport::insert(const uint8_t*& from, const uint8_t* end)
 {
     if (!copyAndAdvance(cpuSvn, from, end)) { return false; }
     if (!copyAndAdvance(miscSelect, from, end)) { return false; }
@@ -340,17 +346,17 @@ std::array<uint8_t,ENCLAVE_REPORT_BYTE_LEN> Quote::EnclaveReport::rawBlob() cons
     return ret;
 }
 
-bool Quote::Ecdsa256BitSignature::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::Ecdsa256BitSignature::insert(const uint8_t*& from, const uint8_t* end)
 {
     return copyAndAdvance(signature, from, end);
 }
 
-bool Quote::Ecdsa256BitPubkey::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::Ecdsa256BitPubkey::insert(const uint8_t*& from, const uint8_t* end)
 {
     return copyAndAdvance(pubKey, from, end);
 }
 
-bool Quote::QeAuthData::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::QeAuthData::insert(const uint8_t*& from, const uint8_t* end)
 {
     const size_t amount = static_cast<size_t>(std::distance(from, end));
     if(from > end || amount < QE_AUTH_DATA_SIZE_BYTE_LEN)
@@ -385,7 +391,7 @@ bool Quote::QeAuthData::insert(std::vector<uint8_t>::const_iterator& from, const
     return true;
 }
 
-bool Quote::QeCertData::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::QeCertData::insert(const uint8_t*& from, const uint8_t* end)
 {
     const auto minLen = QE_CERT_DATA_SIZE_BYTE_LEN + QE_CERT_DATA_TYPE_BYTE_LEN;
     const size_t amount = static_cast<size_t>(std::distance(from, end));
@@ -417,7 +423,7 @@ bool Quote::QeCertData::insert(std::vector<uint8_t>::const_iterator& from, const
     return true;
 }
 
-bool Quote::Ecdsa256BitQuoteAuthData::insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end)
+bool Quote::Ecdsa256BitQuoteAuthData::insert(const uint8_t*& from, const uint8_t* end)
 {
     if (!copyAndAdvance(ecdsa256BitSignature, from, ECDSA_SIGNATURE_BYTE_LEN, end)) { return false; }
     if (!copyAndAdvance(ecdsaAttestationKey, from, ECDSA_PUBKEY_BYTE_LEN, end)) { return false; }
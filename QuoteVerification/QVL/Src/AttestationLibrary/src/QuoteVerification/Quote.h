@@ -55,7 +55,7 @@ public:
         std::array<uint8_t, 16> qeVendorId;
         std::array<uint8_t, 20> userData;
 
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
     };
 
     struct EnclaveReport
@@ -73,7 +73,7 @@ public:
         std::array<uint8_t, 60> reserved4;
         std::array<uint8_t, 64> reportData;
 
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
         std::array<uint8_t, constants::ENCLAVE_REPORT_BYTE_LEN> rawBlob() const;
     };
 
@@ -81,21 +81,21 @@ public:
     {
         std::array<uint8_t, dcap::constants::ECDSA_P256_SIGNATURE_BYTE_LEN> signature;
 
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
     };
 
     struct Ecdsa256BitPubkey
     {
         std::array<uint8_t, 64> pubKey;
 
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
     };
 
     struct QeAuthData
     {
         uint16_t parsedDataSize;
         std::vector<uint8_t> data;
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
     };
 
     struct QeCertData
@@ -103,7 +103,7 @@ public:
         uint16_t type;
         uint32_t parsedDataSize;
         std::vector<uint8_t> data;
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
     };
 
     struct Ecdsa256BitQuoteAuthData
@@ -116,12 +116,13 @@ public:
         QeAuthData qeAuthData;
         QeCertData qeCertData;
 
-        bool insert(std::vector<uint8_t>::const_iterator& from, const std::vector<uint8_t>::const_iterator& end);
+        bool insert(const uint8_t*& from, const uint8_t* end);
     }; 
 
     bool parse(const std::vector<uint8_t>& rawQuote);
     bool parseEnclaveReport(const std::vector<uint8_t>& rawQuote);
     bool validate() const;
+    static bool validateHeader(const Header& header);
 
     const Header& getHeader() const;
     const EnclaveReport& getEnclaveReport() const;
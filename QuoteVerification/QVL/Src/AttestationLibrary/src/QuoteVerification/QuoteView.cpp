@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "QuoteView.h"
+#include "ByteOperands.h"
+
+namespace intel { namespace sgx { namespace dcap {
+
+namespace {
+    using namespace constants;
+
+    constexpr size_t HEADER_BYTE_LEN = 48;
+    constexpr size_t AUTH_DATA_SIZE_BYTE_LEN = 4;
+
+    constexpr size_t ECDSA_SIGNATURE_BYTE_LEN = 64;
+    constexpr size_t ECDSA_PUBKEY_BYTE_LEN = 64;
+    constexpr size_t QE_REPORT_BYTE_LEN = ENCLAVE_REPORT_BYTE_LEN;
+    constexpr size_t QE_REPORT_SIG_BYTE_LEN = ECDSA_SIGNATURE_BYTE_LEN;
+    constexpr size_t QE_AUTH_DATA_SIZE_BYTE_LEN = 2;
+    constexpr size_t QE_CERT_DATA_TYPE_BYTE_LEN = 2;
+    constexpr size_t QE_CERT_DATA_SIZE_BYTE_LEN = 4;
+
+    constexpr size_t AUTH_DATA_MIN_BYTE_LEN =
+            ECDSA_SIGNATURE_BYTE_LEN +
+            ECDSA_PUBKEY_BYTE_LEN +
+            QE_REPORT_BYTE_LEN +
+            QE_REPORT_SIG_BYTE_LEN +
+            QE_AUTH_DATA_SIZE_BYTE_LEN +
+            QE_CERT_DATA_TYPE_BYTE_LEN +
+            QE_CERT_DATA_SIZE_BYTE_LEN;
+
+    constexpr size_t QUOTE_MIN_BYTE_LEN =
+            HEADER_BYTE_LEN +
+            ENCLAVE_REPORT_BYTE_LEN +
+            AUTH_DATA_SIZE_BYTE_LEN +
+            AUTH_DATA_MIN_BYTE_LEN;
+
+    size_t available(const uint8_t *from, const uint8_t *end)
+    {
+        return static_cast<size_t>(end - from);
+    }
+
+    template<typename T>
+    bool readAndAdvance(T& val, const uint8_t*& from, size_t amount, const uint8_t *end)
+    {
+        if (available(from, end) < amount)
+        {
+            return false;
+        }
+        const uint8_t *fieldEnd = from + amount;
+        return val.insert(from, fieldEnd) && from == fieldEnd;
+    }
+
+    bool readAndAdvance(uint16_t& val, const uint8_t*& from, const uint8_t *end)
+    {
+        if (available(from, end) < sizeof(uint16_t))
+        {
+            return false;
+        }
+        val = swapBytes(toUint16(from[0], from[1]));
+        from += sizeof(uint16_t);
+        return true;
+    }
+
+    bool readAndAdvance(uint32_t& val, const uint8_t*& from, const uint8_t *end)
+    {
+        if (available(from, end) < sizeof(uint32_t))
+        {
+            return false;
+        }
+        val = swapBytes(toUint32(from[0], from[1], from[2], from[3]));
+        from += sizeof(uint32_t);
+        return true;
+    }
+
+    bool spanAndAdvance(QuoteView::Span& span, const uint8_t*& from, size_t amount, const uint8_t *end)
+    {
+        if (available(from, end) < amount)
+        {
+            return false;
+        }
+        span = QuoteView::Span{from, amount};
+        from += amount;
+        return true;
+    }
+
+} // anonymous namespace
+
+bool QuoteView::parse(const uint8_t *rawQuote, size_t rawQuoteSize)
+{
+    if(rawQuote == nullptr || rawQuoteSize < QUOTE_MIN_BYTE_LEN)
+    {
+        return false;
+    }
+
+    const uint8_t *from = rawQuote;
+    const uint8_t *end = rawQuote + rawQuoteSize;
+
+    Quote::Header localHeader;
+    if (!readAndAdvance(localHeader, from, HEADER_BYTE_LEN, end)) {
+        return false;
+    }
+
+    Quote::EnclaveReport localEnclaveReport = {};
+    if (localHeader.teeType == TEE_TYPE_SGX)
+    {
+        if (!readAndAdvance(localEnclaveReport, from, ENCLAVE_REPORT_BYTE_LEN, end)) {
+            return false;
+        }
+    }
+
+    uint32_t localAuthDataSize;
+    if (!readAndAdvance(localAuthDataSize, from, end)) {
+        return false;
+    }
+    if(localAuthDataSize != available(from, end))
+    {
+        return false;
+    }
+
+    Quote::Ecdsa256BitSignature localQuoteSignature;
+    Quote::Ecdsa256BitPubkey localAttestationKey;
+    Quote::EnclaveReport localQeReport;
+    Quote::Ecdsa256BitSignature localQeReportSignature;
+    if (!readAndAdvance(localQuoteSignature, from, ECDSA_SIGNATURE_BYTE_LEN, end)) { return false; }
+    if (!readAndAdvance(localAttestationKey, from, ECDSA_PUBKEY_BYTE_LEN, end)) { return false; }
+    const uint8_t *qeReportBegin = from;
+    if (!readAndAdvance(localQeReport, from, QE_REPORT_BYTE_LEN, end)) { return false; }
+    if (!readAndAdvance(localQeReportSignature, from, QE_REPORT_SIG_BYTE_LEN, end)) { return false; }
+
+    uint16_t localQeAuthDataSize = 0;
+    Span localQeAuthData{nullptr, 0};
+    if (!readAndAdvance(localQeAuthDataSize, from, end)) { return false; }
+    if (!spanAndAdvance(localQeAuthData, from, localQeAuthDataSize, end)) { return false; }
+
+    uint16_t localQeCertDataType = 0;
+    uint32_t localQeCertDataSize = 0;
+    Span localQeCertData{nullptr, 0};
+    if (!readAndAdvance(localQeCertDataType, from, end)) { return false; }
+    if (!readAndAdvance(localQeCertDataSize, from, end)) { return false; }
+    if (!spanAndAdvance(localQeCertData, from, localQeCertDataSize, end)) { return false; }
+
+    // parsing done, we should be precisely at the end of our buffer
+    // if we're not it means inconsistency in internal structure
+    // and it means invalid format
+    if(from != end)
+    {
+        return false;
+    }
+
+    header = localHeader;
+    bodyEnclaveReport = localEnclaveReport;
+    authDataSize = localAuthDataSize;
+    quoteSignature = localQuoteSignature;
+    attestationKey = localAttestationKey;
+    qeReport = localQeReport;
+    qeReportBlob = Span{qeReportBegin, QE_REPORT_BYTE_LEN};
+    qeReportSignature = localQeReportSignature;
+    qeAuthData = localQeAuthData;
+    qeCertDataType = localQeCertDataType;
+    qeCertDataSize = localQeCertDataSize;
+    qeCertData = localQeCertData;
+    signedData = localHeader.teeType == TEE_TYPE_SGX ? Span{rawQuote, HEADER_BYTE_LEN + ENCLAVE_REPORT_BYTE_LEN} : Span{nullptr, 0};
+
+    return true;
+}
+
+bool QuoteView::validate() const
+{
+    return Quote::validateHeader(header);
+}
+
+const Quote::Header& QuoteView::getHeader() const
+{
+    return header;
+}
+
+const Quote::EnclaveReport& QuoteView::getEnclaveReport() const
+{
+    return bodyEnclaveReport;
+}
+
+uint32_t QuoteView::getAuthDataSize() const
+{
+    return authDataSize;
+}
+
+const Quote::Ecdsa256BitSignature& QuoteView::getQuoteSignature() const
+{
+    return quoteSignature;
+}
+
+const Quote::Ecdsa256BitPubkey& QuoteView::getAttestationKey() const
+{
+    return attestationKey;
+}
+
+const Quote::EnclaveReport& QuoteView::getQeReport() const
+{
+    return qeReport;
+}
+
+QuoteView::Span QuoteView::getQeReportBlob() const
+{
+    return qeReportBlob;
+}
+
+const Quote::Ecdsa256BitSignature& QuoteView::getQeReportSignature() const
+{
+    return qeReportSignature;
+}
+
+QuoteView::Span QuoteView::getQeAuthData() const
+{
+    return qeAuthData;
+}
+
+uint16_t QuoteView::getQeCertDataType() const
+{
+    return qeCertDataType;
+}
+
+uint32_t QuoteView::getQeCertDataSize() const
+{
+    return qeCertDataSize;
+}
+
+QuoteView::Span QuoteView::getQeCertData() const
+{
+    return qeCertData;
+}
+
+QuoteView::Span QuoteView::getSignedData() const
+{
+    return signedData;
+}
+
+}}} //namespace intel { namespace sgx { namespace dcap {
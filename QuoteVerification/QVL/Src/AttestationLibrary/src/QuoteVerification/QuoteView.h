@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef INTEL_SGX_QVL_QUOTE_VIEW_H_
+#define INTEL_SGX_QVL_QUOTE_VIEW_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include "Quote.h"
+#include "QuoteConstants.h"
+
+namespace intel { namespace sgx { namespace dcap {
+
+/**
+ * Non-owning view over a raw quote.
+ *
+ * Bounds are validated once in parse(). Fixed size fields are decoded into the view,
+ * variable size data (QE authentication data, QE certification data and the signed
+ * part of the quote) is exposed as spans over the caller's buffer, which must outlive the view.
+ */
+class QuoteView
+{
+public:
+
+    struct Span
+    {
+        const uint8_t *data;
+        size_t size;
+
+        const uint8_t* begin() const { return data; }
+        const uint8_t* end() const { return data + size; }
+    };
+
+    bool parse(const uint8_t *rawQuote, size_t rawQuoteSize);
+    bool validate() const;
+
+    const Quote::Header& getHeader() const;
+    const Quote::EnclaveReport& getEnclaveReport() const;
+    uint32_t getAuthDataSize() const;
+
+    const Quote::Ecdsa256BitSignature& getQuoteSignature() const;
+    const Quote::Ecdsa256BitPubkey& getAttestationKey() const;
+    const Quote::EnclaveReport& getQeReport() const;
+    Span getQeReportBlob() const;
+    const Quote::Ecdsa256BitSignature& getQeReportSignature() const;
+    Span getQeAuthData() const;
+    uint16_t getQeCertDataType() const;
+    uint32_t getQeCertDataSize() const;
+    Span getQeCertData() const;
+    Span getSignedData() const;
+
+protected:
+    Quote::Header header{};
+    Quote::EnclaveReport bodyEnclaveReport{};
+    uint32_t authDataSize{0};
+    Quote::Ecdsa256BitSignature quoteSignature{};
+    Quote::Ecdsa256BitPubkey attestationKey{};
+    Quote::EnclaveReport qeReport{};
+    Span qeReportBlob{nullptr, 0};
+    Quote::Ecdsa256BitSignature qeReportSignature{};
+    Span qeAuthData{nullptr, 0};
+    uint16_t qeCertDataType{0};
+    uint32_t qeCertDataSize{0};
+    Span qeCertData{nullptr, 0};
+    Span signedData{nullptr, 0};
+};
+
+}}} // namespace intel { namespace sgx { namespace dcap {
+
+#endif //INTEL_SGX_QVL_QUOTE_VIEW_H_
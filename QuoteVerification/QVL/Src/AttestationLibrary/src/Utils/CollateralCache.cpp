@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "CollateralCache.h"
+
+#include <Verifiers/EnclaveIdentityParser.h>
+
+#include <openssl/sha.h>
+
+#include <cstring>
+
+namespace intel { namespace sgx { namespace dcap {
+
+namespace {
+
+// approximate memory used by an entry besides its raw collateral, so that small entries are bounded too
+constexpr size_t ENTRY_OVERHEAD = 256;
+
+} // anonymous namespace
+
+CollateralCache::CollateralCache(size_t capacity)
+        : _capacity(capacity), _size(0)
+{
+}
+
+CollateralCache& CollateralCache::instance()
+{
+    static CollateralCache cache;
+    return cache;
+}
+
+CollateralCache::Digest CollateralCache::digest(EntryType type, const std::vector<const char*> &parts, size_t &rawSize)
+{
+    Digest hash{};
+    SHA256_CTX ctx;
+    const auto typeByte = static_cast<uint8_t>(type);
+    rawSize = 0;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, &typeByte, sizeof(typeByte));
+    for (const auto part : parts)
+    {
+        // terminating '\0' is hashed as well, so that parts can't be shifted between each other
+        const size_t partSize = std::strlen(part) + 1;
+        SHA256_Update(&ctx, part, partSize);
+        rawSize += partSize;
+    }
+    SHA256_Final(hash.data(), &ctx);
+    return hash;
+}
+
+CollateralCache::Digest CollateralCache::digest(EntryType type, const uint8_t *data, size_t size)
+{
+    Digest hash{};
+    SHA256_CTX ctx;
+    const auto typeByte = static_cast<uint8_t>(type);
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, &typeByte, sizeof(typeByte));
+    SHA256_Update(&ctx, data, size);
+    SHA256_Final(hash.data(), &ctx);
+    return hash;
+}
+
+std::shared_ptr<const void> CollateralCache::find(const Digest &key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _index.find(key);
+    if (it == _index.end())
+    {
+        return nullptr;
+    }
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->value;
+}
+
+void CollateralCache::insert(const Digest &key, std::shared_ptr<const void> value, size_t cost)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (cost > _capacity || _index.find(key) != _index.end())
+    {
+        return;
+    }
+    _entries.push_front(Entry{key, std::move(value), cost});
+    _index[key] = _entries.begin();
+    _size += cost;
+    while (_size > _capacity)
+    {
+        const auto &last = _entries.back();
+        _size -= last.cost;
+        _index.erase(last.key);
+        _entries.pop_back();
+    }
+}
+
+template<typename T, typename ParseFunction>
+std::shared_ptr<const T> CollateralCache::getOrParse(EntryType type, const char *raw, ParseFunction parse)
+{
+    size_t rawSize = 0;
+    const auto key = digest(type, {raw}, rawSize);
+    if (auto found = find(key))
+    {
+        return std::static_pointer_cast<const T>(found);
+    }
+
+    // parse outside of the lock, exceptions are passed to the caller and nothing is cached
+    std::shared_ptr<const T> parsed = parse(raw);
+    if (parsed)
+    {
+        insert(key, parsed, rawSize + ENTRY_OVERHEAD);
+    }
+    return parsed;
+}
+
+std::shared_ptr<const parser::json::TcbInfo> CollateralCache::getTcbInfo(const char *tcbInfo)
+{
+    std::shared_ptr<const TcbLevelMatcher> tcbLevelMatcher;
+    return getTcbInfo(tcbInfo, tcbLevelMatcher);
+}
+
+std::shared_ptr<const parser::json::TcbInfo> CollateralCache::getTcbInfo(const char *tcbInfo,
+                                                                         std::shared_ptr<const TcbLevelMatcher> &tcbLevelMatcher)
+{
+    const auto compiled = getOrParse<CompiledTcbInfo>(EntryType::TcbInfo, tcbInfo, [](const char *raw) {
+        return std::make_shared<const CompiledTcbInfo>(parser::json::TcbInfo::parse(raw));
+    });
+    // both share ownership of the cached entry
+    tcbLevelMatcher = std::shared_ptr<const TcbLevelMatcher>(compiled, &compiled->tcbLevelMatcher);
+    return std::shared_ptr<const parser::json::TcbInfo>(compiled, &compiled->tcbInfo);
+}
+
+std::shared_ptr<const EnclaveIdentity> CollateralCache::getEnclaveIdentity(const char *enclaveIdentity)
+{
+    return getOrParse<EnclaveIdentity>(EntryType::EnclaveIdentity, enclaveIdentity, [](const char *raw) {
+        return std::shared_ptr<const EnclaveIdentity>(EnclaveIdentityParser{}.parse(raw));
+    });
+}
+
+std::shared_ptr<const pckparser::CrlStore> CollateralCache::getCrl(const char *crl)
+{
+    return getOrParse<pckparser::CrlStore>(EntryType::Crl, crl, [](const char *raw) {
+        auto crlStore = std::make_shared<pckparser::CrlStore>();
+        if (!crlStore->parse(raw))
+        {
+            return std::shared_ptr<const pckparser::CrlStore>();
+        }
+        return std::shared_ptr<const pckparser::CrlStore>(std::move(crlStore));
+    });
+}
+
+std::shared_ptr<const parser::x509::Certificate> CollateralCache::getCertificate(const char *pemCertificate)
+{
+    return getOrParse<parser::x509::Certificate>(EntryType::Certificate, pemCertificate, [](const char *raw) {
+        return std::make_shared<const parser::x509::Certificate>(parser::x509::Certificate::parse(raw));
+    });
+}
+
+Status CollateralCache::getCertificateChain(const char *pemCertChain, std::shared_ptr<const CertificateChain> &chain)
+{
+    Status status = STATUS_OK;
+    auto parsed = getOrParse<CertificateChain>(EntryType::CertificateChain, pemCertChain, [&status](const char *raw) {
+        auto certificateChain = std::make_shared<CertificateChain>();
+        status = certificateChain->parse(raw);
+        if (status != STATUS_OK)
+        {
+            return std::shared_ptr<const CertificateChain>();
+        }
+        return std::shared_ptr<const CertificateChain>(std::move(certificateChain));
+    });
+    if (parsed)
+    {
+        chain = std::move(parsed);
+    }
+    return status;
+}
+
+std::shared_ptr<const PreparedCollateral> CollateralCache::getPreparedCollateral(const uint8_t *preparedCollateral, size_t size)
+{
+    const auto key = digest(EntryType::PreparedCollateral, preparedCollateral, size);
+    if (auto found = find(key))
+    {
+        return std::static_pointer_cast<const PreparedCollateral>(found);
+    }
+
+    // load outside of the lock, exceptions are passed to the caller and nothing is cached
+    auto loaded = std::make_shared<const PreparedCollateral>(PreparedCollateral::load(preparedCollateral, size));
+    insert(key, loaded, size + ENTRY_OVERHEAD);
+    return loaded;
+}
+
+Status CollateralCache::getVerificationStatus(const char *verificationName, std::initializer_list<const char*> collateral,
+                                              const std::function<Status()> &verification)
+{
+    size_t rawSize = 0;
+    std::vector<const char*> parts{verificationName};
+    parts.insert(parts.end(), collateral.begin(), collateral.end());
+    const auto key = digest(EntryType::VerificationStatus, parts, rawSize);
+
+    if (auto found = find(key))
+    {
+        return *std::static_pointer_cast<const Status>(found);
+    }
+
+    const auto status = verification();
+    insert(key, std::make_shared<const Status>(status), ENTRY_OVERHEAD);
+    return status;
+}
+
+void CollateralCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _index.clear();
+    _size = 0;
+}
+
+size_t CollateralCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+}}} // namespace intel { namespace sgx { namespace dcap {
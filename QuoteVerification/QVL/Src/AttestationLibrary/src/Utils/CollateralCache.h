@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SGXECDSAATTESTATION_COLLATERALCACHE_H
+#define SGXECDSAATTESTATION_COLLATERALCACHE_H
+
+#include <CertVerification/CertificateChain.h>
+#include <PckParser/CrlStore.h>
+#include <Verifiers/EnclaveIdentity.h>
+#include <Verifiers/TcbLevelMatcher.h>
+#include <Utils/PreparedCollateral.h>
+#include <SgxEcdsaAttestation/AttestationParsers.h>
+#include <SgxEcdsaAttestation/QuoteVerification.h>
+
+#include <array>
+#include <functional>
+#include <initializer_list>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap {
+
+/**
+ * Bounded LRU cache of parsed verification collateral and of the time independent part of its verification,
+ * keyed by SHA-256 of the raw collateral. Quotes from the same platforms share a handful of collateral sets,
+ * so on a hit only the per quote checks have to run. Collateral that fails to parse is never cached.
+ */
+class CollateralCache
+{
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    /**
+     * Default budget in bytes of raw collateral, least recently used entries are evicted above it.
+     * The QvE heap is small, so the enclave keeps about two collateral sets only.
+     */
+#ifdef SGX_TRUSTED
+    static constexpr size_t DEFAULT_CAPACITY = 48 * 1024;
+#else
+    static constexpr size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+#endif
+
+    explicit CollateralCache(size_t capacity = DEFAULT_CAPACITY);
+    CollateralCache(const CollateralCache&) = delete;
+    CollateralCache(CollateralCache&&) = delete;
+    CollateralCache& operator=(const CollateralCache&) = delete;
+    CollateralCache& operator=(CollateralCache&&) = delete;
+    virtual ~CollateralCache() = default;
+
+    /**
+     * Get the cache shared by the library API.
+     */
+    static CollateralCache& instance();
+
+    /**
+     * Get parsed TCB info.
+     * @throws the exceptions of parser::json::TcbInfo::parse
+     */
+    std::shared_ptr<const parser::json::TcbInfo> getTcbInfo(const char *tcbInfo);
+
+    /**
+     * Get parsed TCB info together with its compiled TCB levels, both are cached in the same entry.
+     * @throws the exceptions of parser::json::TcbInfo::parse
+     */
+    std::shared_ptr<const parser::json::TcbInfo> getTcbInfo(const char *tcbInfo,
+                                                            std::shared_ptr<const TcbLevelMatcher> &tcbLevelMatcher);
+
+    /**
+     * Get parsed enclave identity.
+     * @throws ParserException
+     */
+    std::shared_ptr<const EnclaveIdentity> getEnclaveIdentity(const char *enclaveIdentity);
+
+    /**
+     * Get parsed CRL.
+     * @return nullptr if CRL can't be parsed
+     */
+    std::shared_ptr<const pckparser::CrlStore> getCrl(const char *crl);
+
+    /**
+     * Get parsed certificate.
+     * @throws the exceptions of parser::x509::Certificate::parse
+     */
+    std::shared_ptr<const parser::x509::Certificate> getCertificate(const char *pemCertificate);
+
+    /**
+     * Get parsed certificate chain.
+     * @param pemCertChain - string of concatenated PEM certificates
+     * @param chain - parsed chain, set only on success
+     * @return status of CertificateChain::parse
+     */
+    Status getCertificateChain(const char *pemCertChain, std::shared_ptr<const CertificateChain> &chain);
+
+    /**
+     * Get loaded prepared collateral.
+     * @param preparedCollateral - prepared collateral, see PreparedCollateral
+     * @param size - size of prepared collateral in bytes
+     * @throws the exceptions of PreparedCollateral::load
+     */
+    std::shared_ptr<const PreparedCollateral> getPreparedCollateral(const uint8_t *preparedCollateral, size_t size);
+
+    /**
+     * Get memoized status of a verification depending only on the given collateral. The verification runs,
+     * and its status is stored, when there's none for this collateral yet.
+     *
+     * @param verificationName - name of the verification, part of the key
+     * @param collateral - raw collateral the verification depends on
+     * @param verification - verification to run on a miss
+     * @return status of the verification
+     */
+    Status getVerificationStatus(const char *verificationName, std::initializer_list<const char*> collateral,
+                                 const std::function<Status()> &verification);
+
+    /**
+     * Drop all entries.
+     */
+    void clear();
+
+    /**
+     * Get number of cached entries.
+     */
+    size_t size() const;
+
+private:
+    enum class EntryType : uint8_t
+    {
+        TcbInfo,
+        EnclaveIdentity,
+        Crl,
+        Certificate,
+        CertificateChain,
+        VerificationStatus,
+        PreparedCollateral
+    };
+
+    struct CompiledTcbInfo
+    {
+        explicit CompiledTcbInfo(const parser::json::TcbInfo &parsed): tcbInfo(parsed), tcbLevelMatcher(tcbInfo) {}
+
+        const parser::json::TcbInfo tcbInfo;
+        const TcbLevelMatcher tcbLevelMatcher;
+    };
+
+    struct Entry
+    {
+        Digest key;
+        std::shared_ptr<const void> value;
+        size_t cost;
+    };
+
+    static Digest digest(EntryType type, const std::vector<const char*> &parts, size_t &rawSize);
+    static Digest digest(EntryType type, const uint8_t *data, size_t size);
+
+    std::shared_ptr<const void> find(const Digest &key);
+    void insert(const Digest &key, std::shared_ptr<const void> value, size_t cost);
+
+    template<typename T, typename ParseFunction>
+    std::shared_ptr<const T> getOrParse(EntryType type, const char *raw, ParseFunction parse);
+
+    const size_t _capacity;
+    size_t _size;
+    std::list<Entry> _entries; // most recently used first
+    std::map<Digest, std::list<Entry>::iterator> _index;
+    mutable std::mutex _mutex;
+};
+
+}}} // namespace intel { namespace sgx { namespace dcap {
+
+#endif //SGXECDSAATTESTATION_COLLATERALCACHE_H
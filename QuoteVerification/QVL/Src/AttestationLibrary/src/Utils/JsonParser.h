@@ -53,6 +53,12 @@ public:
     bool parse(const std::string& json);
     const rapidjson::Value* getRoot() const;
     const rapidjson::Value* getField(const std::string& fieldName) const;
+    /**
+     * Locate an object or array field of the root object in the text given to parse.
+     * @param fieldName name of the field
+     * @return offset and length of the field value, exactly as it is in the parsed text, or zeros if there's no such field
+     */
+    std::pair<size_t, size_t> getFieldSpan(const std::string& fieldName) const;
     std::pair<std::vector<uint8_t>, ParseStatus> getHexstringFieldOf(const ::rapidjson::Value& parent, const std::string& fieldName, size_t length) const;
     std::pair<std::string, ParseStatus> getStringFieldOf(const ::rapidjson::Value &parent, const std::string &fieldName) const;
     std::pair<tm, ParseStatus> getDateFieldOf(const ::rapidjson::Value& parent, const std::string& fieldName) const;
@@ -64,6 +70,7 @@ private:
     bool isValidHexstring(const std::string& hexString) const;
 
     rapidjson::Document jsonDocument;
+    std::vector<std::pair<std::string, std::pair<size_t, size_t>>> fieldSpans;
 };
 
 }}} // namespace intel { namespace sgx { namespace dcap {
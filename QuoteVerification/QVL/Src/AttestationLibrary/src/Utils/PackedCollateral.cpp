@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "PackedCollateral.h"
+
+#include <cstring>
+
+namespace intel { namespace sgx { namespace dcap {
+
+constexpr size_t PackedCollateral::FIELD_COUNT;
+constexpr size_t PackedCollateral::HEADER_SIZE;
+constexpr uint32_t PackedCollateral::PREPARED_VERSION;
+
+bool PackedCollateral::isFieldUsed(uint32_t version, size_t field)
+{
+    //prepared collateral is binary, it's in TcbInfo only
+    return version != PREPARED_VERSION || field == static_cast<size_t>(Field::TcbInfo);
+}
+
+bool PackedCollateral::append(const Collateral& collateral, size_t maxSize, std::vector<uint8_t>& packed)
+{
+    size_t packedSize = HEADER_SIZE;
+    for (size_t i = 0; i < FIELD_COUNT; i++)
+    {
+        if (!isFieldUsed(collateral.version, i))
+        {
+            if (collateral.fields[i] != nullptr || collateral.sizes[i] != 0)
+            {
+                return false;
+            }
+            continue;
+        }
+        if (collateral.fields[i] == nullptr || collateral.sizes[i] == 0)
+        {
+            return false;
+        }
+        packedSize += collateral.sizes[i];
+    }
+    if (packed.size() > maxSize || packedSize > maxSize - packed.size())
+    {
+        return false;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    std::memcpy(header, &collateral.version, sizeof(collateral.version));
+    std::memcpy(header + sizeof(collateral.version), collateral.sizes.data(), FIELD_COUNT * sizeof(uint32_t));
+
+    packed.reserve(packed.size() + packedSize);
+    packed.insert(packed.end(), header, header + HEADER_SIZE);
+    for (size_t i = 0; i < FIELD_COUNT; i++)
+    {
+        if (collateral.sizes[i] != 0)
+        {
+            packed.insert(packed.end(), collateral.fields[i], collateral.fields[i] + collateral.sizes[i]);
+        }
+    }
+    return true;
+}
+
+bool PackedCollateral::unpack(const uint8_t *data, size_t size, std::vector<Collateral>& collaterals)
+{
+    size_t offset = 0;
+    while (offset < size)
+    {
+        if (size - offset < HEADER_SIZE)
+        {
+            return false;
+        }
+        Collateral collateral{};
+        std::memcpy(&collateral.version, data + offset, sizeof(collateral.version));
+        std::memcpy(collateral.sizes.data(), data + offset + sizeof(collateral.version), FIELD_COUNT * sizeof(uint32_t));
+        offset += HEADER_SIZE;
+
+        for (size_t i = 0; i < FIELD_COUNT; i++)
+        {
+            if (!isFieldUsed(collateral.version, i))
+            {
+                if (collateral.sizes[i] != 0)
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (collateral.sizes[i] == 0 || size - offset < collateral.sizes[i])
+            {
+                return false;
+            }
+            collateral.fields[i] = reinterpret_cast<const char*>(data + offset);
+            offset += collateral.sizes[i];
+        }
+        collaterals.push_back(collateral);
+    }
+    return true;
+}
+
+}}} // namespace intel { namespace sgx { namespace dcap {
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_PACKEDCOLLATERAL_H
+#define SGXECDSAATTESTATION_PACKEDCOLLATERAL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap {
+
+/**
+ * Collaterals of a batch verification packed into one buffer, so that they are copied into the QvE by one ECALL.
+ *
+ * Each packed collateral is a header followed by its fields, the header is in host byte order:
+ *   [0]  uint32  collateral version
+ *   [4]  7 x uint32 sizes of the fields, in the order of Field
+ *
+ * Fields are the NUL terminated collateral strings, or the prepared collateral in TcbInfo for collateral version
+ * PREPARED_VERSION, which has no other fields. Packed collaterals are concatenated.
+ */
+class PackedCollateral
+{
+public:
+    enum class Field : uint8_t
+    {
+        PckCrlIssuerChain,
+        RootCaCrl,
+        PckCrl,
+        TcbInfoIssuerChain,
+        TcbInfo,
+        QeIdentityIssuerChain,
+        QeIdentity,
+        Count
+    };
+
+    static constexpr size_t FIELD_COUNT = static_cast<size_t>(Field::Count);
+    static constexpr size_t HEADER_SIZE = 4 + FIELD_COUNT * 4;
+    static constexpr uint32_t PREPARED_VERSION = 0x100; // QVE_COLLATERAL_VERSION_PREPARED
+
+    struct Collateral
+    {
+        uint32_t version;
+        std::array<const char*, FIELD_COUNT> fields;
+        std::array<uint32_t, FIELD_COUNT> sizes;
+    };
+
+    /**
+     * Append a collateral to packed collaterals.
+     * @param maxSize - limit of the size of the packed collaterals
+     * @return false if a field the collateral version requires is missing, if a field it has no place for is set
+     *         or if the packed collaterals would exceed maxSize. packed is unchanged then.
+     */
+    static bool append(const Collateral& collateral, size_t maxSize, std::vector<uint8_t>& packed);
+
+    /**
+     * Split packed collaterals. Fields of the unpacked collaterals point into data, fields the collateral version
+     * has no place for are NULL.
+     * @return false if the packed collaterals are malformed
+     */
+    static bool unpack(const uint8_t *data, size_t size, std::vector<Collateral>& collaterals);
+
+private:
+    static bool isFieldUsed(uint32_t version, size_t field);
+};
+
+}}} // namespace intel { namespace sgx { namespace dcap {
+
+#endif //SGXECDSAATTESTATION_PACKEDCOLLATERAL_H
@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "PreparedCollateral.h"
+#include "RuntimeException.h"
+
+#include <OpensslHelpers/Bytes.h>
+#include <OpensslHelpers/OpensslTypes.h>
+#include <PckParser/FormatException.h>
+#include <Verifiers/EnclaveIdentityParser.h>
+
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/sha.h>
+
+#include <cstring>
+
+namespace intel { namespace sgx { namespace dcap {
+
+namespace {
+
+constexpr size_t SECTION_TABLE_OFFSET = 32;
+
+uint64_t readLittleEndian(const uint8_t *data, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; i--)
+    {
+        value = (value << 8) | data[i - 1];
+    }
+    return value;
+}
+
+void writeLittleEndian(std::vector<uint8_t> &out, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+// bounds checked reader of a section
+class SectionReader
+{
+public:
+    SectionReader(const uint8_t *data, size_t size): _data(data), _size(size), _offset(0) {}
+
+    uint32_t readUint32()
+    {
+        return static_cast<uint32_t>(readLittleEndian(read(sizeof(uint32_t)), sizeof(uint32_t)));
+    }
+
+    const uint8_t* read(size_t size)
+    {
+        if (size > _size - _offset)
+        {
+            throw RuntimeException(STATUS_INVALID_PARAMETER);
+        }
+        const auto *data = _data + _offset;
+        _offset += size;
+        return data;
+    }
+
+    size_t remaining() const
+    {
+        return _size - _offset;
+    }
+
+private:
+    const uint8_t *_data;
+    size_t _size;
+    size_t _offset;
+};
+
+std::shared_ptr<const CertificateChain> loadCertificateChain(SectionReader section)
+{
+    const auto count = section.readUint32();
+    std::vector<std::vector<uint8_t>> derCerts;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const auto size = section.readUint32();
+        const auto *der = section.read(size);
+        derCerts.emplace_back(der, der + size);
+    }
+    if (section.remaining() != 0)
+    {
+        throw RuntimeException(STATUS_INVALID_PARAMETER);
+    }
+
+    auto chain = std::make_shared<CertificateChain>();
+    const auto status = chain->parseDer(derCerts);
+    if (status != STATUS_OK)
+    {
+        throw RuntimeException(status);
+    }
+    return chain;
+}
+
+std::shared_ptr<const pckparser::CrlStore> loadCrl(SectionReader section)
+{
+    const auto size = section.remaining();
+    const auto *der = section.read(size);
+    auto crl = std::make_shared<pckparser::CrlStore>();
+    if (!crl->parseDer(std::vector<uint8_t>(der, der + size)))
+    {
+        throw RuntimeException(STATUS_SGX_CRL_UNSUPPORTED_FORMAT);
+    }
+    return crl;
+}
+
+// signed JSON body and its signature, put back into the PCS format for the JSON parsers
+std::string loadSignedJson(SectionReader section, const char *bodyName, std::string &body)
+{
+    const auto bodySize = section.readUint32();
+    const auto *bodyData = section.read(bodySize);
+    const auto signatureSize = section.remaining();
+    const auto *signature = section.read(signatureSize);
+
+    body.assign(reinterpret_cast<const char*>(bodyData), bodySize);
+    return std::string("{\"") + bodyName + "\":" + body + ",\"signature\":\""
+           + bytesToHexString(std::vector<uint8_t>(signature, signature + signatureSize)) + "\"}";
+}
+
+std::vector<std::vector<uint8_t>> pemCertificateChainToDer(const char *pemCertChain)
+{
+    std::vector<std::vector<uint8_t>> derCerts;
+    auto bio = crypto::make_unique(BIO_new_mem_buf(pemCertChain, -1));
+    while (bio)
+    {
+        auto cert = crypto::make_unique(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+        if (!cert)
+        {
+            break;
+        }
+        const int size = i2d_X509(cert.get(), nullptr);
+        if (size <= 0)
+        {
+            break;
+        }
+        std::vector<uint8_t> der(static_cast<size_t>(size));
+        auto *out = der.data();
+        i2d_X509(cert.get(), &out);
+        derCerts.push_back(std::move(der));
+    }
+    // reading past the last certificate leaves an error on the queue
+    ERR_clear_error();
+
+    if (derCerts.empty())
+    {
+        throw RuntimeException(STATUS_UNSUPPORTED_CERT_FORMAT);
+    }
+    return derCerts;
+}
+
+std::vector<uint8_t> crlToDer(const char *crl)
+{
+    try
+    {
+        const auto x509Crl = pckparser::str2X509Crl(crl);
+        const int size = i2d_X509_CRL(x509Crl.get(), nullptr);
+        if (size <= 0)
+        {
+            throw RuntimeException(STATUS_SGX_CRL_UNSUPPORTED_FORMAT);
+        }
+        std::vector<uint8_t> der(static_cast<size_t>(size));
+        auto *out = der.data();
+        i2d_X509_CRL(x509Crl.get(), &out);
+        return der;
+    }
+    catch (const pckparser::FormatException&)
+    {
+        throw RuntimeException(STATUS_SGX_CRL_UNSUPPORTED_FORMAT);
+    }
+}
+
+void appendCertificateChain(std::vector<uint8_t> &out, const std::vector<std::vector<uint8_t>> &derCerts)
+{
+    writeLittleEndian(out, derCerts.size(), sizeof(uint32_t));
+    for (const auto &der : derCerts)
+    {
+        writeLittleEndian(out, der.size(), sizeof(uint32_t));
+        out.insert(out.end(), der.cbegin(), der.cend());
+    }
+}
+
+void appendSignedJson(std::vector<uint8_t> &out, const std::vector<uint8_t> &body, const std::vector<uint8_t> &signature)
+{
+    writeLittleEndian(out, body.size(), sizeof(uint32_t));
+    out.insert(out.end(), body.cbegin(), body.cend());
+    out.insert(out.end(), signature.cbegin(), signature.cend());
+}
+
+} // anonymous namespace
+
+constexpr uint32_t PreparedCollateral::MAGIC;
+constexpr uint16_t PreparedCollateral::FORMAT_VERSION;
+constexpr size_t PreparedCollateral::HEADER_SIZE;
+
+std::vector<uint8_t> PreparedCollateral::build(uint16_t collateralVersion,
+                                               const char *pckCrlIssuerChain,
+                                               const char *rootCaCrl,
+                                               const char *pckCrl,
+                                               const char *tcbInfoIssuerChain,
+                                               const char *tcbInfo,
+                                               const char *qeIdentityIssuerChain,
+                                               const char *qeIdentity)
+{
+    if (pckCrlIssuerChain == nullptr || rootCaCrl == nullptr || pckCrl == nullptr || tcbInfoIssuerChain == nullptr
+        || tcbInfo == nullptr || qeIdentityIssuerChain == nullptr || qeIdentity == nullptr)
+    {
+        throw RuntimeException(STATUS_MISSING_PARAMETERS);
+    }
+
+    std::unique_ptr<const parser::json::TcbInfo> parsedTcbInfo;
+    try
+    {
+        parsedTcbInfo.reset(new parser::json::TcbInfo(parser::json::TcbInfo::parse(tcbInfo)));
+    }
+    catch (const parser::FormatException&)
+    {
+        throw RuntimeException(STATUS_SGX_TCB_INFO_UNSUPPORTED_FORMAT);
+    }
+    catch (const parser::InvalidExtensionException&)
+    {
+        throw RuntimeException(STATUS_SGX_TCB_INFO_INVALID);
+    }
+
+    std::unique_ptr<const EnclaveIdentity> parsedQeIdentity;
+    try
+    {
+        parsedQeIdentity = EnclaveIdentityParser{}.parse(qeIdentity);
+    }
+    catch (const ParserException &e)
+    {
+        throw RuntimeException(e.getStatus());
+    }
+
+    // sections in the order of Section
+    std::vector<std::vector<uint8_t>> sections(static_cast<size_t>(Section::Count));
+    appendCertificateChain(sections[static_cast<size_t>(Section::PckCrlIssuerChain)], pemCertificateChainToDer(pckCrlIssuerChain));
+    sections[static_cast<size_t>(Section::RootCaCrl)] = crlToDer(rootCaCrl);
+    sections[static_cast<size_t>(Section::PckCrl)] = crlToDer(pckCrl);
+    appendCertificateChain(sections[static_cast<size_t>(Section::TcbInfoIssuerChain)], pemCertificateChainToDer(tcbInfoIssuerChain));
+    appendSignedJson(sections[static_cast<size_t>(Section::TcbInfo)], parsedTcbInfo->getInfoBody(), parsedTcbInfo->getSignature());
+    appendCertificateChain(sections[static_cast<size_t>(Section::QeIdentityIssuerChain)], pemCertificateChainToDer(qeIdentityIssuerChain));
+    appendSignedJson(sections[static_cast<size_t>(Section::QeIdentity)], parsedQeIdentity->getBody(), parsedQeIdentity->getSignature());
+
+    std::vector<uint8_t> prepared;
+    writeLittleEndian(prepared, MAGIC, sizeof(uint32_t));
+    writeLittleEndian(prepared, FORMAT_VERSION, sizeof(uint16_t));
+    writeLittleEndian(prepared, collateralVersion, sizeof(uint16_t));
+    prepared.insert(prepared.end(), parsedTcbInfo->getFmspc().cbegin(), parsedTcbInfo->getFmspc().cend());
+    prepared.insert(prepared.end(), parsedTcbInfo->getPceId().cbegin(), parsedTcbInfo->getPceId().cend());
+    writeLittleEndian(prepared, static_cast<uint64_t>(parsedTcbInfo->getNextUpdate()), sizeof(uint64_t));
+    writeLittleEndian(prepared, static_cast<uint64_t>(parsedQeIdentity->getNextUpdate()), sizeof(uint64_t));
+
+    size_t offset = HEADER_SIZE;
+    for (const auto &section : sections)
+    {
+        writeLittleEndian(prepared, offset, sizeof(uint32_t));
+        writeLittleEndian(prepared, section.size(), sizeof(uint32_t));
+        offset += section.size();
+    }
+    for (const auto &section : sections)
+    {
+        prepared.insert(prepared.end(), section.cbegin(), section.cend());
+    }
+    return prepared;
+}
+
+PreparedCollateral::Header PreparedCollateral::parseHeader(const uint8_t *data, size_t size)
+{
+    if (data == nullptr || size < HEADER_SIZE
+        || readLittleEndian(data, sizeof(uint32_t)) != MAGIC
+        || readLittleEndian(data + 4, sizeof(uint16_t)) != FORMAT_VERSION)
+    {
+        throw RuntimeException(STATUS_INVALID_PARAMETER);
+    }
+
+    Header header{};
+    header.collateralVersion = static_cast<uint16_t>(readLittleEndian(data + 6, sizeof(uint16_t)));
+    std::memcpy(header.fmspc.data(), data + 8, header.fmspc.size());
+    std::memcpy(header.pceId.data(), data + 14, header.pceId.size());
+    header.tcbInfoNextUpdate = static_cast<std::time_t>(readLittleEndian(data + 16, sizeof(uint64_t)));
+    header.qeIdentityNextUpdate = static_cast<std::time_t>(readLittleEndian(data + 24, sizeof(uint64_t)));
+    return header;
+}
+
+PreparedCollateral PreparedCollateral::load(const uint8_t *data, size_t size)
+{
+    PreparedCollateral prepared;
+    prepared._header = parseHeader(data, size);
+
+    std::vector<SectionReader> sections;
+    for (size_t i = 0; i < static_cast<size_t>(Section::Count); i++)
+    {
+        const auto *entry = data + SECTION_TABLE_OFFSET + i * 8;
+        const auto sectionOffset = readLittleEndian(entry, sizeof(uint32_t));
+        const auto sectionSize = readLittleEndian(entry + 4, sizeof(uint32_t));
+        if (sectionOffset < HEADER_SIZE || sectionOffset > size || sectionSize > size - sectionOffset)
+        {
+            throw RuntimeException(STATUS_INVALID_PARAMETER);
+        }
+        sections.emplace_back(data + sectionOffset, static_cast<size_t>(sectionSize));
+    }
+
+    prepared._pckCrlIssuerChain = loadCertificateChain(sections[static_cast<size_t>(Section::PckCrlIssuerChain)]);
+    prepared._rootCaCrl = loadCrl(sections[static_cast<size_t>(Section::RootCaCrl)]);
+    prepared._pckCrl = loadCrl(sections[static_cast<size_t>(Section::PckCrl)]);
+    prepared._tcbInfoIssuerChain = loadCertificateChain(sections[static_cast<size_t>(Section::TcbInfoIssuerChain)]);
+    prepared._qeIdentityIssuerChain = loadCertificateChain(sections[static_cast<size_t>(Section::QeIdentityIssuerChain)]);
+
+    // JSON bodies are parsed again, only signed content can be trusted. Parsers serialize the body they check
+    // signatures of, which must be the stored body, so that the signature covers what was parsed.
+    std::string body;
+    const auto tcbInfoJson = loadSignedJson(sections[static_cast<size_t>(Section::TcbInfo)], "tcbInfo", body);
+    try
+    {
+        auto tcbInfo = std::make_shared<const parser::json::TcbInfo>(parser::json::TcbInfo::parse(tcbInfoJson));
+        prepared._tcbLevelMatcher = std::make_shared<const TcbLevelMatcher>(*tcbInfo);
+        prepared._tcbInfo = std::move(tcbInfo);
+    }
+    catch (const parser::FormatException&)
+    {
+        throw RuntimeException(STATUS_SGX_TCB_INFO_UNSUPPORTED_FORMAT);
+    }
+    catch (const parser::InvalidExtensionException&)
+    {
+        throw RuntimeException(STATUS_SGX_TCB_INFO_INVALID);
+    }
+    const auto &tcbInfo = *prepared._tcbInfo;
+    const auto &header = prepared._header;
+    if (tcbInfo.getInfoBody() != std::vector<uint8_t>(body.cbegin(), body.cend())
+        || tcbInfo.getFmspc() != std::vector<uint8_t>(header.fmspc.cbegin(), header.fmspc.cend())
+        || tcbInfo.getPceId() != std::vector<uint8_t>(header.pceId.cbegin(), header.pceId.cend())
+        || tcbInfo.getNextUpdate() != header.tcbInfoNextUpdate)
+    {
+        throw RuntimeException(STATUS_SGX_TCB_INFO_INVALID);
+    }
+
+    const auto qeIdentityJson = loadSignedJson(sections[static_cast<size_t>(Section::QeIdentity)], "enclaveIdentity", body);
+    try
+    {
+        prepared._qeIdentity = EnclaveIdentityParser{}.parse(qeIdentityJson);
+    }
+    catch (const ParserException &e)
+    {
+        throw RuntimeException(e.getStatus());
+    }
+    if (prepared._qeIdentity->getBody() != std::vector<uint8_t>(body.cbegin(), body.cend())
+        || prepared._qeIdentity->getNextUpdate() != header.qeIdentityNextUpdate)
+    {
+        throw RuntimeException(STATUS_SGX_ENCLAVE_IDENTITY_INVALID);
+    }
+
+    std::vector<uint8_t> digest(SHA256_DIGEST_LENGTH);
+    SHA256(data, size, digest.data());
+    prepared._digest = bytesToHexString(digest);
+
+    return prepared;
+}
+
+const PreparedCollateral::Header& PreparedCollateral::getHeader() const
+{
+    return _header;
+}
+
+const std::string& PreparedCollateral::getDigest() const
+{
+    return _digest;
+}
+
+const std::shared_ptr<const CertificateChain>& PreparedCollateral::getPckCrlIssuerChain() const
+{
+    return _pckCrlIssuerChain;
+}
+
+const std::shared_ptr<const pckparser::CrlStore>& PreparedCollateral::getRootCaCrl() const
+{
+    return _rootCaCrl;
+}
+
+const std::shared_ptr<const pckparser::CrlStore>& PreparedCollateral::getPckCrl() const
+{
+    return _pckCrl;
+}
+
+const std::shared_ptr<const CertificateChain>& PreparedCollateral::getTcbInfoIssuerChain() const
+{
+    return _tcbInfoIssuerChain;
+}
+
+const std::shared_ptr<const parser::json::TcbInfo>& PreparedCollateral::getTcbInfo() const
+{
+    return _tcbInfo;
+}
+
+const std::shared_ptr<const TcbLevelMatcher>& PreparedCollateral::getTcbLevelMatcher() const
+{
+    return _tcbLevelMatcher;
+}
+
+const std::shared_ptr<const CertificateChain>& PreparedCollateral::getQeIdentityIssuerChain() const
+{
+    return _qeIdentityIssuerChain;
+}
+
+const std::shared_ptr<const EnclaveIdentity>& PreparedCollateral::getQeIdentity() const
+{
+    return _qeIdentity;
+}
+
+}}} // namespace intel { namespace sgx { namespace dcap {
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_PREPAREDCOLLATERAL_H
+#define SGXECDSAATTESTATION_PREPAREDCOLLATERAL_H
+
+#include <CertVerification/CertificateChain.h>
+#include <CertVerification/X509Constants.h>
+#include <PckParser/CrlStore.h>
+#include <Verifiers/EnclaveIdentity.h>
+#include <Verifiers/TcbLevelMatcher.h>
+#include <SgxEcdsaAttestation/AttestationParsers.h>
+#include <SgxEcdsaAttestation/QuoteVerification.h>
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap {
+
+/**
+ * Verification collateral of one FMSPC decoded ahead of time into a compact binary form, so that it can be built once
+ * by the untrusted side and loaded without PEM, base64 and hex decoding.
+ *
+ * All integers are little endian. The header is at fixed offsets:
+ *   [0]  uint32  magic "QVPC"
+ *   [4]  uint16  format version
+ *   [6]  uint16  version of the collateral it was built from, which selects the trusted root CA
+ *   [8]  6 bytes FMSPC of the TCB info
+ *   [14] 2 bytes PCE ID of the TCB info
+ *   [16] int64   next update of the TCB info
+ *   [24] int64   next update of the QE identity
+ *   [32] 7 x (uint32 offset, uint32 size) of the sections, in the order of Section
+ *
+ * Certificate chains are a uint32 count followed by (uint32 size, DER certificate) for each certificate, CRLs are DER
+ * and TCB info and QE identity are a uint32 size followed by the signed JSON body and by the signature.
+ *
+ * Fields of the header are not covered by any signature. They are only meant for the untrusted side to index
+ * prepared collateral, loading rejects prepared collateral whose header differs from the signed content.
+ */
+class PreparedCollateral
+{
+public:
+    enum class Section : uint8_t
+    {
+        PckCrlIssuerChain,
+        RootCaCrl,
+        PckCrl,
+        TcbInfoIssuerChain,
+        TcbInfo,
+        QeIdentityIssuerChain,
+        QeIdentity,
+        Count
+    };
+
+    struct Header
+    {
+        uint16_t collateralVersion;
+        std::array<uint8_t, constants::FMSPC_BYTE_LEN> fmspc;
+        std::array<uint8_t, constants::PCEID_BYTE_LEN> pceId;
+        std::time_t tcbInfoNextUpdate;
+        std::time_t qeIdentityNextUpdate;
+    };
+
+    static constexpr uint32_t MAGIC = 0x43505651; // "QVPC"
+    static constexpr uint16_t FORMAT_VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32 + static_cast<size_t>(Section::Count) * 8;
+
+    /**
+     * Build prepared collateral from the collateral returned by PCS.
+     * @param collateralVersion - version of the collateral, stored in the header
+     * @return prepared collateral
+     *
+     * @throws RuntimeException with status of the collateral that can't be parsed
+     */
+    static std::vector<uint8_t> build(uint16_t collateralVersion,
+                                      const char *pckCrlIssuerChain,
+                                      const char *rootCaCrl,
+                                      const char *pckCrl,
+                                      const char *tcbInfoIssuerChain,
+                                      const char *tcbInfo,
+                                      const char *qeIdentityIssuerChain,
+                                      const char *qeIdentity);
+
+    /**
+     * Decode the header of prepared collateral, without loading it.
+     * @throws RuntimeException with STATUS_INVALID_PARAMETER if it's not prepared collateral of a supported format version
+     */
+    static Header parseHeader(const uint8_t *data, size_t size);
+
+    /**
+     * Load prepared collateral. Signatures are not verified here, the loaded collateral goes through the same
+     * verifiers as collateral parsed from PCS format.
+     *
+     * @throws RuntimeException with STATUS_INVALID_PARAMETER if layout is invalid, or with status of the section that
+     *         can't be parsed or doesn't match the header
+     */
+    static PreparedCollateral load(const uint8_t *data, size_t size);
+
+    const Header& getHeader() const;
+
+    /**
+     * Get hex encoded SHA-256 of the prepared collateral, it identifies the collateral in memoized verifications.
+     */
+    const std::string& getDigest() const;
+
+    const std::shared_ptr<const CertificateChain>& getPckCrlIssuerChain() const;
+    const std::shared_ptr<const pckparser::CrlStore>& getRootCaCrl() const;
+    const std::shared_ptr<const pckparser::CrlStore>& getPckCrl() const;
+    const std::shared_ptr<const CertificateChain>& getTcbInfoIssuerChain() const;
+    const std::shared_ptr<const parser::json::TcbInfo>& getTcbInfo() const;
+    const std::shared_ptr<const TcbLevelMatcher>& getTcbLevelMatcher() const;
+    const std::shared_ptr<const CertificateChain>& getQeIdentityIssuerChain() const;
+    const std::shared_ptr<const EnclaveIdentity>& getQeIdentity() const;
+
+private:
+    PreparedCollateral() = default;
+
+    Header _header{};
+    std::string _digest;
+    std::shared_ptr<const CertificateChain> _pckCrlIssuerChain;
+    std::shared_ptr<const pckparser::CrlStore> _rootCaCrl;
+    std::shared_ptr<const pckparser::CrlStore> _pckCrl;
+    std::shared_ptr<const CertificateChain> _tcbInfoIssuerChain;
+    std::shared_ptr<const parser::json::TcbInfo> _tcbInfo;
+    std::shared_ptr<const TcbLevelMatcher> _tcbLevelMatcher;
+    std::shared_ptr<const CertificateChain> _qeIdentityIssuerChain;
+    std::shared_ptr<const EnclaveIdentity> _qeIdentity;
+};
+
+}}} // namespace intel { namespace sgx { namespace dcap {
+
+#endif //SGXECDSAATTESTATION_PREPAREDCOLLATERAL_H
@@ -107,12 +107,7 @@ bool CommonVerifier::checkSignature(const pckparser::CrlStore &crl, const dcap::
 
 bool CommonVerifier::checkSha256EcdsaSignature(const Bytes &signature, const std::vector<uint8_t> &message,
                                                const std::vector<uint8_t> &publicKey) const {
-    auto pubKey = crypto::rawToP256PubKey(publicKey);
-    if (pubKey == nullptr)
-    {
-        return false;
-    }
-    return crypto::verifySha256EcdsaSignature(signature, message, *pubKey);
+    return crypto::verifySha256EcdsaSignature(signature, message, publicKey);
 }
 
 }}} // namespace intel { namespace sgx { namespace dcap {
@@ -46,6 +46,11 @@ namespace intel { namespace sgx { namespace dcap {
         signature = p_signature;
     }
 
+    void EnclaveIdentity::setBody(std::vector<uint8_t> &p_body)
+    {
+        body = p_body;
+    }
+
     std::vector<uint8_t> EnclaveIdentity::getBody() const
     {
         return body;
@@ -63,6 +63,7 @@ namespace intel { namespace sgx { namespace dcap {
         virtual ~EnclaveIdentity() = default;
 
         virtual void setSignature(std::vector<uint8_t> &p_signature);
+        virtual void setBody(std::vector<uint8_t> &p_body);
         virtual std::vector<uint8_t> getBody() const;
         virtual std::vector<uint8_t> getSignature() const;
 
@@ -71,11 +71,13 @@ namespace intel { namespace sgx { namespace dcap {
 
         // v1 qeidentity has a different field name for enclave identity body.
         // First check if it exists.
-        auto identityField = jsonParser.getField("qeIdentity");
+        std::string identityFieldName = "qeIdentity";
+        auto identityField = jsonParser.getField(identityFieldName);
         if (identityField == nullptr)
         {
             // If not take new field
-            identityField = jsonParser.getField("enclaveIdentity");
+            identityFieldName = "enclaveIdentity";
+            identityField = jsonParser.getField(identityFieldName);
         }
 
         if (identityField == nullptr || !identityField->IsObject())
@@ -83,6 +85,11 @@ namespace intel { namespace sgx { namespace dcap {
             throw ParserException(STATUS_SGX_ENCLAVE_IDENTITY_INVALID);
         }
 
+        // Signature covers the body exactly as it was issued
+        const auto bodySpan = jsonParser.getFieldSpan(identityFieldName);
+        auto bodyBytes = std::vector<uint8_t>(input.cbegin() + static_cast<std::ptrdiff_t>(bodySpan.first),
+                                              input.cbegin() + static_cast<std::ptrdiff_t>(bodySpan.first + bodySpan.second));
+
         std::tie(version, status) = jsonParser.getIntFieldOf(*identityField, "version");
         if (status != JsonParser::OK)
         {
@@ -100,6 +107,7 @@ namespace intel { namespace sgx { namespace dcap {
                     throw ParserException(identity->getStatus());
                 }
                 identity->setSignature(signatureBytes);
+                identity->setBody(bodyBytes);
 
                 return identity;
             }
@@ -111,6 +119,7 @@ namespace intel { namespace sgx { namespace dcap {
                     throw ParserException(identity->getStatus());
                 }
                 identity->setSignature(signatureBytes);
+                identity->setBody(bodyBytes);
                 return identity;
             }
             default:
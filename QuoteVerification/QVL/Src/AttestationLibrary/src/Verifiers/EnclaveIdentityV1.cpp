@@ -33,9 +33,6 @@
 #include "CertVerification/X509Constants.h"
 #include "Utils/TimeUtils.h"
 
-#include <rapidjson/writer.h>
-#include <rapidjson/stringbuffer.h>
-
 #include <tuple>
 
 namespace intel { namespace sgx { namespace dcap {
@@ -60,11 +57,6 @@ namespace intel { namespace sgx { namespace dcap {
             return;
         }
 
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        p_body.Accept(writer);
-
-        body = std::vector<uint8_t>{buffer.GetString(), &buffer.GetString()[buffer.GetSize()]};
         status = STATUS_OK;
     }
 
@@ -29,7 +29,6 @@
  *
  */
 
-#include <rapidjson/writer.h>
 #include "EnclaveIdentityV2.h"
 
 #include <tuple>
@@ -58,11 +57,6 @@ namespace intel { namespace sgx { namespace dcap {
             return;
         }
 
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        p_body.Accept(writer);
-
-        this->body = std::vector<uint8_t>{buffer.GetString(), &buffer.GetString()[buffer.GetSize()]};
         status = STATUS_OK;
     }
 
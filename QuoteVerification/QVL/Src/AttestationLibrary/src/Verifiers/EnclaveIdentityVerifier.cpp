@@ -56,6 +56,33 @@ Status EnclaveIdentityVerifier::verify(
             const pckparser::CrlStore &rootCaCrl,
             const dcap::parser::x509::Certificate &trustedRoot,
             const std::time_t& expirationDate) const
+{
+    std::shared_ptr<const dcap::parser::x509::Certificate> tcbSigningCert;
+    const auto status = verifySignature(enclaveIdentity, chain, rootCaCrl, trustedRoot, tcbSigningCert);
+    if (status != STATUS_OK)
+    {
+        return status;
+    }
+
+    return verifyExpiration(enclaveIdentity, *tcbSigningCert, chain, rootCaCrl, expirationDate);
+}
+
+Status EnclaveIdentityVerifier::verifySignature(
+            const EnclaveIdentity &enclaveIdentity,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const dcap::parser::x509::Certificate &trustedRoot) const
+{
+    std::shared_ptr<const dcap::parser::x509::Certificate> tcbSigningCert;
+    return verifySignature(enclaveIdentity, chain, rootCaCrl, trustedRoot, tcbSigningCert);
+}
+
+Status EnclaveIdentityVerifier::verifySignature(
+            const EnclaveIdentity &enclaveIdentity,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const dcap::parser::x509::Certificate &trustedRoot,
+            std::shared_ptr<const dcap::parser::x509::Certificate> &tcbSigningCert) const
 {
     const auto status = _tcbSigningChain->verify(chain, rootCaCrl, trustedRoot);
     if (status != STATUS_OK)
@@ -63,14 +90,39 @@ Status EnclaveIdentityVerifier::verify(
         return status;
     }
 
-    const auto tcbSigningCert = chain.getTopmostCert();
+    tcbSigningCert = chain.getTopmostCert();
     if(!_commonVerifier->checkSha256EcdsaSignature(
             enclaveIdentity.getSignature(), enclaveIdentity.getBody(), tcbSigningCert->getPubKey()))
     {
         return STATUS_SGX_ENCLAVE_IDENTITY_INVALID_SIGNATURE;
     }
 
-    if(expirationDate > tcbSigningCert->getValidity().getNotAfterTime())
+    return STATUS_OK;
+}
+
+Status EnclaveIdentityVerifier::verifyExpiration(
+            const EnclaveIdentity &enclaveIdentity,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const std::time_t& expirationDate) const
+{
+    const auto tcbSigningCert = chain.getTopmostCert();
+    if(!tcbSigningCert)
+    {
+        return STATUS_SGX_TCB_SIGNING_CERT_MISSING;
+    }
+
+    return verifyExpiration(enclaveIdentity, *tcbSigningCert, chain, rootCaCrl, expirationDate);
+}
+
+Status EnclaveIdentityVerifier::verifyExpiration(
+            const EnclaveIdentity &enclaveIdentity,
+            const dcap::parser::x509::Certificate &tcbSigningCert,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const std::time_t& expirationDate) const
+{
+    if(expirationDate > tcbSigningCert.getValidity().getNotAfterTime())
     {
         return STATUS_SGX_SIGNING_CERT_CHAIN_EXPIRED;
     }
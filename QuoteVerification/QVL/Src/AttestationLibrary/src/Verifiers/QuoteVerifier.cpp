@@ -40,6 +40,7 @@
 #include <QuoteVerification/QuoteConstants.h>
 #include <OpensslHelpers/DigestUtils.h>
 #include <OpensslHelpers/KeyUtils.h>
+#include <OpensslHelpers/PublicKeyCache.h>
 #include <OpensslHelpers/SignatureVerification.h>
 #include <Verifiers/PckCertVerifier.h>
 
@@ -47,87 +48,6 @@ namespace intel { namespace sgx { namespace dcap {
 
 namespace {
 
-constexpr int CPUSVN_LOWER = false;
-constexpr int CPUSVN_EQUAL_OR_HIGHER = true;
-
-bool isCpuSvnHigherOrEqual(const dcap::parser::x509::PckCertificate& pckCert,
-                           const dcap::parser::json::TcbLevel& tcbLevel)
-{
-    for(unsigned int index = 0; index < constants::CPUSVN_BYTE_LEN; ++index)
-    {
-        const auto componentValue = pckCert.getTcb().getSgxTcbComponentSvn(index);
-        const auto otherComponentValue = tcbLevel.getSgxTcbComponentSvn(index);
-        if(componentValue < otherComponentValue)
-        {
-            // If *ANY* CPUSVN component is lower then CPUSVN is considered lower
-            return CPUSVN_LOWER;
-        }
-    }
-    // but for CPUSVN to be considered higher it requires that *EVERY* CPUSVN component to be higher or equal
-    return CPUSVN_EQUAL_OR_HIGHER;
-}
-
-const std::string& getMatchingTcbLevel(const dcap::parser::json::TcbInfo &tcbInfo,
-                                       const dcap::parser::x509::PckCertificate &pckCert)
-{
-    const auto &tcbs = tcbInfo.getTcbLevels();
-    const auto certPceSvn = pckCert.getTcb().getPceSvn();
-
-    for (const auto& tcb : tcbs)
-    {
-        if(isCpuSvnHigherOrEqual(pckCert, tcb) && certPceSvn >= tcb.getPceSvn())
-        {
-            return tcb.getStatus();
-        }
-    }
-
-    /// 4.1.2.4.16.3
-    throw RuntimeException(STATUS_TCB_NOT_SUPPORTED);
-}
-
-Status checkTcbLevel(const dcap::parser::json::TcbInfo& tcbInfoJson, const dcap::parser::x509::PckCertificate& pckCert)
-{
-    /// 4.1.2.4.16.1 & 4.1.2.4.16.2
-    const auto& tcbLevelStatus = getMatchingTcbLevel(tcbInfoJson, pckCert);
-
-    if (tcbLevelStatus == "OutOfDate")
-    {
-        return STATUS_TCB_OUT_OF_DATE;
-    }
-
-    if (tcbLevelStatus == "Revoked")
-    {
-        return STATUS_TCB_REVOKED;
-    }
-
-    if (tcbLevelStatus == "ConfigurationNeeded")
-    {
-        return STATUS_TCB_CONFIGURATION_NEEDED;
-    }
-
-    if (tcbLevelStatus == "ConfigurationAndSWHardeningNeeded")
-    {
-        return STATUS_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED;
-    }
-
-    if (tcbLevelStatus == "UpToDate")
-    {
-        return STATUS_OK;
-    }
-
-    if (tcbLevelStatus == "SWHardeningNeeded")
-    {
-        return STATUS_TCB_SW_HARDENING_NEEDED;
-    }
-
-    if(tcbInfoJson.getVersion() > 1 && tcbLevelStatus == "OutOfDateConfigurationNeeded")
-    {
-        return STATUS_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED;
-    }
-
-    throw RuntimeException(STATUS_TCB_UNRECOGNIZED_STATUS);
-}
-
 Status convergeTcbStatus(Status tcbLevelStatus, Status qeTcbStatus)
 {
     if (qeTcbStatus == STATUS_SGX_ENCLAVE_REPORT_ISVSVN_OUT_OF_DATE)
@@ -166,10 +86,21 @@ Status convergeTcbStatus(Status tcbLevelStatus, Status qeTcbStatus)
 
 }//anonymous namespace
 
-Status QuoteVerifier::verify(const Quote& quote,
+Status QuoteVerifier::verify(const QuoteView& quote,
+                             const dcap::parser::x509::PckCertificate& pckCert,
+                             const pckparser::CrlStore& crl,
+                             const dcap::parser::json::TcbInfo& tcbInfoJson,
+                             const EnclaveIdentity *enclaveIdentity,
+                             const EnclaveReportVerifier& enclaveReportVerifier)
+{
+    return verify(quote, pckCert, crl, tcbInfoJson, TcbLevelMatcher(tcbInfoJson), enclaveIdentity, enclaveReportVerifier);
+}
+
+Status QuoteVerifier::verify(const QuoteView& quote,
                              const dcap::parser::x509::PckCertificate& pckCert,
                              const pckparser::CrlStore& crl,
                              const dcap::parser::json::TcbInfo& tcbInfoJson,
+                             const TcbLevelMatcher& tcbLevelMatcher,
                              const EnclaveIdentity *enclaveIdentity,
                              const EnclaveReportVerifier& enclaveReportVerifier)
 {
@@ -202,14 +133,14 @@ Status QuoteVerifier::verify(const Quote& quote,
         return STATUS_TCB_INFO_MISMATCH;
     }
 
-    const auto qeCertData = quote.getQuoteAuthData().qeCertData;
-    auto qeCertDataVerificationStatus = verifyQeCertData(qeCertData);
+    auto qeCertDataVerificationStatus = verifyQeCertData(quote);
     if(qeCertDataVerificationStatus != STATUS_OK)
     {
         return qeCertDataVerificationStatus;
     }
 
-    auto pubKey = crypto::rawToP256PubKey(pckCert.getPubKey());
+    // PCK key is shared by all quotes of the platform, attestation key below is unique to the quote
+    const auto pubKey = crypto::PublicKeyCache::instance().get(pckCert.getPubKey());
     if (pubKey == nullptr)
     {
         return STATUS_INVALID_PCK_CERT; // if there were issues with parsing public key it means cert was invalid.
@@ -217,8 +148,9 @@ Status QuoteVerifier::verify(const Quote& quote,
     }
 
     /// 4.1.2.4.11
-    if(!crypto::verifySha256EcdsaSignature(quote.getQuoteAuthData().qeReportSignature.signature,
-                                           quote.getQuoteAuthData().qeReport.rawBlob(),
+    const auto qeReportBlob = quote.getQeReportBlob();
+    if(!crypto::verifySha256EcdsaSignature(quote.getQeReportSignature().signature,
+                                           qeReportBlob.data, qeReportBlob.size,
                                            *pubKey))
     {
         return STATUS_INVALID_QE_REPORT_SIGNATURE;
@@ -227,10 +159,10 @@ Status QuoteVerifier::verify(const Quote& quote,
     /// 4.1.2.4.12
     const auto hashedConcatOfAttestKeyAndQeReportData = [&]() -> std::vector<uint8_t>
     {
-        const auto attestKeyData = quote.getQuoteAuthData().ecdsaAttestationKey.pubKey;
-        const auto qeAuthData = quote.getQuoteAuthData().qeAuthData.data;
+        const auto& attestKeyData = quote.getAttestationKey().pubKey;
+        const auto qeAuthData = quote.getQeAuthData();
         std::vector<uint8_t> ret;
-        ret.reserve(attestKeyData.size() + qeAuthData.size());
+        ret.reserve(attestKeyData.size() + qeAuthData.size);
         std::copy(attestKeyData.begin(), attestKeyData.end(), std::back_inserter(ret));
         std::copy(qeAuthData.begin(), qeAuthData.end(), std::back_inserter(ret));
 
@@ -239,7 +171,7 @@ Status QuoteVerifier::verify(const Quote& quote,
 
     if(hashedConcatOfAttestKeyAndQeReportData.empty() || !std::equal(hashedConcatOfAttestKeyAndQeReportData.begin(),
                                                                      hashedConcatOfAttestKeyAndQeReportData.end(),
-                                                                     quote.getQuoteAuthData().qeReport.reportData.begin()))
+                                                                     quote.getQeReport().reportData.begin()))
     {
         return STATUS_INVALID_QE_REPORT_DATA;
     }
@@ -260,7 +192,7 @@ Status QuoteVerifier::verify(const Quote& quote,
         }
 
         /// 4.1.2.4.14
-        qeIdentityStatus = enclaveReportVerifier.verify(enclaveIdentity, quote.getQuoteAuthData().qeReport);
+        qeIdentityStatus = enclaveReportVerifier.verify(enclaveIdentity, quote.getQeReport());
         switch(qeIdentityStatus) {
             case STATUS_SGX_ENCLAVE_REPORT_UNSUPPORTED_FORMAT:
                 return STATUS_UNSUPPORTED_QUOTE_FORMAT;
@@ -280,15 +212,16 @@ Status QuoteVerifier::verify(const Quote& quote,
         }
     }
 
-    const auto attestKey = crypto::rawToP256PubKey(quote.getQuoteAuthData().ecdsaAttestationKey.pubKey);
+    const auto attestKey = crypto::rawToP256PubKey(quote.getAttestationKey().pubKey);
     if(!attestKey)
     {
         return STATUS_UNSUPPORTED_QUOTE_FORMAT;
     }
 
     /// 4.1.2.4.15
-    if (!crypto::verifySha256EcdsaSignature(quote.getQuoteAuthData().ecdsa256BitSignature.signature,
-                                            quote.getSignedData(),
+    const auto signedData = quote.getSignedData();
+    if (!crypto::verifySha256EcdsaSignature(quote.getQuoteSignature().signature,
+                                            signedData.data, signedData.size,
                                             *attestKey))
     {
         return STATUS_INVALID_QUOTE_SIGNATURE;
@@ -297,7 +230,7 @@ Status QuoteVerifier::verify(const Quote& quote,
     try
     {
         /// 4.1.2.4.16
-        const auto tcbLevelStatus = checkTcbLevel(tcbInfoJson, pckCert);
+        const auto tcbLevelStatus = tcbLevelMatcher.match(pckCert);
 
         if (enclaveIdentity)
         {
@@ -312,9 +245,9 @@ Status QuoteVerifier::verify(const Quote& quote,
     }
 }
 
-Status QuoteVerifier::verifyQeCertData(const Quote::QeCertData& qeCertData) const
+Status QuoteVerifier::verifyQeCertData(const QuoteView& quote) const
 {
-    if(qeCertData.parsedDataSize != qeCertData.data.size())
+    if(quote.getQeCertDataSize() != quote.getQeCertData().size)
     {
         return STATUS_UNSUPPORTED_QUOTE_FORMAT;
     }
@@ -36,25 +36,37 @@
 #include <SgxEcdsaAttestation/QuoteVerification.h>
 #include <SgxEcdsaAttestation/AttestationParsers.h>
 #include <PckParser/CrlStore.h>
-#include <QuoteVerification/Quote.h>
+#include <QuoteVerification/QuoteView.h>
 #include "EnclaveReportVerifier.h"
 #include "BaseVerifier.h"
 #include "EnclaveIdentity.h"
+#include "TcbLevelMatcher.h"
 
 namespace intel { namespace sgx { namespace dcap {
 
 class QuoteVerifier
 {
 public:
-    Status verify(const Quote& quote,
+    Status verify(const QuoteView& quote,
                   const dcap::parser::x509::PckCertificate& pckCert,
                   const pckparser::CrlStore& crl,
                   const dcap::parser::json::TcbInfo& tcbInfoJson,
                   const EnclaveIdentity *enclaveIdentity,
                   const EnclaveReportVerifier& enclaveReportVerifier);
 
+    /**
+     * Same as above with TCB levels of tcbInfoJson already compiled, so that they can be reused between quotes.
+     */
+    Status verify(const QuoteView& quote,
+                  const dcap::parser::x509::PckCertificate& pckCert,
+                  const pckparser::CrlStore& crl,
+                  const dcap::parser::json::TcbInfo& tcbInfoJson,
+                  const TcbLevelMatcher& tcbLevelMatcher,
+                  const EnclaveIdentity *enclaveIdentity,
+                  const EnclaveReportVerifier& enclaveReportVerifier);
+
 private:
-    Status verifyQeCertData(const Quote::QeCertData& qeCertData) const;
+    Status verifyQeCertData(const QuoteView& quote) const;
     BaseVerifier _baseVerififer;
 };
 
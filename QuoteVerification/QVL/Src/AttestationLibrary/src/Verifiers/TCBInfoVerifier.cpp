@@ -55,6 +55,33 @@ Status TCBInfoVerifier::verify(
         const pckparser::CrlStore &rootCaCrl,
         const dcap::parser::x509::Certificate &trustedRoot,
         const std::time_t& expirationDate) const
+{
+    std::shared_ptr<const dcap::parser::x509::Certificate> tcbSigningCert;
+    const auto status = verifySignature(tcbJson, chain, rootCaCrl, trustedRoot, tcbSigningCert);
+    if (status != STATUS_OK)
+    {
+        return status;
+    }
+
+    return verifyExpiration(tcbJson, *tcbSigningCert, chain, rootCaCrl, expirationDate);
+}
+
+Status TCBInfoVerifier::verifySignature(
+        const dcap::parser::json::TcbInfo &tcbJson,
+        const CertificateChain &chain,
+        const pckparser::CrlStore &rootCaCrl,
+        const dcap::parser::x509::Certificate &trustedRoot) const
+{
+    std::shared_ptr<const dcap::parser::x509::Certificate> tcbSigningCert;
+    return verifySignature(tcbJson, chain, rootCaCrl, trustedRoot, tcbSigningCert);
+}
+
+Status TCBInfoVerifier::verifySignature(
+        const dcap::parser::json::TcbInfo &tcbJson,
+        const CertificateChain &chain,
+        const pckparser::CrlStore &rootCaCrl,
+        const dcap::parser::x509::Certificate &trustedRoot,
+        std::shared_ptr<const dcap::parser::x509::Certificate> &tcbSigningCert) const
 {
     const auto status = _tcbSigningChain->verify(chain, rootCaCrl, trustedRoot);
     if (status != STATUS_OK)
@@ -62,20 +89,45 @@ Status TCBInfoVerifier::verify(
         return status;
     }
 
-    const auto tcbSigningCert = chain.getTopmostCert();
+    tcbSigningCert = chain.getTopmostCert();
     if(!_commonVerifier->checkSha256EcdsaSignature(
             tcbJson.getSignature(), tcbJson.getInfoBody(), tcbSigningCert->getPubKey()))
     {
         return STATUS_TCB_INFO_INVALID_SIGNATURE;
     }
 
+    return STATUS_OK;
+}
+
+Status TCBInfoVerifier::verifyExpiration(
+        const dcap::parser::json::TcbInfo &tcbJson,
+        const CertificateChain &chain,
+        const pckparser::CrlStore &rootCaCrl,
+        const std::time_t& expirationDate) const
+{
+    const auto tcbSigningCert = chain.getTopmostCert();
+    if(!tcbSigningCert)
+    {
+        return STATUS_SGX_TCB_SIGNING_CERT_MISSING;
+    }
+
+    return verifyExpiration(tcbJson, *tcbSigningCert, chain, rootCaCrl, expirationDate);
+}
+
+Status TCBInfoVerifier::verifyExpiration(
+        const dcap::parser::json::TcbInfo &tcbJson,
+        const dcap::parser::x509::Certificate &tcbSigningCert,
+        const CertificateChain &chain,
+        const pckparser::CrlStore &rootCaCrl,
+        const std::time_t& expirationDate) const
+{
     const auto rootCa = chain.getRootCert();
     if(expirationDate > rootCa->getValidity().getNotAfterTime())
     {
         return STATUS_SGX_SIGNING_CERT_CHAIN_EXPIRED;
     }
 
-    if (expirationDate > tcbSigningCert->getValidity().getNotAfterTime())
+    if (expirationDate > tcbSigningCert.getValidity().getNotAfterTime())
     {
         return STATUS_SGX_SIGNING_CERT_CHAIN_EXPIRED;
     }
@@ -72,7 +72,51 @@ public:
             const dcap::parser::x509::Certificate &trustedRoot,
             const std::time_t& expirationDate) const;
 
+    /**
+     * Verify TCB info signing chain and signature, the part of verify() that doesn't depend on time
+     *
+     * @param tcbJson - TCB info Json verify
+     * @param chain - TCB info chain verify
+     * @param rootCaCrl - root CRL
+     * @param trustedRoot - trusted root certificate
+     * @return Status code of the operation
+     */
+    Status verifySignature(
+            const dcap::parser::json::TcbInfo &tcbJson,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const dcap::parser::x509::Certificate &trustedRoot) const;
+
+    /**
+     * Verify validity periods of TCB info, its signing chain and root CRL, the part of verify() that depends on time
+     *
+     * @param tcbJson - TCB info Json verify
+     * @param chain - TCB info chain verify
+     * @param rootCaCrl - root CRL
+     * @param expirationDate - date to check expiration against
+     * @return Status code of the operation
+     */
+    Status verifyExpiration(
+            const dcap::parser::json::TcbInfo &tcbJson,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const std::time_t& expirationDate) const;
+
 private:
+    Status verifySignature(
+            const dcap::parser::json::TcbInfo &tcbJson,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const dcap::parser::x509::Certificate &trustedRoot,
+            std::shared_ptr<const dcap::parser::x509::Certificate> &tcbSigningCert) const;
+
+    Status verifyExpiration(
+            const dcap::parser::json::TcbInfo &tcbJson,
+            const dcap::parser::x509::Certificate &tcbSigningCert,
+            const CertificateChain &chain,
+            const pckparser::CrlStore &rootCaCrl,
+            const std::time_t& expirationDate) const;
+
     std::unique_ptr<CommonVerifier> _commonVerifier;
     std::unique_ptr<TCBSigningChain> _tcbSigningChain;
 };
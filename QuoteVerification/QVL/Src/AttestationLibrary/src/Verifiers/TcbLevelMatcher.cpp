@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "TcbLevelMatcher.h"
+#include "Utils/RuntimeException.h"
+
+#include <algorithm>
+
+// SGX SDK does not provide intrinsic headers to trusted code, the enclave uses the scalar comparison
+#if !defined(SGX_TRUSTED) && (defined(__SSE2__) || defined(_M_X64))
+#define TCB_LEVEL_MATCHER_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define TCB_LEVEL_MATCHER_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace intel { namespace sgx { namespace dcap {
+
+static_assert(sizeof(std::array<uint8_t, constants::CPUSVN_BYTE_LEN>) == 16, "CPUSVN vectors have to be packed");
+
+namespace {
+
+constexpr int ALL_BYTES_MASK = 0xFFFF;
+
+#ifdef TCB_LEVEL_MATCHER_SSE2
+// bit i of the result is set when byte i of 'value' is higher or equal to byte i of 'lowerBound' (unsigned)
+inline int higherOrEqualMask(__m128i value, __m128i lowerBound)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(value, lowerBound), value));
+}
+#endif
+
+#ifdef TCB_LEVEL_MATCHER_AVX2
+// same as above for two pairs of 16 byte vectors, bits 0-15 for the first pair and 16-31 for the second one
+inline unsigned int higherOrEqualMask(__m256i value, __m256i lowerBound)
+{
+    return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(value, lowerBound), value)));
+}
+#endif
+
+} // anonymous namespace
+
+TcbLevelMatcher::TcbLevelMatcher(const parser::json::TcbInfo& tcbInfo)
+{
+    const auto& tcbLevels = tcbInfo.getTcbLevels();
+    _cpuSvns.reserve(tcbLevels.size());
+    _pceSvns.reserve(tcbLevels.size());
+    _statuses.reserve(tcbLevels.size());
+
+    for (const auto& tcbLevel : tcbLevels)
+    {
+        CpuSvn cpuSvn{};
+        const auto& components = tcbLevel.getCpuSvn();
+        std::copy_n(components.begin(), std::min(components.size(), cpuSvn.size()), cpuSvn.begin());
+
+        _cpuSvns.push_back(cpuSvn);
+        _pceSvns.push_back(tcbLevel.getPceSvn());
+        _statuses.push_back(toStatus(tcbLevel.getStatus(), tcbInfo.getVersion()));
+    }
+}
+
+Status TcbLevelMatcher::match(const parser::x509::PckCertificate& pckCert) const
+{
+    const auto& tcb = pckCert.getTcb();
+
+    // components of the certificate are read once per quote, not once per TCB level
+    CpuSvn certCpuSvn{};
+    for (unsigned int index = 0; index < certCpuSvn.size(); ++index)
+    {
+        certCpuSvn[index] = static_cast<uint8_t>(tcb.getSgxTcbComponentSvn(index));
+    }
+    const auto certPceSvn = tcb.getPceSvn();
+
+    // If *ANY* CPUSVN component is lower then CPUSVN is considered lower,
+    // for CPUSVN to be considered higher it requires that *EVERY* CPUSVN component to be higher or equal
+    for (auto index = findFirstLowerOrEqualCpuSvn(certCpuSvn, 0);
+         index < _cpuSvns.size();
+         index = findFirstLowerOrEqualCpuSvn(certCpuSvn, index + 1))
+    {
+        if (certPceSvn >= _pceSvns[index])
+        {
+            if (_statuses[index] == STATUS_TCB_UNRECOGNIZED_STATUS)
+            {
+                throw RuntimeException(STATUS_TCB_UNRECOGNIZED_STATUS);
+            }
+            return _statuses[index];
+        }
+    }
+
+    /// 4.1.2.4.16.3
+    throw RuntimeException(STATUS_TCB_NOT_SUPPORTED);
+}
+
+size_t TcbLevelMatcher::size() const
+{
+    return _cpuSvns.size();
+}
+
+size_t TcbLevelMatcher::findFirstLowerOrEqualCpuSvn(const CpuSvn& cpuSvn, size_t from) const
+{
+    const auto count = _cpuSvns.size();
+    auto index = from;
+
+#ifdef TCB_LEVEL_MATCHER_SSE2
+    const auto certVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cpuSvn.data()));
+#ifdef TCB_LEVEL_MATCHER_AVX2
+    const auto certVectorPair = _mm256_broadcastsi128_si256(certVector);
+    for (; index + 1 < count; index += 2)
+    {
+        const auto levels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_cpuSvns[index].data()));
+        const auto mask = higherOrEqualMask(certVectorPair, levels);
+        if ((mask & ALL_BYTES_MASK) == ALL_BYTES_MASK)
+        {
+            return index;
+        }
+        if ((mask >> 16) == ALL_BYTES_MASK)
+        {
+            return index + 1;
+        }
+    }
+#endif
+    for (; index < count; ++index)
+    {
+        const auto level = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_cpuSvns[index].data()));
+        if (higherOrEqualMask(certVector, level) == ALL_BYTES_MASK)
+        {
+            return index;
+        }
+    }
+#else
+    for (; index < count; ++index)
+    {
+        const auto& level = _cpuSvns[index];
+        if (std::equal(cpuSvn.begin(), cpuSvn.end(), level.begin(), [](uint8_t certComponent, uint8_t levelComponent) {
+                return certComponent >= levelComponent;
+            }))
+        {
+            return index;
+        }
+    }
+#endif
+    return count;
+}
+
+Status TcbLevelMatcher::toStatus(const std::string& tcbLevelStatus, unsigned int tcbInfoVersion)
+{
+    if (tcbLevelStatus == "OutOfDate")
+    {
+        return STATUS_TCB_OUT_OF_DATE;
+    }
+
+    if (tcbLevelStatus == "Revoked")
+    {
+        return STATUS_TCB_REVOKED;
+    }
+
+    if (tcbLevelStatus == "ConfigurationNeeded")
+    {
+        return STATUS_TCB_CONFIGURATION_NEEDED;
+    }
+
+    if (tcbLevelStatus == "ConfigurationAndSWHardeningNeeded")
+    {
+        return STATUS_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED;
+    }
+
+    if (tcbLevelStatus == "UpToDate")
+    {
+        return STATUS_OK;
+    }
+
+    if (tcbLevelStatus == "SWHardeningNeeded")
+    {
+        return STATUS_TCB_SW_HARDENING_NEEDED;
+    }
+
+    if(tcbInfoVersion > 1 && tcbLevelStatus == "OutOfDateConfigurationNeeded")
+    {
+        return STATUS_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED;
+    }
+
+    // reported only when such level is matched
+    return STATUS_TCB_UNRECOGNIZED_STATUS;
+}
+
+}}} // namespace intel { namespace sgx { namespace dcap {
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_TCBLEVELMATCHER_H
+#define SGXECDSAATTESTATION_TCBLEVELMATCHER_H
+
+#include <SgxEcdsaAttestation/AttestationParsers.h>
+#include <SgxEcdsaAttestation/QuoteVerification.h>
+#include <CertVerification/X509Constants.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap {
+
+/**
+ * TCB levels of a TcbInfo compiled for matching against PCK certificates. Levels are kept in the order
+ * of TcbInfo::getTcbLevels (highest first), their 16 CPUSVN components packed into a contiguous array of 16 byte
+ * vectors, next to their PCESVNs and their statuses already mapped to Status. CPUSVNs are compared with SSE2/AVX2
+ * byte compares where available. Build it once per TcbInfo and reuse it for every quote.
+ */
+class TcbLevelMatcher
+{
+public:
+    explicit TcbLevelMatcher(const parser::json::TcbInfo& tcbInfo);
+    virtual ~TcbLevelMatcher() = default;
+
+    /**
+     * Find the first TCB level with every CPUSVN component and PCESVN lower than or equal to the ones of the PCK certificate.
+     * @param pckCert - PCK certificate
+     * @return status of the matching TCB level (4.1.2.4.16.1 & 4.1.2.4.16.2)
+     *
+     * @throws RuntimeException with STATUS_TCB_NOT_SUPPORTED if no TCB level matches,
+     *         or with STATUS_TCB_UNRECOGNIZED_STATUS if status of the matching TCB level is unknown
+     */
+    virtual Status match(const parser::x509::PckCertificate& pckCert) const;
+
+    /**
+     * Get number of compiled TCB levels
+     */
+    virtual size_t size() const;
+
+private:
+    using CpuSvn = std::array<uint8_t, constants::CPUSVN_BYTE_LEN>;
+
+    std::vector<CpuSvn> _cpuSvns; // contiguous, one 16 byte vector per level
+    std::vector<unsigned int> _pceSvns;
+    std::vector<Status> _statuses;
+
+    static Status toStatus(const std::string& tcbLevelStatus, unsigned int tcbInfoVersion);
+    size_t findFirstLowerOrEqualCpuSvn(const CpuSvn& cpuSvn, size_t from) const;
+};
+
+}}} // namespace intel { namespace sgx { namespace dcap {
+
+#endif //SGXECDSAATTESTATION_TCBLEVELMATCHER_H
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "BenchmarkCorpus.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace intel { namespace sgx { namespace dcap { namespace test {
+
+const Corpus& benchmarkCorpus(int64_t tcbLevels, int64_t revokedSerials)
+{
+    static std::map<std::pair<int64_t, int64_t>, std::unique_ptr<const Corpus>> corpora;
+
+    auto& corpus = corpora[std::make_pair(tcbLevels, revokedSerials)];
+    if (!corpus)
+    {
+        CorpusOptions options;
+        options.fmspcCount = 1;
+        options.quotesPerFmspc = 1;
+        options.tcbLevels = static_cast<size_t>(tcbLevels);
+        options.revokedSerials = static_cast<size_t>(revokedSerials);
+        corpus.reset(new Corpus(generateCorpus(options)));
+    }
+    return *corpus;
+}
+
+}}}}
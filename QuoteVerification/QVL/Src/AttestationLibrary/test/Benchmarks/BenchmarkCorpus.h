@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_BENCHMARKCORPUS_H
+#define SGXECDSAATTESTATION_BENCHMARKCORPUS_H
+
+#include <CorpusGenerator.h>
+
+#include <cstdint>
+
+namespace intel { namespace sgx { namespace dcap { namespace test {
+
+// input sizes shared by benchmarks, small ones are close to a single platform, large ones to production collateral
+constexpr int64_t SMALL_TCB_LEVELS = 1;
+constexpr int64_t LARGE_TCB_LEVELS = 256;
+constexpr int64_t SMALL_REVOKED_SERIALS = 10;
+constexpr int64_t LARGE_REVOKED_SERIALS = 50000;
+
+/**
+ * Returns corpus with single FMSPC and quote, generated once per dimensions so that benchmarks do not pay for it
+ *
+ * @param tcbLevels - number of TCB levels in TCB info
+ * @param revokedSerials - number of revoked serials in each CRL
+ * @return generated corpus
+ */
+const Corpus& benchmarkCorpus(int64_t tcbLevels, int64_t revokedSerials);
+
+}}}}
+
+#endif //SGXECDSAATTESTATION_BENCHMARKCORPUS_H
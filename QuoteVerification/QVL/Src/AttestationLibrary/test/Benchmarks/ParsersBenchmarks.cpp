@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "BenchmarkCorpus.h"
+
+#include <benchmark/benchmark.h>
+
+#include <SgxEcdsaAttestation/AttestationParsers.h>
+#include <PckParser/CrlStore.h>
+#include <QuoteVerification/Quote.h>
+#include <Verifiers/EnclaveIdentityParser.h>
+#include <EnclaveIdentityGenerator.h>
+#include <QuoteGenerator.h>
+
+#include <string>
+
+using namespace intel::sgx::dcap;
+using namespace intel::sgx::dcap::test;
+
+namespace {
+
+const Corpus& smallCorpus()
+{
+    return benchmarkCorpus(SMALL_TCB_LEVELS, SMALL_REVOKED_SERIALS);
+}
+
+const std::string& rootCaCertificate()
+{
+    return smallCorpus().trustedRootCaCert;
+}
+
+const std::string& pckCertificate()
+{
+    return smallCorpus().platforms.front().pckCerts.front();
+}
+
+// V1 identity without TCB levels
+const std::string& qeIdentityV1()
+{
+    return smallCorpus().qeIdentity;
+}
+
+// V2 identity with TCB levels
+const std::string& qeIdentityV2()
+{
+    static const auto identity = enclaveIdentityJsonWithSignature();
+    return identity;
+}
+
+// plain PPID as certification data
+const Bytes& quoteWithPpid()
+{
+    static const auto quote = QuoteGenerator{}.buildSgxQuote();
+    return quote;
+}
+
+// PEM PCK certificate chain as certification data
+const Bytes& quoteWithCertChain()
+{
+    return smallCorpus().platforms.front().quotes.front();
+}
+
+void BM_CertificateParse(benchmark::State& state, const std::string& (*pem)())
+{
+    const auto& input = pem();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser::x509::Certificate::parse(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK_CAPTURE(BM_CertificateParse, rootCa, &rootCaCertificate);
+BENCHMARK_CAPTURE(BM_CertificateParse, pck, &pckCertificate);
+
+// PCK certificates have fixed layout, so there is only one input size
+void BM_PckCertificateParse(benchmark::State& state)
+{
+    const auto& input = pckCertificate();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser::x509::PckCertificate::parse(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_PckCertificateParse);
+
+void BM_CrlStoreParse(benchmark::State& state)
+{
+    const auto& input = benchmarkCorpus(SMALL_TCB_LEVELS, state.range(0)).intermediateCaCrl;
+    for (auto _ : state)
+    {
+        pckparser::CrlStore crl;
+        if (!crl.parse(input))
+        {
+            state.SkipWithError("CRL parsing failed");
+            break;
+        }
+        benchmark::DoNotOptimize(crl);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_CrlStoreParse)->ArgName("revokedSerials")->Arg(SMALL_REVOKED_SERIALS)->Arg(1000)->Arg(LARGE_REVOKED_SERIALS);
+
+void BM_CrlStoreIsRevoked(benchmark::State& state)
+{
+    pckparser::CrlStore crl;
+    if (!crl.parse(benchmarkCorpus(SMALL_TCB_LEVELS, state.range(0)).intermediateCaCrl))
+    {
+        state.SkipWithError("CRL parsing failed");
+        return;
+    }
+    const auto certificate = parser::x509::Certificate::parse(pckCertificate());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crl.isRevoked(certificate));
+    }
+}
+BENCHMARK(BM_CrlStoreIsRevoked)->ArgName("revokedSerials")->Arg(SMALL_REVOKED_SERIALS)->Arg(1000)->Arg(LARGE_REVOKED_SERIALS);
+
+void BM_TcbInfoParse(benchmark::State& state)
+{
+    const auto& input = benchmarkCorpus(state.range(0), SMALL_REVOKED_SERIALS).platforms.front().tcbInfo;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser::json::TcbInfo::parse(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_TcbInfoParse)->ArgName("tcbLevels")->Arg(SMALL_TCB_LEVELS)->Arg(16)->Arg(LARGE_TCB_LEVELS);
+
+void BM_EnclaveIdentityParse(benchmark::State& state, const std::string& (*json)())
+{
+    const auto& input = json();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(EnclaveIdentityParser{}.parse(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK_CAPTURE(BM_EnclaveIdentityParse, qeIdentityV1, &qeIdentityV1);
+BENCHMARK_CAPTURE(BM_EnclaveIdentityParse, enclaveIdentityV2, &qeIdentityV2);
+
+void BM_QuoteParse(benchmark::State& state, const Bytes& (*rawQuote)())
+{
+    const auto& input = rawQuote();
+    for (auto _ : state)
+    {
+        Quote quote;
+        if (!quote.parse(input))
+        {
+            state.SkipWithError("Quote parsing failed");
+            break;
+        }
+        benchmark::DoNotOptimize(quote);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK_CAPTURE(BM_QuoteParse, plainPpid, &quoteWithPpid);
+BENCHMARK_CAPTURE(BM_QuoteParse, pckCertChain, &quoteWithCertChain);
+
+}
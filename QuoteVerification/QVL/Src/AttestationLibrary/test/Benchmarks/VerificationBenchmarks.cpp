@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "BenchmarkCorpus.h"
+
+#include <benchmark/benchmark.h>
+
+#include <SgxEcdsaAttestation/QuoteVerification.h>
+#include <SgxEcdsaAttestation/AttestationParsers.h>
+#include <OpensslHelpers/PublicKeyCache.h>
+#include <PckParser/CrlStore.h>
+#include <QuoteVerification/QuoteView.h>
+#include <Utils/CollateralCache.h>
+#include <Verifiers/EnclaveIdentityParser.h>
+#include <Verifiers/EnclaveReportVerifier.h>
+#include <Verifiers/QuoteVerifier.h>
+
+#include <array>
+#include <functional>
+
+using namespace intel::sgx::dcap;
+using namespace intel::sgx::dcap::test;
+
+namespace {
+
+enum ArgIndex
+{
+    TCB_LEVELS,
+    REVOKED_SERIALS,
+    CACHED
+};
+
+const Corpus& corpusOf(const benchmark::State& state)
+{
+    return benchmarkCorpus(state.range(TCB_LEVELS), state.range(REVOKED_SERIALS));
+}
+
+// small and large collateral, with caches cleared before every call or kept warm
+void collateralSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"tcbLevels", "revokedSerials", "cached"});
+    for (const auto cached : {0, 1})
+    {
+        benchmark->Args({SMALL_TCB_LEVELS, SMALL_REVOKED_SERIALS, cached});
+        benchmark->Args({LARGE_TCB_LEVELS, LARGE_REVOKED_SERIALS, cached});
+    }
+}
+
+void runVerification(benchmark::State& state, const std::function<Status()>& verification)
+{
+    const bool cached = state.range(CACHED) != 0;
+    for (auto _ : state)
+    {
+        if (!cached)
+        {
+            state.PauseTiming();
+            CollateralCache::instance().clear();
+            crypto::PublicKeyCache::instance().clear();
+            state.ResumeTiming();
+        }
+        if (verification() != STATUS_OK)
+        {
+            state.SkipWithError("Verification of generated corpus failed");
+            break;
+        }
+    }
+}
+
+void BM_QuoteVerifierVerify(benchmark::State& state)
+{
+    const auto& corpus = corpusOf(state);
+    const auto& platform = corpus.platforms.front();
+
+    QuoteView quote;
+    pckparser::CrlStore crl;
+    if (!quote.parse(platform.quotes.front().data(), platform.quotes.front().size()) || !crl.parse(corpus.intermediateCaCrl))
+    {
+        state.SkipWithError("Parsing of generated corpus failed");
+        return;
+    }
+    const auto pckCert = parser::x509::PckCertificate::parse(platform.pckCerts.front());
+    const auto tcbInfo = parser::json::TcbInfo::parse(platform.tcbInfo);
+    const auto qeIdentity = EnclaveIdentityParser{}.parse(corpus.qeIdentity);
+    const EnclaveReportVerifier enclaveReportVerifier;
+
+    for (auto _ : state)
+    {
+        if (QuoteVerifier{}.verify(quote, pckCert, crl, tcbInfo, qeIdentity.get(), enclaveReportVerifier) != STATUS_OK)
+        {
+            state.SkipWithError("Verification of generated corpus failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_QuoteVerifierVerify)
+    ->ArgNames({"tcbLevels", "revokedSerials"})
+    ->Args({SMALL_TCB_LEVELS, SMALL_REVOKED_SERIALS})
+    ->Args({LARGE_TCB_LEVELS, LARGE_REVOKED_SERIALS});
+
+void BM_VerifyQuote(benchmark::State& state)
+{
+    const auto& corpus = corpusOf(state);
+    const auto& platform = corpus.platforms.front();
+    const auto& quote = platform.quotes.front();
+
+    runVerification(state, [&] {
+        return sgxAttestationVerifyQuote(quote.data(), static_cast<uint32_t>(quote.size()), platform.pckCerts.front().c_str(),
+                                         corpus.intermediateCaCrl.c_str(), platform.tcbInfo.c_str(), corpus.qeIdentity.c_str());
+    });
+}
+BENCHMARK(BM_VerifyQuote)->Apply(collateralSizes);
+
+void BM_VerifyPCKCertificate(benchmark::State& state)
+{
+    const auto& corpus = corpusOf(state);
+    const auto chain = corpus.pckSigningChain + corpus.platforms.front().pckCerts.front();
+    const std::array<const char*, 2> crls{{corpus.rootCaCrl.c_str(), corpus.intermediateCaCrl.c_str()}};
+
+    runVerification(state, [&] {
+        return sgxAttestationVerifyPCKCertificate(chain.c_str(), crls.data(), corpus.trustedRootCaCert.c_str(), nullptr);
+    });
+}
+BENCHMARK(BM_VerifyPCKCertificate)->Apply(collateralSizes);
+
+void BM_VerifyPCKRevocationList(benchmark::State& state)
+{
+    const auto& corpus = corpusOf(state);
+
+    runVerification(state, [&] {
+        return sgxAttestationVerifyPCKRevocationList(corpus.intermediateCaCrl.c_str(), corpus.pckSigningChain.c_str(),
+                                                     corpus.trustedRootCaCert.c_str());
+    });
+}
+BENCHMARK(BM_VerifyPCKRevocationList)->Apply(collateralSizes);
+
+void BM_VerifyTCBInfo(benchmark::State& state)
+{
+    const auto& corpus = corpusOf(state);
+
+    runVerification(state, [&] {
+        return sgxAttestationVerifyTCBInfo(corpus.platforms.front().tcbInfo.c_str(), corpus.tcbSigningChain.c_str(),
+                                           corpus.rootCaCrl.c_str(), corpus.trustedRootCaCert.c_str(), nullptr);
+    });
+}
+BENCHMARK(BM_VerifyTCBInfo)->Apply(collateralSizes);
+
+void BM_VerifyEnclaveIdentity(benchmark::State& state)
+{
+    const auto& corpus = corpusOf(state);
+
+    runVerification(state, [&] {
+        return sgxAttestationVerifyEnclaveIdentity(corpus.qeIdentity.c_str(), corpus.tcbSigningChain.c_str(),
+                                                   corpus.rootCaCrl.c_str(), corpus.trustedRootCaCert.c_str(), nullptr);
+    });
+}
+BENCHMARK(BM_VerifyEnclaveIdentity)->Apply(collateralSizes);
+
+}
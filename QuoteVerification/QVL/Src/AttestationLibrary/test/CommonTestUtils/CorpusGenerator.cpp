@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "CorpusGenerator.h"
+#include "DigestUtils.h"
+#include "EcdsaSignatureGenerator.h"
+#include "EnclaveIdentityGenerator.h"
+#include "KeyHelpers.h"
+#include "QuoteGenerator.h"
+#include "TcbInfoJsonGenerator.h"
+#include "X509CrlGenerator.h"
+
+#include <X509CertGenerator.h>
+#include <CertVerification/X509Constants.h>
+#include <QuoteVerification/QuoteConstants.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace intel { namespace sgx { namespace dcap { namespace test {
+
+namespace {
+
+using parser::test::X509CertGenerator;
+
+const std::string ISSUE_DATE = "2018-08-22T10:09:10Z";
+const std::string NEXT_UPDATE = "2118-08-23T10:09:10Z";
+const std::string TCB_DATE = "2019-05-23T10:36:02Z";
+const std::string PCE_ID = "0000";
+const std::vector<std::string> LOWER_TCB_STATUSES = {
+    "OutOfDate", "ConfigurationNeeded", "OutOfDateConfigurationNeeded", "Revoked"};
+
+// distinct prefixes keep revoked serials apart from serials of generated certificates
+constexpr uint8_t CA_SERIAL_PREFIX = 0x01;
+constexpr uint8_t PCK_SERIAL_PREFIX = 0x02;
+constexpr uint8_t REVOKED_SERIAL_PREFIX = 0x7f;
+
+Bytes indexedBytes(uint8_t prefix, uint64_t index, size_t size)
+{
+    Bytes bytes(size, 0);
+    bytes[0] = prefix;
+    for (size_t i = 1; i < size && i <= sizeof(index); i++)
+    {
+        bytes[size - i] = static_cast<uint8_t>(index >> (8 * (i - 1)));
+    }
+    return bytes;
+}
+
+Bytes serialNumber(uint8_t prefix, uint64_t index)
+{
+    return indexedBytes(prefix, index, 9);
+}
+
+// PCK certificate extension keeps pcesvn as DER INTEGER content, which has to be minimally encoded
+Bytes derInteger(uint16_t value)
+{
+    Bytes encoded{static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+    while (encoded.size() > 1 && encoded[0] == 0 && encoded[1] < 0x80)
+    {
+        encoded.erase(encoded.begin());
+    }
+    if (encoded[0] >= 0x80)
+    {
+        encoded.insert(encoded.begin(), 0);
+    }
+    return encoded;
+}
+
+Bytes textBytes(const std::string& text)
+{
+    return Bytes(text.cbegin(), text.cend());
+}
+
+std::array<uint8_t, 64> signRaw(const Bytes& data, EVP_PKEY& key)
+{
+    const auto signature = EcdsaSignatureGenerator::signECDSA_SHA256(data, &key);
+    std::array<uint8_t, 64> raw{};
+    std::copy_n(signature.begin(), std::min(raw.size(), signature.size()), raw.begin());
+    return raw;
+}
+
+std::string signedBodyHex(const std::string& body, EVP_PKEY& key)
+{
+    return EcdsaSignatureGenerator::signatureToHexString(EcdsaSignatureGenerator::signECDSA_SHA256(textBytes(body), &key));
+}
+
+class CorpusBuilder
+{
+public:
+    explicit CorpusBuilder(const CorpusOptions& corpusOptions): options(corpusOptions)
+    {
+        rootKey = certGenerator.generateEcKeypair();
+        intermediateKey = certGenerator.generateEcKeypair();
+        tcbSigningKey = certGenerator.generateEcKeypair();
+
+        rootCert = certGenerator.generateCaCert(2, serialNumber(CA_SERIAL_PREFIX, 0), 0, options.validitySeconds,
+                                                rootKey.get(), rootKey.get(),
+                                                constants::ROOT_CA_SUBJECT, constants::ROOT_CA_SUBJECT);
+        intermediateCert = certGenerator.generateCaCert(2, serialNumber(CA_SERIAL_PREFIX, 1), 0, options.validitySeconds,
+                                                        intermediateKey.get(), rootKey.get(),
+                                                        constants::PLATFORM_CA_SUBJECT, constants::ROOT_CA_SUBJECT);
+        tcbSigningCert = certGenerator.generateTcbSigningCert(2, serialNumber(CA_SERIAL_PREFIX, 2), 0, options.validitySeconds,
+                                                              tcbSigningKey.get(), rootKey.get(),
+                                                              constants::TCB_SUBJECT, constants::ROOT_CA_SUBJECT);
+
+        rootPem = certGenerator.x509ToString(rootCert.get());
+        intermediatePem = certGenerator.x509ToString(intermediateCert.get());
+    }
+
+    Corpus build()
+    {
+        Corpus corpus;
+        corpus.derCrls = options.derCrls;
+        corpus.trustedRootCaCert = rootPem;
+        corpus.pckSigningChain = rootPem + intermediatePem;
+        corpus.tcbSigningChain = rootPem + certGenerator.x509ToString(tcbSigningCert.get());
+        corpus.rootCaCrl = crl(rootCert);
+        corpus.intermediateCaCrl = crl(intermediateCert);
+
+        auto qeIdentityBody = qeIdentity.toJSON();
+        corpus.qeIdentity = qeIdentityJsonWithSignature(qeIdentityBody, signedBodyHex(qeIdentityBody, *tcbSigningKey));
+
+        qeIdentity.applyTo(qeReport);
+
+        corpus.platforms.reserve(options.fmspcCount);
+        for (size_t fmspcIndex = 0; fmspcIndex < options.fmspcCount; fmspcIndex++)
+        {
+            corpus.platforms.push_back(platform(fmspcIndex));
+        }
+        return corpus;
+    }
+
+private:
+    std::string crl(const crypto::X509_uptr& issuer) const
+    {
+        std::vector<Bytes> revoked;
+        revoked.reserve(options.revokedSerials);
+        for (size_t i = 0; i < options.revokedSerials; i++)
+        {
+            revoked.push_back(serialNumber(REVOKED_SERIAL_PREFIX, i));
+        }
+        const auto generated = crlGenerator.generateCRL(CRLVersion::CRL_VERSION_2, 0, options.validitySeconds, issuer, revoked);
+        return options.derCrls ? X509CrlGenerator::x509CrlToDERString(generated.get())
+                               : X509CrlGenerator::x509CrlToPEMString(generated.get());
+    }
+
+    // levels are ordered from the highest TCB, every platform is issued at the highest one
+    uint16_t levelSvn(size_t level) const
+    {
+        return static_cast<uint16_t>(options.tcbLevels - level);
+    }
+
+    std::string tcbInfo(const std::string& fmspc) const
+    {
+        std::vector<std::string> levels;
+        levels.reserve(options.tcbLevels);
+        for (size_t level = 0; level < options.tcbLevels; level++)
+        {
+            std::array<int, 16> tcb{};
+            tcb.fill(std::min<int>(levelSvn(level), std::numeric_limits<uint8_t>::max()));
+            const auto& status = level == 0 ? std::string("UpToDate") : LOWER_TCB_STATUSES[(level - 1) % LOWER_TCB_STATUSES.size()];
+            levels.push_back(tcbLevelJsonV2(tcb, levelSvn(level), status, TCB_DATE));
+        }
+        const auto body = tcbInfoJsonV2Body(2, ISSUE_DATE, NEXT_UPDATE, fmspc, PCE_ID, 0, 1, levels);
+        return tcbInfoJsonGenerator(body, signedBodyHex(body, *tcbSigningKey));
+    }
+
+    CorpusPlatform platform(size_t fmspcIndex)
+    {
+        const auto fmspc = indexedBytes(0x00, fmspcIndex, 6);
+        const auto cpusvn = Bytes(16, static_cast<uint8_t>(std::min<int>(levelSvn(0), std::numeric_limits<uint8_t>::max())));
+        const auto pcesvn = derInteger(levelSvn(0));
+
+        CorpusPlatform platform;
+        platform.fmspc = bytesToHexString(fmspc);
+        std::transform(platform.fmspc.begin(), platform.fmspc.end(), platform.fmspc.begin(), ::toupper);
+        platform.tcbInfo = tcbInfo(platform.fmspc);
+
+        for (size_t i = 0; i < options.quotesPerFmspc; i++)
+        {
+            const auto platformIndex = fmspcIndex * options.quotesPerFmspc + i;
+            const auto pckKey = certGenerator.generateEcKeypair();
+            const auto pckCert = certGenerator.generatePCKCert(2, serialNumber(PCK_SERIAL_PREFIX, platformIndex), 0, options.validitySeconds,
+                                                               pckKey.get(), intermediateKey.get(),
+                                                               constants::PCK_SUBJECT, constants::PLATFORM_CA_SUBJECT,
+                                                               indexedBytes(0xaa, platformIndex, 16), cpusvn, pcesvn,
+                                                               Bytes(2, 0x00), fmspc, 0);
+            platform.pckCerts.push_back(certGenerator.x509ToString(pckCert.get()));
+            platform.quotes.push_back(quote(platformIndex, *pckKey, platform.pckCerts.back()));
+        }
+        return platform;
+    }
+
+    // quotes carry the PCK certificate chain as certification data, as produced by the QE3
+    Bytes quote(size_t platformIndex, EVP_PKEY& pckKey, const std::string& pckPem)
+    {
+        const auto attestationKey = certGenerator.generateEcKeypair();
+        const auto certificationData = textBytes(pckPem + intermediatePem + rootPem);
+
+        QuoteGenerator quoteGenerator;
+        quoteGenerator.withQeCertData(constants::PCK_ID_PCK_CERT_CHAIN, certificationData);
+        quoteGenerator.getAuthSize() += static_cast<uint32_t>(certificationData.size());
+
+        const auto reportData = indexedBytes(0x00, platformIndex, 16);
+        std::copy(reportData.begin(), reportData.end(), quoteGenerator.getEnclaveReport().reportData.begin());
+
+        auto& authData = quoteGenerator.getQuoteAuthData();
+        authData.ecdsaAttestationKey.publicKey = getRawPub(*EVP_PKEY_get0_EC_KEY(attestationKey.get()));
+
+        auto report = qeReport;
+        const auto keyHash = DigestUtils::sha256DigestArray(
+                Bytes(authData.ecdsaAttestationKey.publicKey.begin(), authData.ecdsaAttestationKey.publicKey.end())
+                + authData.qeAuthData.data);
+        report.reportData.fill(0);
+        std::copy(keyHash.begin(), keyHash.end(), report.reportData.begin());
+        authData.qeReport = report;
+        authData.qeReportSignature.signature = signRaw(report.bytes(), pckKey);
+        authData.ecdsaSignature.signature = signRaw(quoteGenerator.getHeader().bytes() + quoteGenerator.getEnclaveReport().bytes(),
+                                                    *attestationKey);
+
+        return quoteGenerator.buildSgxQuote();
+    }
+
+    const CorpusOptions& options;
+    X509CertGenerator certGenerator;
+    X509CrlGenerator crlGenerator;
+    EnclaveIdentityVectorModel qeIdentity;
+    QuoteGenerator::EnclaveReport qeReport;
+
+    crypto::EVP_PKEY_uptr rootKey = crypto::make_unique<EVP_PKEY>(nullptr);
+    crypto::EVP_PKEY_uptr intermediateKey = crypto::make_unique<EVP_PKEY>(nullptr);
+    crypto::EVP_PKEY_uptr tcbSigningKey = crypto::make_unique<EVP_PKEY>(nullptr);
+    crypto::X509_uptr rootCert = crypto::make_unique<X509>(nullptr);
+    crypto::X509_uptr intermediateCert = crypto::make_unique<X509>(nullptr);
+    crypto::X509_uptr tcbSigningCert = crypto::make_unique<X509>(nullptr);
+    std::string rootPem;
+    std::string intermediatePem;
+};
+
+void writeFile(const std::string& directory, const std::string& name, const Bytes& content)
+{
+    const auto path = directory + "/" + name;
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+    if (!file)
+    {
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+}
+
+Corpus generateCorpus(const CorpusOptions& options)
+{
+    if (options.tcbLevels == 0 || options.tcbLevels > std::numeric_limits<uint16_t>::max())
+    {
+        throw std::invalid_argument("Number of TCB levels has to be in range 1-65535");
+    }
+    return CorpusBuilder(options).build();
+}
+
+size_t writeCorpus(const Corpus& corpus, const std::string& directory)
+{
+    const std::string crlExtension = corpus.derCrls ? ".der" : ".pem";
+    const auto crlFile = [&](const std::string& crl) {
+        return corpus.derCrls ? hexStringToBytes(crl) : textBytes(crl);
+    };
+    const std::string sharedFiles = " pckSignChain=pckSignChain.pem tcbSignChain=tcbSignChain.pem qeIdentity=qeIdentity.json"
+                                    " rootCaCrl=rootCaCrl" + crlExtension + " intermediateCaCrl=pckCrl" + crlExtension +
+                                    " trustedRootCaCert=trustedRootCaCert.pem";
+    size_t written = 0;
+    const auto write = [&](const std::string& name, const Bytes& content) {
+        writeFile(directory, name, content);
+        ++written;
+    };
+
+    write("trustedRootCaCert.pem", textBytes(corpus.trustedRootCaCert));
+    write("pckSignChain.pem", textBytes(corpus.pckSigningChain));
+    write("tcbSignChain.pem", textBytes(corpus.tcbSigningChain));
+    write("rootCaCrl" + crlExtension, crlFile(corpus.rootCaCrl));
+    write("pckCrl" + crlExtension, crlFile(corpus.intermediateCaCrl));
+    write("qeIdentity.json", textBytes(corpus.qeIdentity));
+
+    std::string manifest = "# generated corpus, one quote with its collateral per line\n";
+    for (const auto& platform : corpus.platforms)
+    {
+        const auto tcbInfoName = "tcbInfo_" + platform.fmspc + ".json";
+        write(tcbInfoName, textBytes(platform.tcbInfo));
+        for (size_t i = 0; i < platform.quotes.size(); i++)
+        {
+            const auto suffix = platform.fmspc + "_" + std::to_string(i);
+            write("pckCert_" + suffix + ".pem", textBytes(platform.pckCerts[i]));
+            write("quote_" + suffix + ".dat", platform.quotes[i]);
+            manifest += "quote=quote_" + suffix + ".dat pckCert=pckCert_" + suffix + ".pem tcbInfo=" + tcbInfoName +
+                        sharedFiles + "\n";
+        }
+    }
+    write("manifest.txt", textBytes(manifest));
+    return written;
+}
+
+}}}}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef SGXECDSAATTESTATION_CORPUSGENERATOR_H
+#define SGXECDSAATTESTATION_CORPUSGENERATOR_H
+
+#include <OpensslHelpers/Bytes.h>
+
+#include <string>
+#include <vector>
+
+namespace intel { namespace sgx { namespace dcap { namespace test {
+
+struct CorpusOptions
+{
+    size_t fmspcCount = 16;
+    size_t quotesPerFmspc = 16;
+    size_t tcbLevels = 32;
+    size_t revokedSerials = 20000;
+    bool derCrls = false;
+    long validitySeconds = 10L * 365 * 24 * 3600;
+};
+
+/**
+ * Collateral of a single FMSPC together with the quotes of its platforms
+ */
+struct CorpusPlatform
+{
+    std::string fmspc;
+    std::string tcbInfo;
+    std::vector<std::string> pckCerts;
+    std::vector<Bytes> quotes;
+};
+
+/**
+ * Internally consistent collateral set signed by a generated root CA.
+ * Certificates and chains are PEM, identities are issued JSON, CRLs are PEM or hex encoded DER depending on options,
+ * so every field can be passed to verification API as it is.
+ */
+struct Corpus
+{
+    std::string trustedRootCaCert;
+    std::string pckSigningChain;
+    std::string tcbSigningChain;
+    std::string rootCaCrl;
+    std::string intermediateCaCrl;
+    std::string qeIdentity;
+    std::vector<CorpusPlatform> platforms;
+    bool derCrls = false;
+};
+
+/**
+ * Generates synthetic quotes and collateral at scale, without access to Intel PCS
+ *
+ * @param options - corpus dimensions
+ * @return generated corpus
+ * @throws std::invalid_argument when options cannot be represented in collateral
+ */
+Corpus generateCorpus(const CorpusOptions& options);
+
+/**
+ * Writes the corpus into existing directory, one file per collateral as sgx_ql_qve_collateral_t expects them,
+ * and "manifest.txt" listing the files used by each quote (AttestationApp --bulkManifest format).
+ * DER CRLs are written in binary form.
+ *
+ * @param corpus - generated corpus
+ * @param directory - output directory
+ * @return number of written files
+ * @throws std::runtime_error when a file cannot be written
+ */
+size_t writeCorpus(const Corpus& corpus, const std::string& directory);
+
+}}}}
+
+#endif //SGXECDSAATTESTATION_CORPUSGENERATOR_H
@@ -63,11 +63,16 @@ static std::string getTcbLevelsV1(std::array<int, 16> tcb, int pcesvn, std::stri
 }
 
 static std::string getTcbLevels(std::array<int, 16> tcb, int pcesvn, std::string status, std::string tcbDate)
+{
+    return "[" + tcbLevelJsonV2(tcb, pcesvn, status, tcbDate) + "]}";
+}
+
+std::string tcbLevelJsonV2(std::array<int, 16> tcb, int pcesvn, std::string tcbStatus, std::string tcbDate)
 {
     std::string result;
-    result = R"([{"tcb":{)" + getTcb(tcb) + R"("pcesvn":)" + std::to_string(pcesvn);
+    result = R"({"tcb":{)" + getTcb(tcb) + R"("pcesvn":)" + std::to_string(pcesvn);
     result += R"(},"tcbDate":")" + tcbDate;
-    result += R"(","tcbStatus":")" + status + R"("}]})";
+    result += R"(","tcbStatus":")" + tcbStatus + R"("})";
 
     return result;
 }
@@ -97,6 +102,25 @@ std::string tcbInfoJsonV2Body(int version, std::string issueDate, std::string ne
     return result;
 }
 
+std::string tcbInfoJsonV2Body(int version, std::string issueDate, std::string nextUpdate, std::string fmspc,
+                              std::string pceId, int tcbType, int tcbEvaluationDataNumber,
+                              const std::vector<std::string>& tcbLevels)
+{
+    std::string result;
+    result = R"({"version":)" + std::to_string(version) + R"(,"issueDate":")" + issueDate;
+    result += R"(","nextUpdate":")" + nextUpdate + R"(","fmspc":")" + fmspc + R"(","pceId":")" + pceId;
+    result += R"(","tcbType":)" + std::to_string(tcbType);
+    result += R"(,"tcbEvaluationDataNumber":)" + std::to_string(tcbEvaluationDataNumber);
+    result += R"(,"tcbLevels":[)";
+    for (size_t i = 0; i < tcbLevels.size(); i++)
+    {
+        result += (i == 0 ? "" : ",") + tcbLevels[i];
+    }
+    result += "]}";
+
+    return result;
+}
+
 std::string tcbInfoJsonGenerator(int version, std::string issueDate, std::string nextUpdate, std::string fmspc,
                                  std::string pceId, std::array<int, 16> tcb, int pcesvn, std::string status,
                                  std::string signature)
@@ -34,6 +34,7 @@
 
 #include <string>
 #include <array>
+#include <vector>
 
 std::string tcbInfoJsonGenerator(int version, std::string issueDate, std::string nextUpdate, std::string fmspc,
                                  std::string pceId, std::array<int, 16> tcb, int pcesvn, std::string status,
@@ -48,6 +49,15 @@ std::string tcbInfoJsonV2Body(int version, std::string issueDate, std::string ne
                               std::string pceId, std::array<int, 16> tcb, int pcesvn, std::string tcbStatus,
                               int tcbType, int tcbEvaluationDataNumber, std::string tcbDate);
 
+/**
+ * Generates a single V2 TCB level, to be listed in tcbInfoJsonV2Body ordered from the highest TCB
+ */
+std::string tcbLevelJsonV2(std::array<int, 16> tcb, int pcesvn, std::string tcbStatus, std::string tcbDate);
+
+std::string tcbInfoJsonV2Body(int version, std::string issueDate, std::string nextUpdate, std::string fmspc,
+                              std::string pceId, int tcbType, int tcbEvaluationDataNumber,
+                              const std::vector<std::string>& tcbLevels);
+
 std::array<int, 16> getRandomTcb();
 
 #endif //SGX_DCAP_PARSERS_TEST_TCB_INFO_JSON_GENERATOR_H
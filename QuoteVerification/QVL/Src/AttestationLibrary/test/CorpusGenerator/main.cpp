@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <CorpusGenerator.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace intel::sgx::dcap::test;
+
+namespace {
+
+void printUsage(const std::string& program)
+{
+    const CorpusOptions defaults;
+    std::cout << "Usage: " << program << " --output=DIR [options]\n"
+              << "Generates synthetic quotes with internally consistent collateral into existing DIR\n\n"
+              << "  --fmspcs=N            number of FMSPCs, each with its own TCB info (default: " << defaults.fmspcCount << ")\n"
+              << "  --quotesPerFmspc=N    number of platforms and quotes per FMSPC (default: " << defaults.quotesPerFmspc << ")\n"
+              << "  --tcbLevels=N         number of TCB levels in each TCB info (default: " << defaults.tcbLevels << ")\n"
+              << "  --revokedSerials=N    number of revoked serials in each CRL (default: " << defaults.revokedSerials << ")\n"
+              << "  --derCrls             write CRLs in DER instead of PEM\n"
+              << "  --help                print this help\n\n"
+              << "Verify generated corpus with: AttestationApp --bulkManifest=DIR/manifest.txt\n";
+}
+
+size_t parseCount(const std::string& name, const std::string& value)
+{
+    size_t parsed = 0;
+    const auto count = std::stoull(value, &parsed);
+    if (parsed != value.size())
+    {
+        throw std::invalid_argument("Invalid value of " + name + ": " + value);
+    }
+    return static_cast<size_t>(count);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    CorpusOptions options;
+    std::string output;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string argument = argv[i];
+            const auto separator = argument.find('=');
+            const auto name = argument.substr(0, separator);
+            const auto value = separator == std::string::npos ? std::string{} : argument.substr(separator + 1);
+
+            if (name == "--help")
+            {
+                printUsage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            else if (name == "--output") { output = value; }
+            else if (name == "--fmspcs") { options.fmspcCount = parseCount(name, value); }
+            else if (name == "--quotesPerFmspc") { options.quotesPerFmspc = parseCount(name, value); }
+            else if (name == "--tcbLevels") { options.tcbLevels = parseCount(name, value); }
+            else if (name == "--revokedSerials") { options.revokedSerials = parseCount(name, value); }
+            else if (name == "--derCrls") { options.derCrls = true; }
+            else
+            {
+                throw std::invalid_argument("Unknown option: " + argument);
+            }
+        }
+        if (output.empty())
+        {
+            throw std::invalid_argument("Output directory is required");
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto corpus = generateCorpus(options);
+        const auto files = writeCorpus(corpus, output);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "Generated " << options.fmspcCount * options.quotesPerFmspc << " quotes for " << options.fmspcCount
+                  << " FMSPCs with " << options.tcbLevels << " TCB levels and " << options.revokedSerials
+                  << " revoked serials per CRL, " << files << " files written to " << output
+                  << " in " << elapsed.count() << " ms" << std::endl;
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << e.what() << "\n\n";
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
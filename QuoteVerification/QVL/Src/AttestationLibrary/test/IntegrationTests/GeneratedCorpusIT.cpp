@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <SgxEcdsaAttestation/QuoteVerification.h>
+#include <CorpusGenerator.h>
+#include <OpensslHelpers/OpensslTypes.h>
+
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+#include <array>
+
+using namespace testing;
+using namespace intel::sgx::dcap;
+using namespace intel::sgx::dcap::test;
+
+struct GeneratedCorpusIT : public Test
+{
+    CorpusOptions options;
+
+    GeneratedCorpusIT()
+    {
+        options.fmspcCount = 2;
+        options.quotesPerFmspc = 2;
+        options.tcbLevels = 12;
+        options.revokedSerials = 1000;
+    }
+
+    void expectVerified(const Corpus& corpus) const
+    {
+        const std::array<const char*, 2> crls{{corpus.rootCaCrl.c_str(), corpus.intermediateCaCrl.c_str()}};
+
+        EXPECT_EQ(STATUS_OK, sgxAttestationVerifyEnclaveIdentity(corpus.qeIdentity.c_str(), corpus.tcbSigningChain.c_str(),
+                                                                 corpus.rootCaCrl.c_str(), corpus.trustedRootCaCert.c_str(), nullptr));
+        for (const auto& platform : corpus.platforms)
+        {
+            EXPECT_EQ(STATUS_OK, sgxAttestationVerifyTCBInfo(platform.tcbInfo.c_str(), corpus.tcbSigningChain.c_str(),
+                                                             corpus.rootCaCrl.c_str(), corpus.trustedRootCaCert.c_str(), nullptr));
+            for (size_t i = 0; i < platform.quotes.size(); i++)
+            {
+                const auto pckCertChain = corpus.pckSigningChain + platform.pckCerts[i];
+                EXPECT_EQ(STATUS_OK, sgxAttestationVerifyPCKCertificate(pckCertChain.c_str(), crls.data(),
+                                                                        corpus.trustedRootCaCert.c_str(), nullptr));
+                EXPECT_EQ(STATUS_OK, sgxAttestationVerifyQuote(platform.quotes[i].data(), static_cast<uint32_t>(platform.quotes[i].size()),
+                                                               platform.pckCerts[i].c_str(), corpus.intermediateCaCrl.c_str(),
+                                                               platform.tcbInfo.c_str(), corpus.qeIdentity.c_str()));
+            }
+        }
+    }
+};
+
+TEST_F(GeneratedCorpusIT, shouldGenerateCorpusThatPassesVerificationWithPemCrls)
+{
+    const auto corpus = generateCorpus(options);
+
+    ASSERT_EQ(options.fmspcCount, corpus.platforms.size());
+    EXPECT_NE(corpus.platforms[0].fmspc, corpus.platforms[1].fmspc);
+    for (const auto& platform : corpus.platforms)
+    {
+        ASSERT_EQ(options.quotesPerFmspc, platform.quotes.size());
+        ASSERT_EQ(options.quotesPerFmspc, platform.pckCerts.size());
+    }
+    expectVerified(corpus);
+}
+
+TEST_F(GeneratedCorpusIT, shouldGenerateCorpusThatPassesVerificationWithDerCrls)
+{
+    options.derCrls = true;
+
+    expectVerified(generateCorpus(options));
+}
+
+TEST_F(GeneratedCorpusIT, shouldRevokeRequestedNumberOfSerials)
+{
+    const auto corpus = generateCorpus(options);
+
+    auto bio = crypto::make_unique(BIO_new_mem_buf(corpus.intermediateCaCrl.data(), static_cast<int>(corpus.intermediateCaCrl.size())));
+    auto crl = crypto::make_unique(PEM_read_bio_X509_CRL(bio.get(), nullptr, nullptr, nullptr));
+    ASSERT_TRUE(crl);
+    EXPECT_EQ(static_cast<int>(options.revokedSerials), sk_X509_REVOKED_num(X509_CRL_get_REVOKED(crl.get())));
+}
+
+TEST_F(GeneratedCorpusIT, shouldRejectTcbLevelsThatCannotBeEncodedInPcesvn)
+{
+    options.tcbLevels = 0;
+    EXPECT_THROW(generateCorpus(options), std::invalid_argument);
+
+    options.tcbLevels = 65536;
+    EXPECT_THROW(generateCorpus(options), std::invalid_argument);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Utils/CollateralCache.h>
+
+#include <string>
+
+using namespace testing;
+using namespace intel::sgx::dcap;
+
+static const std::string ROOT_CERT = R"cert(-----BEGIN CERTIFICATE-----
+MIICkDCCAjWgAwIBAgIVALf/CXgnn0m9mkeN7uLmdD8NVr5mMAoGCCqGSM49BAMC
+MGgxGjAYBgNVBAMMEUludGVsIFNHWCBSb290IENBMRowGAYDVQQKDBFJbnRlbCBD
+b3Jwb3JhdGlvbjEUMBIGA1UEBwwLU2FudGEgQ2xhcmExCzAJBgNVBAgMAkNBMQsw
+CQYDVQQGEwJVUzAeFw0xODAzMjkxMDA3MTFaFw00OTEyMzEyMjU5NTlaMGgxGjAY
+BgNVBAMMEUludGVsIFNHWCBSb290IENBMRowGAYDVQQKDBFJbnRlbCBDb3Jwb3Jh
+dGlvbjEUMBIGA1UEBwwLU2FudGEgQ2xhcmExCzAJBgNVBAgMAkNBMQswCQYDVQQG
+EwJVUzBZMBMGByqGSM49AgEGCCqGSM49AwEHA0IABOg+J8Dbw8l21h+KbjyFt8qH
+9R6jRTx/t+EdBkgbknxB3rEVOW0xKIe68ILaGFQXzuc/V9KYULriAQ8EV84W7Ouj
+gbswgbgwHwYDVR0jBBgwFoAUt/8JeCefSb2aR43u4uZ0Pw1WvmYwUgYDVR0fBEsw
+STBHoEWgQ4ZBaHR0cHM6Ly9jZXJ0aWZpY2F0ZXMudHJ1c3RlZHNlcnZpY2VzLmlu
+dGVsLmNvbS9JbnRlbFNHWFJvb3RDQS5jcmwwHQYDVR0OBBYEFLf/CXgnn0m9mkeN
+7uLmdD8NVr5mMA4GA1UdDwEB/wQEAwIBBjASBgNVHRMBAf8ECDAGAQH/AgEBMAoG
+CCqGSM49BAMCA0kAMEYCIQDNrdFnV6RpzcxPeU4buq6XWJuVwWQJiYuhzAEtpn7p
+bgIhAJbRv7dhz/yzCD14FmJuZnwI/3aDSvkc6MSD/K6m5ot0
+-----END CERTIFICATE-----
+)cert";
+
+struct CollateralCacheUT : public Test
+{
+    CollateralCache cache;
+};
+
+TEST_F(CollateralCacheUT, shouldReturnSameCertificateForSameCollateral)
+{
+    // WHEN
+    const auto first = cache.getCertificate(ROOT_CERT.c_str());
+    const std::string copy = ROOT_CERT;
+    const auto second = cache.getCertificate(copy.c_str());
+
+    // THEN
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(CollateralCacheUT, shouldReturnSameChainForSameCollateral)
+{
+    // GIVEN
+    std::shared_ptr<const CertificateChain> first;
+    std::shared_ptr<const CertificateChain> second;
+
+    // WHEN
+    const auto firstStatus = cache.getCertificateChain(ROOT_CERT.c_str(), first);
+    const auto secondStatus = cache.getCertificateChain(ROOT_CERT.c_str(), second);
+
+    // THEN
+    EXPECT_EQ(STATUS_OK, firstStatus);
+    EXPECT_EQ(STATUS_OK, secondStatus);
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(1, first->length());
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(CollateralCacheUT, shouldNotCacheCollateralThatCannotBeParsed)
+{
+    // GIVEN
+    std::shared_ptr<const CertificateChain> chain;
+
+    // WHEN
+    const auto crl = cache.getCrl("not a CRL");
+    const auto chainStatus = cache.getCertificateChain("not a chain", chain);
+
+    // THEN
+    EXPECT_EQ(nullptr, crl);
+    EXPECT_NE(STATUS_OK, chainStatus);
+    EXPECT_EQ(nullptr, chain);
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(CollateralCacheUT, shouldThrowAndNotCacheWhenCertificateCannotBeParsed)
+{
+    EXPECT_ANY_THROW(cache.getCertificate("not a certificate"));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(CollateralCacheUT, shouldRunVerificationOnceForSameCollateral)
+{
+    // GIVEN
+    int calls = 0;
+    const auto verification = [&calls] { ++calls; return STATUS_TCB_INFO_INVALID_SIGNATURE; };
+
+    // WHEN
+    const auto first = cache.getVerificationStatus("verifier", {"tcbInfo", "chain"}, verification);
+    const auto second = cache.getVerificationStatus("verifier", {"tcbInfo", "chain"}, verification);
+
+    // THEN
+    EXPECT_EQ(STATUS_TCB_INFO_INVALID_SIGNATURE, first);
+    EXPECT_EQ(STATUS_TCB_INFO_INVALID_SIGNATURE, second);
+    EXPECT_EQ(1, calls);
+}
+
+TEST_F(CollateralCacheUT, shouldRunVerificationAgainForDifferentCollateralOrName)
+{
+    // GIVEN
+    int calls = 0;
+    const auto verification = [&calls] { ++calls; return STATUS_OK; };
+
+    // WHEN
+    cache.getVerificationStatus("verifier", {"tcbInfo", "chain"}, verification);
+    cache.getVerificationStatus("verifier", {"tcbInfo", "otherChain"}, verification);
+    cache.getVerificationStatus("otherVerifier", {"tcbInfo", "chain"}, verification);
+    cache.getVerificationStatus("verifier", {"tcbInfoc", "hain"}, verification);
+
+    // THEN
+    EXPECT_EQ(4, calls);
+    EXPECT_EQ(4, cache.size());
+}
+
+TEST_F(CollateralCacheUT, shouldEvictLeastRecentlyUsedEntryWhenCapacityIsExceeded)
+{
+    // GIVEN
+    // room for two certificates and a single verification status
+    CollateralCache smallCache(ROOT_CERT.size() * 2 + 600);
+    int calls = 0;
+    const auto verification = [&calls] { ++calls; return STATUS_OK; };
+
+    // WHEN
+    const auto first = smallCache.getCertificate(ROOT_CERT.c_str());
+    smallCache.getVerificationStatus("verifier", {ROOT_CERT.c_str()}, verification);
+    smallCache.getCertificate(ROOT_CERT.c_str());
+    const std::string other = ROOT_CERT + "\n";
+    smallCache.getCertificate(other.c_str());
+    const auto again = smallCache.getCertificate(ROOT_CERT.c_str());
+    smallCache.getVerificationStatus("verifier", {ROOT_CERT.c_str()}, verification);
+
+    // THEN
+    EXPECT_EQ(first, again);
+    EXPECT_EQ(2, calls);
+    EXPECT_EQ(2, smallCache.size());
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <PckParser/CrlStore.h>
+#include <CertVerification/X509Constants.h>
+#include <X509CertGenerator.h>
+#include <X509CrlGenerator.h>
+
+using namespace testing;
+using namespace ::intel::sgx::dcap;
+using namespace ::intel::sgx::dcap::test;
+using namespace intel::sgx::dcap::parser::test;
+
+struct CrlStoreUT : public Test
+{
+    int timeNow = 0;
+    int timeOneHour = 3600;
+
+    X509CrlGenerator crlGenerator;
+    X509CertGenerator certGenerator;
+    Bytes caSerial {0x23, 0x45};
+
+    crypto::EVP_PKEY_uptr keyRoot = crypto::make_unique<EVP_PKEY>(nullptr);
+    crypto::X509_uptr rootCert = crypto::make_unique<X509>(nullptr);
+
+    CrlStoreUT()
+    {
+        keyRoot = certGenerator.generateEcKeypair();
+        rootCert = certGenerator.generateCaCert(2, caSerial, timeNow, timeOneHour, keyRoot.get(), keyRoot.get(),
+                                                constants::ROOT_CA_SUBJECT, constants::ROOT_CA_SUBJECT);
+    }
+
+    std::string generateCrl(const std::vector<Bytes>& revokedSerials)
+    {
+        auto crl = crlGenerator.generateCRL(CRLVersion::CRL_VERSION_2, timeNow, timeOneHour, rootCert, revokedSerials);
+        return X509CrlGenerator::x509CrlToPEMString(crl.get());
+    }
+
+    parser::x509::Certificate generateCert(const Bytes& serial)
+    {
+        auto key = certGenerator.generateEcKeypair();
+        auto cert = certGenerator.generateCaCert(2, serial, timeNow, timeOneHour, key.get(), keyRoot.get(),
+                                                 constants::PLATFORM_CA_SUBJECT, constants::ROOT_CA_SUBJECT);
+        return parser::x509::Certificate::parse(certGenerator.x509ToString(cert.get()));
+    }
+};
+
+TEST_F(CrlStoreUT, shouldReportRevokedCertificates)
+{
+    // GIVEN
+    const std::vector<Bytes> revokedSerials{{0x12, 0x10, 0x13, 0x11}, {0x11, 0x33, 0xff, 0x56}, {0x05}, {0x11, 0x33, 0xff}};
+    pckparser::CrlStore crl;
+    ASSERT_TRUE(crl.parse(generateCrl(revokedSerials)));
+
+    // WHEN / THEN
+    for(const auto& serial : revokedSerials)
+    {
+        EXPECT_TRUE(crl.isRevoked(generateCert(serial)));
+    }
+}
+
+TEST_F(CrlStoreUT, shouldNotReportCertificatesAbsentFromCrl)
+{
+    // GIVEN
+    pckparser::CrlStore crl;
+    ASSERT_TRUE(crl.parse(generateCrl({{0x12, 0x10, 0x13, 0x11}, {0x11, 0x33, 0xff, 0x56}})));
+
+    // WHEN / THEN
+    EXPECT_FALSE(crl.isRevoked(generateCert({0x12, 0x10, 0x13, 0x12})));
+    EXPECT_FALSE(crl.isRevoked(generateCert({0x11, 0x33, 0xff})));
+    EXPECT_FALSE(crl.isRevoked(generateCert({0x11, 0x33, 0xff, 0x56, 0x01})));
+}
+
+TEST_F(CrlStoreUT, shouldNotReportAnyCertificateWhenCrlIsEmpty)
+{
+    // GIVEN
+    pckparser::CrlStore crl;
+    ASSERT_TRUE(crl.parse(generateCrl({})));
+
+    // WHEN / THEN
+    EXPECT_FALSE(crl.isRevoked(generateCert(caSerial)));
+    EXPECT_TRUE(crl.getRevoked().empty());
+}
+
+TEST_F(CrlStoreUT, shouldReturnAllRevokedEntries)
+{
+    // GIVEN
+    const std::vector<Bytes> revokedSerials{{0x33, 0x01}, {0x12, 0x10, 0x13, 0x11}, {0x05}};
+    pckparser::CrlStore crl;
+    ASSERT_TRUE(crl.parse(generateCrl(revokedSerials)));
+
+    // WHEN
+    const auto& revoked = crl.getRevoked();
+
+    // THEN
+    std::vector<Bytes> serials;
+    for(const auto& entry : revoked)
+    {
+        serials.push_back(entry.serialNumber);
+    }
+    EXPECT_THAT(serials, UnorderedElementsAreArray(revokedSerials));
+}
+
+TEST_F(CrlStoreUT, shouldRebuildRevocationIndexWhenParsedAgain)
+{
+    // GIVEN
+    pckparser::CrlStore crl;
+    ASSERT_TRUE(crl.parse(generateCrl({{0x12, 0x10}})));
+    ASSERT_EQ(1, crl.getRevoked().size());
+
+    // WHEN
+    ASSERT_TRUE(crl.parse(generateCrl({{0x33, 0x01}, {0x44, 0x02}})));
+
+    // THEN
+    EXPECT_FALSE(crl.isRevoked(generateCert({0x12, 0x10})));
+    EXPECT_TRUE(crl.isRevoked(generateCert({0x44, 0x02})));
+    EXPECT_EQ(2, crl.getRevoked().size());
+}
@@ -59,6 +59,19 @@ TEST_F(EnclaveIdentityParserUT, shouldReturnStatusOkWhenJsonIsOk)
     ASSERT_EQ(STATUS_OK, result->getStatus());
 }
 
+TEST_F(EnclaveIdentityParserUT, shouldKeepSignedBodyExactlyAsIssued)
+{
+    const string body = R"json({ "version" : 1,
+        "issueDate":"2018-10-04T11:10:45Z", "nextUpdate":"2019-06-21T12:36:02Z", "miscselect":"8fa64472",
+        "miscselectMask":"0000fffa", "attributes":"0918dad57e9b4ed3bdf2e2aec67af6cc",
+        "attributesMask":"fffffffffffffffffffffffffffffff9",
+        "mrsigner":"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "isvprodid":0, "isvsvn":0 })json";
+    auto result = parser.parse(qeIdentityJsonWithSignature(body));
+
+    ASSERT_EQ(STATUS_OK, result->getStatus());
+    EXPECT_EQ(vector<uint8_t>(body.cbegin(), body.cend()), result->getBody());
+}
+
 TEST_F(EnclaveIdentityParserUT, shouldReturnEnclaveIdentityInvalidWhenMiscselectIsWrong)
 {
     EnclaveIdentityVectorModel model;
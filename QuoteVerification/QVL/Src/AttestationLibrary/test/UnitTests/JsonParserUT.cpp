@@ -72,6 +72,33 @@ TEST_F(JsonParserTests, shouldReturnMainObjectFields)
     EXPECT_EQ(nullptr, missingField);
 }
 
+TEST_F(JsonParserTests, shouldLocateObjectFieldExactlyAsWritten)
+{
+    const std::string json = R"json({"data" : { "v":  1,
+        "w": [2, 3] }, "otherField": 66})json";
+    ASSERT_TRUE(jsonParser.parse(json));
+    const auto span = jsonParser.getFieldSpan("data");
+    EXPECT_EQ(R"json({ "v":  1,
+        "w": [2, 3] })json", json.substr(span.first, span.second));
+}
+
+TEST_F(JsonParserTests, shouldLocateFirstOfDuplicatedFields)
+{
+    const std::string json = R"json({"d\u0061ta": {"v": 1}, "data": {"v": 2}})json";
+    ASSERT_TRUE(jsonParser.parse(json));
+    const auto span = jsonParser.getFieldSpan("data");
+    EXPECT_EQ(R"json({"v": 1})json", json.substr(span.first, span.second));
+    EXPECT_EQ(1, (*jsonParser.getField("data"))["v"].GetInt());
+}
+
+TEST_F(JsonParserTests, shouldNotLocateScalarOrMissingFields)
+{
+    ASSERT_TRUE(jsonParser.parse(R"json({"data": {"v": {}}, "otherField": 66})json"));
+    EXPECT_EQ(0, jsonParser.getFieldSpan("otherField").second);
+    EXPECT_EQ(0, jsonParser.getFieldSpan("v").second);
+    EXPECT_EQ(0, jsonParser.getFieldSpan("missingField").second);
+}
+
 TEST_F(JsonParserTests, shouldParseObjectWithHexstring)
 {
     std::vector<uint8_t> expectedValue = {0xad, 0xff, 0x09, 0xa7};
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Utils/PackedCollateral.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace ::intel::sgx::dcap;
+
+namespace {
+
+constexpr uint32_t COLLATERAL_VERSION = 3;
+constexpr size_t MAX_SIZE = 64 * 1024;
+
+}
+
+struct PackedCollateralUT : public Test
+{
+    const std::vector<std::string> values{"pckCrlIssuerChain", "rootCaCrl", "pckCrl", "tcbInfoIssuerChain",
+                                          "tcbInfo", "qeIdentityIssuerChain", "qeIdentity"};
+    const std::vector<uint8_t> prepared{0x51, 0x56, 0x50, 0x43, 0x00, 0x01, 0x00};
+
+    PackedCollateral::Collateral pcsCollateral() const
+    {
+        PackedCollateral::Collateral collateral{};
+        collateral.version = COLLATERAL_VERSION;
+        for (size_t i = 0; i < PackedCollateral::FIELD_COUNT; i++)
+        {
+            collateral.fields[i] = values[i].c_str();
+            collateral.sizes[i] = static_cast<uint32_t>(values[i].size() + 1);
+        }
+        return collateral;
+    }
+
+    PackedCollateral::Collateral preparedCollateral() const
+    {
+        PackedCollateral::Collateral collateral{};
+        collateral.version = PackedCollateral::PREPARED_VERSION;
+        collateral.fields[static_cast<size_t>(PackedCollateral::Field::TcbInfo)] = reinterpret_cast<const char*>(prepared.data());
+        collateral.sizes[static_cast<size_t>(PackedCollateral::Field::TcbInfo)] = static_cast<uint32_t>(prepared.size());
+        return collateral;
+    }
+};
+
+TEST_F(PackedCollateralUT, shouldUnpackBatchWithPcsAndPreparedCollateral)
+{
+    // GIVEN
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(PackedCollateral::append(pcsCollateral(), MAX_SIZE, packed));
+    ASSERT_TRUE(PackedCollateral::append(preparedCollateral(), MAX_SIZE, packed));
+    ASSERT_TRUE(PackedCollateral::append(pcsCollateral(), MAX_SIZE, packed));
+
+    // WHEN
+    std::vector<PackedCollateral::Collateral> collaterals;
+    ASSERT_TRUE(PackedCollateral::unpack(packed.data(), packed.size(), collaterals));
+
+    // THEN
+    ASSERT_EQ(3, collaterals.size());
+    for (size_t index : {0, 2})
+    {
+        EXPECT_EQ(COLLATERAL_VERSION, collaterals[index].version);
+        for (size_t i = 0; i < PackedCollateral::FIELD_COUNT; i++)
+        {
+            ASSERT_EQ(values[i].size() + 1, collaterals[index].sizes[i]);
+            EXPECT_STREQ(values[i].c_str(), collaterals[index].fields[i]);
+        }
+    }
+
+    const auto &unpackedPrepared = collaterals[1];
+    EXPECT_EQ(PackedCollateral::PREPARED_VERSION, unpackedPrepared.version);
+    for (size_t i = 0; i < PackedCollateral::FIELD_COUNT; i++)
+    {
+        if (i == static_cast<size_t>(PackedCollateral::Field::TcbInfo))
+        {
+            const auto *data = reinterpret_cast<const uint8_t*>(unpackedPrepared.fields[i]);
+            EXPECT_EQ(prepared, std::vector<uint8_t>(data, data + unpackedPrepared.sizes[i]));
+        }
+        else
+        {
+            EXPECT_EQ(nullptr, unpackedPrepared.fields[i]);
+            EXPECT_EQ(0, unpackedPrepared.sizes[i]);
+        }
+    }
+}
+
+TEST_F(PackedCollateralUT, shouldRejectPcsCollateralWithMissingField)
+{
+    auto collateral = pcsCollateral();
+    collateral.fields[static_cast<size_t>(PackedCollateral::Field::PckCrl)] = nullptr;
+    collateral.sizes[static_cast<size_t>(PackedCollateral::Field::PckCrl)] = 0;
+
+    std::vector<uint8_t> packed;
+    EXPECT_FALSE(PackedCollateral::append(collateral, MAX_SIZE, packed));
+    EXPECT_TRUE(packed.empty());
+}
+
+TEST_F(PackedCollateralUT, shouldRejectPreparedCollateralWithOtherFields)
+{
+    auto collateral = preparedCollateral();
+    collateral.fields[static_cast<size_t>(PackedCollateral::Field::QeIdentity)] = values[6].c_str();
+    collateral.sizes[static_cast<size_t>(PackedCollateral::Field::QeIdentity)] = static_cast<uint32_t>(values[6].size() + 1);
+
+    std::vector<uint8_t> packed;
+    EXPECT_FALSE(PackedCollateral::append(collateral, MAX_SIZE, packed));
+    EXPECT_TRUE(packed.empty());
+}
+
+TEST_F(PackedCollateralUT, shouldRejectCollateralOverMaxSize)
+{
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(PackedCollateral::append(preparedCollateral(), MAX_SIZE, packed));
+    const auto packedSize = packed.size();
+
+    EXPECT_FALSE(PackedCollateral::append(preparedCollateral(), packedSize * 2 - 1, packed));
+    EXPECT_EQ(packedSize, packed.size());
+    EXPECT_TRUE(PackedCollateral::append(preparedCollateral(), packedSize * 2, packed));
+}
+
+TEST_F(PackedCollateralUT, shouldRejectPackedPreparedCollateralWithOtherFieldSizes)
+{
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(PackedCollateral::append(preparedCollateral(), MAX_SIZE, packed));
+    const uint32_t qeIdentitySize = 1;
+    std::memcpy(packed.data() + 4 + static_cast<size_t>(PackedCollateral::Field::QeIdentity) * 4,
+                &qeIdentitySize, sizeof(qeIdentitySize));
+    packed.push_back(0);
+
+    std::vector<PackedCollateral::Collateral> collaterals;
+    EXPECT_FALSE(PackedCollateral::unpack(packed.data(), packed.size(), collaterals));
+}
+
+TEST_F(PackedCollateralUT, shouldRejectTruncatedPackedCollateral)
+{
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(PackedCollateral::append(pcsCollateral(), MAX_SIZE, packed));
+
+    std::vector<PackedCollateral::Collateral> collaterals;
+    EXPECT_FALSE(PackedCollateral::unpack(packed.data(), packed.size() - 1, collaterals));
+    EXPECT_FALSE(PackedCollateral::unpack(packed.data(), PackedCollateral::HEADER_SIZE - 1, collaterals));
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Utils/PreparedCollateral.h>
+#include <Utils/CollateralCache.h>
+#include <Utils/PackedCollateral.h>
+#include <Utils/RuntimeException.h>
+#include <Verifiers/EnclaveIdentityParser.h>
+#include <CertVerification/X509Constants.h>
+#include <X509CertGenerator.h>
+#include <X509CrlGenerator.h>
+#include <TcbInfoJsonGenerator.h>
+#include <EnclaveIdentityGenerator.h>
+
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace ::intel::sgx::dcap;
+using namespace ::intel::sgx::dcap::test;
+using namespace intel::sgx::dcap::parser::test;
+
+struct PreparedCollateralUT : public Test
+{
+    int timeNow = 0;
+    int timeOneHour = 3600;
+
+    X509CrlGenerator crlGenerator;
+    X509CertGenerator certGenerator;
+
+    crypto::EVP_PKEY_uptr keyRoot = crypto::make_unique<EVP_PKEY>(nullptr);
+    crypto::X509_uptr rootCert = crypto::make_unique<X509>(nullptr);
+    crypto::X509_uptr signingCert = crypto::make_unique<X509>(nullptr);
+
+    std::string chain;
+    std::string rootCaCrl;
+    std::string pckCrl;
+    std::string tcbInfo;
+    std::string qeIdentity;
+
+    PreparedCollateralUT()
+    {
+        keyRoot = certGenerator.generateEcKeypair();
+        rootCert = certGenerator.generateCaCert(2, {0x23, 0x45}, timeNow, timeOneHour, keyRoot.get(), keyRoot.get(),
+                                                constants::ROOT_CA_SUBJECT, constants::ROOT_CA_SUBJECT);
+        auto keySigning = certGenerator.generateEcKeypair();
+        signingCert = certGenerator.generateCaCert(2, {0x23, 0x46}, timeNow, timeOneHour, keySigning.get(), keyRoot.get(),
+                                                   constants::TCB_SUBJECT, constants::ROOT_CA_SUBJECT);
+        chain = certGenerator.x509ToString(signingCert.get()) + certGenerator.x509ToString(rootCert.get());
+
+        auto crl = crlGenerator.generateCRL(CRLVersion::CRL_VERSION_2, timeNow, timeOneHour, rootCert, {{0x12, 0x10}});
+        rootCaCrl = X509CrlGenerator::x509CrlToDERString(crl.get());
+        pckCrl = X509CrlGenerator::x509CrlToPEMString(crl.get());
+
+        tcbInfo = tcbInfoJsonGenerator(tcbInfoJsonV2Body(2, "2018-07-22T10:09:10Z", "2118-08-23T10:09:10Z", "04F34445AA00",
+                                                         "0000", getRandomTcb(), 0, "UpToDate", 1, 1, "2058-08-23T10:09:10Z"),
+                                       validSignatureTemplate);
+        qeIdentity = enclaveIdentityJsonWithSignature();
+    }
+
+    std::vector<uint8_t> build()
+    {
+        return PreparedCollateral::build(3, chain.c_str(), rootCaCrl.c_str(), pckCrl.c_str(), chain.c_str(),
+                                         tcbInfo.c_str(), chain.c_str(), qeIdentity.c_str());
+    }
+
+    static Status loadStatus(const std::vector<uint8_t> &prepared)
+    {
+        try
+        {
+            PreparedCollateral::load(prepared.data(), prepared.size());
+        }
+        catch (const RuntimeException &e)
+        {
+            return e.getStatus();
+        }
+        return STATUS_OK;
+    }
+};
+
+TEST_F(PreparedCollateralUT, shouldLoadCollateralAsParsedFromPcsFormat)
+{
+    // GIVEN
+    const auto prepared = build();
+    const auto expectedTcbInfo = parser::json::TcbInfo::parse(tcbInfo);
+    const auto expectedQeIdentity = EnclaveIdentityParser{}.parse(qeIdentity);
+    pckparser::CrlStore expectedCrl;
+    ASSERT_TRUE(expectedCrl.parse(pckCrl));
+
+    // WHEN
+    const auto loaded = PreparedCollateral::load(prepared.data(), prepared.size());
+
+    // THEN
+    EXPECT_EQ(3, loaded.getHeader().collateralVersion);
+    EXPECT_EQ(expectedTcbInfo.getFmspc(), std::vector<uint8_t>(loaded.getHeader().fmspc.cbegin(), loaded.getHeader().fmspc.cend()));
+    EXPECT_EQ(expectedTcbInfo.getNextUpdate(), loaded.getHeader().tcbInfoNextUpdate);
+    EXPECT_EQ(expectedQeIdentity->getNextUpdate(), loaded.getHeader().qeIdentityNextUpdate);
+    EXPECT_EQ(64, loaded.getDigest().size());
+
+    EXPECT_EQ(expectedTcbInfo.getInfoBody(), loaded.getTcbInfo()->getInfoBody());
+    EXPECT_EQ(expectedTcbInfo.getSignature(), loaded.getTcbInfo()->getSignature());
+    EXPECT_EQ(expectedTcbInfo.getTcbLevels().size(), loaded.getTcbLevelMatcher()->size());
+    EXPECT_EQ(expectedQeIdentity->getBody(), loaded.getQeIdentity()->getBody());
+    EXPECT_EQ(expectedQeIdentity->getSignature(), loaded.getQeIdentity()->getSignature());
+
+    EXPECT_EQ(expectedCrl, *loaded.getRootCaCrl());
+    EXPECT_EQ(expectedCrl, *loaded.getPckCrl());
+    for (const auto &loadedChain : {loaded.getPckCrlIssuerChain(), loaded.getTcbInfoIssuerChain(), loaded.getQeIdentityIssuerChain()})
+    {
+        ASSERT_EQ(2, loadedChain->length());
+        EXPECT_EQ(certGenerator.x509ToString(rootCert.get()), loadedChain->getRootCert()->getPem());
+        EXPECT_EQ(certGenerator.x509ToString(signingCert.get()), loadedChain->getTopmostCert()->getPem());
+    }
+}
+
+TEST_F(PreparedCollateralUT, shouldRejectHeaderNotMatchingSignedContent)
+{
+    // GIVEN
+    auto fmspcChanged = build();
+    fmspcChanged[8] ^= 0x01;
+    auto nextUpdateChanged = build();
+    nextUpdateChanged[24] ^= 0x01;
+
+    // WHEN / THEN
+    EXPECT_EQ(STATUS_SGX_TCB_INFO_INVALID, loadStatus(fmspcChanged));
+    EXPECT_EQ(STATUS_SGX_ENCLAVE_IDENTITY_INVALID, loadStatus(nextUpdateChanged));
+}
+
+TEST_F(PreparedCollateralUT, shouldRejectInvalidLayout)
+{
+    // GIVEN
+    const auto prepared = build();
+    auto wrongMagic = prepared;
+    wrongMagic[0] ^= 0x01;
+    auto wrongFormatVersion = prepared;
+    wrongFormatVersion[4] ^= 0x01;
+    auto sectionOutOfBounds = prepared;
+    sectionOutOfBounds[PreparedCollateral::HEADER_SIZE - 1] = 0x01;
+    const std::vector<uint8_t> truncated(prepared.cbegin(), prepared.cend() - 1);
+    const std::vector<uint8_t> headerOnly(prepared.cbegin(), prepared.cbegin() + PreparedCollateral::HEADER_SIZE - 1);
+
+    // WHEN / THEN
+    EXPECT_EQ(STATUS_INVALID_PARAMETER, loadStatus(wrongMagic));
+    EXPECT_EQ(STATUS_INVALID_PARAMETER, loadStatus(wrongFormatVersion));
+    EXPECT_EQ(STATUS_INVALID_PARAMETER, loadStatus(sectionOutOfBounds));
+    EXPECT_EQ(STATUS_INVALID_PARAMETER, loadStatus(truncated));
+    EXPECT_EQ(STATUS_INVALID_PARAMETER, loadStatus(headerOnly));
+}
+
+TEST_F(PreparedCollateralUT, shouldNotBuildFromCollateralThatCannotBeParsed)
+{
+    EXPECT_THROW(PreparedCollateral::build(3, "not a chain", rootCaCrl.c_str(), pckCrl.c_str(), chain.c_str(),
+                                           tcbInfo.c_str(), chain.c_str(), qeIdentity.c_str()), RuntimeException);
+    EXPECT_THROW(PreparedCollateral::build(3, chain.c_str(), "not a CRL", pckCrl.c_str(), chain.c_str(),
+                                           tcbInfo.c_str(), chain.c_str(), qeIdentity.c_str()), RuntimeException);
+    EXPECT_THROW(PreparedCollateral::build(3, chain.c_str(), rootCaCrl.c_str(), pckCrl.c_str(), chain.c_str(),
+                                           "{}", chain.c_str(), qeIdentity.c_str()), RuntimeException);
+}
+
+TEST_F(PreparedCollateralUT, shouldLoadPreparedCollateralOnceInCache)
+{
+    // GIVEN
+    CollateralCache cache;
+    const auto prepared = build();
+    const auto copy = prepared;
+
+    // WHEN
+    const auto first = cache.getPreparedCollateral(prepared.data(), prepared.size());
+    const auto second = cache.getPreparedCollateral(copy.data(), copy.size());
+
+    // THEN
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(PreparedCollateralUT, shouldLoadPreparedCollateralUnpackedFromBatch)
+{
+    // GIVEN
+    const auto prepared = build();
+    const std::vector<const std::string*> pcsFields{&chain, &rootCaCrl, &pckCrl, &chain, &tcbInfo, &chain, &qeIdentity};
+    PackedCollateral::Collateral pcsCollateral{};
+    pcsCollateral.version = 3;
+    for (size_t i = 0; i < PackedCollateral::FIELD_COUNT; i++)
+    {
+        pcsCollateral.fields[i] = pcsFields[i]->c_str();
+        pcsCollateral.sizes[i] = static_cast<uint32_t>(pcsFields[i]->size() + 1);
+    }
+    PackedCollateral::Collateral preparedCollateral{};
+    preparedCollateral.version = PackedCollateral::PREPARED_VERSION;
+    preparedCollateral.fields[static_cast<size_t>(PackedCollateral::Field::TcbInfo)] = reinterpret_cast<const char*>(prepared.data());
+    preparedCollateral.sizes[static_cast<size_t>(PackedCollateral::Field::TcbInfo)] = static_cast<uint32_t>(prepared.size());
+
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(PackedCollateral::append(pcsCollateral, 192 * 1024, packed));
+    ASSERT_TRUE(PackedCollateral::append(preparedCollateral, 192 * 1024, packed));
+
+    // WHEN
+    std::vector<PackedCollateral::Collateral> collaterals;
+    ASSERT_TRUE(PackedCollateral::unpack(packed.data(), packed.size(), collaterals));
+
+    // THEN
+    ASSERT_EQ(2, collaterals.size());
+    const auto &unpacked = collaterals[1];
+    ASSERT_EQ(PackedCollateral::PREPARED_VERSION, unpacked.version);
+    const auto *data = reinterpret_cast<const uint8_t*>(unpacked.fields[static_cast<size_t>(PackedCollateral::Field::TcbInfo)]);
+    const auto loaded = PreparedCollateral::load(data, unpacked.sizes[static_cast<size_t>(PackedCollateral::Field::TcbInfo)]);
+    EXPECT_EQ(parser::json::TcbInfo::parse(tcbInfo).getInfoBody(), loaded.getTcbInfo()->getInfoBody());
+    EXPECT_EQ(STATUS_OK, loadStatus(prepared));
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <OpensslHelpers/PublicKeyCache.h>
+#include <OpensslHelpers/SignatureVerification.h>
+#include <gtest/gtest.h>
+
+#include "KeyHelpers.h"
+#include "DigestUtils.h"
+
+using namespace intel::sgx;
+using namespace ::testing;
+
+struct PublicKeyCacheUT : public Test
+{
+    dcap::crypto::PublicKeyCache cache{2};
+    const std::vector<uint8_t> data = std::vector<uint8_t>(150, 0xff);
+
+    static std::array<uint8_t, 64> otherRawKey()
+    {
+        auto key = dcap::crypto::make_unique(EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+        EC_KEY_generate_key(key.get());
+        return dcap::test::getRawPub(*key);
+    }
+};
+
+TEST_F(PublicKeyCacheUT, shouldVerifySignaturesWithPreparedKey)
+{
+    auto prv = dcap::test::priv(dcap::test::PEM_PRV);
+    auto evp = dcap::crypto::make_unique(EVP_PKEY_new());
+    ASSERT_EQ(1, EVP_PKEY_set1_EC_KEY(evp.get(), prv.get()));
+    auto pb = dcap::test::pub(dcap::test::PEM_PUB);
+    const auto sig = dcap::DigestUtils::signMessageSha256(data, *evp);
+    ASSERT_FALSE(sig.empty());
+
+    const auto key = cache.get(dcap::test::getVectorPub(*pb));
+    ASSERT_NE(nullptr, key);
+
+    // every verification starts from the same prepared context
+    EXPECT_TRUE(key->verifySha256Signature(sig, data.data(), data.size()));
+    EXPECT_FALSE(key->verifySha256Signature(sig, data.data(), data.size() - 1));
+    EXPECT_TRUE(key->verifySha256Signature(sig, data.data(), data.size()));
+}
+
+TEST_F(PublicKeyCacheUT, shouldReturnSameKeyOnHit)
+{
+    auto pb = dcap::test::pub(dcap::test::PEM_PUB);
+
+    const auto first = cache.get(dcap::test::getRawPub(*pb));
+    const auto second = cache.get(dcap::test::getVectorPub(*pb));
+
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(PublicKeyCacheUT, shouldNotCacheInvalidKeys)
+{
+    auto pb = dcap::test::pub(dcap::test::PEM_PUB);
+    auto notOnCurve = dcap::test::getRawPub(*pb);
+    notOnCurve[63] ^= 0x01;
+    auto compressedHeader = dcap::test::getVectorPub(*pb);
+    compressedHeader[0] = POINT_CONVERSION_COMPRESSED;
+
+    EXPECT_EQ(nullptr, cache.get(notOnCurve));
+    EXPECT_EQ(nullptr, cache.get(compressedHeader));
+    EXPECT_EQ(nullptr, cache.get(std::vector<uint8_t>{}));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(PublicKeyCacheUT, shouldEvictLeastRecentlyUsedKey)
+{
+    auto pb = dcap::test::pub(dcap::test::PEM_PUB);
+    const auto rawKey = dcap::test::getRawPub(*pb);
+
+    const auto first = cache.get(rawKey);
+    cache.get(otherRawKey());
+    EXPECT_EQ(first, cache.get(rawKey));
+    cache.get(otherRawKey());
+
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(first, cache.get(rawKey));
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    const auto prepared = cache.get(rawKey);
+    EXPECT_NE(first, prepared);
+    EXPECT_NE(nullptr, prepared);
+}
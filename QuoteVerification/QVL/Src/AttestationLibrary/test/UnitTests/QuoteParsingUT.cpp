@@ -143,12 +143,12 @@ TEST(quoteParsingAndValidation, shouldParseEmptyHeader)
     const auto headerBytes = testHeader.bytes();
 
     // WHEN
-    auto from = headerBytes.begin();
+    const uint8_t *from = headerBytes.data();
     dcap::Quote::Header header;
-    header.insert(from, headerBytes.cend());
+    header.insert(from, headerBytes.data() + headerBytes.size());
 
     // THEN
-    ASSERT_TRUE(from == headerBytes.cend());
+    ASSERT_TRUE(from == headerBytes.data() + headerBytes.size());
     EXPECT_TRUE(testHeader == header);
 }
 
@@ -298,11 +298,11 @@ TEST(quoteParsingAndValidation, shouldParseEnclaveReport)
     const dcap::test::QuoteGenerator::EnclaveReport testReport{};
     const auto bytes = testReport.bytes();
 
-    auto from = bytes.begin();
+    const uint8_t *from = bytes.data();
     dcap::Quote::EnclaveReport report{};
-    report.insert(from, bytes.cend());
+    report.insert(from, bytes.data() + bytes.size());
 
-    ASSERT_TRUE(from == bytes.cend());
+    ASSERT_TRUE(from == bytes.data() + bytes.size());
     ASSERT_TRUE(testReport == report);
     ASSERT_THAT(report.rawBlob(), ::testing::ElementsAreArray(bytes));
 }
@@ -329,11 +329,11 @@ TEST(quoteParsingAndValidation, shouldParseQeAuthData)
     dcap::test::QuoteGenerator::QeAuthData testAuth{5, {1,2,3,4,5}};
     const auto bytes = testAuth.bytes();
 
-    auto from = bytes.begin();
+    const uint8_t *from = bytes.data();
     dcap::Quote::QeAuthData auth;
-    auth.insert(from, bytes.cend());
+    auth.insert(from, bytes.data() + bytes.size());
 
-    ASSERT_TRUE(from == bytes.cend());
+    ASSERT_TRUE(from == bytes.data() + bytes.size());
     EXPECT_EQ(5, auth.parsedDataSize);
     EXPECT_EQ(5, auth.data.size());
     EXPECT_EQ(testAuth.data, auth.data);
@@ -344,11 +344,11 @@ TEST(quoteParsingAndValidation, shouldParseQeAuthWithShorterDataButPointerShould
     dcap::test::QuoteGenerator::QeAuthData testAuth{5, {1,2,3,4}};
     const auto bytes = testAuth.bytes();
 
-    auto from = bytes.begin();
+    const uint8_t *from = bytes.data();
     dcap::Quote::QeAuthData auth;
-    auth.insert(from, bytes.cend());
+    auth.insert(from, bytes.data() + bytes.size());
 
-    ASSERT_TRUE(from == bytes.begin());
+    ASSERT_TRUE(from == bytes.data());
     EXPECT_EQ(5, auth.parsedDataSize);
     EXPECT_EQ(0, auth.data.size());
 }
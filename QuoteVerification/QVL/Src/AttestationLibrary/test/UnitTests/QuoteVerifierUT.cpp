@@ -182,7 +182,7 @@ struct QuoteVerifierUT: public testing::Test
 
 TEST_F(QuoteVerifierUT, shouldReturnStatusTcbInfoMismatchWhenFmspcDoesNotMatch)
 {
-    dcap::Quote quote;
+    dcap::QuoteView quote;
     std::vector<uint8_t> emptyVector{};
 
     EXPECT_CALL(tcbInfoJson, getFmspc()).WillRepeatedly(testing::ReturnRef(emptyVector));
@@ -192,7 +192,7 @@ TEST_F(QuoteVerifierUT, shouldReturnStatusTcbInfoMismatchWhenFmspcDoesNotMatch)
 
 TEST_F(QuoteVerifierUT, shouldReturnStatusTcbInfoMismatchWhenPceIdDoesNotMatch)
 {
-    dcap::Quote quote;
+    dcap::QuoteView quote;
     std::vector<uint8_t> emptyVector{};
 
     EXPECT_CALL(tcbInfoJson, getPceId()).WillRepeatedly(testing::ReturnRef(emptyVector));
@@ -203,67 +203,66 @@ TEST_F(QuoteVerifierUT, shouldReturnStatusTcbInfoMismatchWhenPceIdDoesNotMatch)
 TEST_F(QuoteVerifierUT, shouldReturnStatusInvalidPckCrlWhenPeriodAndIssuerIsInvalid)
 {
     const auto quoteBin = gen.buildSgxQuote();
-    dcap::Quote quote;
+    dcap::QuoteView quote;
 
     EXPECT_CALL(crl, getIssuer()).WillRepeatedly(testing::ReturnRef(dcap::constants::ROOT_CA_CRL_ISSUER));
 
 
-    ASSERT_TRUE(quote.parse(quoteBin));
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_INVALID_PCK_CRL, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
 TEST_F(QuoteVerifierUT, shouldReturnStatusInvalidPckCrlWhenCrlIssuerIsDifferentThanPck)
 {
     const auto quoteBin = gen.buildSgxQuote();
-    dcap::Quote quote;
+    dcap::QuoteView quote;
 
     EXPECT_CALL(crl, getIssuer()).WillRepeatedly(testing::ReturnRef(dcap::constants::PCK_PLATFORM_CRL_ISSUER));
     EXPECT_CALL(pck, getIssuer()).WillRepeatedly(testing::ReturnRef(dcap::constants::PROCESSOR_CA_SUBJECT));
 
-    ASSERT_TRUE(quote.parse(quoteBin));
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_INVALID_PCK_CRL, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
 TEST_F(QuoteVerifierUT, shouldReturnStatusPckRevoked)
 {
     const auto quoteBin = gen.buildSgxQuote();
-    dcap::Quote quote;
+    dcap::QuoteView quote;
 
     EXPECT_CALL(crl, isRevoked(testing::_)).WillOnce(testing::Return(true));
 
-    ASSERT_TRUE(quote.parse(quoteBin));
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_PCK_REVOKED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
 TEST_F(QuoteVerifierUT, shouldReturnStatusInvalidQeFormat)
 {
-    dcap::Quote quote;
+    dcap::QuoteView quote;
     gen.getQuoteAuthData().ecdsaAttestationKey.publicKey = std::array<uint8_t, 64>{};
     const auto quoteBin = gen.buildSgxQuote();
 
-    ASSERT_TRUE(quote.parse(quoteBin));
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_INVALID_QE_REPORT_DATA, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
 TEST_F(QuoteVerifierUT, shouldReturnUnsupportedQuoteFormatWhenParsedDatraSizeIsDifferentThanDataSize)
 {
-    class QuoteMock : public dcap::Quote
+    class QuoteMock : public dcap::QuoteView
     {
     public:
-        void setEcdsa256BitQuoteAuthData(dcap::Quote::Ecdsa256BitQuoteAuthData p_authData){
-            dcap::Quote::authData = std::move(p_authData);
+        void setQeCertData(uint16_t type, uint32_t parsedDataSize, const std::vector<uint8_t>& data){
+            dcap::QuoteView::qeCertDataType = type;
+            dcap::QuoteView::qeCertDataSize = parsedDataSize;
+            dcap::QuoteView::qeCertData = dcap::QuoteView::Span{data.data(), data.size()};
         }
     };
 
-    dcap::Quote::Ecdsa256BitQuoteAuthData authData;
-    authData.qeCertData.type = 1;
-    authData.qeCertData.parsedDataSize = 5;
-    authData.qeCertData.data = concat(ppid, concat(cpusvn, pcesvn));
+    const auto qeCertData = concat(ppid, concat(cpusvn, pcesvn));
     QuoteMock quote;
     const auto quoteBin = gen.buildSgxQuote();
 
-    ASSERT_TRUE(quote.parse(quoteBin));
-    quote.setEcdsa256BitQuoteAuthData(authData);
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
+    quote.setQeCertData(1, 5, qeCertData);
     EXPECT_EQ(STATUS_UNSUPPORTED_QUOTE_FORMAT, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -274,8 +273,8 @@ TEST_F(QuoteVerifierUT, shouldVerifySgxCorrectly)
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{cpusvn, toUint16(pcesvn[1], pcesvn[0]), "UpToDate"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_OK, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV2, enclaveReportVerifier));
 }
 
@@ -285,8 +284,8 @@ TEST_F(QuoteVerifierUT, shouldReturnInvalidPCKCert)
     ON_CALL(pck, getSubject()).WillByDefault(testing::ReturnRef(emptySubject));
     const auto quoteBin = gen.buildSgxQuote();
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_INVALID_PCK_CERT, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -309,8 +308,8 @@ TEST_P(QuoteVerifierUTPckTypesParametrized, shouldReturnStatusOkEvenWhenPpidIsNo
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{cpusvn, toUint16(pcesvn[1], pcesvn[0]), "UpToDate"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_OK, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -327,8 +326,8 @@ TEST_F(QuoteVerifierUT, shouldReturnQuoteInvalidSignature)
     gen.getQuoteAuthData().ecdsaSignature.signature[0] = (unsigned char) ~gen.getQuoteAuthData().ecdsaSignature.signature[0];
     const auto quoteBin = gen.buildSgxQuote();
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_INVALID_QUOTE_SIGNATURE, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -337,8 +336,8 @@ TEST_F(QuoteVerifierUT, shouldReturnInvalidQeReportSignature)
     gen.getQuoteAuthData().qeReportSignature.signature[0] = (unsigned char) ~gen.getQuoteAuthData().qeReportSignature.signature[0];
     const auto quoteBin = gen.buildSgxQuote();
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_INVALID_QE_REPORT_SIGNATURE, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -349,8 +348,8 @@ TEST_F(QuoteVerifierUT, shouldReturnTcbRevokedOnLatestRevokedEqualPckTCB)
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{cpusvn, toUint16(pcesvn[1], pcesvn[0]), "Revoked"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_REVOKED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -368,8 +367,8 @@ TEST_F(QuoteVerifierUT, shouldMatchToLowerTCBWhenBothSVNsAreLowerAndReturnConfig
     tcbs.insert(dcap::parser::json::TcbLevel{higherCpusvn, toUint16(higherPcesvn[1], higherPcesvn[0]), "Revoked"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_CONFIGURATION_NEEDED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -388,8 +387,8 @@ TEST_F(QuoteVerifierUT, shouldMatchToLowerTCBWhenBothSVNsAreLowerAndReturnConfig
     ON_CALL(tcbInfoJson, getVersion()).WillByDefault(testing::Return(2));
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_CONFIGURATION_NEEDED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -408,8 +407,8 @@ TEST_F(QuoteVerifierUT, shouldMatchToLowerTCBWhenBothSVNsAreLowerAndReturnOutOfD
     ON_CALL(tcbInfoJson, getVersion()).WillByDefault(testing::Return(2));
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -431,8 +430,8 @@ TEST_F(QuoteVerifierUT, shouldMatchToLowerTCBAndReturnConfigurationNeeded)
     }
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_CONFIGURATION_NEEDED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -456,8 +455,8 @@ TEST_F(QuoteVerifierUT, shouldMatchToLowerTCBAndReturnConfigurationAndSwHardenin
     }
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -470,8 +469,8 @@ TEST_F(QuoteVerifierUT, shouldReturnTcbNotSupportedWhenOnlyPceSvnIsHigher)
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{cpusvn, toUint16(higherPcesvn[1], higherPcesvn[0]), "Revoked"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_NOT_SUPPORTED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -485,8 +484,8 @@ TEST_F(QuoteVerifierUT, shouldReturnTcbRevokedWhenOnlyCpuSvnIsLower)
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{lowerCpusvn, toUint16(pcesvn[1], pcesvn[0]), "Revoked"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_REVOKED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -499,8 +498,8 @@ TEST_F(QuoteVerifierUT, shouldReturnTcbRevokedWhenOnlyPcesvnIsLower)
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{cpusvn, toUint16(lowerPcesvn[1], lowerPcesvn[0]), "Revoked"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_REVOKED, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -517,8 +516,8 @@ TEST_F(QuoteVerifierUT, shouldNOTReturnTcbRevokedWhenRevokedPcesvnAndCpusvnAreLo
     tcbs.insert(dcap::parser::json::TcbLevel{lowerCpusvn, toUint16(lowerPcesvn[1], lowerPcesvn[0]), "Revoked"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_OK, dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -534,8 +533,8 @@ TEST_F(QuoteVerifierUT, shouldReturnSwHardeningNeeded)
     tcbs.insert(dcap::parser::json::TcbLevel{cpusvn, toUint16(pcesvn[1], pcesvn[0]), "SWHardeningNeeded"});
     EXPECT_CALL(tcbInfoJson, getTcbLevels()).WillOnce(testing::ReturnRef(tcbs));
 
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     EXPECT_EQ(STATUS_TCB_SW_HARDENING_NEEDED , dcap::QuoteVerifier{}.verify(quote, pck, crl, tcbInfoJson, &enclaveIdentityV1, enclaveReportVerifier));
 }
 
@@ -552,8 +551,8 @@ TEST_P(QuoteVerifierUTQeIdentityStatusParametrized, testAllStatuses)
 {
     auto params = GetParam();
     const auto quoteBin = gen.buildSgxQuote();
-    dcap::Quote quote;
-    ASSERT_TRUE(quote.parse(quoteBin));
+    dcap::QuoteView quote;
+    ASSERT_TRUE(quote.parse(quoteBin.data(), quoteBin.size()));
     tcbs.insert(tcbs.begin(), dcap::parser::json::TcbLevel{cpusvn, toUint16(pcesvn[1], pcesvn[0]), "UpToDate"});
     if (params.enclaveVerifierStatus == STATUS_OK)
     {
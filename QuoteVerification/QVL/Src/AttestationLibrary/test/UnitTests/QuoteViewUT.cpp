@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "QuoteGenerator.h"
+#include <QuoteVerification/Quote.h>
+#include <QuoteVerification/QuoteView.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock-matchers.h>
+
+using namespace intel::sgx;
+using namespace ::testing;
+
+namespace {
+
+std::vector<uint8_t> toVector(const dcap::QuoteView::Span& span)
+{
+    return std::vector<uint8_t>(span.begin(), span.end());
+}
+
+} // anonymous namespace
+
+struct QuoteViewUT : public Test
+{
+    dcap::test::QuoteGenerator gen;
+};
+
+TEST_F(QuoteViewUT, shouldExposeSameDataAsOwningQuote)
+{
+    // GIVEN
+    gen.withQeAuthData(dcap::test::QuoteGenerator::QeAuthData{5, {1, 2, 3, 4, 5}});
+    gen.withQeCertData(dcap::constants::PCK_ID_PCK_CERT_CHAIN, {0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x42, 0x45});
+    gen.getAuthSize() += 5 + 7;
+    const auto quoteBin = gen.buildSgxQuote();
+    dcap::Quote quote;
+    ASSERT_TRUE(quote.parse(quoteBin));
+
+    // WHEN
+    dcap::QuoteView view;
+    ASSERT_TRUE(view.parse(quoteBin.data(), quoteBin.size()));
+
+    // THEN
+    const auto& authData = quote.getQuoteAuthData();
+    EXPECT_EQ(quote.getHeader().version, view.getHeader().version);
+    EXPECT_EQ(quote.getHeader().qeVendorId, view.getHeader().qeVendorId);
+    EXPECT_EQ(quote.getEnclaveReport().rawBlob(), view.getEnclaveReport().rawBlob());
+    EXPECT_EQ(quote.getAuthDataSize(), view.getAuthDataSize());
+    EXPECT_EQ(authData.ecdsa256BitSignature.signature, view.getQuoteSignature().signature);
+    EXPECT_EQ(authData.ecdsaAttestationKey.pubKey, view.getAttestationKey().pubKey);
+    EXPECT_EQ(authData.qeReport.rawBlob(), view.getQeReport().rawBlob());
+    EXPECT_THAT(toVector(view.getQeReportBlob()), ElementsAreArray(authData.qeReport.rawBlob()));
+    EXPECT_EQ(authData.qeReportSignature.signature, view.getQeReportSignature().signature);
+    EXPECT_EQ(authData.qeAuthData.data, toVector(view.getQeAuthData()));
+    EXPECT_EQ(authData.qeCertData.type, view.getQeCertDataType());
+    EXPECT_EQ(authData.qeCertData.parsedDataSize, view.getQeCertDataSize());
+    EXPECT_EQ(authData.qeCertData.data, toVector(view.getQeCertData()));
+    EXPECT_EQ(quote.getSignedData(), toVector(view.getSignedData()));
+}
+
+TEST_F(QuoteViewUT, shouldReferToCallerBufferWithoutCopying)
+{
+    // GIVEN
+    gen.withQeCertData(dcap::constants::PCK_ID_PCK_CERT_CHAIN, {1, 2, 3, 4});
+    gen.getAuthSize() += 4;
+    const auto quoteBin = gen.buildSgxQuote();
+
+    // WHEN
+    dcap::QuoteView view;
+    ASSERT_TRUE(view.parse(quoteBin.data(), quoteBin.size()));
+
+    // THEN
+    const auto quoteEnd = quoteBin.data() + quoteBin.size();
+    EXPECT_EQ(quoteBin.data(), view.getSignedData().data);
+    EXPECT_EQ(dcap::test::QUOTE_HEADER_SIZE + dcap::test::ENCLAVE_REPORT_SIZE, view.getSignedData().size);
+    EXPECT_EQ(quoteEnd, view.getQeCertData().end());
+    EXPECT_EQ(4, view.getQeCertData().size);
+    EXPECT_TRUE(view.getQeReportBlob().begin() > quoteBin.data() && view.getQeReportBlob().end() < quoteEnd);
+}
+
+TEST_F(QuoteViewUT, shouldValidateParsedHeader)
+{
+    // GIVEN
+    const auto validQuote = gen.buildSgxQuote();
+    gen.getHeader().attestationKeyType = 3; // Not supported value
+    const auto invalidQuote = gen.buildSgxQuote();
+
+    // WHEN
+    dcap::QuoteView validView;
+    dcap::QuoteView invalidView;
+    ASSERT_TRUE(validView.parse(validQuote.data(), validQuote.size()));
+    ASSERT_TRUE(invalidView.parse(invalidQuote.data(), invalidQuote.size()));
+
+    // THEN
+    EXPECT_TRUE(validView.validate());
+    EXPECT_FALSE(invalidView.validate());
+}
+
+TEST_F(QuoteViewUT, shouldNotParseTooShortQuote)
+{
+    const auto quoteBin = gen.buildSgxQuote();
+
+    dcap::QuoteView view;
+    EXPECT_FALSE(view.parse(quoteBin.data(), quoteBin.size() - 1));
+    EXPECT_FALSE(view.parse(quoteBin.data(), dcap::test::QUOTE_MINIMAL_SIZE - 1));
+    EXPECT_FALSE(view.parse(nullptr, quoteBin.size()));
+}
+
+TEST_F(QuoteViewUT, shouldNotParseQuoteWithTrailingBytes)
+{
+    auto quoteBin = gen.buildSgxQuote();
+    quoteBin.push_back(0x00);
+
+    dcap::QuoteView view;
+    EXPECT_FALSE(view.parse(quoteBin.data(), quoteBin.size()));
+}
+
+TEST_F(QuoteViewUT, shouldNotParseWhenQeCertDataSizeExceedsQuote)
+{
+    gen.withQeCertData(dcap::constants::PCK_ID_PCK_CERT_CHAIN, {1, 2, 3, 4});
+    gen.getAuthSize() += 4;
+    gen.getQuoteAuthData().qeCertData.size = 5;
+    const auto quoteBin = gen.buildSgxQuote();
+
+    dcap::QuoteView view;
+    EXPECT_FALSE(view.parse(quoteBin.data(), quoteBin.size()));
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2011-2021 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Verifiers/TcbLevelMatcher.h>
+#include <Utils/RuntimeException.h>
+
+#include "Mocks/CertCrlStoresMocks.h"
+#include "Mocks/TcbInfoMock.h"
+
+#include <set>
+#include <vector>
+
+using namespace testing;
+using namespace intel::sgx;
+
+struct TcbLevelMatcherUT: public testing::Test
+{
+    std::vector<uint8_t> certCpuSvn = std::vector<uint8_t>(16, 0x40);
+    std::set<dcap::parser::json::TcbLevel, std::greater<dcap::parser::json::TcbLevel>> tcbs{};
+
+    NiceMock<test::TcbMock> tcbMock;
+    NiceMock<dcap::test::PckCertificateMock> pck;
+    NiceMock<dcap::test::TcbInfoMock> tcbInfo;
+
+    void SetUp() override
+    {
+        ON_CALL(tcbMock, getPceSvn()).WillByDefault(Return(10));
+        ON_CALL(tcbMock, getSgxTcbComponentSvn(_)).WillByDefault(Invoke([this](unsigned int index) {
+            return static_cast<unsigned int>(certCpuSvn.at(index));
+        }));
+        ON_CALL(pck, getTcb()).WillByDefault(ReturnRef(tcbMock));
+
+        ON_CALL(tcbInfo, getVersion()).WillByDefault(Return(2));
+        ON_CALL(tcbInfo, getTcbLevels()).WillByDefault(ReturnRef(tcbs));
+    }
+
+    Status matchStatus() const
+    {
+        try
+        {
+            return dcap::TcbLevelMatcher(tcbInfo).match(pck);
+        }
+        catch (const dcap::RuntimeException &ex)
+        {
+            return ex.getStatus();
+        }
+    }
+};
+
+TEST_F(TcbLevelMatcherUT, shouldMatchHighestLevelLowerOrEqualToCert)
+{
+    tcbs.emplace(std::vector<uint8_t>(16, 0x41), 10, "UpToDate");
+    tcbs.emplace(std::vector<uint8_t>(16, 0x40), 10, "SWHardeningNeeded");
+    tcbs.emplace(std::vector<uint8_t>(16, 0x30), 10, "OutOfDate");
+
+    EXPECT_EQ(STATUS_TCB_SW_HARDENING_NEEDED, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldSkipLevelWhenAnyCpuSvnComponentIsHigher)
+{
+    for (size_t index = 0; index < certCpuSvn.size(); ++index)
+    {
+        tcbs.clear();
+        auto higherComponent = std::vector<uint8_t>(16, 0x00);
+        higherComponent[index] = 0x41;
+        tcbs.emplace(higherComponent, 10, "UpToDate");
+        tcbs.emplace(std::vector<uint8_t>(16, 0x00), 10, "OutOfDate");
+
+        EXPECT_EQ(STATUS_TCB_OUT_OF_DATE, matchStatus()) << "component " << index;
+    }
+}
+
+TEST_F(TcbLevelMatcherUT, shouldCompareCpuSvnComponentsAsUnsigned)
+{
+    certCpuSvn = std::vector<uint8_t>(16, 0x80);
+    tcbs.emplace(std::vector<uint8_t>(16, 0xFF), 10, "UpToDate");
+    tcbs.emplace(std::vector<uint8_t>(16, 0x7F), 10, "ConfigurationNeeded");
+
+    EXPECT_EQ(STATUS_TCB_CONFIGURATION_NEEDED, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldSkipLevelWhenPceSvnIsHigher)
+{
+    tcbs.emplace(std::vector<uint8_t>(16, 0x40), 11, "UpToDate");
+    tcbs.emplace(std::vector<uint8_t>(16, 0x40), 10, "Revoked");
+
+    EXPECT_EQ(STATUS_TCB_REVOKED, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldMatchAmongManyLevels)
+{
+    // odd number of levels, so that both paired and single comparisons are exercised
+    for (uint8_t svn = 0x61; svn > 0x10; --svn)
+    {
+        tcbs.emplace(std::vector<uint8_t>(16, svn), 10, svn == 0x40 ? "ConfigurationAndSWHardeningNeeded" : "OutOfDate");
+    }
+    ASSERT_EQ(1u, tcbs.size() % 2);
+
+    EXPECT_EQ(STATUS_TCB_CONFIGURATION_AND_SW_HARDENING_NEEDED, matchStatus());
+
+    certCpuSvn = std::vector<uint8_t>(16, 0x11);
+    EXPECT_EQ(STATUS_TCB_OUT_OF_DATE, matchStatus());
+
+    certCpuSvn = std::vector<uint8_t>(16, 0x10);
+    EXPECT_EQ(STATUS_TCB_NOT_SUPPORTED, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldReturnTcbNotSupportedWhenNoLevelMatches)
+{
+    tcbs.emplace(std::vector<uint8_t>(16, 0x41), 10, "UpToDate");
+
+    EXPECT_EQ(STATUS_TCB_NOT_SUPPORTED, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldReturnTcbNotSupportedWhenThereAreNoLevels)
+{
+    EXPECT_EQ(0u, dcap::TcbLevelMatcher(tcbInfo).size());
+    EXPECT_EQ(STATUS_TCB_NOT_SUPPORTED, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldReturnUnrecognizedStatusOnlyWhenSuchLevelMatches)
+{
+    tcbs.emplace(std::vector<uint8_t>(16, 0x41), 10, "Unknown");
+    tcbs.emplace(std::vector<uint8_t>(16, 0x40), 10, "UpToDate");
+    EXPECT_EQ(STATUS_OK, matchStatus());
+
+    certCpuSvn = std::vector<uint8_t>(16, 0x41);
+    EXPECT_EQ(STATUS_TCB_UNRECOGNIZED_STATUS, matchStatus());
+}
+
+TEST_F(TcbLevelMatcherUT, shouldRecognizeOutOfDateConfigurationNeededFromVersion2)
+{
+    tcbs.emplace(std::vector<uint8_t>(16, 0x40), 10, "OutOfDateConfigurationNeeded");
+    EXPECT_EQ(STATUS_TCB_OUT_OF_DATE_CONFIGURATION_NEEDED, matchStatus());
+
+    ON_CALL(tcbInfo, getVersion()).WillByDefault(Return(1));
+    EXPECT_EQ(STATUS_TCB_UNRECOGNIZED_STATUS, matchStatus());
+}
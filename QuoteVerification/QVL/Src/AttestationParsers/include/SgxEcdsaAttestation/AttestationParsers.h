@@ -472,7 +472,7 @@ namespace intel { namespace sgx { namespace dcap { namespace parser
 
             /**
              * Get value
-             * @return vector of bytes representing extension's value
+             * @return vector of bytes representing extension's raw (DER encoded) value
              */
             virtual const std::vector<uint8_t>& getValue() const;
 
@@ -632,6 +632,15 @@ namespace intel { namespace sgx { namespace dcap { namespace parser
              */
             static Certificate parse(const std::string& pem);
 
+            /**
+             * Parse DER encoded X.509 certificate
+             * @param der DER encoded X.509 certificate
+             * @return Certificate instance
+             *
+             * @throws intel::sgx::dcap::parser::FormatException in case of parsing error
+             */
+            static Certificate parseDer(const std::vector<uint8_t>& der);
+
         protected:
             unsigned int _version;
             DistinguishedName _subject;
@@ -645,8 +654,11 @@ namespace intel { namespace sgx { namespace dcap { namespace parser
             std::string _pem;
 
             explicit Certificate(const std::string& pem);
+            explicit Certificate(const std::vector<uint8_t>& der);
 
         private:
+            void parseX509(X509* x509);
+            void setPem(X509* x509);
             void setInfo(X509* x509);
             void setVersion(const X509* x509);
             void setSerialNumber(const X509* x509);
@@ -802,6 +814,14 @@ namespace intel { namespace sgx { namespace dcap { namespace parser
              */
             explicit PckCertificate(const Certificate& certificate);
 
+            /**
+             * Upcast Certificate to PCK certificate taking over its already parsed members
+             * @param certificate
+             *
+             * @throws intel::sgx::dcap::parser::FormatException in case of upcasting error
+             */
+            explicit PckCertificate(Certificate&& certificate);
+
             PckCertificate& operator=(const PckCertificate &) = delete;
             PckCertificate& operator=(PckCertificate &&) = default;
 
@@ -33,7 +33,9 @@
 
 #include "OpensslHelpers/Bytes.h"
 #include "Utils/TimeUtils.h"
+#include "Utils/JsonFieldSpanRecorder.h"
 
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 
 #include <tuple>
@@ -47,8 +49,17 @@ bool JsonParser::parse(const std::string& json)
     {
         return false;
     }
-    jsonDocument.Parse(json.c_str());
-    return !jsonDocument.HasParseError() && jsonDocument.IsObject();
+    fieldSpans.clear();
+    bool parsed = false;
+    auto generator = [&](rapidjson::Document& document) {
+        rapidjson::StringStream stream(json.c_str());
+        JsonFieldSpanRecorder recorder(document, stream, fieldSpans);
+        rapidjson::Reader reader;
+        parsed = !reader.Parse(stream, recorder).IsError();
+        return parsed;
+    };
+    jsonDocument.Populate(generator);
+    return parsed && jsonDocument.IsObject();
 }
 
 const rapidjson::Value* JsonParser::getField(const std::string& fieldName) const
@@ -60,6 +71,20 @@ const rapidjson::Value* JsonParser::getField(const std::string& fieldName) const
     return &jsonDocument[fieldName.c_str()];
 }
 
+std::pair<size_t, size_t> JsonParser::getFieldSpan(const std::string& fieldName) const
+{
+    // Member lookup returns the first of duplicated fields, so does this
+    const auto span = std::find_if(fieldSpans.cbegin(), fieldSpans.cend(),
+                                   [&fieldName](const std::pair<std::string, std::pair<size_t, size_t>>& fieldSpan) {
+                                       return fieldSpan.first == fieldName;
+                                   });
+    if(span == fieldSpans.cend())
+    {
+        return std::make_pair(0, 0);
+    }
+    return span->second;
+}
+
 std::pair<std::string, JsonParser::ParseStatus> JsonParser::getStringFieldOf(const ::rapidjson::Value &parent, const std::string &fieldName) const
 {
     if(!parent.HasMember(fieldName.c_str()))
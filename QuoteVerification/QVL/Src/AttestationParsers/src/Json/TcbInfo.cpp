@@ -35,9 +35,6 @@
 #include "X509Constants.h"
 #include "JsonParser.h"
 
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
-
 #include <tuple>
 
 namespace intel { namespace sgx { namespace dcap { namespace parser { namespace json {
@@ -238,13 +235,10 @@ TcbInfo::TcbInfo(const std::string& jsonString)
         throw InvalidExtensionException("Number of parsed [tcbLevels] should not be 0");
     }
 
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    writer.SetMaxDecimalPlaces(25);
-    tcbInfo->Accept(writer);
-
-    _infoBody = std::vector<uint8_t>{ buffer.GetString(),
-                                      &buffer.GetString()[buffer.GetSize()] };
+    // Signature covers the body exactly as it was issued
+    const auto infoBodySpan = jsonParser.getFieldSpan("tcbInfo");
+    _infoBody = std::vector<uint8_t>{ jsonString.cbegin() + static_cast<std::ptrdiff_t>(infoBodySpan.first),
+                                      jsonString.cbegin() + static_cast<std::ptrdiff_t>(infoBodySpan.first + infoBodySpan.second) };
 }
 
 void TcbInfo::parsePartV2(const ::rapidjson::Value &tcbInfo, JsonParser &jsonParser)
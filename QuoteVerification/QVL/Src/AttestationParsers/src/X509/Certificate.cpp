@@ -120,40 +120,84 @@ Certificate Certificate::parse(const std::string& pem)
     return Certificate(pem);
 }
 
+Certificate Certificate::parseDer(const std::vector<uint8_t>& der)
+{
+    return Certificate(der);
+}
+
 // Protected
 
 Certificate::Certificate(const std::string &pem)
 {
     _pem = pem;
-    crypto::BIO_uptr bio(BIO_new(BIO_s_mem()), ::BIO_free_all);
-    BIO_puts(bio.get(), pem.c_str());
+    // read-only BIO over the PEM string, no intermediate copy of the input is made
+    auto bio = crypto::make_unique(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())));
 
     auto x509 = crypto::make_unique(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
     if (!x509) {
         throw FormatException("PEM_read_bio_X509 failed " + getLastError());
     }
 
-    setPublicKey(x509.get());
-    setInfo(x509.get());
-    setSignature(x509.get());
-    setVersion(x509.get());
-    setSerialNumber(x509.get());
-    setSubject(x509.get());
-    setIssuer(x509.get());
-    setValidity(x509.get());
-    setExtensions(x509.get());
+    parseX509(x509.get());
+}
+
+Certificate::Certificate(const std::vector<uint8_t> &der)
+{
+    // WARNING! Using this temporary pointer is mandatory!
+    const auto *derPtr = der.data();
+    auto x509 = crypto::make_unique(d2i_X509(nullptr, &derPtr, static_cast<long>(der.size())));
+    if (!x509 || derPtr != der.data() + der.size()) {
+        throw FormatException("d2i_X509 failed " + getLastError());
+    }
+
+    setPem(x509.get());
+    parseX509(x509.get());
 }
 
 // Private
 
+void Certificate::parseX509(X509 *x509)
+{
+    // every member is decoded in this single pass over already parsed X509 structure,
+    // extension values are kept as DER and decoded only by code that needs them
+    setPublicKey(x509);
+    setInfo(x509);
+    setSignature(x509);
+    setVersion(x509);
+    setSerialNumber(x509);
+    setSubject(x509);
+    setIssuer(x509);
+    setValidity(x509);
+    setExtensions(x509);
+}
+
+void Certificate::setPem(X509 *x509)
+{
+    auto bio = crypto::make_unique(BIO_new(BIO_s_mem()));
+    if (!bio || !PEM_write_bio_X509(bio.get(), x509))
+    {
+        throw FormatException("PEM_write_bio_X509 failed " + getLastError());
+    }
+
+    BUF_MEM *bptr; // this will be freed when bio will be closed
+    BIO_get_mem_ptr(bio.get(), &bptr);
+
+    _pem = std::string(bptr->data, bptr->length);
+}
+
 void Certificate::setInfo(X509 *x509)
 {
-    size_t len = static_cast<size_t>(i2d_re_X509_tbs(x509, NULL));
+    // single encoding pass, OpenSSL allocates the output buffer
+    unsigned char *info = nullptr;
+    const int len = i2d_re_X509_tbs(x509, &info);
 
-    _info = std::vector<uint8_t>(len);
-    auto info = _info.data();
+    if (len <= 0 || !info)
+    {
+        throw FormatException("i2d_re_X509_tbs failed " + getLastError());
+    }
 
-    i2d_re_X509_tbs(x509, &info);
+    _info = std::vector<uint8_t>(info, info + len);
+    OPENSSL_free(info);
 }
 
 void Certificate::setVersion(const X509 *x509)
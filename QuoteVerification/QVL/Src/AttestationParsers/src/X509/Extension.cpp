@@ -32,9 +32,6 @@
 #include "SgxEcdsaAttestation/AttestationParsers.h"
 
 #include "ParserUtils.h" // obj2Str
-#include "OpensslHelpers/OpensslTypes.h"
-
-#include <algorithm>
 
 namespace intel { namespace sgx { namespace dcap { namespace parser { namespace x509 {
 
@@ -89,51 +86,19 @@ Extension::Extension(X509_EXTENSION *ext)
 
     _nid = OBJ_obj2nid(asn1Obj);
 
-    if(_nid == NID_undef)
-    {   // we encountered our custom entry
-        // name handling is different and its value is
-        // equal to one of our custom OID
-
-        _name = obj2Str(asn1Obj);
-
-        const auto val = X509_EXTENSION_get_data(ext);
-
-        if(!val)
-        {
-            throw FormatException("Invalid Extension");
-        }
-
-        _value = std::vector<uint8_t>(static_cast<size_t>(val->length));
-        std::copy_n(val->data, val->length, _value.begin());
-
-        return;
-    }
-
-    auto bio = crypto::make_unique(BIO_new(BIO_s_mem()));
-    if(!X509V3_EXT_print(bio.get(), ext, 0, 0))
-    {   // revocation extensions may not be printable,
-        // at the time of writing this code, there was no revocation
-        // extensions planned so this 'if' statement probably won't be
-        // hit at all
-        const auto val = X509_EXTENSION_get_data(ext);
-
-        _value = std::vector<uint8_t>(static_cast<size_t>(val->length));
-        std::copy_n(val->data, val->length, _value.begin());
+    // Custom entries (SGX) have no NID, so their name is the OID itself
+    _name = _nid == NID_undef ? obj2Str(asn1Obj) : std::string(OBJ_nid2ln(_nid));
 
-        _name = std::string(OBJ_nid2ln(_nid));
+    // Value is kept as raw DER octets, decoding is left to the code that needs it
+    // (e.g. SGX extensions in PckCertificate) instead of rendering every value to text
+    const auto val = X509_EXTENSION_get_data(ext);
 
-        return;
+    if(!val)
+    {
+        throw FormatException("Invalid Extension");
     }
 
-    BUF_MEM *bptr; // this will be freed when bio will be closed
-    BIO_get_mem_ptr(bio.get(), &bptr);
-
-    _value = std::vector<uint8_t>(static_cast<size_t>(bptr->length));
-
-    const auto noNewLineChar = [](uint8_t chr){ return chr != '\r' && chr != '\n'; };
-    std::copy_if(bptr->data, bptr->data + bptr->length, _value.begin(), noNewLineChar);
-
-    _name = std::string(OBJ_nid2ln(_nid));
+    _value = std::vector<uint8_t>(val->data, val->data + val->length);
 }
 
 }}}}} // namespace intel { namespace sgx { namespace dcap { namespace parser { namespace x509 {
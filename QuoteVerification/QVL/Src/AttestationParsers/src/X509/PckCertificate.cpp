@@ -36,6 +36,7 @@
 #include "OpensslHelpers/OidUtils.h"
 
 #include <algorithm> // find_if
+#include <utility> // move
 
 #include <openssl/asn1.h>
 
@@ -47,6 +48,12 @@ PckCertificate::PckCertificate(const Certificate& certificate): Certificate(cert
     setMembers(sgxExtensions.get());
 }
 
+PckCertificate::PckCertificate(Certificate&& certificate): Certificate(std::move(certificate))
+{
+    auto sgxExtensions = crypto::make_unique(getSgxExtensions());
+    setMembers(sgxExtensions.get());
+}
+
 const std::vector<uint8_t>& PckCertificate::getPpid() const
 {
     return _ppid;
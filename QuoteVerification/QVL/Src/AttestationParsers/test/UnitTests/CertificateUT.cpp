@@ -92,6 +92,36 @@ TEST_F(CertificateUT, certificateParse)
     ASSERT_NO_THROW(x509::Certificate::parse(pemRootCert));
 }
 
+TEST_F(CertificateUT, certificateParseDer)
+{
+    uint8_t *der = nullptr;
+    const auto derLen = i2d_X509(cert.get(), &der);
+    ASSERT_GT(derLen, 0);
+    const std::vector<uint8_t> derPckCert { der, der + derLen };
+    OPENSSL_free(der);
+
+    const auto& fromDer = x509::Certificate::parseDer(derPckCert);
+    const auto& fromPem = x509::Certificate::parse(pemPckCert);
+
+    ASSERT_EQ(fromDer, fromPem);
+    ASSERT_EQ(fromDer.getPem(), pemPckCert);
+}
+
+TEST_F(CertificateUT, certificateParseDerShouldThrowWhenDataIsInvalid)
+{
+    uint8_t *der = nullptr;
+    const auto derLen = i2d_X509(cert.get(), &der);
+    ASSERT_GT(derLen, 0);
+    const std::vector<uint8_t> truncated { der, der + derLen - 1 };
+    std::vector<uint8_t> trailing { der, der + derLen };
+    trailing.push_back(0x00);
+    OPENSSL_free(der);
+
+    ASSERT_THROW(x509::Certificate::parseDer({}), FormatException);
+    ASSERT_THROW(x509::Certificate::parseDer(truncated), FormatException);
+    ASSERT_THROW(x509::Certificate::parseDer(trailing), FormatException);
+}
+
 TEST_F(CertificateUT, certificateConstructors)
 {
     const auto& certificate = x509::Certificate::parse(pemPckCert);
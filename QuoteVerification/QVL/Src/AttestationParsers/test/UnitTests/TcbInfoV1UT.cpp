@@ -46,7 +46,8 @@ struct TcbInfoV1UT : public Test
 
 TEST_F(TcbInfoV1UT, shouldSuccessfullyParseTcbWhenAllRequiredDataProvided)
 {
-    auto tcbInfoJson = TcbInfoGenerator::generateTcbInfo();
+    const auto tcbInfoJson = R"json({"tcbInfo":)json" + std::string(DEFAULT_INFO_BODY.cbegin(), DEFAULT_INFO_BODY.cend())
+                             + "," + validSignatureTemplate + "}";
 
     const auto tcbInfo = parser::json::TcbInfo::parse(tcbInfoJson);
 
@@ -56,13 +56,24 @@
 #include <cstring>
 #include <array>
 #include <algorithm>
+#include <memory>
+#include <vector>
 #include "Verifiers/EnclaveIdentityParser.h"
 #include "Verifiers/EnclaveIdentity.h"
 #include "Verifiers/EnclaveIdentityV2.h"
-#include "QuoteVerification/Quote.h"
+#include "Verifiers/PckCertVerifier.h"
+#include "Verifiers/TCBInfoVerifier.h"
+#include "Verifiers/EnclaveIdentityVerifier.h"
+#include "Verifiers/EnclaveReportVerifier.h"
+#include "Verifiers/QuoteVerifier.h"
+#include "QuoteVerification/QuoteView.h"
 #include "PckParser/CrlStore.h"
 #include "CertVerification/CertificateChain.h"
 #include "Utils/TimeUtils.h"
+#include "Utils/CollateralCache.h"
+#include "Utils/PreparedCollateral.h"
+#include "Utils/PackedCollateral.h"
+#include "Utils/RuntimeException.h"
 #include "SgxEcdsaAttestation/AttestationParsers.h"
 #include "sgx_qve_header.h"
 #include "sgx_qve_def.h"
@@ -552,10 +563,356 @@ static time_t getLatestExpirationDate(const CertificateChain* chain) {
 
 
 /**
- * Helper function to return earliest & latest issue date and expiration date comparing all collaterals.
- * @param p_cert_chain_obj[IN] - Pointer to CertificateChain object containing PCK Cert chain (for quote with cert type 5, this should be extracted from the quote).
- * @param p_tcb_info_obj[IN] - Pointer to TcbInfo object.
+ * Quote and verification collateral, each parsed once and shared by the collateral dates, the verifiers
+ * and the supplemental data. Collateral comes from the collateral cache, so it is only parsed again
+ * when it changes. Prepared collateral is loaded as a whole, it's set before the context is parsed.
+ **/
+struct qve_verification_context_t {
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral;
+    const char *trusted_root_ca_cert;
+    std::shared_ptr<const PreparedCollateral> prepared_collateral;
+    QuoteView quote;
+    CertificateChain pck_cert_chain;
+    std::shared_ptr<const json::TcbInfo> tcb_info;
+    std::shared_ptr<const TcbLevelMatcher> tcb_level_matcher;
+    std::shared_ptr<const EnclaveIdentity> qe_identity;
+    std::shared_ptr<const CertificateChain> tcb_info_issuer_chain;
+    std::shared_ptr<const CertificateChain> qe_identity_issuer_chain;
+    std::shared_ptr<const CertificateChain> pck_crl_issuer_chain;
+    std::shared_ptr<const pckparser::CrlStore> root_ca_crl;
+    std::shared_ptr<const pckparser::CrlStore> pck_crl;
+    std::shared_ptr<const x509::Certificate> trusted_root_ca;
+};
+
+/**
+ * Parse the verification collateral of the PCS format into a verification context.
+ * @param p_quote_collateral[IN] - Pointer to _sgx_ql_qve_collateral_t struct.
+ * @param p_context[OUT] - Pointer to the verification context to fill.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_TCBINFO_UNSUPPORTED_FORMAT
+ *      - SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT
+ *      - SGX_QL_PCK_CERT_CHAIN_ERROR
+ *      - SGX_QL_CRL_UNSUPPORTED_FORMAT
+ **/
+static quote3_error_t qve_parse_collateral(const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    qve_verification_context_t *p_context) {
+
+    CollateralCache& cache = CollateralCache::instance();
+
+    //parse tcbInfo JSON string into TcbInfo object
+    //
+    try
+    {
+        p_context->tcb_info = cache.getTcbInfo(p_quote_collateral->tcb_info, p_context->tcb_level_matcher);
+    }
+    catch (...)
+    {
+        return status_error_to_quote3_error(STATUS_SGX_TCB_INFO_INVALID);
+    }
+
+    if (cache.getCertificateChain(p_quote_collateral->qe_identity_issuer_chain, p_context->qe_identity_issuer_chain) != STATUS_OK) {
+        return SGX_QL_PCK_CERT_CHAIN_ERROR;
+    }
+    if (cache.getCertificateChain(p_quote_collateral->tcb_info_issuer_chain, p_context->tcb_info_issuer_chain) != STATUS_OK) {
+        return SGX_QL_PCK_CERT_CHAIN_ERROR;
+    }
+
+    try
+    {
+        p_context->qe_identity = cache.getEnclaveIdentity(p_quote_collateral->qe_identity);
+    }
+    catch (...)
+    {
+        return SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
+    }
+    if (p_context->qe_identity == nullptr) {
+        return SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
+    }
+
+    p_context->root_ca_crl = cache.getCrl(p_quote_collateral->root_ca_crl);
+    if (p_context->root_ca_crl == nullptr) {
+        return SGX_QL_CRL_UNSUPPORTED_FORMAT;
+    }
+    p_context->pck_crl = cache.getCrl(p_quote_collateral->pck_crl);
+    if (p_context->pck_crl == nullptr) {
+        return SGX_QL_CRL_UNSUPPORTED_FORMAT;
+    }
+
+    if (cache.getCertificateChain(p_quote_collateral->pck_crl_issuer_chain, p_context->pck_crl_issuer_chain) != STATUS_OK) {
+        return SGX_QL_PCK_CERT_CHAIN_ERROR;
+    }
+
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Load prepared collateral into a verification context, before the context is parsed. Loading checks the layout
+ * and that the header matches the signed content, signatures are verified as for any other collateral.
+ * @param p_quote_collateral[IN] - Pointer to _sgx_ql_qve_collateral_t struct of QVE_COLLATERAL_VERSION_PREPARED.
+ * @param p_context[OUT] - Pointer to the verification context to fill.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_TCBINFO_UNSUPPORTED_FORMAT
+ *      - SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT
+ *      - SGX_QL_PCK_CERT_CHAIN_ERROR
+ *      - SGX_QL_CRL_UNSUPPORTED_FORMAT
+ *      - SGX_QL_ERROR_UNEXPECTED
+ **/
+static quote3_error_t qve_load_prepared_collateral(const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    qve_verification_context_t *p_context) {
+
+    try
+    {
+        p_context->prepared_collateral = CollateralCache::instance().getPreparedCollateral(
+            reinterpret_cast<const uint8_t*>(p_quote_collateral->tcb_info), p_quote_collateral->tcb_info_size);
+    }
+    catch (const RuntimeException &e)
+    {
+        switch (e.getStatus()) {
+        case STATUS_INVALID_PARAMETER:
+            return SGX_QL_ERROR_INVALID_PARAMETER;
+        case STATUS_UNSUPPORTED_CERT_FORMAT:
+        case STATUS_SGX_ROOT_CA_INVALID_EXTENSIONS:
+        case STATUS_SGX_INTERMEDIATE_CA_INVALID_EXTENSIONS:
+        case STATUS_SGX_TCB_SIGNING_CERT_INVALID_EXTENSIONS:
+        case STATUS_SGX_PCK_INVALID_EXTENSIONS:
+            return SGX_QL_PCK_CERT_CHAIN_ERROR;
+        case STATUS_SGX_CRL_UNSUPPORTED_FORMAT:
+            return SGX_QL_CRL_UNSUPPORTED_FORMAT;
+        case STATUS_SGX_TCB_INFO_UNSUPPORTED_FORMAT:
+        case STATUS_SGX_TCB_INFO_INVALID:
+            return SGX_QL_TCBINFO_UNSUPPORTED_FORMAT;
+        default:
+            return SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
+        }
+    }
+    catch (...)
+    {
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Parse the quote and the verification collateral into a verification context.
+ * @param p_quote[IN] - Pointer to an SGX Quote.
+ * @param quote_size[IN] - Size of the buffer pointed to by p_quote (in bytes).
  * @param p_quote_collateral[IN] - Pointer to _sgx_ql_qve_collateral_t struct.
+ * @param trusted_root_ca_cert[IN] - PEM of the trusted root CA certificate matching the collateral version.
+ * @param p_context[OUT] - Pointer to the verification context to fill.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_QUOTE_FORMAT_UNSUPPORTED
+ *      - SGX_QL_QUOTE_CERTIFICATION_DATA_UNSUPPORTED
+ *      - SGX_QL_TCBINFO_UNSUPPORTED_FORMAT
+ *      - SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT
+ *      - SGX_QL_PCK_CERT_CHAIN_ERROR
+ *      - SGX_QL_CRL_UNSUPPORTED_FORMAT
+ *      - SGX_QL_ERROR_UNEXPECTED
+ **/
+static quote3_error_t qve_parse_verification_context(const uint8_t *p_quote, uint32_t quote_size,
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral, const char *trusted_root_ca_cert,
+    qve_verification_context_t *p_context) {
+
+    if (p_quote == NULL || quote_size < QUOTE_MIN_SIZE || p_quote_collateral == NULL ||
+        trusted_root_ca_cert == NULL || p_context == NULL) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+
+    int version = 0;
+    quote3_error_t ret = SGX_QL_ERROR_UNEXPECTED;
+
+    p_context->p_quote_collateral = p_quote_collateral;
+    p_context->trusted_root_ca_cert = trusted_root_ca_cert;
+
+    //parse the quote and extract PCK Cert chain from its certification data
+    //
+    // We totaly trust user on this, it should be explicitly and clearly
+    // mentioned in doc, is there any max quote len other than numeric_limit<uint32_t>::max() ?
+    // The quote is not copied, the view refers to p_quote which outlives the context.
+    if (!p_context->quote.parse(p_quote, quote_size) || !p_context->quote.validate()) {
+        return status_error_to_quote3_error(STATUS_UNSUPPORTED_QUOTE_FORMAT);
+    }
+    const auto qe_cert_data = p_context->quote.getQeCertData();
+    if (p_context->quote.getQeCertDataSize() == 0) {
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    if (p_context->quote.getQeCertDataType() != QUOTE_CERT_TYPE) {
+        return SGX_QL_QUOTE_CERTIFICATION_DATA_UNSUPPORTED;
+    }
+
+    //parse PCK Cert chain into CertificateChain object, the certification data is not '\0' terminated
+    //
+    const std::string pck_cert_chain(qe_cert_data.begin(),
+        std::find(qe_cert_data.begin(), qe_cert_data.end(), '\0'));
+    if (p_context->pck_cert_chain.parse(pck_cert_chain) != STATUS_OK ||
+        p_context->pck_cert_chain.length() != EXPECTED_CERTIFICATE_COUNT_IN_PCK_CHAIN) {
+        return SGX_QL_PCK_CERT_CHAIN_ERROR;
+    }
+
+    if (p_context->prepared_collateral != nullptr) {
+        //prepared collateral has been loaded as a whole, see qve_load_prepared_collateral
+        //
+        const PreparedCollateral &prepared = *p_context->prepared_collateral;
+        p_context->tcb_info = prepared.getTcbInfo();
+        p_context->tcb_level_matcher = prepared.getTcbLevelMatcher();
+        p_context->qe_identity = prepared.getQeIdentity();
+        p_context->tcb_info_issuer_chain = prepared.getTcbInfoIssuerChain();
+        p_context->qe_identity_issuer_chain = prepared.getQeIdentityIssuerChain();
+        p_context->pck_crl_issuer_chain = prepared.getPckCrlIssuerChain();
+        p_context->root_ca_crl = prepared.getRootCaCrl();
+        p_context->pck_crl = prepared.getPckCrl();
+    }
+    else {
+        ret = qve_parse_collateral(p_quote_collateral, p_context);
+        if (ret != SGX_QL_SUCCESS) {
+            return ret;
+        }
+    }
+
+    //supports only EnclaveIdentity V2 and V3
+    //
+    version = p_context->qe_identity->getVersion();
+    if (version != 2 && version != 3) {
+        return SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
+    }
+
+    //supports only TCBInfo V2 and V3
+    //
+    version = p_context->tcb_info->getVersion();
+    if (version != 2 && version != 3) {
+        return SGX_QL_TCBINFO_UNSUPPORTED_FORMAT;
+    }
+
+    try
+    {
+        p_context->trusted_root_ca = CollateralCache::instance().getCertificate(trusted_root_ca_cert);
+    }
+    catch (...)
+    {
+        return status_error_to_quote3_error(STATUS_TRUSTED_ROOT_CA_UNSUPPORTED_FORMAT);
+    }
+
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Verify PCK Cert chain of a parsed verification context, see sgxAttestationVerifyPCKCertificate.
+ **/
+static Status qve_verify_pck_cert_chain(const qve_verification_context_t &context, time_t expiration_check_date) {
+    return PckCertVerifier{}.verify(context.pck_cert_chain, *context.root_ca_crl, *context.pck_crl,
+        *context.trusted_root_ca, expiration_check_date);
+}
+
+/**
+ * Verify TCB info of a parsed verification context, see sgxAttestationVerifyTCBInfo.
+ * The signature checks don't depend on time and run once per collateral set.
+ **/
+static Status qve_verify_tcb_info(const qve_verification_context_t &context, time_t expiration_check_date) {
+    if (context.tcb_info_issuer_chain->length() != EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN) {
+        return STATUS_UNSUPPORTED_CERT_FORMAT;
+    }
+    try
+    {
+        const TCBInfoVerifier verifier{};
+        const auto verify_signature = [&context, &verifier] {
+            return verifier.verifySignature(*context.tcb_info, *context.tcb_info_issuer_chain,
+                *context.root_ca_crl, *context.trusted_root_ca);
+        };
+        Status signature_status = context.prepared_collateral != nullptr ?
+            CollateralCache::instance().getVerificationStatus("TCBInfoVerifier",
+                { context.prepared_collateral->getDigest().c_str(), context.trusted_root_ca_cert }, verify_signature) :
+            CollateralCache::instance().getVerificationStatus("TCBInfoVerifier",
+                { context.p_quote_collateral->tcb_info, context.p_quote_collateral->tcb_info_issuer_chain,
+                  context.p_quote_collateral->root_ca_crl, context.trusted_root_ca_cert }, verify_signature);
+        if (signature_status != STATUS_OK) {
+            return signature_status;
+        }
+        return verifier.verifyExpiration(*context.tcb_info, *context.tcb_info_issuer_chain, *context.root_ca_crl,
+            expiration_check_date);
+    }
+    catch (const FormatException&)
+    {
+        return STATUS_UNSUPPORTED_CERT_FORMAT;
+    }
+    catch (const InvalidExtensionException&)
+    {
+        return STATUS_SGX_ROOT_CA_INVALID_EXTENSIONS;
+    }
+}
+
+/**
+ * Verify QE identity of a parsed verification context, see sgxAttestationVerifyEnclaveIdentity.
+ * The signature checks don't depend on time and run once per collateral set.
+ **/
+static Status qve_verify_qe_identity(const qve_verification_context_t &context, time_t expiration_check_date) {
+    if (context.qe_identity_issuer_chain->length() != EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN) {
+        return STATUS_UNSUPPORTED_CERT_FORMAT;
+    }
+    try
+    {
+        const EnclaveIdentityVerifier verifier{};
+        const auto verify_signature = [&context, &verifier] {
+            return verifier.verifySignature(*context.qe_identity, *context.qe_identity_issuer_chain,
+                *context.root_ca_crl, *context.trusted_root_ca);
+        };
+        Status signature_status = context.prepared_collateral != nullptr ?
+            CollateralCache::instance().getVerificationStatus("EnclaveIdentityVerifier",
+                { context.prepared_collateral->getDigest().c_str(), context.trusted_root_ca_cert }, verify_signature) :
+            CollateralCache::instance().getVerificationStatus("EnclaveIdentityVerifier",
+                { context.p_quote_collateral->qe_identity, context.p_quote_collateral->qe_identity_issuer_chain,
+                  context.p_quote_collateral->root_ca_crl, context.trusted_root_ca_cert }, verify_signature);
+        if (signature_status != STATUS_OK) {
+            return signature_status;
+        }
+        return verifier.verifyExpiration(*context.qe_identity, *context.qe_identity_issuer_chain, *context.root_ca_crl,
+            expiration_check_date);
+    }
+    catch (const FormatException&)
+    {
+        return STATUS_UNSUPPORTED_CERT_FORMAT;
+    }
+    catch (const InvalidExtensionException&)
+    {
+        return STATUS_SGX_ROOT_CA_INVALID_EXTENSIONS;
+    }
+}
+
+/**
+ * Verify the quote of a parsed verification context, see sgxAttestationVerifyQuote.
+ **/
+static Status qve_verify_quote_body(const qve_verification_context_t &context) {
+    auto pck_cert = context.pck_cert_chain.getPckCert();
+
+    //compare to nullptr (C++ way of comparing pointers to NULL), otherwise gcc will report a compilation warning
+    //
+    if (pck_cert == nullptr) {
+        return STATUS_INVALID_PCK_CERT;
+    }
+    try
+    {
+        return QuoteVerifier{}.verify(context.quote, *pck_cert, *context.pck_crl, *context.tcb_info,
+            *context.tcb_level_matcher, context.qe_identity.get(), EnclaveReportVerifier());
+    }
+    catch (const FormatException&)
+    {
+        return STATUS_UNSUPPORTED_PCK_CERT_FORMAT;
+    }
+    catch (const InvalidExtensionException&)
+    {
+        return STATUS_INVALID_PCK_CERT;
+    }
+}
+
+/**
+ * Helper function to return earliest & latest issue date and expiration date comparing all collaterals.
+ * @param p_context[IN] - Pointer to the verification context holding the parsed quote and collaterals.
  * @param p_earliest_issue_date[OUT] - Pointer to store the value of the earliest issue date of all input data in quote verification collaterals.
  * @param p_earliest_expiration_date[OUT] - Pointer to store the value of the earliest expiration date of all collaterals used in quote verification collaterals.
  * @param p_latest_issue_date[OUT] - Pointer to store the value of the latest issue date of all input data in quote verification collaterals.
@@ -564,22 +921,23 @@ static time_t getLatestExpirationDate(const CertificateChain* chain) {
  * @return Status code of the operation, one of:
  *      - SGX_QL_SUCCESS
  *      - SGX_QL_ERROR_INVALID_PARAMETER
- *      - SGX_QL_ATT_KEY_CERT_DATA_INVALID
- *      - SGX_QL_QUOTE_CERTIFICATION_DATA_UNSUPPORTED
  *      - SGX_QL_ERROR_UNEXPECTED
  **/
-static quote3_error_t qve_get_collateral_dates(const CertificateChain* p_cert_chain_obj, const json::TcbInfo* p_tcb_info_obj,
-    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+static quote3_error_t qve_get_collateral_dates(const qve_verification_context_t* p_context,
     time_t* p_earliest_issue_date, time_t* p_earliest_expiration_date,
     time_t* p_latest_issue_date, time_t* p_latest_expiration_date) {
 
     quote3_error_t ret = SGX_QL_ERROR_INVALID_PARAMETER;
-    int version = 0;
 
     do {
-        if (p_cert_chain_obj == NULL ||
-            p_tcb_info_obj == NULL ||
-            p_quote_collateral == NULL ||
+        if (p_context == NULL ||
+            p_context->qe_identity == nullptr ||
+            p_context->tcb_info == nullptr ||
+            p_context->root_ca_crl == nullptr ||
+            p_context->pck_crl == nullptr ||
+            p_context->qe_identity_issuer_chain == nullptr ||
+            p_context->tcb_info_issuer_chain == nullptr ||
+            p_context->pck_crl_issuer_chain == nullptr ||
             p_earliest_issue_date == NULL ||
             p_earliest_expiration_date == NULL ||
             p_latest_issue_date == NULL ||
@@ -591,61 +949,14 @@ static quote3_error_t qve_get_collateral_dates(const CertificateChain* p_cert_ch
         *p_latest_issue_date = 0;
         *p_latest_expiration_date = 0;
 
-        CertificateChain qe_identity_issuer_chain;
-        if (qe_identity_issuer_chain.parse((reinterpret_cast<const char*>(p_quote_collateral->qe_identity_issuer_chain))) != STATUS_OK) {
-            ret = SGX_QL_PCK_CERT_CHAIN_ERROR;
-            break;
-        }
-        CertificateChain tcb_info_issuer_chain;
-        if (tcb_info_issuer_chain.parse((reinterpret_cast<const char*>(p_quote_collateral->tcb_info_issuer_chain))) != STATUS_OK) {
-            ret = SGX_QL_PCK_CERT_CHAIN_ERROR;
-            break;
-        }
-
-        EnclaveIdentityParser parser;
-        std::unique_ptr<EnclaveIdentity> enclaveIdentity;
-        try
-        {
-            enclaveIdentity = parser.parse(p_quote_collateral->qe_identity);
-        }
-        catch (...)
-        {
-            ret = SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
-            break;
-        }
-        //supports only EnclaveIdentity V2 and V3
-        //
-        version = enclaveIdentity->getVersion();
-        if (version != 2 && version != 3) {
-            ret = SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
-            break;
-        }
-
-        //supports only TCBInfo V2 and V3
-        //
-        version = p_tcb_info_obj->getVersion();
-        if (version != 2 && version != 3) {
-            ret = SGX_QL_TCBINFO_UNSUPPORTED_FORMAT;
-            break;
-        }
-
-        pckparser::CrlStore root_ca_crl;
-        if (root_ca_crl.parse(p_quote_collateral->root_ca_crl) != true) {
-            ret = SGX_QL_CRL_UNSUPPORTED_FORMAT;
-            break;
-        }
-
-        pckparser::CrlStore pck_crl;
-        if (pck_crl.parse(p_quote_collateral->pck_crl) != true) {
-            ret = SGX_QL_CRL_UNSUPPORTED_FORMAT;
-            break;
-        }
-
-        CertificateChain pck_crl_issuer_chain;
-        if (pck_crl_issuer_chain.parse((reinterpret_cast<const char*>(p_quote_collateral->pck_crl_issuer_chain))) != STATUS_OK) {
-            ret = SGX_QL_PCK_CERT_CHAIN_ERROR;
-            break;
-        }
+        const CertificateChain* p_cert_chain_obj = &p_context->pck_cert_chain;
+        const json::TcbInfo* p_tcb_info_obj = p_context->tcb_info.get();
+        const EnclaveIdentity* enclaveIdentity = p_context->qe_identity.get();
+        const pckparser::CrlStore& root_ca_crl = *p_context->root_ca_crl;
+        const pckparser::CrlStore& pck_crl = *p_context->pck_crl;
+        const CertificateChain& qe_identity_issuer_chain = *p_context->qe_identity_issuer_chain;
+        const CertificateChain& tcb_info_issuer_chain = *p_context->tcb_info_issuer_chain;
+        const CertificateChain& pck_crl_issuer_chain = *p_context->pck_crl_issuer_chain;
 
         //Earliest issue date
         //
@@ -718,9 +1029,7 @@ static quote3_error_t qve_get_collateral_dates(const CertificateChain* p_cert_ch
 
 /**
  * Setup supplemental data.
- * @param chain[IN] - Pointer to CertificateChain object containing PCK Cert chain (for quote with cert type 5, this should be extracted from the quote).
- * @param tcb_info_obj[IN] - Pointer to TcbInfo object.
- * @param p_quote_collateral[IN] - Pointer to _sgx_ql_qve_collateral_t struct.
+ * @param p_context[IN] - Pointer to the verification context holding the parsed quote and collaterals.
  * @param earliest_issue_date[IN] - value of the earliest issue date of all collaterals used in quote verification.
  * @param p_supplemental_data[OUT] - Pointer to a supplemental data buffer. Must be allocated by caller (untrusted code).
 
@@ -733,14 +1042,20 @@ static quote3_error_t qve_get_collateral_dates(const CertificateChain* p_cert_ch
  *      - SGX_QL_QUOTE_CERTIFICATION_DATA_UNSUPPORTED
  *      - SGX_QL_ERROR_UNEXPECTED
  **/
-static quote3_error_t qve_set_quote_supplemental_data(const CertificateChain *chain, const json::TcbInfo *tcb_info_obj,
-    uint16_t qe_report_isvsvn, const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+static quote3_error_t qve_set_quote_supplemental_data(const qve_verification_context_t *p_context,
     time_t earliest_issue_date, time_t latest_issue_date, time_t earliest_expiration_date,
     uint8_t *p_supplemental_data) {
-    if (chain == NULL || tcb_info_obj == NULL || p_quote_collateral == NULL || p_supplemental_data == NULL) {
+    if (p_context == NULL || p_context->tcb_info == nullptr || p_context->root_ca_crl == nullptr ||
+        p_context->pck_crl == nullptr || p_supplemental_data == NULL) {
         return SGX_QL_ERROR_INVALID_PARAMETER;
     }
 
+    const CertificateChain *chain = &p_context->pck_cert_chain;
+    const json::TcbInfo *tcb_info_obj = p_context->tcb_info.get();
+    const pckparser::CrlStore &root_ca_crl = *p_context->root_ca_crl;
+    const pckparser::CrlStore &pck_crl = *p_context->pck_crl;
+    uint16_t qe_report_isvsvn = p_context->quote.getQeReport().isvSvn;
+
     quote3_error_t ret = SGX_QL_ERROR_INVALID_PARAMETER;
     int version = 0;
     sgx_ql_qv_supplemental_t* supplemental_data = (sgx_ql_qv_supplemental_t*)p_supplemental_data;
@@ -755,8 +1070,7 @@ static quote3_error_t qve_set_quote_supplemental_data(const CertificateChain *ch
     //Start collecting supplemental data
     //
     do {
-        EnclaveIdentityParser parser;
-        EnclaveIdentityV2* qe_identity_v2 = NULL;
+        const EnclaveIdentityV2* qe_identity_v2 = NULL;
 
         //some of the required supplemental data exist only on V2 & V3 TCBInfo, validate TCBInfo version.
         //
@@ -766,18 +1080,9 @@ static quote3_error_t qve_set_quote_supplemental_data(const CertificateChain *ch
             break;
         }
 
-        //parse qe_identity and validate its version
+        //validate qe_identity version
         //
-        std::unique_ptr<EnclaveIdentity> qe_identity_obj;
-        try
-        {
-            qe_identity_obj = parser.parse(p_quote_collateral->qe_identity);
-        }
-        catch (...)
-        {
-            ret = SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
-            break;
-        }
+        const EnclaveIdentity* qe_identity_obj = p_context->qe_identity.get();
         if (qe_identity_obj == nullptr) {
             ret = SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
             break;
@@ -785,25 +1090,13 @@ static quote3_error_t qve_set_quote_supplemental_data(const CertificateChain *ch
 
         version = qe_identity_obj->getVersion();
         if (version == 2 || version == 3) {
-            qe_identity_v2 = dynamic_cast<EnclaveIdentityV2*>(qe_identity_obj.get());
+            qe_identity_v2 = dynamic_cast<const EnclaveIdentityV2*>(qe_identity_obj);
         }
         else {
             ret = SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
             break;
         }
 
-        pckparser::CrlStore root_ca_crl;
-        if (root_ca_crl.parse(p_quote_collateral->root_ca_crl) != true) {
-            ret = SGX_QL_ERROR_INVALID_PARAMETER;
-            break;
-        }
-
-        pckparser::CrlStore pck_crl;
-        if (pck_crl.parse(p_quote_collateral->pck_crl) != true) {
-            ret = SGX_QL_ERROR_INVALID_PARAMETER;
-            break;
-        }
-
         //get certificates objects from chain
         //
         auto chain_root_ca_cert = chain->getRootCert();
@@ -1156,6 +1449,18 @@ static quote3_error_t sgx_qve_generate_report(
 #define IS_IN_ENCLAVE_POINTER(p, size) (p && (strnlen(p, size) == size - 1) && sgx_is_within_enclave(p, size))
 
 static bool is_collateral_deep_copied(const struct _sgx_ql_qve_collateral_t *p_quote_collateral) {
+    //prepared collateral is binary, it's in tcb_info only
+    //
+    if (p_quote_collateral->version == QVE_COLLATERAL_VERSION_PREPARED) {
+        return p_quote_collateral->tcb_info != NULL && p_quote_collateral->tcb_info_size != 0 &&
+            sgx_is_within_enclave(p_quote_collateral->tcb_info, p_quote_collateral->tcb_info_size) &&
+            p_quote_collateral->pck_crl_issuer_chain == NULL && p_quote_collateral->pck_crl_issuer_chain_size == 0 &&
+            p_quote_collateral->root_ca_crl == NULL && p_quote_collateral->root_ca_crl_size == 0 &&
+            p_quote_collateral->pck_crl == NULL && p_quote_collateral->pck_crl_size == 0 &&
+            p_quote_collateral->tcb_info_issuer_chain == NULL && p_quote_collateral->tcb_info_issuer_chain_size == 0 &&
+            p_quote_collateral->qe_identity_issuer_chain == NULL && p_quote_collateral->qe_identity_issuer_chain_size == 0 &&
+            p_quote_collateral->qe_identity == NULL && p_quote_collateral->qe_identity_size == 0;
+    }
     if (IS_IN_ENCLAVE_POINTER(p_quote_collateral->pck_crl_issuer_chain, p_quote_collateral->pck_crl_issuer_chain_size) &&
         IS_IN_ENCLAVE_POINTER(p_quote_collateral->root_ca_crl, p_quote_collateral->root_ca_crl_size) &&
         IS_IN_ENCLAVE_POINTER(p_quote_collateral->pck_crl, p_quote_collateral->pck_crl_size) &&
@@ -1175,6 +1480,7 @@ static bool is_collateral_deep_copied(const struct _sgx_ql_qve_collateral_t *p_q
  * @param p_quote[IN] - Pointer to an SGX Quote.
  * @param quote_size[IN] - Size of the buffer pointed to by p_quote (in bytes).
  * @param p_quote_collateral[IN] - This is a pointer to the Quote Certification Collateral provided by the caller.
+ *        Of version QVE_COLLATERAL_VERSION_PREPARED, it holds the prepared collateral in tcb_info.
  * @param expiration_check_date[IN] - This is the date that the QvE will use to determine if any of the inputted collateral have expired.
  * @param p_collateral_expiration_status[OUT] - Address of the outputted expiration status.  This input must not be NULL.
  * @param p_quote_verification_result[OUT] - Address of the outputted quote verification result.
@@ -1247,7 +1553,8 @@ quote3_error_t sgx_qve_verify_quote(
         !sgx_is_within_enclave(p_quote_collateral, sizeof(*p_quote_collateral)) ||
         !is_collateral_deep_copied(p_quote_collateral) ||
         (p_quote_collateral->version != QVE_COLLATERAL_VERSION1 &&
-         p_quote_collateral->version != QVE_COLLATERAL_VERSION3) ||
+         p_quote_collateral->version != QVE_COLLATERAL_VERSION3 &&
+         p_quote_collateral->version != QVE_COLLATERAL_VERSION_PREPARED) ||
         expiration_check_date <= 0 ||
         (p_qve_report_info != NULL && !sgx_is_within_enclave(p_qve_report_info, sizeof(*p_qve_report_info))) ||
         (p_supplemental_data == NULL && supplemental_data_size != 0)) {
@@ -1264,12 +1571,10 @@ quote3_error_t sgx_qve_verify_quote(
     time_t latest_issue_date = 0;
     Status collateral_verification_res = STATUS_SGX_ENCLAVE_REPORT_MRSIGNER_MISMATCH;
     quote3_error_t ret = SGX_QL_ERROR_INVALID_PARAMETER;
-    uint32_t pck_cert_chain_size = 0;
-    uint8_t *p_pck_cert_chain = NULL;
     time_t set_time = 0;
-    CertificateChain chain;
-    json::TcbInfo tcb_info_obj;
+    qve_verification_context_t context;
     const char* quote_trusted_root_ca_cert;
+    uint32_t collateral_version = 0;
 
     //start the verification operation
     //
@@ -1285,45 +1590,23 @@ quote3_error_t sgx_qve_verify_quote(
             break;
         }
 
-        //extract PCK Cert chain from the given quote
-        //
-        ret = extract_chain_from_quote(p_quote, quote_size, &pck_cert_chain_size, &p_pck_cert_chain);
-        if (ret != SGX_QL_SUCCESS || !p_pck_cert_chain) {
-            break;
-        }
-
-        try
-        {
-            //parse tcbInfo JSON string into TcbInfo object
-            //
-            tcb_info_obj = json::TcbInfo::parse(p_quote_collateral->tcb_info);
-        }
-        catch (...)
-        {
-            //unable to parse tcbInfo JSON, return an error
-            //
-            ret = status_error_to_quote3_error(STATUS_SGX_TCB_INFO_INVALID);
-            break;
-        }
-
-        //parse PCK Cert chain into CertificateChain object. return error in case of failure
+        //prepared collateral carries the version of the collateral it was built from
         //
-        if (chain.parse((reinterpret_cast<const char*>(p_pck_cert_chain))) != STATUS_OK ||
-            chain.length() != EXPECTED_CERTIFICATE_COUNT_IN_PCK_CHAIN) {
-            ret = SGX_QL_PCK_CERT_CHAIN_ERROR;
-            break;
+        collateral_version = p_quote_collateral->version;
+        if (collateral_version == QVE_COLLATERAL_VERSION_PREPARED) {
+            ret = qve_load_prepared_collateral(p_quote_collateral, &context);
+            if (ret != SGX_QL_SUCCESS) {
+                break;
+            }
+            collateral_version = context.prepared_collateral->getHeader().collateralVersion;
         }
 
-        //create CRLs combined array
-        //
-        const std::array<const char*, 2> crls{ p_quote_collateral->root_ca_crl, p_quote_collateral->pck_crl };
-
         //collateral version 1 will use v1 root CA
         //collateral version 3 will use v3 root CA
         //all other collateral versions are not supported
-        if (p_quote_collateral->version == QVE_COLLATERAL_VERSION1)
+        if (collateral_version == QVE_COLLATERAL_VERSION1)
             quote_trusted_root_ca_cert = TRUSTED_ROOT_CA_CERT;
-        else if (p_quote_collateral->version == QVE_COLLATERAL_VERSION3)
+        else if (collateral_version == QVE_COLLATERAL_VERSION3)
             quote_trusted_root_ca_cert = TRUSTED_ROOT_CA_CERT_V3;
         else {
             //defense in depth
@@ -1332,7 +1615,15 @@ quote3_error_t sgx_qve_verify_quote(
             break;
         }
 
-        ret = qve_get_collateral_dates(&chain, &tcb_info_obj, p_quote_collateral,
+        //parse the quote, the PCK Cert chain extracted from it and all collaterals once,
+        //the parsed objects are shared by all the following steps
+        //
+        ret = qve_parse_verification_context(p_quote, quote_size, p_quote_collateral, quote_trusted_root_ca_cert, &context);
+        if (ret != SGX_QL_SUCCESS) {
+            break;
+        }
+
+        ret = qve_get_collateral_dates(&context,
             &earliest_issue_date, &earliest_expiration_date,
             &latest_issue_date, &latest_expiration_date);
         if (ret != SGX_QL_SUCCESS) {
@@ -1348,9 +1639,9 @@ quote3_error_t sgx_qve_verify_quote(
             *p_collateral_expiration_status = 0;
         }
 
-        //parse and verify PCK certificate chain
+        //verify PCK certificate chain
         //
-        collateral_verification_res = sgxAttestationVerifyPCKCertificate((const char*)p_pck_cert_chain, crls.data(), quote_trusted_root_ca_cert, &expiration_check_date);
+        collateral_verification_res = qve_verify_pck_cert_chain(context, expiration_check_date);
         if (collateral_verification_res != STATUS_OK) {
             if (is_expiration_error(collateral_verification_res)) {
                 *p_collateral_expiration_status = 1;
@@ -1361,9 +1652,9 @@ quote3_error_t sgx_qve_verify_quote(
             }
         }
 
-        //parse and verify TCB info
+        //verify TCB info
         //
-        collateral_verification_res = sgxAttestationVerifyTCBInfo(p_quote_collateral->tcb_info, p_quote_collateral->tcb_info_issuer_chain, p_quote_collateral->root_ca_crl, quote_trusted_root_ca_cert, &expiration_check_date);
+        collateral_verification_res = qve_verify_tcb_info(context, expiration_check_date);
         if (collateral_verification_res != STATUS_OK) {
             if (is_expiration_error(collateral_verification_res)) {
                 *p_collateral_expiration_status = 1;
@@ -1374,9 +1665,9 @@ quote3_error_t sgx_qve_verify_quote(
             }
         }
 
-        //parse and verify QE identity
+        //verify QE identity
         //
-        collateral_verification_res = sgxAttestationVerifyEnclaveIdentity(p_quote_collateral->qe_identity, p_quote_collateral->qe_identity_issuer_chain, p_quote_collateral->root_ca_crl, quote_trusted_root_ca_cert, &expiration_check_date);
+        collateral_verification_res = qve_verify_qe_identity(context, expiration_check_date);
         if (collateral_verification_res != STATUS_OK) {
             if (is_expiration_error(collateral_verification_res)) {
                 *p_collateral_expiration_status = 1;
@@ -1387,9 +1678,9 @@ quote3_error_t sgx_qve_verify_quote(
             }
         }
 
-        //parse and verify the quote, update verification results
+        //verify the quote, update verification results
         //
-        collateral_verification_res = sgxAttestationVerifyQuote(p_quote, quote_size, chain.getPckCert()->getPem().c_str(), p_quote_collateral->pck_crl, p_quote_collateral->tcb_info, p_quote_collateral->qe_identity);
+        collateral_verification_res = qve_verify_quote_body(context);
         *p_quote_verification_result = status_error_to_ql_qve_result(collateral_verification_res);
 
         if (is_nonterminal_error(collateral_verification_res)) {
@@ -1402,17 +1693,7 @@ quote3_error_t sgx_qve_verify_quote(
         //collect supplemental data if required, only if verification completed with non-terminal status
         //
         if (p_supplemental_data && ret == SGX_QL_SUCCESS) {
-            // We totaly trust user on this, it should be explicitly and clearly
-            // mentioned in doc, is there any max quote len other than numeric_limit<uint32_t>::max() ?
-            const std::vector<uint8_t> vecQuote(p_quote, std::next(p_quote, quote_size));
-
-            Quote quote;
-            if (!quote.parse(vecQuote))
-            {
-                ret = status_error_to_quote3_error(STATUS_UNSUPPORTED_QUOTE_FORMAT);
-            }
-            auto qe_report_isvsvn = quote.getQuoteAuthData().qeReport.isvSvn;
-            ret = qve_set_quote_supplemental_data(&chain, &tcb_info_obj, qe_report_isvsvn, p_quote_collateral, earliest_issue_date, latest_issue_date, earliest_expiration_date, p_supplemental_data);
+            ret = qve_set_quote_supplemental_data(&context, earliest_issue_date, latest_issue_date, earliest_expiration_date, p_supplemental_data);
             if (ret != SGX_QL_SUCCESS) {
                 break;
             }
@@ -1453,12 +1734,6 @@ quote3_error_t sgx_qve_verify_quote(
     }
  #endif //SGX_TRUSTED
 
-    //clear and free allocated memory
-    //
-    if (p_pck_cert_chain) {
-        CLEAR_FREE_MEM(p_pck_cert_chain, pck_cert_chain_size);
-    }
-
     //if any check or operation failed (e.g. generating report, or supplemental data)
     //set p_quote_verification_result to SGX_QL_QV_RESULT_UNSPECIFIED
     //
@@ -1469,3 +1744,416 @@ quote3_error_t sgx_qve_verify_quote(
     return ret;
 }
 
+#ifndef SGX_TRUSTED
+/**
+ * Build prepared collateral, see PreparedCollateral. The prepared collateral is returned in a collateral of version
+ * QVE_COLLATERAL_VERSION_PREPARED allocated together with it, to be released with free().
+ *
+ * @param p_quote_collateral[IN] - Pointer to _sgx_ql_qve_collateral_t struct of version 1 or 3.
+ * @param pp_prepared_collateral[OUT] - Pointer to the allocated collateral holding the prepared collateral.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_ERROR_OUT_OF_MEMORY
+ *      - SGX_QL_TCBINFO_UNSUPPORTED_FORMAT
+ *      - SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT
+ *      - SGX_QL_PCK_CERT_CHAIN_ERROR
+ *      - SGX_QL_CRL_UNSUPPORTED_FORMAT
+ *      - SGX_QL_ERROR_UNEXPECTED
+ **/
+quote3_error_t sgx_qvl_prepare_collateral(
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    struct _sgx_ql_qve_collateral_t **pp_prepared_collateral) {
+
+    if (p_quote_collateral == NULL || pp_prepared_collateral == NULL ||
+        (p_quote_collateral->version != QVE_COLLATERAL_VERSION1 &&
+         p_quote_collateral->version != QVE_COLLATERAL_VERSION3) ||
+        !is_collateral_deep_copied(p_quote_collateral)) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+
+    std::vector<uint8_t> prepared;
+    try
+    {
+        prepared = PreparedCollateral::build(static_cast<uint16_t>(p_quote_collateral->version),
+            p_quote_collateral->pck_crl_issuer_chain, p_quote_collateral->root_ca_crl, p_quote_collateral->pck_crl,
+            p_quote_collateral->tcb_info_issuer_chain, p_quote_collateral->tcb_info,
+            p_quote_collateral->qe_identity_issuer_chain, p_quote_collateral->qe_identity);
+    }
+    catch (const RuntimeException &e)
+    {
+        switch (e.getStatus()) {
+        case STATUS_UNSUPPORTED_CERT_FORMAT:
+            return SGX_QL_PCK_CERT_CHAIN_ERROR;
+        case STATUS_SGX_CRL_UNSUPPORTED_FORMAT:
+            return SGX_QL_CRL_UNSUPPORTED_FORMAT;
+        case STATUS_SGX_TCB_INFO_UNSUPPORTED_FORMAT:
+        case STATUS_SGX_TCB_INFO_INVALID:
+            return SGX_QL_TCBINFO_UNSUPPORTED_FORMAT;
+        default:
+            return SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT;
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        return SGX_QL_ERROR_OUT_OF_MEMORY;
+    }
+    catch (...)
+    {
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+    if (prepared.size() > UINT32_MAX - sizeof(struct _sgx_ql_qve_collateral_t)) {
+        return SGX_QL_ERROR_UNEXPECTED;
+    }
+
+    struct _sgx_ql_qve_collateral_t *p_prepared_collateral = reinterpret_cast<struct _sgx_ql_qve_collateral_t*>(
+        malloc(sizeof(struct _sgx_ql_qve_collateral_t) + prepared.size()));
+    if (p_prepared_collateral == NULL) {
+        return SGX_QL_ERROR_OUT_OF_MEMORY;
+    }
+    memset(p_prepared_collateral, 0, sizeof(*p_prepared_collateral));
+    p_prepared_collateral->version = QVE_COLLATERAL_VERSION_PREPARED;
+    p_prepared_collateral->tcb_info = reinterpret_cast<char*>(p_prepared_collateral + 1);
+    p_prepared_collateral->tcb_info_size = static_cast<uint32_t>(prepared.size());
+    memcpy(p_prepared_collateral->tcb_info, prepared.data(), prepared.size());
+
+    *pp_prepared_collateral = p_prepared_collateral;
+    return SGX_QL_SUCCESS;
+}
+#endif //SGX_TRUSTED
+
+
+#ifdef SGX_TRUSTED
+/**
+ * Unpack the collaterals of a batch, see PackedCollateral. The unpacked collaterals point into p_collaterals.
+ *
+ * @param p_collaterals[IN] - Concatenated packed collaterals.
+ * @param collaterals_size[IN] - Size of the buffer pointed to by p_collaterals (in bytes).
+ * @param collaterals[OUT] - Unpacked collaterals.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ **/
+static quote3_error_t qve_unpack_collaterals(const uint8_t *p_collaterals, uint32_t collaterals_size,
+    std::vector<struct _sgx_ql_qve_collateral_t> &collaterals) {
+
+    static_assert(PackedCollateral::PREPARED_VERSION == QVE_COLLATERAL_VERSION_PREPARED, "prepared collateral version mismatch");
+
+    std::vector<PackedCollateral::Collateral> unpacked;
+    if (!PackedCollateral::unpack(p_collaterals, collaterals_size, unpacked)) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+
+    for (const auto &packed : unpacked) {
+        struct _sgx_ql_qve_collateral_t collateral;
+        memset(&collateral, 0, sizeof(collateral));
+        collateral.version = packed.version;
+
+        char **fields[PackedCollateral::FIELD_COUNT] = {
+            &collateral.pck_crl_issuer_chain, &collateral.root_ca_crl, &collateral.pck_crl,
+            &collateral.tcb_info_issuer_chain, &collateral.tcb_info,
+            &collateral.qe_identity_issuer_chain, &collateral.qe_identity };
+        uint32_t *field_sizes[PackedCollateral::FIELD_COUNT] = {
+            &collateral.pck_crl_issuer_chain_size, &collateral.root_ca_crl_size, &collateral.pck_crl_size,
+            &collateral.tcb_info_issuer_chain_size, &collateral.tcb_info_size,
+            &collateral.qe_identity_issuer_chain_size, &collateral.qe_identity_size };
+
+        for (size_t i = 0; i < PackedCollateral::FIELD_COUNT; i++) {
+            *fields[i] = const_cast<char*>(packed.fields[i]);
+            *field_sizes[i] = packed.sizes[i];
+        }
+        collaterals.push_back(collateral);
+    }
+    return SGX_QL_SUCCESS;
+}
+
+//hash of the batch report, kept between the ECALLs of a batch verified in chunks. The QvE is single threaded and
+//the untrusted side verifies all chunks of a batch with the same QvE instance
+//
+static sgx_sha_state_handle_t g_batch_report_sha_handle = NULL;
+static time_t g_batch_report_expiration_check_date = 0;
+
+static void qve_close_batch_report()
+{
+    if (g_batch_report_sha_handle != NULL) {
+        sgx_sha256_close(g_batch_report_sha_handle);
+        g_batch_report_sha_handle = NULL;
+    }
+    g_batch_report_expiration_check_date = 0;
+}
+
+/**
+ * Generate enclave report for a batch with:
+ * SHA256([nonce || expiration_check_date || for each quote: quote || expiration_status || verification_result || supplemental_data] || 32 - 0x00s)
+ *
+ * A batch verified in chunks hashes the nonce and expiration_check_date with the first chunk and the quotes of each
+ * chunk in order, the report is generated with the last chunk.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_UNABLE_TO_GENERATE_REPORT
+ **/
+static quote3_error_t sgx_qve_generate_batch_report(
+    const uint8_t *p_quotes,
+    const uint32_t *p_quote_sizes,
+    uint32_t quote_count,
+    const time_t expiration_check_date,
+    const uint32_t *p_collateral_expiration_status,
+    const sgx_ql_qv_result_t *p_quote_verification_result,
+    uint32_t batch_flags,
+    sgx_ql_qe_report_info_t *p_qve_report_info,
+    uint32_t supplemental_stride,
+    const uint8_t *p_supplemental_data)
+{
+    sgx_status_t sgx_status = SGX_ERROR_UNEXPECTED;
+    quote3_error_t ret = SGX_QL_UNABLE_TO_GENERATE_REPORT;
+    sgx_report_data_t report_data = { 0 };
+    const uint8_t *p_quote = p_quotes;
+    uint32_t i = 0;
+
+    do {
+        if (batch_flags & QVE_BATCH_FIRST_CHUNK) {
+            qve_close_batch_report();
+
+            sgx_status = sgx_sha256_init(&g_batch_report_sha_handle);
+            SGX_ERR_BREAK(sgx_status);
+
+            sgx_status = sgx_sha256_update((p_qve_report_info->nonce.rand), sizeof(p_qve_report_info->nonce.rand), g_batch_report_sha_handle);
+            SGX_ERR_BREAK(sgx_status);
+
+            sgx_status = sgx_sha256_update((const uint8_t*)&expiration_check_date, sizeof(expiration_check_date), g_batch_report_sha_handle);
+            SGX_ERR_BREAK(sgx_status);
+
+            g_batch_report_expiration_check_date = expiration_check_date;
+        }
+        else if (g_batch_report_sha_handle == NULL ||
+                 g_batch_report_expiration_check_date != expiration_check_date) {
+            //the chunk doesn't continue a batch
+            //
+            ret = SGX_QL_ERROR_INVALID_PARAMETER;
+            break;
+        }
+
+        for (i = 0; i < quote_count; i++) {
+            sgx_status = sgx_sha256_update(p_quote, p_quote_sizes[i], g_batch_report_sha_handle);
+            SGX_ERR_BREAK(sgx_status);
+            p_quote += p_quote_sizes[i];
+
+            sgx_status = sgx_sha256_update((const uint8_t*)&p_collateral_expiration_status[i], sizeof(p_collateral_expiration_status[i]), g_batch_report_sha_handle);
+            SGX_ERR_BREAK(sgx_status);
+
+            sgx_status = sgx_sha256_update((const uint8_t*)&p_quote_verification_result[i], sizeof(p_quote_verification_result[i]), g_batch_report_sha_handle);
+            SGX_ERR_BREAK(sgx_status);
+
+            if (p_supplemental_data) {
+                sgx_status = sgx_sha256_update(p_supplemental_data + (size_t)i * supplemental_stride, supplemental_stride, g_batch_report_sha_handle);
+                SGX_ERR_BREAK(sgx_status);
+            }
+        }
+        if (i != quote_count) {
+            break;
+        }
+
+        if (!(batch_flags & QVE_BATCH_LAST_CHUNK)) {
+            ret = SGX_QL_SUCCESS;
+            break;
+        }
+
+        sgx_status = sgx_sha256_get_hash(g_batch_report_sha_handle, reinterpret_cast<sgx_sha256_hash_t *>(&report_data));
+        SGX_ERR_BREAK(sgx_status);
+
+        sgx_status = sgx_create_report(&(p_qve_report_info->app_enclave_target_info), &report_data, &(p_qve_report_info->qe_report));
+        SGX_ERR_BREAK(sgx_status);
+
+        ret = SGX_QL_SUCCESS;
+    } while (0);
+
+    memset_s(&report_data, sizeof(sgx_report_data_t), 0, sizeof(sgx_report_data_t));
+    if (ret != SGX_QL_SUCCESS || (batch_flags & QVE_BATCH_LAST_CHUNK)) {
+        qve_close_batch_report();
+    }
+    return ret;
+}
+
+/**
+ * Perform verification of a batch of quotes in one ECALL. Each quote is verified as by sgx_qve_verify_quote, against
+ * the collateral selected by its collateral index. Quotes with index QVE_BATCH_NO_COLLATERAL are not verified, their
+ * verification status is SGX_QL_ERROR_INVALID_PARAMETER. A batch too large for one ECALL is verified in chunks, one
+ * ECALL per chunk in order, with one report for the whole batch.
+ *
+ * @param p_quotes[IN] - Concatenated SGX Quotes.
+ * @param quotes_size[IN] - Size of the buffer pointed to by p_quotes (in bytes).
+ * @param p_quote_sizes[IN] - Size of each quote (in bytes).
+ * @param p_collateral_indexes[IN] - Index of the collateral of each quote in p_collaterals.
+ * @param quote_count[IN] - Number of quotes.
+ * @param p_collaterals[IN] - Concatenated packed collaterals, see PackedCollateral.
+ * @param collaterals_size[IN] - Size of the buffer pointed to by p_collaterals (in bytes).
+ * @param expiration_check_date[IN] - This is the date that the QvE will use to determine if any of the inputted collateral have expired.
+ * @param p_collateral_expiration_status[OUT] - Expiration status of each quote.
+ * @param p_quote_verification_result[OUT] - Verification result of each quote.
+ * @param p_verification_status[OUT] - Status of the verification of each quote, as returned by sgx_qve_verify_quote.
+ * @param batch_flags[IN] - QVE_BATCH_FIRST_CHUNK and/or QVE_BATCH_LAST_CHUNK, both of them for a batch verified by one ECALL.
+ * @param p_qve_report_info[IN/OUT] - This parameter is optional. If not NULL, the QvE will generate one report for the whole batch
+ *        with the last chunk. If it is NULL, the chunks are verified independently and batch_flags is not used.
+ * @param supplemental_data_size[IN] - Size of the buffer pointed to by p_supplemental_data (in bytes), 0 or quote_count times the supplemental data size.
+ * @param p_supplemental_data[OUT] - Supplemental data of each quote. The parameter is optional. If it is NULL, supplemental_data_size must be 0.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_UNABLE_TO_GENERATE_REPORT
+ *      - SGX_QL_ERROR_UNEXPECTED
+ **/
+quote3_error_t sgx_qve_verify_quote_batch(
+    const uint8_t *p_quotes,
+    uint32_t quotes_size,
+    const uint32_t *p_quote_sizes,
+    const uint32_t *p_collateral_indexes,
+    uint32_t quote_count,
+    const uint8_t *p_collaterals,
+    uint32_t collaterals_size,
+    const time_t expiration_check_date,
+    uint32_t *p_collateral_expiration_status,
+    sgx_ql_qv_result_t *p_quote_verification_result,
+    quote3_error_t *p_verification_status,
+    uint32_t batch_flags,
+    sgx_ql_qe_report_info_t *p_qve_report_info,
+    uint32_t supplemental_data_size,
+    uint8_t *p_supplemental_data) {
+
+    //validate parameters, the per quote ones are validated by sgx_qve_verify_quote
+    //
+    if ((batch_flags & ~(uint32_t)(QVE_BATCH_FIRST_CHUNK | QVE_BATCH_LAST_CHUNK)) != 0 ||
+        p_quotes == NULL ||
+        quote_count == 0 ||
+        !sgx_is_within_enclave(p_quotes, quotes_size) ||
+        p_quote_sizes == NULL ||
+        !sgx_is_within_enclave(p_quote_sizes, sizeof(*p_quote_sizes) * quote_count) ||
+        p_collateral_indexes == NULL ||
+        !sgx_is_within_enclave(p_collateral_indexes, sizeof(*p_collateral_indexes) * quote_count) ||
+        (p_collaterals != NULL && !sgx_is_within_enclave(p_collaterals, collaterals_size)) ||
+        (p_collaterals == NULL && collaterals_size != 0) ||
+        p_collateral_expiration_status == NULL ||
+        !sgx_is_within_enclave(p_collateral_expiration_status, sizeof(*p_collateral_expiration_status) * quote_count) ||
+        p_quote_verification_result == NULL ||
+        !sgx_is_within_enclave(p_quote_verification_result, sizeof(*p_quote_verification_result) * quote_count) ||
+        p_verification_status == NULL ||
+        !sgx_is_within_enclave(p_verification_status, sizeof(*p_verification_status) * quote_count) ||
+        expiration_check_date <= 0 ||
+        (p_qve_report_info != NULL && !sgx_is_within_enclave(p_qve_report_info, sizeof(*p_qve_report_info))) ||
+        CHECK_OPT_PARAMS(p_supplemental_data, supplemental_data_size) ||
+        (p_supplemental_data != NULL &&
+         (supplemental_data_size / quote_count != sizeof(sgx_ql_qv_supplemental_t) ||
+          supplemental_data_size % quote_count != 0 ||
+          !sgx_is_within_enclave(p_supplemental_data, supplemental_data_size)))) {
+        qve_close_batch_report();
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t supplemental_stride = p_supplemental_data ? supplemental_data_size / quote_count : 0;
+    std::vector<struct _sgx_ql_qve_collateral_t> collaterals;
+    quote3_error_t ret = SGX_QL_ERROR_INVALID_PARAMETER;
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < quote_count; i++) {
+        p_collateral_expiration_status[i] = 1;
+        p_quote_verification_result[i] = SGX_QL_QV_RESULT_UNSPECIFIED;
+        p_verification_status[i] = SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+    if (p_supplemental_data) {
+        memset_s(p_supplemental_data, supplemental_data_size, 0, supplemental_data_size);
+    }
+
+    do {
+        //setup expiration check date to verify against (trusted time)
+        //
+        if (getCurrentTime(&expiration_check_date) != expiration_check_date) {
+            ret = SGX_QL_ERROR_UNEXPECTED;
+            break;
+        }
+
+        try {
+            ret = qve_unpack_collaterals(p_collaterals, collaterals_size, collaterals);
+        }
+        catch (...) {
+            ret = SGX_QL_ERROR_OUT_OF_MEMORY;
+        }
+        if (ret != SGX_QL_SUCCESS) {
+            break;
+        }
+
+        //verify each quote against its collateral, the collateral cache parses and checks
+        //the signatures of each collateral once for the whole batch
+        //
+        for (uint32_t i = 0; i < quote_count; i++) {
+            if (p_quote_sizes[i] > quotes_size - offset) {
+                ret = SGX_QL_ERROR_INVALID_PARAMETER;
+                break;
+            }
+            if (p_collateral_indexes[i] != QVE_BATCH_NO_COLLATERAL) {
+                if (p_collateral_indexes[i] >= collaterals.size()) {
+                    ret = SGX_QL_ERROR_INVALID_PARAMETER;
+                    break;
+                }
+                p_verification_status[i] = sgx_qve_verify_quote(
+                    p_quotes + offset, p_quote_sizes[i],
+                    &collaterals[p_collateral_indexes[i]],
+                    expiration_check_date,
+                    &p_collateral_expiration_status[i],
+                    &p_quote_verification_result[i],
+                    NULL,
+                    supplemental_stride,
+                    p_supplemental_data ? p_supplemental_data + (size_t)i * supplemental_stride : NULL);
+            }
+            offset += p_quote_sizes[i];
+        }
+        if (ret != SGX_QL_SUCCESS) {
+            break;
+        }
+        if (offset != quotes_size) {
+            ret = SGX_QL_ERROR_INVALID_PARAMETER;
+            break;
+        }
+
+        //defense-in-depth: validate that the input time is still the one returned by getCurrentTime
+        //
+        if (getCurrentTime(NULL) != expiration_check_date) {
+            ret = SGX_QL_ERROR_UNEXPECTED;
+            break;
+        }
+
+        //generate one report with the verification results of all quotes
+        //
+        if (p_qve_report_info != NULL) {
+            ret = sgx_qve_generate_batch_report(
+                p_quotes,
+                p_quote_sizes,
+                quote_count,
+                expiration_check_date,
+                p_collateral_expiration_status,
+                p_quote_verification_result,
+                batch_flags,
+                p_qve_report_info,
+                supplemental_stride,
+                p_supplemental_data);
+            if (ret != SGX_QL_SUCCESS) {
+                memset_s(&(p_qve_report_info->qe_report), sizeof(p_qve_report_info->qe_report), 0, sizeof(p_qve_report_info->qe_report));
+            }
+        }
+    } while (0);
+
+    //if the batch failed, none of the per quote results can be trusted, and a batch verified in chunks can't continue
+    //
+    if (ret != SGX_QL_SUCCESS) {
+        for (uint32_t i = 0; i < quote_count; i++) {
+            p_quote_verification_result[i] = SGX_QL_QV_RESULT_UNSPECIFIED;
+        }
+        qve_close_batch_report();
+    }
+
+    return ret;
+}
+#endif //SGX_TRUSTED
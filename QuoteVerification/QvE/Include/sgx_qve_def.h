@@ -44,6 +44,7 @@
 #define SUPPLEMENTAL_DATA_VERSION 3
 #define QVE_COLLATERAL_VERSION1 1
 #define QVE_COLLATERAL_VERSION3 3
+#define QVE_COLLATERAL_VERSION_PREPARED 0x100   ///< prepared collateral in tcb_info, all other collateral fields are NULL
 #define FMSPC_SIZE 6
 #define CA_SIZE 10
 #define SGX_CPUSVN_SIZE   16
@@ -79,5 +80,13 @@
 #endif //CLEAR_FREE_MEM
 
 #define EXPECTED_CERTIFICATE_COUNT_IN_PCK_CHAIN 3
+#define EXPECTED_CERTIFICATE_COUNT_IN_TCB_CHAIN 2
+
+//batch verification, see sgx_qve_verify_quote_batch
+//
+#define QVE_BATCH_NO_COLLATERAL 0xFFFFFFFF
+#define QVE_BATCH_FIRST_CHUNK 0x1     //the ECALL starts the batch report
+#define QVE_BATCH_LAST_CHUNK 0x2      //the ECALL generates the batch report
+#define QVE_BATCH_MAX_DATA_SIZE (192 * 1024)     //quotes and packed collaterals copied into the QvE by one batch ECALL, see PackedCollateral
 
 #endif //_SGX_QVE_DEF_H_
@@ -66,6 +66,44 @@ extern "C" {
 quote3_error_t sgx_qv_set_enclave_load_policy(sgx_ql_request_policy_t policy);
 
 
+/**
+ * Load the QvE instances of the pool (see sgx_qv_set_enclave_pool_size) ahead of the first trusted quote verification,
+ * so that the enclave creation cost is not paid by the first calls to sgx_qv_verify_quote. With the SGX_QL_PERSISTENT
+ * policy, the instances stay loaded until sgx_qv_unload_enclave is called, the policy is changed to SGX_QL_EPHEMERAL
+ * or the library is unloaded. With the SGX_QL_EPHEMERAL policy, each instance is unloaded after its next verification.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_PSW_NOT_AVAILABLE
+ *      - SGX_QL_OUT_OF_EPC
+ *      - SGX_QL_ENCLAVE_LOAD_ERROR
+ **/
+quote3_error_t sgx_qv_load_enclave(void);
+
+
+/**
+ * Unload the QvE regardless of the enclave load policy. A later trusted quote verification loads it again.
+ *
+ * @return SGX_QL_SUCCESS
+ **/
+quote3_error_t sgx_qv_unload_enclave(void);
+
+
+/**
+ * Set the maximum number of QvE instances used for trusted quote verification. Each concurrent call to
+ * sgx_qv_verify_quote uses its own QvE instance, so up to pool_size trusted verifications run in parallel and
+ * further calls wait for an instance to be released. Instances are created on demand, or ahead of time by
+ * sgx_qv_load_enclave. The default pool size is 1.
+ *
+ * @param pool_size[IN] - Maximum number of QvE instances, between 1 and 256.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ **/
+quote3_error_t sgx_qv_set_enclave_pool_size(uint32_t pool_size);
+
+
 /**
  * Get supplemental data required size.
  * @param p_data_size[OUT] - Pointer to hold the size of the buffer in bytes required to contain all of the supplemental data.
@@ -100,6 +138,7 @@ quote3_error_t sgx_qv_get_quote_supplemental_data_size(uint32_t *p_data_size);
  *      - SGX_QL_QUOTE_FORMAT_UNSUPPORTED
  *      - SGX_QL_QUOTE_CERTIFICATION_DATA_UNSUPPORTED
  *      - SGX_QL_UNABLE_TO_GENERATE_REPORT
+ *      - SGX_QL_ENCLAVE_LOST
  *      - SGX_QL_CRL_UNSUPPORTED_FORMAT
  *      - SGX_QL_ERROR_UNEXPECTED
  **/
@@ -115,6 +154,90 @@ quote3_error_t sgx_qv_verify_quote(
     uint8_t *p_supplemental_data);
 
 
+/**
+ * A quote of a batch verified by sgx_qv_verify_quote_batch, with its results.
+ **/
+typedef struct _sgx_qv_quote_batch_entry_t
+{
+    const uint8_t *p_quote;                         ///< [IN] Pointer to SGX Quote.
+    uint32_t quote_size;                            ///< [IN] Size of the buffer pointed to by p_quote (in bytes).
+    uint32_t supplemental_data_size;                ///< [IN] Size of the buffer pointed to by p_supplemental_data (in bytes).
+    uint8_t *p_supplemental_data;                   ///< [OUT] Optional, for all the entries of a batch or none of them. If it is NULL, supplemental_data_size must be 0.
+    uint32_t collateral_expiration_status;          ///< [OUT] Expiration status, as by sgx_qv_verify_quote.
+    sgx_ql_qv_result_t quote_verification_result;   ///< [OUT] Quote verification result, as by sgx_qv_verify_quote.
+    quote3_error_t verification_status;             ///< [OUT] Status sgx_qv_verify_quote would return for this quote.
+} sgx_qv_quote_batch_entry_t;
+
+
+/**
+ * Perform verification of a batch of quotes. Each quote is verified as by sgx_qv_verify_quote, but the collateral
+ * is retrieved and verified once per group of quotes with the same FMSPC and PCK CA, and in the QvE mode all quotes
+ * are verified by one ECALL.
+ *
+ * @param p_entries[IN/OUT] - Quotes to verify, the results of each quote are stored in its entry.
+ * @param entry_count[IN] - Number of entries.
+ * @param p_quote_collateral[IN] - This parameter is optional. If not NULL, the collateral is used for all the quotes,
+ *        otherwise the collateral of each group of quotes is retrieved with the quote provider library.
+ * @param expiration_check_date[IN] - This is the date that will be used to determine if any of the inputted collateral have expired.
+ * @param p_qve_report_info[IN/OUT] - This parameter can be used in 2 ways.
+ *        If p_qve_report_info is NOT NULL, the API will use Intel QvE to perform quote verification, and QvE will generate one report for the batch
+ *        using the target_info in sgx_ql_qe_report_info_t structure, with report_data = SHA256([nonce || expiration_check_date ||
+ *        for each entry: quote || collateral_expiration_status || quote_verification_result || supplemental_data]) || 32 - 0x00s.
+ *        The supplemental data is hashed for all entries or none of them, see p_supplemental_data of the entries.
+ *        Each quote with its packed collateral must fit in QVE_BATCH_MAX_DATA_SIZE bytes, a larger batch is verified by several ECALLs
+ *        to the same QvE, which still generates one report.
+ *        If p_qve_report_info is NULL, the API will use QVL library to perform quote verification, note that the results can not be cryptographically authenticated in this mode.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS, the status of each quote is in its verification_status
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_ERROR_OUT_OF_MEMORY
+ *      - SGX_QL_PSW_NOT_AVAILABLE
+ *      - SGX_QL_ENCLAVE_LOAD_ERROR
+ *      - SGX_QL_UNABLE_TO_GENERATE_REPORT
+ *      - SGX_QL_ENCLAVE_LOST
+ *      - SGX_QL_ERROR_UNEXPECTED
+ **/
+quote3_error_t sgx_qv_verify_quote_batch(
+    sgx_qv_quote_batch_entry_t *p_entries,
+    uint32_t entry_count,
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    const time_t expiration_check_date,
+    sgx_ql_qe_report_info_t *p_qve_report_info);
+
+
+/**
+ * Build prepared collateral, the verification collateral of one FMSPC decoded into a compact binary form. Quotes are
+ * verified against it with sgx_qv_verify_quote without decoding the PEM certificates, hex encoded CRLs and JSON
+ * signatures of the collateral again, all signatures are still verified. The returned collateral has version
+ * QVE_COLLATERAL_VERSION_PREPARED, the prepared collateral is in its tcb_info and may be stored as is.
+ *
+ * @param p_quote_collateral[IN] - Collateral of version 1 or 3, as returned by the quote provider library.
+ * @param pp_prepared_collateral[OUT] - Pointer to the collateral holding the prepared collateral, to be released
+ *        with sgx_qv_free_prepared_collateral.
+ *
+ * @return Status code of the operation, one of:
+ *      - SGX_QL_SUCCESS
+ *      - SGX_QL_ERROR_INVALID_PARAMETER
+ *      - SGX_QL_ERROR_OUT_OF_MEMORY
+ *      - SGX_QL_TCBINFO_UNSUPPORTED_FORMAT
+ *      - SGX_QL_QEIDENTITY_UNSUPPORTED_FORMAT
+ *      - SGX_QL_PCK_CERT_CHAIN_ERROR
+ *      - SGX_QL_CRL_UNSUPPORTED_FORMAT
+ *      - SGX_QL_ERROR_UNEXPECTED
+ **/
+quote3_error_t sgx_qv_prepare_collateral(
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    struct _sgx_ql_qve_collateral_t **pp_prepared_collateral);
+
+
+/**
+ * Free the collateral allocated by sgx_qv_prepare_collateral.
+ **/
+quote3_error_t sgx_qv_free_prepared_collateral(
+    struct _sgx_ql_qve_collateral_t *p_prepared_collateral);
+
+
 
 /**
  * Call quote provider library to get QvE identity.
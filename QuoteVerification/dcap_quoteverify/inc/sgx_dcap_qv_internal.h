@@ -56,6 +56,10 @@ quote3_error_t sgx_qvl_verify_quote(
     uint32_t supplemental_data_size,
     uint8_t *p_supplemental_data);
 
+quote3_error_t sgx_qvl_prepare_collateral(
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    struct _sgx_ql_qve_collateral_t **pp_prepared_collateral);
+
 quote3_error_t sgx_qvl_get_quote_supplemental_data_size(
     uint32_t *p_data_size);
 
@@ -38,6 +38,7 @@
 #include "sgx_dcap_pcs_com.h"
 #include "sgx_dcap_qv_internal.h"
 #include "sgx_qve_def.h"
+#include "Utils/PackedCollateral.h"
 #ifndef _MSC_VER
 #include "linux/qve_u.h"
 #else //_MSC_VER
@@ -50,6 +51,14 @@
 #include "se_thread.h"
 #include "se_memcpy.h"
 #include "sgx_urts_wrapper.h"
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <list>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <new>
 
 
 sgx_create_enclave_func_t p_sgx_urts_create_enclave = NULL;
@@ -132,118 +141,170 @@ bool get_qve_path(char *p_file_path, size_t buf_size);
 
 #endif
 
+#define QVE_ENCLAVE_POOL_MAX_SIZE 256
+
+struct QvE_instance {
+    sgx_enclave_id_t m_qve_eid;     // 0 while the enclave is being created
+    bool m_in_use;
+    uint32_t m_generation;          // instances of an older generation are unloaded when released
+};
+
 struct QvE_status {
-    se_mutex_t m_qve_mutex;
+    std::mutex m_qve_mutex;
+    std::condition_variable m_qve_cond;
     sgx_ql_request_policy_t m_qve_enclave_load_policy;
-    sgx_enclave_id_t m_qve_eid;
-    sgx_misc_attribute_t m_qve_attributes;
+    uint32_t m_qve_pool_size;
+    uint32_t m_qve_generation;
+    std::list<QvE_instance> m_qve_instances;    // a list, so the slot load_qve reserves stays valid while others are erased
 
     QvE_status() :
         m_qve_enclave_load_policy(SGX_QL_DEFAULT),
-        m_qve_eid(0)
+        m_qve_pool_size(1),
+        m_qve_generation(0)
     {
-        se_mutex_init(&m_qve_mutex);
-        //should be replaced with memset_s, but currently can't find proper header file for it
-        //
-        memset(&m_qve_attributes, 0, sizeof(m_qve_attributes));
-    }
-    ~QvE_status() {
-        se_mutex_destroy(&m_qve_mutex);
     }
 };
 
 static QvE_status g_qve_status;
 
-static sgx_status_t load_qve(sgx_enclave_id_t *p_qve_eid,
-    sgx_misc_attribute_t *p_qve_attributes,
-    sgx_launch_token_t *p_launch_token)
+static sgx_status_t create_qve(sgx_enclave_id_t *p_qve_eid)
 {
     sgx_status_t sgx_status = SGX_SUCCESS;
     int enclave_lost_retry_time = 1;
     int launch_token_updated = 0;
+    sgx_launch_token_t launch_token = { 0 };
+    sgx_misc_attribute_t qve_attributes;
 #if defined(_MSC_VER)
     TCHAR qve_enclave_path[MAX_PATH] = _T("");
 #else
     char qve_enclave_path[MAX_PATH] = "";
 #endif
-    //should be replaced with memset_s, but currently can't find proper header file for it
-    //
-    memset(p_launch_token, 0, sizeof(*p_launch_token));
 
+    if (!get_qve_path(qve_enclave_path, MAX_PATH)) {
+        return SGX_ERROR_UNEXPECTED; //SGX_QvE_INTERFACE_UNAVAILABLE;
+    }
+    if (!p_sgx_urts_create_enclave) {
+        return SGX_ERROR_UNEXPECTED; //urts handle has been closed;
+    }
+    do
+    {
+        SE_TRACE(SE_TRACE_DEBUG, "Call sgx_create_enclave for QvE. %s\n", qve_enclave_path);
+        sgx_status = p_sgx_urts_create_enclave(qve_enclave_path,
+            0, // Don't support debug load QvE by default
+            &launch_token,
+            &launch_token_updated,
+            p_qve_eid,
+            &qve_attributes);
+        if (SGX_SUCCESS != sgx_status)
+        {
+            SE_TRACE(SE_TRACE_ERROR, "Error, call sgx_create_enclave for QvE fail [%s], SGXError:%04x.\n", __FUNCTION__, sgx_status);
+        }
+
+        // Retry in case there was a power transition that resulted is losing the enclave.
+    } while (SGX_ERROR_ENCLAVE_LOST == sgx_status && enclave_lost_retry_time--);
+    if (sgx_status != SGX_SUCCESS)
+    {
+        if (sgx_status == SGX_ERROR_OUT_OF_EPC)
+            return SGX_ERROR_OUT_OF_EPC;
+        else
+            return SGX_ERROR_UNEXPECTED; //SGX_QvE_INTERFACE_UNAVAILABLE;
+    }
+    return SGX_SUCCESS;
+}
+
+static void destroy_qve(sgx_enclave_id_t qve_eid)
+{
+    SE_TRACE(SE_TRACE_DEBUG, "unload qve enclave 0X%llX\n", qve_eid);
+    if (p_sgx_urts_destroy_enclave) {
+        p_sgx_urts_destroy_enclave(qve_eid);
+    }
+}
+
+/**
+ * Take a QvE instance from the pool for exclusive use by the calling thread. An idle loaded instance is reused if
+ * there is one, otherwise a new instance is created as long as the pool isn't full. When all instances are busy,
+ * the call waits until one is released with release_qve.
+ **/
+static sgx_status_t load_qve(sgx_enclave_id_t *p_qve_eid)
+{
     // Try to load urts lib first
     //
     if (!sgx_dcap_load_urts()) {
         return SGX_ERROR_FEATURE_NOT_SUPPORTED;
     }
 
-    int rc = se_mutex_lock(&g_qve_status.m_qve_mutex);
-    if (rc != 1)
-    {
-        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
-        return SGX_ERROR_UNEXPECTED; // SGX_QvE_INTERFACE_UNAVAILABLE;
-    }
-
-    // Load the QvE
-    if (g_qve_status.m_qve_eid == 0)
-    {
-        if (!get_qve_path(qve_enclave_path, MAX_PATH)) {
-            rc = se_mutex_unlock(&g_qve_status.m_qve_mutex);
-            if (rc != 1)
-            {
-                SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
+    std::unique_lock<std::mutex> lock(g_qve_status.m_qve_mutex);
+    for (;;) {
+        for (auto it = g_qve_status.m_qve_instances.begin(); it != g_qve_status.m_qve_instances.end(); ++it) {
+            if (!it->m_in_use && it->m_qve_eid != 0) {
+                it->m_in_use = true;
+                *p_qve_eid = it->m_qve_eid;
+                return SGX_SUCCESS;
             }
-            return SGX_ERROR_UNEXPECTED; //SGX_QvE_INTERFACE_UNAVAILABLE;
         }
-        do
-        {
-            SE_TRACE(SE_TRACE_DEBUG, "Call sgx_create_enclave for QvE. %s\n", qve_enclave_path);
-            if (p_sgx_urts_create_enclave) {
-                sgx_status = p_sgx_urts_create_enclave(qve_enclave_path,
-                    0, // Don't support debug load QvE by default
-                    p_launch_token,
-                    &launch_token_updated,
-                    p_qve_eid,
-                    p_qve_attributes);
-                if (SGX_SUCCESS != sgx_status)
-                {
-                    SE_TRACE(SE_TRACE_ERROR, "Error, call sgx_create_enclave for QvE fail [%s], SGXError:%04x.\n", __FUNCTION__, sgx_status);
-                }
-            }
-            else
-                return SGX_ERROR_UNEXPECTED; //urts handle has been closed;
-
-            // Retry in case there was a power transition that resulted is losing the enclave.
-        } while (SGX_ERROR_ENCLAVE_LOST == sgx_status && enclave_lost_retry_time--);
-        if (sgx_status != SGX_SUCCESS)
-        {
-            rc = se_mutex_unlock(&g_qve_status.m_qve_mutex);
-            if (rc != 1)
-            {
-                SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
-                return SGX_ERROR_UNEXPECTED; //SGX_QvE_INTERFACE_UNAVAILABLE;
-            }
-            if (sgx_status == SGX_ERROR_OUT_OF_EPC)
-                return SGX_ERROR_OUT_OF_EPC;
-            else
-                return SGX_ERROR_UNEXPECTED; //SGX_QvE_INTERFACE_UNAVAILABLE;
+        if (g_qve_status.m_qve_instances.size() < g_qve_status.m_qve_pool_size) {
+            break;
         }
-        g_qve_status.m_qve_eid = *p_qve_eid;
-        memcpy_s(&g_qve_status.m_qve_attributes, sizeof(sgx_misc_attribute_t), p_qve_attributes, sizeof(sgx_misc_attribute_t));
+        g_qve_status.m_qve_cond.wait(lock);
+    }
+
+    // Reserve a slot and create the enclave without holding the lock, so other threads can use the pool meanwhile
+    //
+    QvE_instance new_instance = { 0, true, g_qve_status.m_qve_generation };
+    auto reserved = g_qve_status.m_qve_instances.insert(g_qve_status.m_qve_instances.end(), new_instance);
+    lock.unlock();
+
+    sgx_enclave_id_t qve_eid = 0;
+    sgx_status_t sgx_status = create_qve(&qve_eid);
+
+    // The reserved slot is in use, so no other thread erased it meanwhile
+    //
+    lock.lock();
+    if (sgx_status == SGX_SUCCESS) {
+        reserved->m_qve_eid = qve_eid;
+        *p_qve_eid = qve_eid;
     }
     else {
-        *p_qve_eid = g_qve_status.m_qve_eid;
-        memcpy_s(p_qve_attributes, sizeof(sgx_misc_attribute_t), &g_qve_status.m_qve_attributes, sizeof(sgx_misc_attribute_t));
+        g_qve_status.m_qve_instances.erase(reserved);
+        g_qve_status.m_qve_cond.notify_one();
     }
-    rc = se_mutex_unlock(&g_qve_status.m_qve_mutex);
-    if (rc != 1)
-    {
-        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
-        return SGX_ERROR_UNEXPECTED;
+    return sgx_status;
+}
+
+/**
+ * Return a QvE instance taken with load_qve to the pool. The instance is unloaded if the load policy isn't
+ * SGX_QL_PERSISTENT, if force is set (e.g. the enclave was lost), if the pool was shrunk or unloaded meanwhile.
+ * An instance returned unused by sgx_qv_load_enclave (preload) is kept whatever the policy, so with the
+ * SGX_QL_EPHEMERAL policy it's unloaded after the verification that uses it.
+ **/
+static void release_qve(sgx_enclave_id_t qve_eid, bool force = false, bool preload = false)
+{
+    std::unique_lock<std::mutex> lock(g_qve_status.m_qve_mutex);
+    for (auto it = g_qve_status.m_qve_instances.begin(); it != g_qve_status.m_qve_instances.end(); ++it) {
+        if (it->m_qve_eid != qve_eid) {
+            continue;
+        }
+        if (force ||
+            (g_qve_status.m_qve_enclave_load_policy != SGX_QL_PERSISTENT && !preload) ||
+            it->m_generation != g_qve_status.m_qve_generation ||
+            g_qve_status.m_qve_instances.size() > g_qve_status.m_qve_pool_size)
+        {
+            g_qve_status.m_qve_instances.erase(it);
+            g_qve_status.m_qve_cond.notify_one();
+            lock.unlock();
+            destroy_qve(qve_eid);
+            return;
+        }
+        it->m_in_use = false;
+        g_qve_status.m_qve_cond.notify_one();
+        return;
     }
-    return SGX_SUCCESS;
 }
 
-static void unload_qve(bool force = false)
+/**
+ * Unload all idle QvE instances. Instances in use are unloaded as soon as they are released.
+ **/
+static void unload_qve()
 {
     // Try to load urts lib first
     //
@@ -252,31 +313,24 @@ static void unload_qve(bool force = false)
         return;
     }
 
-    int rc = se_mutex_lock(&g_qve_status.m_qve_mutex);
-    if (rc != 1)
-    {
-        SE_TRACE(SE_TRACE_ERROR, "Failed to lock mutex\n");
-        return;
-    }
-
-    // Unload the QvE enclave
-    if (g_qve_status.m_qve_eid &&
-        (force || g_qve_status.m_qve_enclave_load_policy != SGX_QL_PERSISTENT)
-        )
+    std::vector<sgx_enclave_id_t> idle_eids;
     {
-        SE_TRACE(SE_TRACE_DEBUG, "unload qve enclave 0X%llX\n", g_qve_status.m_qve_eid);
-        if (p_sgx_urts_destroy_enclave) {
-            p_sgx_urts_destroy_enclave(g_qve_status.m_qve_eid);
+        std::lock_guard<std::mutex> lock(g_qve_status.m_qve_mutex);
+        g_qve_status.m_qve_generation++;
+        for (auto it = g_qve_status.m_qve_instances.begin(); it != g_qve_status.m_qve_instances.end(); ) {
+            if (!it->m_in_use) {
+                idle_eids.push_back(it->m_qve_eid);
+                it = g_qve_status.m_qve_instances.erase(it);
+            }
+            else {
+                ++it;
+            }
         }
-        g_qve_status.m_qve_eid = 0;
-        memset(&g_qve_status.m_qve_attributes, 0, sizeof(g_qve_status.m_qve_attributes));
     }
 
-    rc = se_mutex_unlock(&g_qve_status.m_qve_mutex);
-    if (rc != 1)
-    {
-        SE_TRACE(SE_TRACE_ERROR, "Failed to unlock mutex\n");
-        return;
+    // Unload the QvE enclaves
+    for (size_t i = 0; i < idle_eids.size(); i++) {
+        destroy_qve(idle_eids[i]);
     }
 }
 
@@ -287,22 +341,84 @@ quote3_error_t sgx_qv_set_enclave_load_policy(
         return SGX_QL_UNSUPPORTED_LOADING_POLICY;
     g_qve_status.m_qve_enclave_load_policy = policy;
     if (policy == SGX_QL_EPHEMERAL)
-        unload_qve(true);
+        unload_qve();
     return SGX_QL_SUCCESS;
 }
 
+/**
+ * Set the maximum number of QvE instances used for concurrent trusted verifications.
+ **/
+quote3_error_t sgx_qv_set_enclave_pool_size(uint32_t pool_size)
+{
+    if (pool_size == 0 || pool_size > QVE_ENCLAVE_POOL_MAX_SIZE)
+        return SGX_QL_ERROR_INVALID_PARAMETER;
 
-/* Initialize the enclave:
- * Call sgx_create_enclave to initialize an enclave instance
+    std::vector<sgx_enclave_id_t> idle_eids;
+    {
+        std::lock_guard<std::mutex> lock(g_qve_status.m_qve_mutex);
+        g_qve_status.m_qve_pool_size = pool_size;
+
+        // Unload idle instances beyond the new size, busy ones are unloaded when released
+        auto it = g_qve_status.m_qve_instances.end();
+        while (it != g_qve_status.m_qve_instances.begin() && g_qve_status.m_qve_instances.size() > pool_size) {
+            --it;
+            if (!it->m_in_use) {
+                idle_eids.push_back(it->m_qve_eid);
+                it = g_qve_status.m_qve_instances.erase(it);
+            }
+        }
+        // Waiters may now be able to create a new instance
+        g_qve_status.m_qve_cond.notify_all();
+    }
+    for (size_t i = 0; i < idle_eids.size(); i++) {
+        destroy_qve(idle_eids[i]);
+    }
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Load the QvE instances of the pool ahead of the first verification.
  **/
-static sgx_status_t initialize_enclave(sgx_enclave_id_t* eid)
+quote3_error_t sgx_qv_load_enclave()
 {
-    sgx_launch_token_t token = { 0 };
-    sgx_status_t ret = SGX_ERROR_UNEXPECTED;
-    sgx_misc_attribute_t p_mist_attribute;
-    ret = load_qve(eid, &p_mist_attribute, &token);
+    std::vector<sgx_enclave_id_t> qve_eids;
+    sgx_status_t load_ret = SGX_SUCCESS;
+
+    // Take instances until the pool is full, then return them all unused, so they stay loaded until a verification
+    // uses them
+    uint32_t pool_size = g_qve_status.m_qve_pool_size;
+    for (uint32_t i = 0; i < pool_size; i++) {
+        sgx_enclave_id_t qve_eid = 0;
+        load_ret = load_qve(&qve_eid);
+        if (load_ret != SGX_SUCCESS) {
+            break;
+        }
+        qve_eids.push_back(qve_eid);
+    }
+    for (size_t i = 0; i < qve_eids.size(); i++) {
+        release_qve(qve_eids[i], false, true);
+    }
 
-    return ret;
+    if (load_ret == SGX_SUCCESS) {
+        return SGX_QL_SUCCESS;
+    }
+    else if (load_ret == SGX_ERROR_FEATURE_NOT_SUPPORTED) {
+        return SGX_QL_PSW_NOT_AVAILABLE;
+    }
+    else if (load_ret == SGX_ERROR_OUT_OF_EPC) {
+        return SGX_QL_OUT_OF_EPC;
+    }
+    SE_TRACE(SE_TRACE_ERROR, "Error, failed to load QvE.\n");
+    return SGX_QL_ENCLAVE_LOAD_ERROR;
+}
+
+/**
+ * Unload the QvE regardless of the enclave load policy.
+ **/
+quote3_error_t sgx_qv_unload_enclave()
+{
+    unload_qve();
+    return SGX_QL_SUCCESS;
 }
 
 
@@ -367,7 +483,7 @@ quote3_error_t sgx_qv_verify_quote(
 
             //create and initialize QvE
             //
-            load_ret = initialize_enclave(&qve_eid);
+            load_ret = load_qve(&qve_eid);
             if (load_ret != SGX_SUCCESS) {
                 if (load_ret == SGX_ERROR_FEATURE_NOT_SUPPORTED) {
                     qve_ret = SGX_QL_PSW_NOT_AVAILABLE;
@@ -431,10 +547,17 @@ quote3_error_t sgx_qv_verify_quote(
 
         } while (0);
 
-        //destroy QvE enclave
+        //an enclave kept loaded across calls may be lost after a power transition,
+        //destroy it so that the next call loads a new one
+        //
+        if (ecall_ret == SGX_ERROR_ENCLAVE_LOST) {
+            qve_ret = SGX_QL_ENCLAVE_LOST;
+        }
+
+        //destroy QvE enclave, unless the load policy is SGX_QL_PERSISTENT
         //
         if (qve_eid != 0) {
-            unload_qve(true);
+            release_qve(qve_eid, ecall_ret == SGX_ERROR_ENCLAVE_LOST);
         }
     }
     else {
@@ -499,6 +622,385 @@ quote3_error_t sgx_qv_verify_quote(
     return qve_ret;
 }
 
+/**
+ * Group the quotes of a batch by the collateral they are verified against. With a collateral provided by the caller
+ * there's a single group, otherwise the collateral of each FMSPC and PCK CA is retrieved once using QPL. Quotes
+ * without a collateral keep QVE_BATCH_NO_COLLATERAL as collateral index, with the error in their verification status.
+ **/
+static quote3_error_t qv_group_batch_quotes(
+    sgx_qv_quote_batch_entry_t *p_entries,
+    uint32_t entry_count,
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    std::vector<const struct _sgx_ql_qve_collateral_t*> &collaterals,
+    std::vector<uint32_t> &collateral_indexes,
+    std::vector<struct _sgx_ql_qve_collateral_t*> &collaterals_from_qp)
+{
+    if (p_quote_collateral) {
+        collaterals.push_back(p_quote_collateral);
+        std::fill(collateral_indexes.begin(), collateral_indexes.end(), 0);
+        return SGX_QL_SUCCESS;
+    }
+
+    //FMSPC and CA -> collateral index, or error of the collateral retrieval
+    //
+    std::map<std::string, std::pair<uint32_t, quote3_error_t>> groups;
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+        unsigned char fmspc_from_quote[FMSPC_SIZE] = { 0 };
+        unsigned char ca_from_quote[CA_SIZE] = { 0 };
+
+        //the QVL is enough to extract fmspc and CA for grouping, the QvE verifies them against the collateral
+        //
+        quote3_error_t qv_ret = qvl_get_fmspc_ca_from_quote(p_entries[i].p_quote, p_entries[i].quote_size,
+            fmspc_from_quote, FMSPC_SIZE, ca_from_quote, CA_SIZE);
+        if (qv_ret != SGX_QL_SUCCESS) {
+            SE_TRACE(SE_TRACE_DEBUG, "Error: get_fmspc_ca_from_quote failed: 0x%04x\n", qv_ret);
+            p_entries[i].verification_status = qv_ret;
+            continue;
+        }
+
+        std::string key(reinterpret_cast<const char*>(fmspc_from_quote), FMSPC_SIZE);
+        key.append(reinterpret_cast<const char*>(ca_from_quote), CA_SIZE);
+        auto group = groups.find(key);
+        if (group == groups.end()) {
+            struct _sgx_ql_qve_collateral_t *p_collateral_from_qp = NULL;
+
+            //retrieve verification collateral using QPL, once per group
+            //
+            qv_ret = sgx_dcap_retrieve_verification_collateral(
+                (const char *)fmspc_from_quote,
+                FMSPC_SIZE,
+                (const char *)ca_from_quote,
+                &p_collateral_from_qp);
+            if (qv_ret == SGX_QL_SUCCESS) {
+                SE_TRACE(SE_TRACE_DEBUG, "Info: sgx_dcap_retrieve_verification_collateral successfully returned.\n");
+                collaterals_from_qp.push_back(p_collateral_from_qp);
+                collaterals.push_back(p_collateral_from_qp);
+                group = groups.emplace(key, std::make_pair(static_cast<uint32_t>(collaterals.size() - 1), SGX_QL_SUCCESS)).first;
+            }
+            else {
+                SE_TRACE(SE_TRACE_DEBUG, "Error: sgx_dcap_retrieve_verification_collateral failed: 0x%04x\n", qv_ret);
+                group = groups.emplace(key, std::make_pair(QVE_BATCH_NO_COLLATERAL, qv_ret)).first;
+            }
+        }
+        collateral_indexes[i] = group->second.first;
+        if (group->second.first == QVE_BATCH_NO_COLLATERAL) {
+            p_entries[i].verification_status = group->second.second;
+        }
+    }
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Append a collateral to a batch ECALL buffer, see PackedCollateral.
+ **/
+static quote3_error_t qv_pack_collateral(const struct _sgx_ql_qve_collateral_t *p_collateral, std::vector<uint8_t> &packed)
+{
+    const intel::sgx::dcap::PackedCollateral::Collateral collateral = {
+        p_collateral->version,
+        { p_collateral->pck_crl_issuer_chain, p_collateral->root_ca_crl, p_collateral->pck_crl,
+          p_collateral->tcb_info_issuer_chain, p_collateral->tcb_info,
+          p_collateral->qe_identity_issuer_chain, p_collateral->qe_identity },
+        { p_collateral->pck_crl_issuer_chain_size, p_collateral->root_ca_crl_size, p_collateral->pck_crl_size,
+          p_collateral->tcb_info_issuer_chain_size, p_collateral->tcb_info_size,
+          p_collateral->qe_identity_issuer_chain_size, p_collateral->qe_identity_size } };
+
+    if (!intel::sgx::dcap::PackedCollateral::append(collateral, QVE_BATCH_MAX_DATA_SIZE, packed)) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Verify the quotes [begin, end) of a batch with one ECALL to the QvE, see qve_verify_quote_batch. The ECALL takes
+ * the packed collaterals of these quotes only.
+ **/
+static quote3_error_t qve_verify_quote_batch_chunk(
+    sgx_enclave_id_t qve_eid,
+    sgx_qv_quote_batch_entry_t *p_entries,
+    uint32_t begin,
+    uint32_t end,
+    const std::vector<std::vector<uint8_t>> &packed_collaterals,
+    const std::vector<uint32_t> &collateral_indexes,
+    const time_t expiration_check_date,
+    uint32_t batch_flags,
+    sgx_ql_qe_report_info_t *p_qve_report_info,
+    uint32_t supplemental_data_size,
+    sgx_status_t *p_ecall_ret)
+{
+    uint32_t quote_count = end - begin;
+    std::vector<uint8_t> chunk_collaterals;
+    std::vector<uint32_t> chunk_collateral_indexes(quote_count, QVE_BATCH_NO_COLLATERAL);
+    std::vector<uint32_t> chunk_indexes(packed_collaterals.size(), QVE_BATCH_NO_COLLATERAL);
+    uint32_t chunk_collateral_count = 0;
+    std::vector<uint8_t> quotes;
+    std::vector<uint32_t> quote_sizes(quote_count);
+    quote3_error_t qve_ret = SGX_QL_ERROR_UNEXPECTED;
+
+    //copy quotes and their collaterals into one buffer each, the collateral indexes are renumbered for the chunk
+    //
+    for (uint32_t i = 0; i < quote_count; i++) {
+        const sgx_qv_quote_batch_entry_t &entry = p_entries[begin + i];
+        uint32_t index = collateral_indexes[begin + i];
+        if (index != QVE_BATCH_NO_COLLATERAL) {
+            if (chunk_indexes[index] == QVE_BATCH_NO_COLLATERAL) {
+                chunk_indexes[index] = chunk_collateral_count++;
+                chunk_collaterals.insert(chunk_collaterals.end(), packed_collaterals[index].begin(), packed_collaterals[index].end());
+            }
+            chunk_collateral_indexes[i] = chunk_indexes[index];
+        }
+        quotes.insert(quotes.end(), entry.p_quote, entry.p_quote + entry.quote_size);
+        quote_sizes[i] = entry.quote_size;
+    }
+
+    std::vector<uint32_t> collateral_expiration_status(quote_count, 1);
+    std::vector<sgx_ql_qv_result_t> quote_verification_result(quote_count, SGX_QL_QV_RESULT_UNSPECIFIED);
+    std::vector<quote3_error_t> verification_status(quote_count, SGX_QL_ERROR_UNEXPECTED);
+    std::vector<uint8_t> supplemental_data((size_t)supplemental_data_size * quote_count);
+
+    *p_ecall_ret = sgx_qve_verify_quote_batch(
+        qve_eid, &qve_ret,
+        quotes.data(), static_cast<uint32_t>(quotes.size()),
+        quote_sizes.data(),
+        chunk_collateral_indexes.data(),
+        quote_count,
+        chunk_collaterals.empty() ? NULL : chunk_collaterals.data(), static_cast<uint32_t>(chunk_collaterals.size()),
+        expiration_check_date,
+        collateral_expiration_status.data(),
+        quote_verification_result.data(),
+        verification_status.data(),
+        batch_flags,
+        p_qve_report_info,
+        static_cast<uint32_t>(supplemental_data.size()),
+        supplemental_data.empty() ? NULL : supplemental_data.data());
+    if (qve_ret == SGX_QL_SUCCESS && *p_ecall_ret == SGX_SUCCESS) {
+        SE_TRACE(SE_TRACE_DEBUG, "Info: QvE: sgx_qve_verify_quote_batch successfully returned.\n");
+    }
+    else {
+        SE_TRACE(SE_TRACE_DEBUG, "Error: QvE: sgx_qve_verify_quote_batch failed: 0x%04x\n", qve_ret);
+        if (*p_ecall_ret != SGX_SUCCESS) {
+            qve_ret = *p_ecall_ret == SGX_ERROR_ENCLAVE_LOST ? SGX_QL_ENCLAVE_LOST : SGX_QL_ERROR_UNEXPECTED;
+        }
+        return qve_ret;
+    }
+
+    for (uint32_t i = 0; i < quote_count; i++) {
+        sgx_qv_quote_batch_entry_t &entry = p_entries[begin + i];
+        entry.collateral_expiration_status = collateral_expiration_status[i];
+        entry.quote_verification_result = quote_verification_result[i];
+        if (chunk_collateral_indexes[i] != QVE_BATCH_NO_COLLATERAL) {
+            entry.verification_status = verification_status[i];
+        }
+        if (entry.p_supplemental_data) {
+            memcpy_s(entry.p_supplemental_data, entry.supplemental_data_size,
+                &supplemental_data[(size_t)i * supplemental_data_size], supplemental_data_size);
+        }
+    }
+    return SGX_QL_SUCCESS;
+}
+
+/**
+ * Verify the grouped quotes of a batch with the QvE. The quotes and collaterals copied into the QvE by one ECALL are
+ * limited to QVE_BATCH_MAX_DATA_SIZE bytes, so a larger batch is split into chunks of consecutive quotes, each
+ * with the collaterals of its quotes. All chunks are verified in order by the same QvE instance, which generates
+ * one report for the whole batch.
+ **/
+static quote3_error_t qve_verify_quote_batch(
+    sgx_qv_quote_batch_entry_t *p_entries,
+    uint32_t entry_count,
+    const std::vector<const struct _sgx_ql_qve_collateral_t*> &collaterals,
+    const std::vector<uint32_t> &collateral_indexes,
+    const time_t expiration_check_date,
+    sgx_ql_qe_report_info_t *p_qve_report_info,
+    uint32_t supplemental_data_size)
+{
+    std::vector<std::vector<uint8_t>> packed_collaterals(collaterals.size());
+    quote3_error_t qve_ret = SGX_QL_ERROR_UNEXPECTED;
+
+    for (size_t i = 0; i < collaterals.size(); i++) {
+        qve_ret = qv_pack_collateral(collaterals[i], packed_collaterals[i]);
+        if (qve_ret != SGX_QL_SUCCESS) {
+            return qve_ret;
+        }
+    }
+
+    //split the batch into chunks [chunk_begins[k], chunk_begins[k + 1]), each quote with its collateral must fit
+    //in one ECALL
+    //
+    std::vector<uint32_t> chunk_begins(1, 0);
+    std::vector<bool> collateral_in_chunk(collaterals.size(), false);
+    size_t chunk_size = 0;
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint32_t index = collateral_indexes[i];
+        size_t size = p_entries[i].quote_size;
+        if (index != QVE_BATCH_NO_COLLATERAL && !collateral_in_chunk[index]) {
+            size += packed_collaterals[index].size();
+        }
+        if (size > QVE_BATCH_MAX_DATA_SIZE - chunk_size && i != chunk_begins.back()) {
+            chunk_begins.push_back(i);
+            std::fill(collateral_in_chunk.begin(), collateral_in_chunk.end(), false);
+            chunk_size = 0;
+            size = p_entries[i].quote_size;
+            if (index != QVE_BATCH_NO_COLLATERAL) {
+                size += packed_collaterals[index].size();
+            }
+        }
+        if (size > QVE_BATCH_MAX_DATA_SIZE - chunk_size) {
+            return SGX_QL_ERROR_INVALID_PARAMETER;
+        }
+        chunk_size += size;
+        if (index != QVE_BATCH_NO_COLLATERAL) {
+            collateral_in_chunk[index] = true;
+        }
+    }
+    chunk_begins.push_back(entry_count);
+
+    sgx_enclave_id_t qve_eid = 0;
+    sgx_status_t load_ret = SGX_ERROR_UNEXPECTED;
+    sgx_status_t ecall_ret = SGX_SUCCESS;
+
+    do {
+        //create and initialize QvE
+        //
+        load_ret = load_qve(&qve_eid);
+        if (load_ret != SGX_SUCCESS) {
+            if (load_ret == SGX_ERROR_FEATURE_NOT_SUPPORTED) {
+                qve_ret = SGX_QL_PSW_NOT_AVAILABLE;
+            }
+            else {
+                SE_TRACE(SE_TRACE_ERROR, "Error, failed to load QvE.\n");
+                qve_ret = SGX_QL_ENCLAVE_LOAD_ERROR;
+            }
+            break;
+        }
+
+        size_t chunk_count = chunk_begins.size() - 1;
+        for (size_t k = 0; k < chunk_count; k++) {
+            uint32_t batch_flags = (k == 0 ? QVE_BATCH_FIRST_CHUNK : 0) | (k == chunk_count - 1 ? QVE_BATCH_LAST_CHUNK : 0);
+            qve_ret = qve_verify_quote_batch_chunk(qve_eid, p_entries, chunk_begins[k], chunk_begins[k + 1],
+                packed_collaterals, collateral_indexes, expiration_check_date, batch_flags, p_qve_report_info,
+                supplemental_data_size, &ecall_ret);
+            if (qve_ret != SGX_QL_SUCCESS) {
+                break;
+            }
+        }
+    } while (0);
+
+    //destroy QvE enclave, unless the load policy is SGX_QL_PERSISTENT
+    //
+    if (qve_eid != 0) {
+        release_qve(qve_eid, ecall_ret == SGX_ERROR_ENCLAVE_LOST);
+    }
+
+    return qve_ret;
+}
+
+/**
+ * Perform verification of a batch of quotes. Quotes are grouped by collateral, so that the collateral is retrieved
+ * once per group, and in QvE mode the whole batch is verified by one ECALL.
+ **/
+quote3_error_t sgx_qv_verify_quote_batch(
+    sgx_qv_quote_batch_entry_t *p_entries,
+    uint32_t entry_count,
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    const time_t expiration_check_date,
+    sgx_ql_qe_report_info_t *p_qve_report_info)
+{
+    //validate input parameters
+    //
+    if (NULL_POINTER(p_entries) ||
+        entry_count == 0 ||
+        expiration_check_date == 0) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+
+    //supplemental data is required for all the quotes or none of them
+    //
+    bool supplemental_required = p_entries[0].p_supplemental_data != NULL;
+    for (uint32_t i = 0; i < entry_count; i++) {
+        if (CHECK_MANDATORY_PARAMS(p_entries[i].p_quote, p_entries[i].quote_size) ||
+            CHECK_OPT_PARAMS(p_entries[i].p_supplemental_data, p_entries[i].supplemental_data_size) ||
+            (p_entries[i].p_supplemental_data != NULL) != supplemental_required) {
+            return SGX_QL_ERROR_INVALID_PARAMETER;
+        }
+    }
+
+    //validate supplemental data size
+    //
+    uint32_t supplemental_data_size = 0;
+    if (supplemental_required) {
+        quote3_error_t tmp_ret = sgx_qv_get_quote_supplemental_data_size(&supplemental_data_size);
+        if (tmp_ret != SGX_QL_SUCCESS) {
+            return SGX_QL_ERROR_INVALID_PARAMETER;
+        }
+        for (uint32_t i = 0; i < entry_count; i++) {
+            if (supplemental_data_size > p_entries[i].supplemental_data_size) {
+                return SGX_QL_ERROR_INVALID_PARAMETER;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+        p_entries[i].collateral_expiration_status = 1;
+        p_entries[i].quote_verification_result = SGX_QL_QV_RESULT_UNSPECIFIED;
+        p_entries[i].verification_status = SGX_QL_ERROR_UNEXPECTED;
+    }
+
+    quote3_error_t qv_ret = SGX_QL_ERROR_UNEXPECTED;
+    std::vector<struct _sgx_ql_qve_collateral_t*> collaterals_from_qp;
+
+    try {
+        std::vector<const struct _sgx_ql_qve_collateral_t*> collaterals;
+        std::vector<uint32_t> collateral_indexes(entry_count, QVE_BATCH_NO_COLLATERAL);
+
+        qv_ret = qv_group_batch_quotes(p_entries, entry_count, p_quote_collateral,
+            collaterals, collateral_indexes, collaterals_from_qp);
+
+        //decide trusted VS untrusted verification
+        //
+        if (qv_ret == SGX_QL_SUCCESS && p_qve_report_info) {
+            qv_ret = qve_verify_quote_batch(p_entries, entry_count, collaterals, collateral_indexes,
+                expiration_check_date, p_qve_report_info, supplemental_data_size);
+        }
+        else if (qv_ret == SGX_QL_SUCCESS) {
+            for (uint32_t i = 0; i < entry_count; i++) {
+                if (collateral_indexes[i] == QVE_BATCH_NO_COLLATERAL) {
+                    continue;
+                }
+                p_entries[i].verification_status = sgx_qvl_verify_quote(
+                    p_entries[i].p_quote, p_entries[i].quote_size,
+                    collaterals[collateral_indexes[i]],
+                    expiration_check_date,
+                    &p_entries[i].collateral_expiration_status,
+                    &p_entries[i].quote_verification_result,
+                    NULL,
+                    p_entries[i].supplemental_data_size,
+                    p_entries[i].p_supplemental_data);
+            }
+        }
+    }
+    catch (const std::bad_alloc&) {
+        qv_ret = SGX_QL_ERROR_OUT_OF_MEMORY;
+    }
+
+    //free verification collateral using QPL
+    //
+    for (size_t i = 0; i < collaterals_from_qp.size(); i++) {
+        sgx_dcap_free_verification_collateral(collaterals_from_qp[i]);
+    }
+
+    //if the batch failed, none of the quotes is verified
+    //
+    if (qv_ret != SGX_QL_SUCCESS) {
+        for (uint32_t i = 0; i < entry_count; i++) {
+            p_entries[i].quote_verification_result = SGX_QL_QV_RESULT_UNSPECIFIED;
+            p_entries[i].verification_status = qv_ret;
+        }
+    }
+
+    return qv_ret;
+}
+
 /**
  * Get supplemental data required size.
  **/
@@ -518,7 +1020,7 @@ quote3_error_t sgx_qv_get_quote_supplemental_data_size(
     do {
         //create and initialize QvE
         //
-        load_ret = initialize_enclave(&qve_eid);
+        load_ret = load_qve(&qve_eid);
         if (load_ret != SGX_SUCCESS) {
             if (load_ret == SGX_ERROR_FEATURE_NOT_SUPPORTED) {
                 qve_ret = SGX_QL_PSW_NOT_AVAILABLE;
@@ -593,16 +1095,46 @@ quote3_error_t sgx_qv_get_quote_supplemental_data_size(
     } while (0) ;
 
 
-    //destroy QvE enclave
+    //destroy QvE enclave, unless the load policy is SGX_QL_PERSISTENT
     //
     if (qve_eid != 0) {
-        unload_qve(true);
+        release_qve(qve_eid, ecall_ret == SGX_ERROR_ENCLAVE_LOST);
     }
 
     return qve_ret;
 }
 
 
+/**
+ * Build prepared collateral, it's decoded by the untrusted QVL
+ **/
+quote3_error_t sgx_qv_prepare_collateral(
+    const struct _sgx_ql_qve_collateral_t *p_quote_collateral,
+    struct _sgx_ql_qve_collateral_t **pp_prepared_collateral) {
+
+    if (NULL_POINTER(p_quote_collateral) || NULL_POINTER(pp_prepared_collateral)) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+
+    return sgx_qvl_prepare_collateral(p_quote_collateral, pp_prepared_collateral);
+}
+
+
+/**
+ * Free prepared collateral
+ **/
+quote3_error_t sgx_qv_free_prepared_collateral(
+    struct _sgx_ql_qve_collateral_t *p_prepared_collateral) {
+
+    if (NULL_POINTER(p_prepared_collateral) || p_prepared_collateral->version != QVE_COLLATERAL_VERSION_PREPARED) {
+        return SGX_QL_ERROR_INVALID_PARAMETER;
+    }
+    free(p_prepared_collateral);
+
+    return SGX_QL_SUCCESS;
+}
+
+
 /**
  * Get QvE identity and Root CA CRL
  **/